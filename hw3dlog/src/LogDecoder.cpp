@@ -0,0 +1,195 @@
+#include "LogDecoder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <string>
+
+namespace
+{
+	template<class T>
+	T read(const std::byte* data) noexcept
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+	// Records come in order, so the calendar part is only worked out again when the second changes
+	class TimeFormatter
+	{
+	public:
+		explicit TimeFormatter(const BinaryLogFormat::FileHeader& file) noexcept
+			:
+			file_(file)
+		{}
+
+		void append(std::string& out, const std::uint64_t ticks)
+		{
+			const long double seconds = static_cast<long double>(static_cast<std::int64_t>(ticks - file_.openTicks))
+				* static_cast<long double>(file_.tickNumerator) / static_cast<long double>(file_.tickDenominator);
+			const std::int64_t nanoseconds = file_.openUnixNanoseconds + static_cast<std::int64_t>(seconds * 1e9L);
+			const std::time_t time = static_cast<std::time_t>(nanoseconds / 1000000000);
+			if (time != second_)
+			{
+				tm t;
+#ifdef _WIN32
+				localtime_s(&t, &time);
+#else
+				localtime_r(&time, &t);
+#endif
+				std::snprintf(date_, sizeof(date_), "%04d-%02d-%02d %02d:%02d:%02d.",
+					t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+				second_ = time;
+			}
+			char milliseconds[8];
+			std::snprintf(milliseconds, sizeof(milliseconds), "%03d ", static_cast<int>(nanoseconds / 1000000 % 1000));
+			out += date_;
+			out += milliseconds;
+		}
+	private:
+		const BinaryLogFormat::FileHeader& file_;
+		std::time_t second_ = -1;
+		char date_[80] = {};
+	};
+}
+
+LogDecoder::LogDecoder(const std::span<const std::byte> contents)
+{
+	const std::byte* begin = contents.data();
+	if (contents.size() < sizeof(file_))
+	{
+		result_ = Result::TOO_SHORT;
+		return;
+	}
+	std::memcpy(&file_, begin, sizeof(file_));
+	if (!std::equal(std::begin(file_.magic), std::end(file_.magic), std::begin(BinaryLogFormat::magic)) || file_.version != BinaryLogFormat::version)
+	{
+		result_ = Result::WRONG_VERSION;
+		return;
+	}
+
+	// A log that was not closed has no used size, its records then run to the end of the file
+	const std::byte* end = begin + contents.size();
+	if (file_.usedBytes != 0u)
+	{
+		end = std::min(end, begin + file_.headerSize + file_.usedBytes);
+	}
+
+	// Sites are defined before their first event, but threads commit out of order, so definitions are collected
+	// first and the events ordered by time
+	for (const std::byte* position = begin + file_.headerSize; static_cast<size_t>(end - position) >= sizeof(BinaryLogFormat::RecordHeader);)
+	{
+		const auto* header = reinterpret_cast<const BinaryLogFormat::RecordHeader*>(position);
+		const std::uint32_t length = read<std::uint32_t>(position);
+		if (length == 0u)
+		{
+			// Room a thread claimed and died before sizing, or the unused rest of the file. Either way it is all
+			// zeros, and whatever record comes next starts on the next nonzero 8 byte boundary.
+			const std::byte* next = position + sizeof(std::uint64_t);
+			while (static_cast<size_t>(end - next) >= sizeof(std::uint64_t) && read<std::uint64_t>(next) == 0u)
+			{
+				next += sizeof(std::uint64_t);
+			}
+			if (static_cast<size_t>(end - next) >= sizeof(BinaryLogFormat::RecordHeader))
+			{
+				incomplete_++;
+			}
+			position = next;
+			continue;
+		}
+		if (length < sizeof(BinaryLogFormat::RecordHeader) || length > static_cast<size_t>(end - position))
+		{
+			incomplete_++;
+			break;
+		}
+		const std::byte* payload = position + sizeof(BinaryLogFormat::RecordHeader);
+		position += length;
+
+		const std::uint32_t tag = read<std::uint32_t>(reinterpret_cast<const std::byte*>(&header->tag));
+		if (tag == 0u)
+		{
+			incomplete_++;
+		}
+		else if (tag & BinaryLogFormat::definitionTag)
+		{
+			const auto definition = read<BinaryLogFormat::DefinitionHeader>(payload);
+			const std::byte* types = payload + sizeof(definition);
+			const auto* strings = reinterpret_cast<const char*>(types + definition.argumentCount);
+			if (types + definition.argumentCount + definition.formatLength + definition.funcLength > position)
+			{
+				incomplete_++;
+				continue;
+			}
+			Site& site = sites_[tag & ~BinaryLogFormat::definitionTag];
+			site.severity = definition.severity;
+			site.line = definition.line;
+			site.types.resize(definition.argumentCount);
+			std::memcpy(site.types.data(), types, definition.argumentCount);
+			site.format = std::string_view(strings, definition.formatLength);
+			site.func = std::string_view(strings + definition.formatLength, definition.funcLength);
+		}
+		else
+		{
+			events_.push_back({ header, payload, position });
+		}
+	}
+	std::stable_sort(events_.begin(), events_.end(), [](const Record& a, const Record& b)
+		{
+			return a.header->ticks < b.header->ticks;
+		});
+}
+
+LogDecoder::Result LogDecoder::getResult() const noexcept
+{
+	return result_;
+}
+
+const std::unordered_map<std::uint32_t, LogDecoder::Site>& LogDecoder::getSites() const noexcept
+{
+	return sites_;
+}
+
+const std::vector<LogDecoder::Record>& LogDecoder::getEvents() const noexcept
+{
+	return events_;
+}
+
+size_t LogDecoder::getIncomplete() const noexcept
+{
+	return incomplete_;
+}
+
+size_t LogDecoder::write(std::ostream& output) const
+{
+	TimeFormatter timeFormatter(file_);
+	size_t unknown = 0u;
+	std::string line;
+	for (const Record& event : events_)
+	{
+		const auto site = sites_.find(event.header->tag);
+		if (site == sites_.end())
+		{
+			unknown++;
+			continue;
+		}
+		line.clear();
+		timeFormatter.append(line, event.header->ticks);
+		char severity[8];
+		std::snprintf(severity, sizeof(severity), "%-5s ", BinaryLogFormat::severityName(site->second.severity));
+		line += severity;
+		line += "[" + std::to_string(event.header->thread) + "] ";
+		line += "[";
+		line += site->second.func;
+		line += "@" + std::to_string(site->second.line) + "] ";
+		if (!BinaryLogFormat::formatMessage(line, site->second.format, site->second.types, event.payload, event.end))
+		{
+			line += " <arguments cut short>";
+		}
+		line += "\n";
+		output << line;
+	}
+	return unknown;
+}
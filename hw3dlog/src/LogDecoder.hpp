@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "BinaryLogFormat.hpp"
+
+// Reads the records out of a binary log held in memory and writes them as text. The log's bytes must outlive
+// the decoder, the sites and events point into them.
+class LogDecoder
+{
+public:
+	enum class Result : std::uint8_t
+	{
+		OK,
+		TOO_SHORT,
+		WRONG_VERSION
+	};
+
+	struct Site
+	{
+		std::uint8_t severity;
+		std::uint32_t line;
+		std::vector<BinaryLogFormat::ArgType> types;
+		std::string_view format;
+		std::string_view func;
+	};
+
+	struct Record
+	{
+		const BinaryLogFormat::RecordHeader* header;
+		const std::byte* payload;
+		const std::byte* end;
+	};
+
+public:
+	explicit LogDecoder(std::span<const std::byte> contents);
+
+	[[nodiscard]] Result getResult() const noexcept;
+	[[nodiscard]] const std::unordered_map<std::uint32_t, Site>& getSites() const noexcept;
+	// Oldest first
+	[[nodiscard]] const std::vector<Record>& getEvents() const noexcept;
+	// Records cut short, never committed or never sized
+	[[nodiscard]] size_t getIncomplete() const noexcept;
+
+	// One line per event in plog's TxtFormatter layout; returns how many events were skipped for coming from a
+	// site that was never defined
+	size_t write(std::ostream& output) const;
+private:
+	Result result_ = Result::OK;
+	BinaryLogFormat::FileHeader file_ = {};
+	std::unordered_map<std::uint32_t, Site> sites_;
+	std::vector<Record> events_;
+	size_t incomplete_ = 0u;
+};
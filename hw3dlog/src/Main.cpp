@@ -0,0 +1,69 @@
+// Turns a binary log written by hw3dw's BinaryLog back into text, one line per record in plog's TxtFormatter
+// layout, oldest first.
+//
+//     hw3dlog <log.blog> [output.txt]
+//
+// Only the standard library is used, so it builds wherever the log is looked at.
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "LogDecoder.hpp"
+
+int main(const int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: hw3dlog <log.blog> [output.txt]\n";
+		return 2;
+	}
+
+	std::ifstream input(argv[1], std::ios::binary);
+	if (!input)
+	{
+		std::cerr << "Cannot open " << argv[1] << "\n";
+		return 1;
+	}
+	const std::vector<char> contents{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+
+	const LogDecoder decoder(std::as_bytes(std::span(contents)));
+	switch (decoder.getResult())
+	{
+	case LogDecoder::Result::TOO_SHORT:
+		std::cerr << argv[1] << " is too short to be a binary log\n";
+		return 1;
+	case LogDecoder::Result::WRONG_VERSION:
+		std::cerr << argv[1] << " is not a version " << BinaryLogFormat::version << " binary log\n";
+		return 1;
+	default:
+		break;
+	}
+
+	std::ofstream outputFile;
+	if (argc > 2)
+	{
+		outputFile.open(argv[2], std::ios::binary);
+		if (!outputFile)
+		{
+			std::cerr << "Cannot write " << argv[2] << "\n";
+			return 1;
+		}
+	}
+	std::ostream& output = argc > 2 ? outputFile : std::cout;
+
+	const size_t unknown = decoder.write(output);
+	std::cerr << decoder.getEvents().size() - unknown << " records from " << decoder.getSites().size() << " sites";
+	if (decoder.getIncomplete() != 0u)
+	{
+		std::cerr << ", " << decoder.getIncomplete() << " incomplete";
+	}
+	if (unknown != 0u)
+	{
+		std::cerr << ", " << unknown << " from undefined sites";
+	}
+	std::cerr << "\n";
+	return 0;
+}
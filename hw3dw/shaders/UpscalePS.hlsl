@@ -0,0 +1,15 @@
+cbuffer cbuff
+{
+	// Part of the scene texture the scaled scene covers, and the last texel centre inside it
+	float2 uvScale;
+	float2 uvMax;
+};
+
+Texture2D tex;
+
+SamplerState splr;
+
+float4 main(float2 tc : TEXCOORD) : SV_Target
+{
+	return tex.Sample(splr, min(tc * uvScale, uvMax));
+}
@@ -0,0 +1,14 @@
+struct vs_out
+{
+	float2 tex : TEXCOORD;
+	float4 pos : SV_POSITION;
+};
+
+// One triangle covering the screen, generated from the vertex id without any buffers
+vs_out main(uint id : SV_VertexID)
+{
+	vs_out vs_out;
+	vs_out.tex = float2((id << 1) & 2, id & 2);
+	vs_out.pos = float4(vs_out.tex * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f), 0.0f, 1.0f);
+	return vs_out;
+}
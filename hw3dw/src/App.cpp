@@ -1,6 +1,12 @@
 #include <3rdParty/ImGui/imgui.h>
+#include <algorithm>
+#include <array>
+#include <cfloat>
 #include <DirectXMath.h>
+#include <filesystem>
+#include <fstream>
 #include <random>
+#include <thread>
 
 #include "App.hpp"
 #include "AppConfig.hpp"
@@ -13,9 +19,12 @@
 #include "Logging.hpp"
 #include "Melon.hpp"
 #include "Pyramid.hpp"
+#include "QoiEncoder.hpp"
+#include "ScenePopulation.hpp"
 #include "Sheet.hpp"
 #include "SkinnedBox.hpp"
 #include "Surface.hpp"
+#include "TransformConstantBuffer.hpp"
 
 #if defined(LOG_WINDOW_MESSAGES) || defined(LOG_WINDOW_MOUSE_MESSAGES) // defined in LoggingConfig.hpp
 #include "WindowsMessageMap.hpp"
@@ -46,8 +55,12 @@ const char* App::AppException::getType() const noexcept
 }
 
 // --- Lifecycle ---
-App::App(bool allowConsoleLogging)
+App::App(bool allowConsoleLogging, std::optional<RegressionSuite::Options> regression, const std::filesystem::path& recording)
 	: window_(std::make_unique<Window>(WIDTH, HEIGHT, TEXT("Atum D3D Window")))
+	, timestep_(static_cast<float>(SIMULATION_TICK_RATE), MAX_TICKS_PER_FRAME)
+	, framePacer_(static_cast<double>(MAX_FPS))
+	, resolutionScaler_({ .targetMilliseconds = static_cast<float>(RESOLUTION_TARGET_MILLISECONDS) })
+	, regression_(std::move(regression))
 	, stop_(false)
 {
 	PLOGI << "Constructing App";
@@ -55,7 +68,8 @@ App::App(bool allowConsoleLogging)
 	// Create a small context that holds pointers to App and Window.
 	// This context is passed to CreateWindowEx via Window::create and stored in GWLP_USERDATA.
 	auto ctx = new Window::WndContext{ static_cast<void*>(this), nullptr };
-	window_->create(ctx);
+	// The regression suite runs hidden on WARP, so neither the GPU nor its driver decide whether it can run
+	window_->create(ctx, !regression_.has_value(), regression_ ? D3D_DRIVER_TYPE_WARP : D3D_DRIVER_TYPE_HARDWARE);
 
 	if (!window_->getHandle())
 	{
@@ -99,13 +113,17 @@ App::App(bool allowConsoleLogging)
 		}
 	}
 
-	// Initialize the FPS Counter and CPU Counter
+	// Initialize the FPS Counter
 	fps_.initialize();
-	cpu_.initialize();
 #endif
+	cpu_.initialize();
+	memory_.initialize();
 
-	// Setup Dear ImGui context
+	// Setup Dear ImGui context, its heap is charged to its own tag
 	IMGUI_CHECKVERSION();
+	ImGui::SetAllocatorFunctions(
+		[](const size_t size, void*) { return MemoryTracker::allocate(size, MemoryTag::ImGui); },
+		[](void* pointer, void*) { MemoryTracker::deallocate(pointer); });
 	ImGui::CreateContext();
 
 	configureImGui();
@@ -117,11 +135,65 @@ App::App(bool allowConsoleLogging)
 	graphics_->getCamera()->setFOV(DirectX::XM_PIDIV4); // Zoom
 
 	gdiManager_ = std::make_unique<GdiPlusManager>();
-	populateDrawables();
+	if (regression_)
+	{
+		if (!regression_->replay.empty())
+		{
+			// The recording decides the scene and how many frames there are
+			replay_ = std::make_unique<InputRecording::Replay>(regression_->replay);
+			regression_->seed = replay_->getSeed();
+			regression_->drawableCount = replay_->getDrawableCount();
+			regression_->frameCount = static_cast<unsigned int>(replay_->getFrames().size());
+		}
+		populateDrawables(regression_->seed, regression_->drawableCount);
+	}
+	else
+	{
+		const unsigned int seed = std::random_device{}();
+		if (!recording.empty())
+		{
+			// The pipelined simulation works on the frame after the one whose input it gets
+			recorder_ = std::make_unique<InputRecording::Recorder>(recording, seed, static_cast<std::uint32_t>(NUMBER_OF_DRAWABLES),
+				PIPELINED_SIMULATION ? 1u : 0u);
+		}
+		populateDrawables(seed, NUMBER_OF_DRAWABLES);
+	}
+	renderQueue_.reserve(drawables_.size());
+	graphics_->reserveDraws(drawables_.size());
+
+#if (PIPELINED_SIMULATION)
+	if (!regression_)
+	{
+		PLOGI << "Simulating on a separate thread, one frame ahead of rendering";
+		simulation_ = std::make_unique<SimulationThread>([this](const float dt, SceneSnapshot& snapshot) { simulateFrame(dt, snapshot); });
+		// The first frame renders this one
+		simulation_->request(0.0f);
+	}
+#endif
+
+#if (RECORDING_THREADS > 0)
+	PLOGI << "Recording draws on " << RECORDING_THREADS << " worker threads";
+	recordingPool_ = std::make_unique<WorkerPool>(RECORDING_THREADS);
+	// The main thread records a range as well
+	for (size_t i = 0; i <= recordingPool_->getThreadCount(); i++)
+	{
+		recorders_.push_back(std::make_unique<CommandRecorder>(*graphics_));
+	}
+#endif
+
+#if (CAPTURE_FRAMES)
+	frameCapture_ = std::make_unique<FrameCapture>("captures");
+#endif
 }
 
 App::~App()
 {
+	simulation_.reset();
+	// Let the encoder finish with the pooled frames before the window and device go away
+	frameCapture_.reset();
+	recorders_.clear();
+	recordingPool_.reset();
+
 #ifdef IMGUI_DOCKING
 	// Disable platform windows before shutdown
 	ImGuiIO& io = ImGui::GetIO();
@@ -151,17 +223,16 @@ App::~App()
 // --- Main Loop ---
 int App::run()
 {
+	if (regression_)
+	{
+		return runRegression();
+	}
+
 	bool showDemoWindow = true;
 	bool showAnotherWindow = false;
 	auto clearColor = ImVec4(0.07f, 0.0f, 0.12f, 1.00f);
 	const ImGuiIO& io = ImGui::GetIO();
 
-#if defined(MAX_FPS) && (MAX_FPS > 0)
-	using clock = std::chrono::steady_clock; // Monotonic clock, unaffected by system time changes
-	const std::chrono::seconds interval(MAX_FPS);  // 1 FPS = 1 second per frame
-	auto next_tick = clock::now();
-#endif
-
 	PLOGI << "Starting Message Pump and Render Loop";
 	while (!stop_)
 	{
@@ -177,32 +248,17 @@ int App::run()
 			}
 		}
 
-#if defined(MAX_FPS) && (MAX_FPS > 0)
-		auto now = clock::now();
-		std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-		char timeStr[26]; // ctime_s requires a buffer of at least 26 bytes
-		errno_t err = ctime_s(timeStr, sizeof(timeStr), &t);
-		if (err == 0) {
-			PLOGV << "Tick at: " << timeStr; // already includes newline
-		}
-		else {
-			PLOGW << "Failed to format time string";
-		}
-
-		// Schedule next tick
-		next_tick += interval;
-		// Sleep until the next scheduled time
-		std::this_thread::sleep_until(next_tick);
-#endif
+		framePacer_.wait();
 
+		cpu_.frame();
+		memory_.frame();
 #if (IS_DEBUG)
 		fps_.frame();
-		cpu_.frame();
 		window_->setTitle(L"fps: " + std::to_wstring(fps_.getFps()) + L" / cpu: " + std::to_wstring(cpu_.getCpuPercentage()) + L"%");
 #endif
 
 #ifdef LOG_GRAPHICS_CALLS
-		PLOGV << "graphics.beginFrame()";
+		BLOGV("graphics.beginFrame()");
 #endif
 		const auto [width, height] = window_->getTargetDimensions();
 		if (!graphics_->beginFrame(width, height))
@@ -214,8 +270,26 @@ int App::run()
 			continue;
 		}
 
+		// Input pumped so far reaches the screen with this frame
+		auto& inputLatency = graphics_->getInputLatency();
+		mouse_->reportArrivals(inputLatency);
+		keyboard_->reportArrivals(inputLatency);
+		inputLatency.beginFrame();
+		const Mouse::FrameInput mouseInput = mouse_->collectFrame([this](const Mouse::Event& event)
+			{
+				if (recorder_)
+				{
+					recorder_->record(event);
+				}
+			});
+		if (recorder_)
+		{
+			keyboard_->drainKeys([this](const Keyboard::Event& event) { recorder_->record(event); });
+			keyboard_->drainChars([this](const char character) { recorder_->recordChar(character); });
+		}
+
 		// Start the Dear ImGui frame
-		PLOGD << "Start the Dear ImGui frame";
+		BLOGD("Start the Dear ImGui frame");
 		Graphics::ImGui::NewFrame();
 		Window::ImGui::NewFrame();
 		ImGui::NewFrame();
@@ -223,13 +297,13 @@ int App::run()
 		// 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
 		if (showDemoWindow)
 		{
-			PLOGD << "Show the big demo window";
+			BLOGD("Show the big demo window");
 			ImGui::ShowDemoWindow(&showDemoWindow);
 		}
 
 		// 2. Show a simple window that we create ourselves. We use a Begin/End pair to create a named window.
 		{
-			PLOGD << "Show a simple Dear ImGui window";
+			BLOGD("Show a simple Dear ImGui window");
 			static float f = 0.0f;
 			static int counter = 0;
 
@@ -248,13 +322,61 @@ int App::run()
 			ImGui::Text("counter = %d", counter);
 
 			ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+			const auto pacing = framePacer_.getStatistics();
+			ImGui::Text("Frame interval %.3f ms, jitter %.3f ms, wake error %.3f ms (max %.3f), missed %llu", pacing.meanIntervalMicroseconds / 1000.0,
+				pacing.intervalJitterMicroseconds / 1000.0, pacing.meanErrorMicroseconds / 1000.0, pacing.maxErrorMicroseconds / 1000.0, pacing.missedDeadlines);
+			if (ImGui::Button("Reset pacing"))
+			{
+				framePacer_.resetStatistics();
+			}
+			ImGui::Text("Render scale %.3f, GPU %.2f ms (target %.1f ms)", graphics_->getRenderScale(), resolutionScaler_.getAverageMilliseconds(),
+				resolutionScaler_.getSettings().targetMilliseconds);
+			const auto latency = graphics_->getInputLatency().getStatistics();
+			ImGui::Text("Input to photon p50 %.0f ms, p95 %.0f ms, p99 %.0f ms, max %.1f ms (%llu frames, %llu events)", latency.p50Milliseconds,
+				latency.p95Milliseconds, latency.p99Milliseconds, latency.maxMilliseconds, latency.samples, latency.inputs);
+			std::array<float, InputLatency::bucketCount> latencyBuckets;
+			std::ranges::transform(graphics_->getInputLatency().getHistogram(), latencyBuckets.begin(), [](const unsigned long long count) { return static_cast<float>(count); });
+			ImGui::PlotHistogram("Latency (1 ms buckets)", latencyBuckets.data(), static_cast<int>(latencyBuckets.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+			if (ImGui::Button("Reset latency"))
+			{
+				graphics_->getInputLatency().reset();
+			}
+			ImGui::Text("Mouse %d, %d moved %d, %d, wheel %d: %u moves in %u events", mouseInput.x, mouseInput.y, mouseInput.deltaX,
+				mouseInput.deltaY, mouseInput.wheel, mouseInput.moves, mouseInput.events);
+			const auto logging = Logging::getStatistics();
+			ImGui::Text("Logged %llu records in %llu batches, dropped %llu, waited %llu (peak %zu blocks)", logging.written, logging.batches,
+				logging.dropped, logging.waited, logging.peakBlocks);
+			if (const auto binary = Logging::getBinaryStatistics())
+			{
+				ImGui::Text("Binary log %.1f / %.1f MiB from %zu sites, dropped %zu", static_cast<double>(binary->usedBytes) / (1024.0 * 1024.0),
+					static_cast<double>(binary->capacityBytes) / (1024.0 * 1024.0), binary->sites, binary->dropped);
+			}
+			showCpuUsage();
+			showMemoryUsage();
+#if (CAPTURE_FRAMES)
+			const auto capture = frameCapture_->getStatistics();
+			ImGui::Text("Captured %llu / dropped %llu / queued %zu (peak %zu)", capture.encoded, capture.dropped, capture.queued, capture.peakQueued);
+			ImGui::Text("Capture written %.1f MiB", static_cast<double>(capture.bytesWritten) / (1024.0 * 1024.0));
+#endif
+			if (ImGui::Button("Render on CPU"))
+			{
+				renderSoftwareFrame(clearColor);
+			}
+			if (softwareRasterizer_)
+			{
+				const auto& software = softwareRasterizer_->getStatistics();
+				ImGui::SameLine();
+				ImGui::Text("setup %.2f ms, raster %.2f ms, %zu of %zu triangles, %zu pixels (%s)", software.setupMilliseconds,
+					software.rasterMilliseconds, software.trianglesRasterized, software.triangles, software.pixelsShaded,
+					softwareRasterizer_->isUsingAvx2() ? "AVX2" : "scalar");
+			}
 			ImGui::End();
 		}
 
 		// 3. Show another simple window.
 		if (showAnotherWindow)
 		{
-			PLOGD << "Show another simple Dear ImGui window";
+			BLOGD("Show another simple Dear ImGui window");
 			ImGui::Begin("Another Window", &showAnotherWindow);   // Pass a pointer to our bool variable (the window will have a closing button that will clear the bool when clicked)
 			ImGui::Text("Hello from another window!");
 			if (ImGui::Button("Close Me"))
@@ -263,17 +385,17 @@ int App::run()
 		}
 
 #ifdef LOG_GRAPHICS_CALLS
-		PLOGV << "ImGui::Render();";
+		BLOGV("ImGui::Render();");
 #endif
 		ImGui::Render();
 
 #ifdef LOG_GRAPHICS_CALLS
-		PLOGV << "renderFrame(clear_color);";
+		BLOGV("renderFrame(clear_color);");
 #endif
 		renderFrame(clearColor);
 
 #ifdef LOG_GRAPHICS_CALLS
-		PLOGV << "graphics->endFrame();";
+		BLOGV("graphics->endFrame();");
 #endif
 		graphics_->endFrame();
 	}
@@ -327,7 +449,8 @@ void App::configureImGui() const
 LRESULT App::thunkEntry(const HWND hWnd, const UINT msg, const WPARAM wParam, const LPARAM lParam)
 {
 #ifdef LOG_WINDOW_MESSAGES
-	PLOGV << windowsMessageMap(msg, lParam, wParam).c_str();
+	char message[WindowsMessageMap::bufferSize];
+	PLOGV << windowsMessageMap(message, msg, lParam, wParam);
 #endif
 	// Forward to the real instance handler which may be noexcept.
 	return WndProcHandler(hWnd, msg, wParam, lParam);
@@ -337,12 +460,14 @@ extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg
 LRESULT App::WndProcHandler(const HWND hWnd, const UINT msg, const WPARAM wParam, const LPARAM lParam) noexcept
 {
 #ifdef LOG_WINDOW_MESSAGES
-	PLOGV << windowsMessageMap(msg, lParam, wParam).c_str();
+	char message[WindowsMessageMap::bufferSize];
+	PLOGV << windowsMessageMap(message, msg, lParam, wParam);
 #endif
 #ifdef LOG_WINDOW_MOUSE_MESSAGES
 	if (msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST)
 	{
-		PLOGV << windowsMessageMap(msg, lParam, wParam).c_str();
+		char message[WindowsMessageMap::bufferSize];
+		PLOGV << windowsMessageMap(message, msg, lParam, wParam);
 	}
 #endif
 
@@ -500,7 +625,8 @@ std::optional<unsigned int> App::processMessages()
 	while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
 	{
 #ifdef LOG_WINDOW_MESSAGES
-		PLOGV << windowsMessageMap(msg.message, msg.lParam, msg.wParam).c_str();
+		char message[WindowsMessageMap::bufferSize];
+		PLOGV << windowsMessageMap(message, msg.message, msg.lParam, msg.wParam);
 #endif
 		if (msg.message == WM_QUIT)
 		{
@@ -542,11 +668,18 @@ std::optional<unsigned int> App::processMessages()
 void App::renderFrame(const ImVec4& clearColor)
 {
 	const auto dt = timer_.mark();
-	PLOGD << "Fetch Dear ImGui IO";
+	if (recorder_)
+	{
+		recorder_->endFrame(dt);
+	}
+	BLOGD("Fetch Dear ImGui IO");
 	const ImGuiIO& io = ImGui::GetIO(); (void)io;
 
-	PLOGD << "Clear the buffer";
-	graphics_->clearBuffer(clearColor);
+	// Trade scene resolution for GPU time before anything draws at the old scale
+	if (const auto gpuMilliseconds = graphics_->takeGpuFrameMilliseconds())
+	{
+		graphics_->setRenderScale(resolutionScaler_.update(*gpuMilliseconds));
+	}
 
 #define CAMERA_ZOOM false
 #if (CAMERA_ZOOM)
@@ -566,125 +699,485 @@ void App::renderFrame(const ImVec4& clearColor)
 	camera->setPosition(pos);
 #endif
 
-	PLOGD << "Draw all drawables";
+	// Paused frames add no time, so the same pose keeps being rendered
+	const float frameSeconds = keyboard_->isKeyPressed(VK_SPACE) ? 0.0f : dt;
+	if (simulation_)
+	{
+		// Take the frame simulated during the last one and start on the next before drawing
+		BLOGD("Hand the frame over to the simulation thread");
+		const SceneSnapshot& snapshot = simulation_->wait();
+		simulation_->request(frameSeconds);
+		applySnapshot(snapshot);
+	}
+	else
+	{
+		BLOGD("Update all drawables");
+		simulateFrame(frameSeconds, sceneSnapshot_);
+		applySnapshot(sceneSnapshot_);
+	}
+
+	BLOGD("Sort and draw all drawables");
+	renderQueue_.clear();
 	for (const auto& drawable : drawables_)
 	{
-		drawable->update(keyboard_->isKeyPressed(VK_SPACE) ? 0.0f : dt);
-		//drawable->update(dt);
-		drawable->draw(*graphics_);
+		drawable->submit(renderQueue_, *graphics_);
+	}
+	renderQueue_.sort();
+	if (!recorders_.empty())
+	{
+		recordDrawables();
+	}
+
+	// Everything the scene needs is ready, so the GPU timer only spans the scene passes
+	graphics_->beginScene();
+	BLOGD("Clear the buffer");
+	graphics_->clearBuffer(clearColor);
+	if (!recorders_.empty())
+	{
+		BLOGD("Execute {} recorded command lists", recorders_.size());
+		for (const auto& recorder : recorders_)
+		{
+			recorder->execute();
+		}
+	}
+	else
+	{
+		drawImmediate();
 	}
 
-	PLOGV << "ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData())";
+	BLOGD("Upscale the scene, ImGui draws on top at native resolution");
+	graphics_->resolveScene();
+
+#if (CAPTURE_FRAMES)
+	// Copied before ImGui draws, so captures hold only the scene and compare from run to run
+	graphics_->captureFrame(*frameCapture_);
+#endif
+
+	BLOGV("ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData())");
 	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 
 #ifdef IMGUI_DOCKING
 	// Update and Render additional Platform Windows
 	if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 	{
-		PLOGV << "ImGui::UpdatePlatformWindows()";
+		BLOGV("ImGui::UpdatePlatformWindows()");
 		ImGui::UpdatePlatformWindows();
-		PLOGV << "ImGui::RenderPlatformWindowsDefault()";
+		BLOGV("ImGui::RenderPlatformWindowsDefault()");
 		ImGui::RenderPlatformWindowsDefault();
 	}
 #endif
 }
 
-void App::populateDrawables()
+void App::simulateFrame(const float dt, SceneSnapshot& snapshot)
+{
+	const unsigned int ticks = timestep_.advance(dt);
+	const float step = timestep_.getStep();
+	for (unsigned int tick = 0; tick < ticks; tick++)
+	{
+		for (const auto& drawable : drawables_)
+		{
+			drawable->tick(step);
+		}
+	}
+
+	const float alpha = timestep_.getAlpha();
+	snapshot.transforms.resize(drawables_.size());
+	for (size_t i = 0; i < drawables_.size(); i++)
+	{
+		snapshot.transforms[i] = drawables_[i]->interpolateTransform(alpha);
+	}
+}
+
+void App::applySnapshot(const SceneSnapshot& snapshot) const noexcept
+{
+	for (size_t i = 0; i < drawables_.size(); i++)
+	{
+		drawables_[i]->setRenderTransform(snapshot.transforms[i]);
+	}
+}
+
+void App::recordDrawables()
+{
+	// Each recorder takes a contiguous range of the sorted queue, so replaying the lists in order keeps the sorted order
+	const std::span<const RenderQueue::Packet> packets = renderQueue_.getPackets();
+	const size_t rangeSize = (packets.size() + recorders_.size() - 1u) / recorders_.size();
+
+	// One slice per packet is mapped up front, and every recorder writes the transforms of its range into its part
+	auto* ring = graphics_->getConstantRing();
+	const auto constants = ring ? ring->mapBlock(static_cast<UINT>(packets.size())) : std::nullopt;
+	try
+	{
+		recordingPool_->run(recorders_.size(), [this, packets, rangeSize, &constants](const size_t index)
+			{
+				const size_t first = std::min(index * rangeSize, packets.size());
+				const size_t last = std::min(first + rangeSize, packets.size());
+
+				auto& recorder = *recorders_[index];
+				recorder.begin(constants
+					? std::optional(constants->part(static_cast<UINT>(first), static_cast<UINT>(last - first)))
+					: std::nullopt);
+				try
+				{
+					Drawable::drawPackets(*graphics_, packets.subspan(first, last - first));
+				}
+				catch (...)
+				{
+					recorder.end();
+					throw;
+				}
+				recorder.end();
+			});
+	}
+	catch (...)
+	{
+		if (ring)
+		{
+			ring->unmapBlock();
+		}
+		throw;
+	}
+	if (ring)
+	{
+		ring->unmapBlock();
+	}
+}
+
+void App::drawImmediate()
+{
+	const std::span<const RenderQueue::Packet> packets = renderQueue_.getPackets();
+
+	// A draw can't read a buffer while it is mapped, so the transforms are all written first and the draws bind
+	// theirs by offset. Without room for the whole frame each draw maps its own slice instead.
+	auto* ring = graphics_->getConstantRing();
+	if (auto constants = ring ? ring->mapBlock(static_cast<UINT>(packets.size())) : std::nullopt)
+	{
+		for (const auto& packet : packets)
+		{
+			const auto transform = TransformConstantBuffer::getTransform(*graphics_, *packet.drawable);
+			static_cast<void>(ConstantRing::upload(*constants, &transform, sizeof(transform)));
+		}
+		ring->unmapBlock();
+		ring->setImmediateBlock(*constants);
+	}
+	Drawable::drawPackets(*graphics_, packets);
+}
+
+void App::renderSoftwareFrame(const ImVec4& clearColor)
+{
+	const auto [targetWidth, targetHeight] = window_->getTargetDimensions();
+	if (targetWidth <= 0 || targetHeight <= 0)
+	{
+		return;
+	}
+	const auto outputWidth = static_cast<unsigned int>(targetWidth);
+	const auto outputHeight = static_cast<unsigned int>(targetHeight);
+	// Rasterize at the same scale as the GPU scene and upscale the same way
+	const unsigned int width = ResolutionScaler::scaleExtent(outputWidth, graphics_->getRenderScale());
+	const unsigned int height = ResolutionScaler::scaleExtent(outputHeight, graphics_->getRenderScale());
+	if (!softwareRasterizer_ || softwareRasterizer_->getWidth() != width || softwareRasterizer_->getHeight() != height)
+	{
+		const unsigned int cores = std::thread::hardware_concurrency();
+		softwareRasterizer_ = std::make_unique<SoftwareRasterizer>(width, height, cores > 1u ? cores - 1u : 0u);
+	}
+
+	const auto* camera = graphics_->getCamera();
+	const auto viewProjection = camera->getView() * camera->getProjection();
+	for (const auto& drawable : drawables_)
+	{
+		drawable->rasterize(*softwareRasterizer_, viewProjection);
+	}
+
+	Surface scene(width, height);
+	const auto toByte = [](const float value) { return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+	softwareRasterizer_->render(scene, Surface::color(toByte(clearColor.w), toByte(clearColor.x), toByte(clearColor.y), toByte(clearColor.z)));
+	Surface frame(outputWidth, outputHeight);
+	resolutionScaler_.upscale(scene, frame);
+
+	const auto& statistics = softwareRasterizer_->getStatistics();
+	const float milliseconds = statistics.setupMilliseconds + statistics.rasterMilliseconds;
+	PLOGI << "Software rendered " << width << "x" << height << " in " << milliseconds << "ms ("
+		<< static_cast<float>(statistics.triangles) / (milliseconds * 1000.0f) << " Mtri/s, "
+		<< static_cast<float>(statistics.pixelsShaded) / (milliseconds * 1000.0f) << " Mpix/s, "
+		<< (softwareRasterizer_->isUsingAvx2() ? "AVX2" : "scalar") << ")";
+
+	const std::filesystem::path directory = "captures";
+	std::filesystem::create_directories(directory);
+	const auto encoded = QoiEncoder::encode(frame);
+	std::ofstream file(directory / "software.qoi", std::ios::binary);
+	file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+}
+
+void App::showCpuUsage() const
+{
+	const auto& sample = cpu_.getSample();
+	// Counts the platform does not keep show as a dash
+	const auto count = [](const std::optional<std::uint64_t>& value)
+		{
+			if (value.has_value())
+			{
+				ImGui::Text("%llu", static_cast<unsigned long long>(*value));
+			}
+			else
+			{
+				ImGui::TextUnformatted("-");
+			}
+		};
+
+	ImGui::Text("CPU %.1f%% of %u cores, %.1f ms over %.0f ms (%u frames)", cpu_.getCpuPercentage(), sample.processors,
+		sample.process.cpuMilliseconds, sample.windowSeconds * 1000.0, sample.frames);
+	if (!ImGui::CollapsingHeader("Threads"))
+	{
+		return;
+	}
+	if (ImGui::BeginTable("Threads", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+	{
+		ImGui::TableSetupColumn("Thread");
+		ImGui::TableSetupColumn("Id");
+		ImGui::TableSetupColumn("CPU %");
+		ImGui::TableSetupColumn("ms");
+		ImGui::TableSetupColumn("Voluntary");
+		ImGui::TableSetupColumn("Involuntary");
+		ImGui::TableSetupColumn("Faults");
+		ImGui::TableSetupColumn("Major");
+		ImGui::TableHeadersRow();
+		const auto row = [&count](const char* name, const std::uint32_t id, const CpuMetric::Usage& usage)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(name);
+				ImGui::TableNextColumn();
+				if (id != 0u)
+				{
+					ImGui::Text("%u", id);
+				}
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f", usage.utilization * 100.0);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", usage.cpuMilliseconds);
+				ImGui::TableNextColumn();
+				count(usage.voluntarySwitches);
+				ImGui::TableNextColumn();
+				count(usage.involuntarySwitches);
+				ImGui::TableNextColumn();
+				count(usage.pageFaults);
+				ImGui::TableNextColumn();
+				count(usage.majorFaults);
+			};
+		row("Process", 0u, sample.process);
+		for (const auto& thread : sample.threads)
+		{
+			row(thread.name.empty() ? "?" : thread.name.c_str(), thread.id, thread);
+		}
+		ImGui::EndTable();
+	}
+}
+
+void App::showMemoryUsage() const
+{
+	const auto& sample = memory_.getSample();
+	ImGui::Text("Heap %.1f MiB, %llu allocations last frame (peak %llu)", static_cast<double>(sample.currentBytes) / (1024.0 * 1024.0),
+		sample.frameAllocations, sample.peakFrameAllocations);
+	if (!ImGui::CollapsingHeader("Memory"))
+	{
+		return;
+	}
+	if (ImGui::BeginTable("Memory", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+	{
+		ImGui::TableSetupColumn("Tag");
+		ImGui::TableSetupColumn("KiB");
+		ImGui::TableSetupColumn("Peak KiB");
+		ImGui::TableSetupColumn("Blocks");
+		ImGui::TableSetupColumn("Allocs/s");
+		ImGui::TableSetupColumn("KiB/s");
+		ImGui::TableHeadersRow();
+		for (const auto& tag : sample.tags)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(tag.name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", static_cast<double>(tag.currentBytes) / 1024.0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", static_cast<double>(tag.peakBytes) / 1024.0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", tag.liveAllocations);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.0f", tag.allocationsPerSecond);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", tag.bytesPerSecond / 1024.0);
+		}
+		ImGui::EndTable();
+	}
+}
+
+int App::runRegression()
+{
+	PLOGI << "Running the regression suite into " << regression_->directory.string() << " (seed " << regression_->seed << ", "
+		<< drawables_.size() << " drawables, " << regression_->frameCount << " frames" << (regression_->pipelined ? ", pipelined" : "") << ")";
+
+	// Single threaded scalar rendering, so neither the machine's core count nor its instruction set changes
+	// the images or the timings
+	RegressionSuite suite(*regression_);
+	SoftwareRasterizer reference(WIDTH, HEIGHT, 0u, false);
+	Surface frame(WIDTH, HEIGHT);
+	const auto* camera = graphics_->getCamera();
+	const auto viewProjection = camera->getView() * camera->getProjection();
+
+	// Every frame steps the same fixed time and renders the latest tick, with or without the pipeline. A replay
+	// runs the recorded frame times through the fixed timestep like the recorded session did instead.
+	const auto simulate = [this](const float dt, SceneSnapshot& snapshot)
+		{
+			if (replay_)
+			{
+				simulateFrame(dt, snapshot);
+				return;
+			}
+			snapshot.transforms.resize(drawables_.size());
+			for (size_t i = 0; i < drawables_.size(); i++)
+			{
+				drawables_[i]->tick(dt);
+				snapshot.transforms[i] = drawables_[i]->interpolateTransform(1.0f);
+			}
+		};
+	// Feed the recorded input that reached the simulated frame to the handlers and return the time it simulates,
+	// paused like renderFrame()
+	const auto frameStep = [this](const unsigned int frame)
+		{
+			if (!replay_)
+			{
+				return regression_->frameStep;
+			}
+			const float seconds = replay_->apply(frame, *mouse_, *keyboard_);
+			mouse_->collectFrame();
+			return keyboard_->isKeyPressed(VK_SPACE) ? 0.0f : seconds;
+		};
+	std::unique_ptr<SimulationThread> pipeline;
+	if (regression_->pipelined && regression_->frameCount > 0u)
+	{
+		pipeline = std::make_unique<SimulationThread>(simulate);
+		pipeline->request(frameStep(0u));
+	}
+
+	const auto runStart = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < regression_->frameCount; i++)
+	{
+		float updateMilliseconds;
+		if (pipeline)
+		{
+			const SceneSnapshot& snapshot = pipeline->wait();
+			updateMilliseconds = snapshot.updateMilliseconds;
+			if (i + 1u < regression_->frameCount)
+			{
+				pipeline->request(frameStep(i + 1u));
+			}
+			applySnapshot(snapshot);
+		}
+		else
+		{
+			const float dt = frameStep(i);
+			const auto start = std::chrono::steady_clock::now();
+			simulate(dt, sceneSnapshot_);
+			updateMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			applySnapshot(sceneSnapshot_);
+		}
+
+		for (const auto& drawable : drawables_)
+		{
+			drawable->rasterize(reference, viewProjection);
+		}
+		reference.render(frame, Surface::color(255u, 18u, 0u, 31u));
+		suite.addFrame(frame, reference.getStatistics(), updateMilliseconds);
+	}
+	const std::chrono::duration<float, std::milli> wall = std::chrono::steady_clock::now() - runStart;
+	pipeline.reset();
+
+	PLOGI << "Rendered " << regression_->frameCount << " frames " << (regression_->pipelined ? "pipelined" : "serially") << " in "
+		<< wall.count() << "ms";
+	const bool passed = suite.finish(wall.count());
+	if (passed)
+	{
+		PLOGI << "Regression suite passed";
+	}
+	else
+	{
+		PLOGE << "Regression suite failed, see " << (regression_->directory / "report.json").string();
+	}
+	return passed ? 0 : 1;
+}
+
+void App::populateDrawables(const unsigned int rng_seed, const size_t count)
 {
-	const auto rng_seed = std::random_device{}();
 	PLOGI << "mt19937 rng seed: " << rng_seed;
 
 #define PROTOTYPE_DRAWABLE false // if set to true, don't use the factory and draw a single drawable
 #if (PROTOTYPE_DRAWABLE)
 	PLOGD << "Draw a Prototype Drawable";
-	std::mt19937 rng_{ rng_seed };
-	std::uniform_real_distribution<float> distanceDistribution_{ 0.0f, 0.0f };
-	//std::uniform_real_distribution<float> sphericalCoordinatePositionDistribution_{ 0.0f, PI * 2.0f };
-	std::uniform_real_distribution<float> sphericalCoordinatePositionDistribution_{ 0.0f, 0.0f };
-	std::uniform_real_distribution<float> rotationOfDrawableDistribution_{ 0.0f, PI * 0.5f };
-	//std::uniform_real_distribution<float> rotationOfDrawableDistribution_{ 0.0f, 0.0f };
-	//std::uniform_real_distribution<float> sphericalCoordinateMovementOfDrawableDistribution_{ 0.0f, PI * 0.08f };
-	std::uniform_real_distribution<float> sphericalCoordinateMovementOfDrawableDistribution_{ 0.0f, 0.0f };
-	drawables_.emplace_back(
-		std::make_unique<SkinnedBox>(
-			*graphics_, rng_, distanceDistribution_, sphericalCoordinatePositionDistribution_, rotationOfDrawableDistribution_,
-			sphericalCoordinateMovementOfDrawableDistribution_
-		));
+	ScenePopulation population(rng_seed, {
+		.sphericalCoordinatePosition{ 0.0f, 0.0f },
+		//.sphericalCoordinatePosition{ 0.0f, PI * 2.0f },
+		.rotationOfDrawable{ 0.0f, PI * 0.5f },
+		//.rotationOfDrawable{ 0.0f, 0.0f },
+		.sphericalCoordinateMovementOfDrawable{ 0.0f, 0.0f },
+		//.sphericalCoordinateMovementOfDrawable{ 0.0f, PI * 0.08f },
+		.distance{ 0.0f, 0.0f }
+	});
+	drawables_.emplace_back(std::make_unique<SkinnedBox>(*graphics_, population.next(ScenePopulation::Kind::SkinnedBox)));
 #else
+	// Builds the drawables out of the scene the seed stands for, which the headless replay rebuilds without a device
 	class DrawableFactory
 	{
 	public:
 		DrawableFactory(Graphics& graphics, const unsigned int rng_seed)
 			:
 			graphics_(graphics),
-			rng_(rng_seed)
+			population_(rng_seed)
 		{
 		}
 
 		int count = 0;
 		std::unique_ptr<Drawable> operator()()
 		{
-			switch (drawableTypeDistribution_(rng_))
+			const ScenePopulation::Spawn spawn = population_.next();
+			switch (spawn.kind)
 			{
-			case 0:
+			case ScenePopulation::Kind::Pyramid:
 #ifdef LOG_GRAPHICS_CALLS
 				LOGV << "Drawable <Pyramid>     #" << ++count;
 #endif
-				return std::make_unique<Pyramid>(
-					graphics_, rng_, distanceDistribution_, sphericalCoordinatePositionDistribution_, rotationOfDrawableDistribution_,
-					sphericalCoordinateMovementOfDrawableDistribution_
-				);
-			case 1:
+				return std::make_unique<Pyramid>(graphics_, spawn);
+			case ScenePopulation::Kind::Box:
 #ifdef LOG_GRAPHICS_CALLS
 				LOGV << "Drawable <Box>         #" << ++count;
 #endif
-				return std::make_unique<Box>(
-					graphics_, rng_, distanceDistribution_, sphericalCoordinatePositionDistribution_, rotationOfDrawableDistribution_,
-					sphericalCoordinateMovementOfDrawableDistribution_, zAxisDistortionDistribution_
-				);
-			case 2:
+				return std::make_unique<Box>(graphics_, spawn);
+			case ScenePopulation::Kind::Melon:
 #ifdef LOG_GRAPHICS_CALLS
 				LOGV << "Drawable <Melon>       #" << ++count;
 #endif
-				return std::make_unique<Melon>(
-					graphics_, rng_, distanceDistribution_, sphericalCoordinatePositionDistribution_, rotationOfDrawableDistribution_,
-					sphericalCoordinateMovementOfDrawableDistribution_, latitudeDistribution_, longitudeDistribution_
-				);
-			case 3:
+				return std::make_unique<Melon>(graphics_, spawn);
+			case ScenePopulation::Kind::Sheet:
 #ifdef LOG_GRAPHICS_CALLS
 				LOGV << "Drawable <Sheet>       #" << ++count;
 #endif
-				return std::make_unique<Sheet>(
-					graphics_, rng_, distanceDistribution_, sphericalCoordinatePositionDistribution_, rotationOfDrawableDistribution_, sphericalCoordinateMovementOfDrawableDistribution_
-				);
-			case 4:
+				return std::make_unique<Sheet>(graphics_, spawn);
+			case ScenePopulation::Kind::SkinnedBox:
 #ifdef LOG_GRAPHICS_CALLS
 				LOGV << "Drawable <SkinnedBox> #" << ++count;
 #endif
-				return std::make_unique<SkinnedBox>(
-					graphics_, rng_, distanceDistribution_, sphericalCoordinatePositionDistribution_, rotationOfDrawableDistribution_,
-					sphericalCoordinateMovementOfDrawableDistribution_
-				);
+				return std::make_unique<SkinnedBox>(graphics_, spawn);
 			default:
 				assert(false && "bad drawable type in factory");
 				return {};
 			}
-		}	private:
-			Graphics& graphics_;
-			std::mt19937 rng_;
-			std::uniform_real_distribution<float> sphericalCoordinatePositionDistribution_{ 0.0f, PI * 2.0f };				// adist
-			std::uniform_real_distribution<float> rotationOfDrawableDistribution_{ 0.0f, PI * 0.5f };						// ddist
-			std::uniform_real_distribution<float> sphericalCoordinateMovementOfDrawableDistribution_{ 0.0f, PI * 0.08f };	// odist
-			std::uniform_real_distribution<float> distanceDistribution_{ 6.0f, 20.0f };									// rdist
-			std::uniform_real_distribution<float> zAxisDistortionDistribution_{ 0.4f, 3.0f };								// bdist
-			std::uniform_int_distribution<int> latitudeDistribution_{ 5, 20 };												// latdist
-			std::uniform_int_distribution<int> longitudeDistribution_{ 10, 40 };											// longdist
-			std::uniform_int_distribution<int> drawableTypeDistribution_{ 0, 4 };											// typedist
+		}
+	private:
+		Graphics& graphics_;
+		ScenePopulation population_;
 	};
 
-	drawables_.reserve(NUMBER_OF_DRAWABLES);
+	drawables_.reserve(count);
 
 	PLOGD << "Populating pool of drawables";
-	std::generate_n(std::back_inserter(drawables_), NUMBER_OF_DRAWABLES, DrawableFactory(*graphics_, rng_seed));
+	std::generate_n(std::back_inserter(drawables_), count, DrawableFactory(*graphics_, rng_seed));
 #endif
 }
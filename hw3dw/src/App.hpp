@@ -1,12 +1,24 @@
 #pragma once
 
+#include "CommandRecorder.hpp"
 #include "Drawable.hpp"
+#include "FixedTimestep.hpp"
+#include "FrameCapture.hpp"
+#include "FramePacer.hpp"
+#include "InputRecording.hpp"
+#include "RegressionSuite.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "RenderQueue.hpp"
+#include "ResolutionScaler.hpp"
+#include "SimulationThread.hpp"
 #include "Window.hpp"
 #include "Console.hpp"
 #include "Timer.hpp"
 #include "CpuMetric.hpp"
 #include "FpsMetric.hpp"
 #include "GDIPlusManager.hpp"
+#include "MemoryTracker.hpp"
+#include "WorkerPool.hpp"
 
 class App
 {
@@ -23,7 +35,10 @@ public:
     };
 
     // Lifecycle
-    explicit App(bool allowConsoleLogging);
+    // With regression options the window stays hidden and run() renders the regression suite instead. A recording
+    // path writes the seed, frame times and input of the session there for a later --replay.
+    explicit App(bool allowConsoleLogging, std::optional<RegressionSuite::Options> regression = std::nullopt,
+        const std::filesystem::path& recording = {});
     ~App();
 
     App(const App&) = delete;
@@ -48,7 +63,20 @@ private:
     // Helpers
     static std::optional<unsigned int> processMessages();
     void renderFrame(const ImVec4& clearColor);
-    void populateDrawables();
+    // Advance the simulation by a frame and write the interpolated transforms into the snapshot
+    void simulateFrame(float dt, SceneSnapshot& snapshot);
+    void applySnapshot(const SceneSnapshot& snapshot) const noexcept;
+    // Record the sorted queue into the recorders' command lists, renderFrame() executes them
+    void recordDrawables();
+    // Draw the sorted queue on the immediate context, with every transform written to the constant ring in one map
+    void drawImmediate();
+    void renderSoftwareFrame(const ImVec4& clearColor);
+    // Process CPU use and the per-thread breakdown of the last window
+    void showCpuUsage() const;
+    // Heap use by tag and the allocations of the last frame
+    void showMemoryUsage() const;
+    int runRegression();
+    void populateDrawables(unsigned int seed, size_t count);
 
     // Members
     static HWND s_mainWindow;
@@ -59,10 +87,25 @@ private:
 #if (IS_DEBUG)
     std::unique_ptr<Console> console_;
     FpsMetric fps_{};
-    CpuMetric cpu_{};
 #endif
+    CpuMetric cpu_{};
+    MemoryTracker memory_{};
     Timer timer_;
+    FixedTimestep timestep_;
+    FramePacer framePacer_;
+    ResolutionScaler resolutionScaler_;
     std::unique_ptr<GdiPlusManager> gdiManager_;
     std::vector<std::unique_ptr<Drawable>> drawables_;
+    RenderQueue renderQueue_;
+    SceneSnapshot sceneSnapshot_;
+    // Declared after the drawables, so the thread stops before they go away
+    std::unique_ptr<SimulationThread> simulation_;
+    std::unique_ptr<FrameCapture> frameCapture_;
+    std::unique_ptr<WorkerPool> recordingPool_;
+    std::vector<std::unique_ptr<CommandRecorder>> recorders_;
+    std::unique_ptr<SoftwareRasterizer> softwareRasterizer_;
+    std::optional<RegressionSuite::Options> regression_;
+    std::unique_ptr<InputRecording::Recorder> recorder_;
+    std::unique_ptr<InputRecording::Replay> replay_;
     bool stop_;
 };
@@ -1,10 +1,11 @@
 #pragma once
 #define IMGUI_DOCKING
-#define MAX_FPS 0 // Set to 0 to disable
+#define MAX_FPS 0 // Target frames per second for the frame pacer, 0 leaves the frame rate unlimited
+#define RECORDING_THREADS 2 // Worker threads recording draws on deferred contexts, 0 submits from the main thread
+#define CAPTURE_FRAMES 0 // Set to 1 to write every frame to the captures directory as QOI
+#define TRACK_ALLOCATIONS 1 // Route the global operator new through MemoryTracker so every heap allocation is charged to a tag
+#define SIMULATION_TICK_RATE 60 // Fixed simulation ticks per second, rendering interpolates between them; 0 steps once per frame
+#define MAX_TICKS_PER_FRAME 5 // Catch-up cap, simulation time beyond it is dropped
 
-#if defined(MAX_FPS) && (MAX_FPS > 0)
-// Timer for 1 fps execution
-#include <iostream>
-#include <chrono>
-#include <thread>
-#endif
+#define PIPELINED_SIMULATION 1 // Simulate the next frame on its own thread while the current one renders, adds one frame of latency
+#define RESOLUTION_TARGET_MILLISECONDS 14 // GPU frame time the scene render scale adjusts to hold, 0 always renders at full resolution
@@ -0,0 +1,310 @@
+#include "AsyncAppender.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "CpuMetric.hpp"
+#include "MemoryTracker.hpp"
+
+namespace
+{
+	// Records handed to the sinks in one write
+	constexpr size_t maxBatch = 256u;
+}
+
+AsyncAppender::AsyncAppender(const Settings settings)
+	:
+	capacity_(std::bit_ceil(std::max<size_t>(settings.blocks, 16u))),
+	mask_(capacity_ - 1u),
+	// One record may take up to a quarter of the queue, longer messages are cut
+	maxMessageLength_((capacity_ / 4u * blockSize - sizeof(Header)) / sizeof(plog::util::nchar)),
+	overflow_(settings.overflow),
+	neverDrop_(settings.neverDrop),
+	interval_(settings.interval),
+	blocks_(MemoryTracker::tagged(MemoryTag::Logging, [this] { return std::make_unique<Block[]>(capacity_); })),
+	sequences_(MemoryTracker::tagged(MemoryTag::Logging, [this] { return std::make_unique<std::atomic<size_t>[]>(capacity_); }))
+{
+	MemoryTracker::Scope scope(MemoryTag::Logging);
+	for (size_t i = 0; i < capacity_; i++)
+	{
+		sequences_[i].store(i, std::memory_order_relaxed);
+	}
+	batch_.reserve(maxBatch + 1u);
+	running_.store(true, std::memory_order_release);
+	thread_ = std::thread([this] { run(); });
+}
+
+AsyncAppender::~AsyncAppender()
+{
+	stop_.store(true, std::memory_order_release);
+	wake();
+	thread_.join();
+}
+
+void AsyncAppender::write(const plog::Record& record)
+{
+	const plog::util::nchar* message = record.getMessage();
+	const auto messageLength = static_cast<std::uint32_t>(std::min(std::char_traits<plog::util::nchar>::length(message), maxMessageLength_));
+	const size_t count = blockCount(messageLength);
+	const plog::Severity severity = record.getSeverity();
+
+	size_t position;
+	if (!reserve(count, severity, position))
+	{
+		dropped_.fetch_add(1u, std::memory_order_relaxed);
+		return;
+	}
+
+	Header header;
+	header.severity = severity;
+	header.tid = record.getTid();
+	header.time = record.getTime().time;
+	header.line = static_cast<std::uint32_t>(record.getLine());
+	header.messageLength = messageLength;
+	header.milliseconds = record.getTime().millitm;
+	const char* func = record.getFunc();
+	const size_t funcLength = std::min(std::strlen(func), funcCapacity - 1u);
+	std::memcpy(header.func, func, funcLength);
+	header.func[funcLength] = '\0';
+
+	copyIn(position, 0u, &header, sizeof(header));
+	copyIn(position, sizeof(Header), message, messageLength * sizeof(plog::util::nchar));
+	sequences_[position & mask_].store(position + 1u, std::memory_order_release);
+
+	if (severity <= neverDrop_ || position + count - dequeued_.load(std::memory_order_relaxed) > capacity_ / 2u)
+	{
+		wake();
+	}
+}
+
+void AsyncAppender::addSink(Sink& sink)
+{
+	std::lock_guard lock(sinksMutex_);
+	sinks_.push_back(&sink);
+}
+
+void AsyncAppender::removeSink(Sink& sink)
+{
+	std::lock_guard lock(sinksMutex_);
+	std::erase(sinks_, &sink);
+}
+
+plog::Severity AsyncAppender::getMaxSinkSeverity()
+{
+	std::lock_guard lock(sinksMutex_);
+	plog::Severity severity = plog::none;
+	for (const Sink* sink : sinks_)
+	{
+		severity = std::max(severity, sink->getMaxSeverity());
+	}
+	return severity;
+}
+
+bool AsyncAppender::flush(const std::chrono::milliseconds timeout) noexcept
+{
+	if (std::this_thread::get_id() == thread_.get_id() || !running_.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+	const size_t target = enqueued_.load(std::memory_order_acquire);
+	wake();
+	std::unique_lock lock(flushMutex_);
+	return flushed_.wait_for(lock, timeout, [this, target] { return dequeued_.load(std::memory_order_acquire) >= target; });
+}
+
+AsyncAppender::Statistics AsyncAppender::getStatistics() const noexcept
+{
+	return {
+		.written = written_.load(std::memory_order_relaxed),
+		.dropped = dropped_.load(std::memory_order_relaxed),
+		.waited = waited_.load(std::memory_order_relaxed),
+		.batches = batches_.load(std::memory_order_relaxed),
+		.peakBlocks = peakBlocks_.load(std::memory_order_relaxed)
+	};
+}
+
+size_t AsyncAppender::blockCount(const size_t messageLength) noexcept
+{
+	return (sizeof(Header) + messageLength * sizeof(plog::util::nchar) + blockSize - 1u) / blockSize;
+}
+
+bool AsyncAppender::reserve(const size_t count, const plog::Severity severity, size_t& position) noexcept
+{
+	const bool mayDrop = overflow_ == OverflowPolicy::DROP && severity > neverDrop_;
+	bool waited = false;
+	position = enqueued_.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		// Blocks are freed in order, so the last one being free means the whole range is
+		const size_t last = position + count - 1u;
+		const size_t sequence = sequences_[last & mask_].load(std::memory_order_acquire);
+		const auto difference = static_cast<std::ptrdiff_t>(sequence - last);
+		if (difference == 0)
+		{
+			if (enqueued_.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+		else if (difference < 0)
+		{
+			// Full; nobody is left to make room once the logging thread is gone
+			if (mayDrop || !running_.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+			if (!waited)
+			{
+				waited = true;
+				waited_.fetch_add(1u, std::memory_order_relaxed);
+			}
+			wake();
+			std::this_thread::yield();
+			position = enqueued_.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			position = enqueued_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void AsyncAppender::copyIn(const size_t position, const size_t offset, const void* source, const size_t size) noexcept
+{
+	const size_t ringBytes = capacity_ * blockSize;
+	const size_t start = ((position & mask_) * blockSize + offset) % ringBytes;
+	const size_t first = std::min(size, ringBytes - start);
+	auto* bytes = reinterpret_cast<std::byte*>(blocks_.get());
+	std::memcpy(bytes + start, source, first);
+	std::memcpy(bytes, static_cast<const std::byte*>(source) + first, size - first);
+}
+
+void AsyncAppender::copyOut(const size_t position, const size_t offset, void* destination, const size_t size) const noexcept
+{
+	const size_t ringBytes = capacity_ * blockSize;
+	const size_t start = ((position & mask_) * blockSize + offset) % ringBytes;
+	const size_t first = std::min(size, ringBytes - start);
+	const auto* bytes = reinterpret_cast<const std::byte*>(blocks_.get());
+	std::memcpy(destination, bytes + start, first);
+	std::memcpy(static_cast<std::byte*>(destination) + first, bytes, size - first);
+}
+
+void AsyncAppender::wake() noexcept
+{
+	// A wake landing between the logging thread's check and its wait is picked up an interval later
+	if (!wakeRequested_.exchange(true, std::memory_order_acq_rel))
+	{
+		wakeup_.notify_one();
+	}
+}
+
+void AsyncAppender::run() noexcept
+{
+	CpuMetric::nameCurrentThread("Logging");
+	// The sinks format and write on this thread
+	MemoryTracker::Scope scope(MemoryTag::Logging);
+	for (;;)
+	{
+		{
+			std::unique_lock lock(wakeMutex_);
+			wakeup_.wait_for(lock, interval_, [this] { return wakeRequested_.load(std::memory_order_acquire); });
+		}
+		wakeRequested_.store(false, std::memory_order_release);
+		const bool stopping = stop_.load(std::memory_order_acquire);
+		while (drain())
+		{
+		}
+		if (stopping)
+		{
+			break;
+		}
+	}
+	running_.store(false, std::memory_order_release);
+	// Let flush() callers see the last records went out
+	{
+		std::lock_guard lock(flushMutex_);
+	}
+	flushed_.notify_all();
+}
+
+bool AsyncAppender::drain() noexcept
+{
+	const size_t start = dequeued_.load(std::memory_order_relaxed);
+	const size_t queued = enqueued_.load(std::memory_order_relaxed) - start;
+	if (queued > peakBlocks_.load(std::memory_order_relaxed))
+	{
+		peakBlocks_.store(queued, std::memory_order_relaxed);
+	}
+
+	batch_.clear();
+	size_t position = start;
+	const auto* bytes = reinterpret_cast<const std::byte*>(blocks_.get());
+	while (batch_.size() < maxBatch && sequences_[position & mask_].load(std::memory_order_acquire) == position + 1u)
+	{
+		Header header;
+		copyOut(position, 0u, &header, sizeof(header));
+		const size_t count = blockCount(header.messageLength);
+		const plog::util::nchar* message;
+		const bool wraps = (position & mask_) + count > capacity_;
+		if (!wraps)
+		{
+			message = reinterpret_cast<const plog::util::nchar*>(bytes + (position & mask_) * blockSize + sizeof(Header));
+		}
+		else
+		{
+			// Only the one record that runs past the end of the array needs copying out
+			wrapped_.resize(header.messageLength);
+			copyOut(position, sizeof(Header), wrapped_.data(), header.messageLength * sizeof(plog::util::nchar));
+			message = wrapped_.data();
+		}
+		// func lives in the queue too, so the entry points at the copy in the block rather than the local header
+		const auto* func = reinterpret_cast<const char*>(bytes + (position & mask_) * blockSize + offsetof(Header, func));
+		batch_.push_back({ header.severity, header.tid, header.time, header.milliseconds, header.line, func, { message, header.messageLength } });
+		position += count;
+		if (wraps)
+		{
+			break;
+		}
+	}
+	if (batch_.empty())
+	{
+		return false;
+	}
+
+	const unsigned long long dropped = dropped_.load(std::memory_order_relaxed);
+	const size_t records = batch_.size();
+	if (dropped != droppedReported_)
+	{
+		const std::string text = std::to_string(dropped - droppedReported_) + " log records dropped, the queue was full";
+		droppedMessage_.assign(text.begin(), text.end());
+		const auto now = std::chrono::system_clock::now();
+		batch_.push_back({ plog::warning, 0u, std::chrono::system_clock::to_time_t(now),
+			static_cast<unsigned short>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000),
+			0u, "AsyncAppender", droppedMessage_ });
+		droppedReported_ = dropped;
+	}
+	writeBatch();
+
+	for (size_t freed = start; freed != position; freed++)
+	{
+		sequences_[freed & mask_].store(freed + capacity_, std::memory_order_release);
+	}
+	dequeued_.store(position, std::memory_order_release);
+	written_.fetch_add(records, std::memory_order_relaxed);
+	batches_.fetch_add(1u, std::memory_order_relaxed);
+	{
+		std::lock_guard lock(flushMutex_);
+	}
+	flushed_.notify_all();
+	return true;
+}
+
+void AsyncAppender::writeBatch() noexcept
+{
+	std::lock_guard lock(sinksMutex_);
+	for (Sink* sink : sinks_)
+	{
+		sink->write(batch_);
+	}
+}
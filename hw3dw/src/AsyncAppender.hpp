@@ -0,0 +1,190 @@
+#pragma once
+#include <3rdParty/plog/Log.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// plog appender that takes the console and debug output writes off the threads that log. write() copies the
+// record into a bounded lock-free multi producer queue and returns; a logging thread wakes every interval (or at
+// once for warnings and worse, or when the queue fills up) and hands whatever collected to the sinks in one batch.
+//
+// The queue is an array of 128 byte blocks with a sequence number each. A producer claims the blocks for its
+// record with a compare and swap on the write position, which only succeeds when the last of them has been freed,
+// copies the record in and publishes it through the first block's sequence. The logging thread consumes records
+// in order and frees their blocks by advancing their sequences a lap. Time, thread id and function are taken from
+// the record by write(), on the thread that logs, so the output matches what the synchronous appenders wrote.
+class AsyncAppender : public plog::IAppender
+{
+public:
+	enum class OverflowPolicy : std::uint8_t
+	{
+		// Drop the record and count it, the thread that logs never waits
+		DROP,
+		// Wait for the logging thread to make room
+		BLOCK
+	};
+
+	struct Settings
+	{
+		// Queue size in 128 byte blocks, a power of two. A message up to 24 characters takes one block
+		size_t blocks = 4096u;
+		OverflowPolicy overflow = OverflowPolicy::DROP;
+		// Records this severe or worse wait instead of being dropped and wake the logging thread at once
+		plog::Severity neverDrop = plog::warning;
+		// How long records collect before the logging thread writes them
+		std::chrono::milliseconds interval{ 5 };
+	};
+
+	// A record as the sinks see it. The strings point into the queue and live until write() returns.
+	struct Entry
+	{
+		plog::Severity severity;
+		unsigned int tid;
+		std::time_t time;
+		unsigned short milliseconds;
+		size_t line;
+		const char* func;
+		std::basic_string_view<plog::util::nchar> message;
+	};
+
+	// Destination for the records. Sinks run on the logging thread only and must not log themselves.
+	class Sink
+	{
+	public:
+		explicit Sink(const plog::Severity maxSeverity) noexcept
+			:
+			maxSeverity_(maxSeverity)
+		{}
+		virtual ~Sink() = default;
+		Sink(const Sink&) = delete;
+		Sink& operator=(const Sink&) = delete;
+		Sink(const Sink&&) = delete;
+		Sink& operator=(const Sink&&) = delete;
+
+		virtual void write(std::span<const Entry> entries) noexcept = 0;
+
+		void setMaxSeverity(const plog::Severity maxSeverity) noexcept
+		{
+			maxSeverity_.store(maxSeverity, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] plog::Severity getMaxSeverity() const noexcept
+		{
+			return maxSeverity_.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] bool checkSeverity(const plog::Severity severity) const noexcept
+		{
+			return severity <= getMaxSeverity();
+		}
+	private:
+		std::atomic<plog::Severity> maxSeverity_;
+	};
+
+	struct Statistics
+	{
+		unsigned long long written;
+		unsigned long long dropped;
+		// Records that had to wait for room
+		unsigned long long waited;
+		unsigned long long batches;
+		size_t peakBlocks;
+	};
+
+public:
+	explicit AsyncAppender(Settings settings);
+	// Writes out everything still queued
+	~AsyncAppender() override;
+	AsyncAppender(const AsyncAppender&) = delete;
+	AsyncAppender& operator=(const AsyncAppender&) = delete;
+	AsyncAppender(const AsyncAppender&&) = delete;
+	AsyncAppender& operator=(const AsyncAppender&&) = delete;
+
+	void write(const plog::Record& record) override;
+
+	void addSink(Sink& sink);
+	void removeSink(Sink& sink);
+	// The most verbose severity any sink writes, none without sinks. Records past it need not be formatted.
+	[[nodiscard]] plog::Severity getMaxSinkSeverity();
+
+	// Wait until everything logged before the call reached the sinks, for the crash and exit paths. Gives up
+	// after the timeout, or at once on the logging thread itself, and returns whether it got there.
+	bool flush(std::chrono::milliseconds timeout) noexcept;
+
+	[[nodiscard]] Statistics getStatistics() const noexcept;
+private:
+	static constexpr size_t blockSize = 128u;
+	static constexpr size_t funcCapacity = 48u;
+
+	struct Header
+	{
+		plog::Severity severity;
+		unsigned int tid;
+		std::time_t time;
+		std::uint32_t line;
+		std::uint32_t messageLength;
+		std::uint16_t milliseconds;
+		char func[funcCapacity];
+	};
+
+	struct alignas(blockSize) Block
+	{
+		std::byte bytes[blockSize];
+	};
+
+	[[nodiscard]] static size_t blockCount(size_t messageLength) noexcept;
+	bool reserve(size_t count, plog::Severity severity, size_t& position) noexcept;
+	void copyIn(size_t position, size_t offset, const void* source, size_t size) noexcept;
+	void copyOut(size_t position, size_t offset, void* destination, size_t size) const noexcept;
+	void wake() noexcept;
+	void run() noexcept;
+	// Hand every published record to the sinks and free its blocks, returns whether there were any
+	bool drain() noexcept;
+	void writeBatch() noexcept;
+
+	const size_t capacity_;
+	const size_t mask_;
+	const size_t maxMessageLength_;
+	const OverflowPolicy overflow_;
+	const plog::Severity neverDrop_;
+	const std::chrono::milliseconds interval_;
+	std::unique_ptr<Block[]> blocks_;
+	std::unique_ptr<std::atomic<size_t>[]> sequences_;
+
+	// Producers
+	alignas(64) std::atomic<size_t> enqueued_{ 0u };
+	std::atomic<unsigned long long> dropped_{ 0ull };
+	std::atomic<unsigned long long> waited_{ 0ull };
+
+	// Logging thread
+	alignas(64) std::atomic<size_t> dequeued_{ 0u };
+	std::atomic<unsigned long long> written_{ 0ull };
+	std::atomic<unsigned long long> batches_{ 0ull };
+	std::atomic<size_t> peakBlocks_{ 0u };
+	unsigned long long droppedReported_ = 0ull;
+	std::vector<Entry> batch_;
+	std::basic_string<plog::util::nchar> wrapped_;
+	std::basic_string<plog::util::nchar> droppedMessage_;
+
+	std::mutex sinksMutex_;
+	std::vector<Sink*> sinks_;
+
+	std::atomic<bool> wakeRequested_{ false };
+	std::atomic<bool> stop_{ false };
+	std::atomic<bool> running_{ false };
+	std::mutex wakeMutex_;
+	std::condition_variable wakeup_;
+	std::mutex flushMutex_;
+	std::condition_variable flushed_;
+	std::thread thread_;
+};
@@ -0,0 +1,61 @@
+#include "AtlasTexture.hpp"
+
+#include <chrono>
+#include <memory>
+
+#include "Logging.hpp"
+
+// Images referenced by the textured drawables (Sheet, SkinnedBox)
+static constexpr const wchar_t* atlasSources[] = {
+	L"kappa50.png",
+	L"cube.png",
+};
+
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> AtlasTexture::sharedView_;
+
+AtlasTexture::AtlasTexture(Graphics& graphics)
+{
+	if (!sharedView_)
+	{
+		createView(graphics, getAtlas().getPage());
+		sharedView_ = textureView_;
+	}
+	else
+	{
+		textureView_ = sharedView_;
+	}
+}
+
+const TextureAtlas& AtlasTexture::getAtlas()
+{
+	static std::unique_ptr<TextureAtlas> atlas;
+	if (!atlas)
+	{
+		// Built aside and only kept once packed, so an image that fails to load leaves nothing half added
+		const auto start = std::chrono::steady_clock::now();
+		auto built = std::make_unique<TextureAtlas>();
+		for (const auto* source : atlasSources)
+		{
+			built->add(source, Surface::fromFile(source));
+		}
+		built->pack();
+		const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		PLOGI << "Packed " << std::size(atlasSources) << " textures into a "
+			<< built->getPage().getWidth() << "x" << built->getPage().getHeight() << " atlas ("
+			<< built->getOccupancy() * 100.0f << "% occupied) in " << elapsed.count() << "ms";
+		atlas = std::move(built);
+	}
+	return *atlas;
+}
+
+const SampledTexture& AtlasTexture::getSampledAtlas()
+{
+	static const SampledTexture sampled(getAtlas().getPage());
+	return sampled;
+}
+
+void AtlasTexture::release() noexcept
+{
+	sharedView_.Reset();
+}
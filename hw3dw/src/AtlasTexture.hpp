@@ -0,0 +1,25 @@
+#pragma once
+#include "SampledTexture.hpp"
+#include "Texture.hpp"
+#include "TextureAtlas.hpp"
+
+// Texture bind shared by every textured drawable type. All of their images are packed into one atlas page
+// on first use, so switching between these types no longer switches the shader resource view.
+class AtlasTexture : public Texture
+{
+public:
+	explicit AtlasTexture(Graphics& graphics);
+	~AtlasTexture() override = default;
+	AtlasTexture(const AtlasTexture&) = delete;
+	AtlasTexture& operator=(const AtlasTexture&) = delete;
+	AtlasTexture(const AtlasTexture&&) = delete;
+	AtlasTexture& operator=(const AtlasTexture&&) = delete;
+
+	static const TextureAtlas& getAtlas();
+	// The atlas page as a tiled mip chain for the software rasterizer, built on first use
+	static const SampledTexture& getSampledAtlas();
+	// Drops the shared view; call before the device it was created on is destroyed
+	static void release() noexcept;
+private:
+	static Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> sharedView_;
+};
@@ -0,0 +1,249 @@
+#include "BinaryLog.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#ifdef _WIN32
+#include "AtumWindows.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	std::uint32_t currentThread() noexcept
+	{
+		// The id plog puts in its records, looked up once per thread
+		thread_local const std::uint32_t thread = static_cast<std::uint32_t>(plog::util::gettid());
+		return thread;
+	}
+}
+
+BinaryLog::BinaryLog(const std::filesystem::path& path, const size_t capacityBytes, const plog::Severity maxSeverity)
+	:
+	generation_(nextGeneration_.fetch_add(1u, std::memory_order_relaxed)),
+	maxSeverity_(maxSeverity),
+	capacity_(BinaryLogFormat::align(std::max(capacityBytes, sizeof(BinaryLogFormat::FileHeader) + 4096u)))
+{
+	map(path);
+
+	BinaryLogFormat::FileHeader header = {};
+	std::copy(std::begin(BinaryLogFormat::magic), std::end(BinaryLogFormat::magic), header.magic);
+	header.version = BinaryLogFormat::version;
+	header.headerSize = sizeof(BinaryLogFormat::FileHeader);
+	header.tickNumerator = clock::period::num;
+	header.tickDenominator = clock::period::den;
+	header.openTicks = static_cast<std::uint64_t>(clock::now().time_since_epoch().count());
+	header.openUnixNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	std::memcpy(view_, &header, sizeof(header));
+	used_.store(sizeof(header), std::memory_order_relaxed);
+}
+
+BinaryLog::~BinaryLog()
+{
+	close();
+}
+
+void BinaryLog::set(BinaryLog* log) noexcept
+{
+	instance_.store(log, std::memory_order_release);
+}
+
+void BinaryLog::setMaxSeverity(const plog::Severity maxSeverity) noexcept
+{
+	maxSeverity_.store(maxSeverity, std::memory_order_relaxed);
+}
+
+void BinaryLog::close() noexcept
+{
+	if (!view_)
+	{
+		return;
+	}
+	if (get() == this)
+	{
+		set(nullptr);
+	}
+
+	// A reservation that ran past the end moved the position anyway
+	const size_t used = std::min(used_.exchange(capacity_, std::memory_order_acq_rel), capacity_);
+	const std::uint64_t usedBytes = used - sizeof(BinaryLogFormat::FileHeader);
+	std::memcpy(view_ + offsetof(BinaryLogFormat::FileHeader, usedBytes), &usedBytes, sizeof(usedBytes));
+	unmap(used);
+}
+
+BinaryLog::Statistics BinaryLog::getStatistics() const noexcept
+{
+	return {
+		.usedBytes = std::min(used_.load(std::memory_order_relaxed), capacity_),
+		.capacityBytes = capacity_,
+		.sites = sites_.load(std::memory_order_relaxed),
+		.dropped = dropped_.load(std::memory_order_relaxed)
+	};
+}
+
+std::byte* BinaryLog::reserve(const size_t size) noexcept
+{
+	const size_t offset = used_.fetch_add(size, std::memory_order_relaxed);
+	if (offset + size > capacity_)
+	{
+		dropped_.fetch_add(1u, std::memory_order_relaxed);
+		return nullptr;
+	}
+	std::byte* record = view_ + offset;
+	const auto length = static_cast<std::uint32_t>(size);
+	std::memcpy(record, &length, sizeof(length));
+	return record;
+}
+
+void BinaryLog::commit(std::byte* record, const std::uint32_t tag) noexcept
+{
+	auto* header = reinterpret_cast<BinaryLogFormat::RecordHeader*>(record);
+	header->ticks = static_cast<std::uint64_t>(clock::now().time_since_epoch().count());
+	header->thread = currentThread();
+	header->reserved = 0u;
+	std::atomic_ref(header->tag).store(tag, std::memory_order_release);
+}
+
+std::uint64_t BinaryLog::define(Site& site, const std::span<const BinaryLogFormat::ArgType> types) noexcept
+{
+	// First use of a site, so a lock is fine; it keeps two threads from both defining it
+	std::lock_guard lock(defineMutex_);
+	const std::uint64_t key = site.key.load(std::memory_order_acquire);
+	if (key >> 32u == generation_)
+	{
+		return key;
+	}
+
+	const std::string_view format = site.format;
+	const std::string_view func = site.func;
+	const BinaryLogFormat::DefinitionHeader definition = {
+		.severity = static_cast<std::uint8_t>(site.severity),
+		.argumentCount = static_cast<std::uint8_t>(types.size()),
+		.reserved = 0u,
+		.line = site.line,
+		.formatLength = static_cast<std::uint32_t>(format.size()),
+		.funcLength = static_cast<std::uint32_t>(func.size())
+	};
+	const size_t size = sizeof(BinaryLogFormat::RecordHeader) + sizeof(definition) + types.size() + format.size() + func.size();
+	std::byte* record = reserve(BinaryLogFormat::align(size));
+	if (!record)
+	{
+		return 0u;
+	}
+	std::byte* out = record + sizeof(BinaryLogFormat::RecordHeader);
+	std::memcpy(out, &definition, sizeof(definition));
+	out += sizeof(definition);
+	std::memcpy(out, types.data(), types.size());
+	out += types.size();
+	std::memcpy(out, format.data(), format.size());
+	out += format.size();
+	std::memcpy(out, func.data(), func.size());
+
+	const std::uint32_t id = sites_.fetch_add(1u, std::memory_order_relaxed) + 1u;
+	commit(record, BinaryLogFormat::definitionTag | id);
+	const std::uint64_t defined = static_cast<std::uint64_t>(generation_) << 32u | id;
+	site.key.store(defined, std::memory_order_release);
+	return defined;
+}
+
+#ifdef _WIN32
+void BinaryLog::map(const std::filesystem::path& path)
+{
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw Exception(__LINE__, __FILE__, "Creating " + path.string() + " failed with error " + std::to_string(GetLastError()) + ".");
+	}
+	LARGE_INTEGER size;
+	size.QuadPart = static_cast<LONGLONG>(capacity_);
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size.HighPart), size.LowPart, nullptr);
+	void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0u, 0u, capacity_) : nullptr;
+	if (!view)
+	{
+		const DWORD error = GetLastError();
+		if (mapping)
+		{
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		throw Exception(__LINE__, __FILE__, "Mapping " + std::to_string(capacity_) + " bytes of " + path.string() + " failed with error " + std::to_string(error) + ".");
+	}
+	file_ = file;
+	mapping_ = mapping;
+	view_ = static_cast<std::byte*>(view);
+}
+
+void BinaryLog::unmap(const size_t keepBytes) noexcept
+{
+	UnmapViewOfFile(view_);
+	CloseHandle(mapping_);
+	LARGE_INTEGER size;
+	size.QuadPart = static_cast<LONGLONG>(keepBytes);
+	SetFilePointerEx(file_, size, nullptr, FILE_BEGIN);
+	SetEndOfFile(file_);
+	CloseHandle(file_);
+	view_ = nullptr;
+	mapping_ = nullptr;
+	file_ = nullptr;
+}
+#else
+void BinaryLog::map(const std::filesystem::path& path)
+{
+	const int descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0)
+	{
+		throw Exception(__LINE__, __FILE__, "Creating " + path.string() + " failed with error " + std::to_string(errno) + ".");
+	}
+	void* view = ftruncate(descriptor, static_cast<off_t>(capacity_)) == 0
+		? mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0)
+		: MAP_FAILED;
+	if (view == MAP_FAILED)
+	{
+		const int error = errno;
+		::close(descriptor);
+		throw Exception(__LINE__, __FILE__, "Mapping " + std::to_string(capacity_) + " bytes of " + path.string() + " failed with error " + std::to_string(error) + ".");
+	}
+	descriptor_ = descriptor;
+	view_ = static_cast<std::byte*>(view);
+}
+
+void BinaryLog::unmap(const size_t keepBytes) noexcept
+{
+	munmap(view_, capacity_);
+	[[maybe_unused]] const int result = ftruncate(descriptor_, static_cast<off_t>(keepBytes));
+	::close(descriptor_);
+	view_ = nullptr;
+	descriptor_ = -1;
+}
+#endif
+
+// binary log exception stuff
+BinaryLog::Exception::Exception(const int line, const char* file, std::string note) noexcept
+	:
+	AtumException(line, file),
+	note_(std::move(note))
+{}
+
+const char* BinaryLog::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AtumException::what() << "\n"
+		<< "[Note] " << getNote();
+	whatBuffer_ = oss.str();
+	return whatBuffer_.c_str();
+}
+
+const char* BinaryLog::Exception::getType() const noexcept
+{
+	return "Atum Binary Log Exception";
+}
+
+const std::string& BinaryLog::Exception::getNote() const noexcept
+{
+	return note_;
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <3rdParty/plog/Log.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+#include "AtumException.hpp"
+#include "BinaryLogFormat.hpp"
+
+// Log that leaves the formatting for later. A BLOG site writes its site id, a timestamp, the thread and its raw
+// argument bytes into a memory mapped file, and the hw3dlog tool turns the file back into the text plog would have
+// written. The format string, function, line and argument types of a site go into the file once, the first time
+// the site logs. This is for the verbose logging of performance investigations, where building the text costs
+// more than whatever is being measured.
+//
+// The file is sized up front. A thread claims room for its record with a single add on the write position and
+// fills it in without any lock, so threads only meet on that one counter. Once the file is full records are
+// dropped and counted. The pages belong to the file rather than the process, so whatever was written is there
+// even when the process dies; close() trims the file to what was used.
+class BinaryLog
+{
+public:
+	class Exception : public AtumException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* getType() const noexcept override;
+		const std::string& getNote() const noexcept;
+	private:
+		std::string note_;
+	};
+
+	// A log statement, one static per BLOG site
+	struct Site
+	{
+		plog::Severity severity;
+		const char* format;
+		const char* func;
+		std::uint32_t line;
+		// Generation of the log that defined the site in the high half, its id there in the low half
+		std::atomic<std::uint64_t> key{ 0u };
+	};
+
+	struct Statistics
+	{
+		size_t usedBytes;
+		size_t capacityBytes;
+		size_t sites;
+		size_t dropped;
+	};
+
+public:
+	BinaryLog(const std::filesystem::path& path, size_t capacityBytes, plog::Severity maxSeverity);
+	~BinaryLog();
+	BinaryLog(const BinaryLog&) = delete;
+	BinaryLog& operator=(const BinaryLog&) = delete;
+	BinaryLog(const BinaryLog&&) = delete;
+	BinaryLog& operator=(const BinaryLog&&) = delete;
+
+	// The log BLOG sites write to, nullptr to have them go through plog as text
+	[[nodiscard]] static BinaryLog* get() noexcept
+	{
+		return instance_.load(std::memory_order_acquire);
+	}
+	// Only while no thread is logging; the previous log stays open
+	static void set(BinaryLog* log) noexcept;
+
+	[[nodiscard]] bool checkSeverity(const plog::Severity severity) const noexcept
+	{
+		return severity <= maxSeverity_.load(std::memory_order_relaxed);
+	}
+	void setMaxSeverity(plog::Severity maxSeverity) noexcept;
+
+	template<class... Args>
+	void write(Site& site, const Args&... args) noexcept
+	{
+		std::uint64_t key = site.key.load(std::memory_order_acquire);
+		if (key >> 32u != generation_)
+		{
+			static constexpr BinaryLogFormat::ArgType types[] = { BinaryLogFormat::argType<Args>()..., BinaryLogFormat::ArgType::BOOL };
+			key = define(site, std::span<const BinaryLogFormat::ArgType>(types, sizeof...(Args)));
+			if (key == 0u)
+			{
+				return;
+			}
+		}
+		writeStored(static_cast<std::uint32_t>(key), BinaryLogFormat::toStored(args)...);
+	}
+
+	// Write the used size into the header, unmap and trim the file. Only once no thread is in the middle of a
+	// write; records that come after are dropped.
+	void close() noexcept;
+	[[nodiscard]] Statistics getStatistics() const noexcept;
+private:
+	template<class... Stored>
+	void writeStored(const std::uint32_t id, const Stored&... stored) noexcept
+	{
+		const size_t payload = (size_t{ 0u } + ... + BinaryLogFormat::storedSize(stored));
+		std::byte* record = reserve(BinaryLogFormat::align(sizeof(BinaryLogFormat::RecordHeader) + payload));
+		if (!record)
+		{
+			return;
+		}
+		[[maybe_unused]] std::byte* out = record + sizeof(BinaryLogFormat::RecordHeader);
+		((out = BinaryLogFormat::store(out, stored)), ...);
+		commit(record, id);
+	}
+
+	// Room for a record of size bytes with its length filled in, nullptr when the file is full
+	[[nodiscard]] std::byte* reserve(size_t size) noexcept;
+	// Fill in the timestamp and thread and publish the record under tag
+	static void commit(std::byte* record, std::uint32_t tag) noexcept;
+	// Give the site an id in this log and write its definition; the site's new key, 0 when the file is full
+	std::uint64_t define(Site& site, std::span<const BinaryLogFormat::ArgType> types) noexcept;
+	void map(const std::filesystem::path& path);
+	void unmap(size_t keepBytes) noexcept;
+
+	static inline std::atomic<BinaryLog*> instance_ = nullptr;
+	static inline std::atomic<std::uint32_t> nextGeneration_ = 1u;
+
+	const std::uint32_t generation_;
+	std::atomic<int> maxSeverity_;
+	std::byte* view_ = nullptr;
+	size_t capacity_ = 0u;
+	alignas(64) std::atomic<size_t> used_ = 0u;
+	alignas(64) std::atomic<size_t> dropped_ = 0u;
+	std::mutex defineMutex_;
+	std::atomic<std::uint32_t> sites_ = 0u;
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+	int descriptor_ = -1;
+};
+
+// BLOG sites take a format string with {} placeholders and its arguments, numbers, pointers and narrow strings:
+//     BLOGV("deviceContext_->DrawIndexed( {}, 0u, 0u)", count);
+// Without a BinaryLog they are formatted and logged through plog, so they can replace PLOG sites outright. The
+// string arguments are copied, the format string and function name are only pointed to and must be literals.
+#define BLOG_(severity, message, ...) \
+	LOG_IF_COMPILED_(severity) \
+	if (BinaryLog* const binaryLog_ = BinaryLog::get(); binaryLog_ != nullptr) \
+	{ \
+		if (binaryLog_->checkSeverity(severity)) \
+		{ \
+			binaryLog_->write([](const char* func) -> BinaryLog::Site& \
+				{ \
+					static BinaryLog::Site site{ severity, message, func, __LINE__ }; \
+					return site; \
+				}(PLOG_GET_FUNC()), ##__VA_ARGS__); \
+		} \
+	} \
+	else PLOG(severity) << BinaryLogFormat::format(message, ##__VA_ARGS__)
+
+#define BLOGV(message, ...) BLOG_(plog::verbose, message, ##__VA_ARGS__)
+#define BLOGD(message, ...) BLOG_(plog::debug, message, ##__VA_ARGS__)
+#define BLOGI(message, ...) BLOG_(plog::info, message, ##__VA_ARGS__)
+#define BLOGW(message, ...) BLOG_(plog::warning, message, ##__VA_ARGS__)
+#define BLOGE(message, ...) BLOG_(plog::error, message, ##__VA_ARGS__)
+#define BLOGF(message, ...) BLOG_(plog::fatal, message, ##__VA_ARGS__)
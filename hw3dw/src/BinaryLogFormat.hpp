@@ -0,0 +1,388 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Layout of the binary log shared by BinaryLog, which writes it, and the hw3dlog decoder. Everything is little
+// endian and 8 byte aligned.
+//
+// The file starts with a FileHeader. Records follow back to back, each a RecordHeader and its payload padded to
+// 8 bytes. A record's tag is written last, so a record some thread was still filling in when the process died
+// has a length and a zero tag. A thread that died between claiming its room and writing the length leaves zeros,
+// which the decoder skips to the next record like it skips the unused end of the file. DEFINITION records describe a log site once: its
+// severity, line, argument types, format string and function. EVENT records carry the site id, a timestamp, the
+// thread and the raw argument bytes, and the decoder puts the text back together from the two.
+namespace BinaryLogFormat
+{
+	inline constexpr char magic[8] = { 'A', 'T', 'U', 'M', 'B', 'L', 'O', 'G' };
+	inline constexpr std::uint32_t version = 1u;
+	inline constexpr std::uint32_t definitionTag = 0x80000000u;
+
+	struct FileHeader
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t headerSize;
+		// Bytes of records, written when the log closes; 0 after a crash, the decoder then reads the whole file
+		std::uint64_t usedBytes;
+		// Timestamps are steady clock ticks of tickNumerator / tickDenominator seconds. openTicks was taken at
+		// openUnixNanoseconds on the wall clock.
+		std::uint64_t tickNumerator;
+		std::uint64_t tickDenominator;
+		std::uint64_t openTicks;
+		std::int64_t openUnixNanoseconds;
+	};
+
+	struct RecordHeader
+	{
+		std::uint32_t length;
+		// Site id for an event, definitionTag | id for a definition, 0 until the record is complete
+		std::uint32_t tag;
+		std::uint64_t ticks;
+		std::uint32_t thread;
+		std::uint32_t reserved;
+	};
+
+	struct DefinitionHeader
+	{
+		std::uint8_t severity;
+		std::uint8_t argumentCount;
+		std::uint16_t reserved;
+		std::uint32_t line;
+		std::uint32_t formatLength;
+		std::uint32_t funcLength;
+		// Followed by argumentCount ArgType bytes, the format string and the function name
+	};
+
+	// Arguments are stored raw at their own size, strings as a 32 bit length and their bytes
+	enum class ArgType : std::uint8_t
+	{
+		BOOL,
+		CHAR,
+		INT32,
+		UINT32,
+		INT64,
+		UINT64,
+		FLOAT,
+		DOUBLE,
+		STRING,
+		POINTER
+	};
+
+	constexpr size_t align(const size_t size) noexcept
+	{
+		return (size + 7u) & ~size_t{ 7u };
+	}
+
+	template<class T>
+	constexpr ArgType argType() noexcept
+	{
+		using U = std::remove_cvref_t<T>;
+		if constexpr (std::is_same_v<U, bool>)
+		{
+			return ArgType::BOOL;
+		}
+		else if constexpr (std::is_same_v<U, char>)
+		{
+			return ArgType::CHAR;
+		}
+		else if constexpr (std::is_enum_v<U>)
+		{
+			return argType<std::underlying_type_t<U>>();
+		}
+		else if constexpr (std::is_integral_v<U>)
+		{
+			if constexpr (sizeof(U) <= 4u)
+			{
+				return std::is_signed_v<U> ? ArgType::INT32 : ArgType::UINT32;
+			}
+			else
+			{
+				return std::is_signed_v<U> ? ArgType::INT64 : ArgType::UINT64;
+			}
+		}
+		else if constexpr (std::is_same_v<U, float>)
+		{
+			return ArgType::FLOAT;
+		}
+		else if constexpr (std::is_floating_point_v<U>)
+		{
+			return ArgType::DOUBLE;
+		}
+		else if constexpr (std::is_convertible_v<const U&, std::string_view>)
+		{
+			return ArgType::STRING;
+		}
+		else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>)
+		{
+			return ArgType::POINTER;
+		}
+		else
+		{
+			static_assert(sizeof(U) == 0u, "Binary log arguments are numbers, pointers and narrow strings");
+			return ArgType::BOOL;
+		}
+	}
+
+	// The value an argument is stored as: the fixed size number of its ArgType, or a string_view
+	template<class T>
+	auto toStored(const T& value) noexcept
+	{
+		constexpr ArgType type = argType<T>();
+		if constexpr (type == ArgType::STRING)
+		{
+			if constexpr (std::is_pointer_v<T>)
+			{
+				return value ? std::string_view(value) : std::string_view("(null)");
+			}
+			else
+			{
+				return std::string_view(value);
+			}
+		}
+		else if constexpr (type == ArgType::POINTER)
+		{
+			return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(static_cast<const void*>(value)));
+		}
+		else if constexpr (type == ArgType::INT32)
+		{
+			return static_cast<std::int32_t>(value);
+		}
+		else if constexpr (type == ArgType::UINT32)
+		{
+			return static_cast<std::uint32_t>(value);
+		}
+		else if constexpr (type == ArgType::INT64)
+		{
+			return static_cast<std::int64_t>(value);
+		}
+		else if constexpr (type == ArgType::UINT64)
+		{
+			return static_cast<std::uint64_t>(value);
+		}
+		else if constexpr (type == ArgType::DOUBLE)
+		{
+			return static_cast<double>(value);
+		}
+		else
+		{
+			return value;
+		}
+	}
+
+	template<class T>
+	constexpr size_t storedSize(const T& stored) noexcept
+	{
+		if constexpr (std::is_same_v<T, std::string_view>)
+		{
+			return sizeof(std::uint32_t) + stored.size();
+		}
+		else
+		{
+			return sizeof(T);
+		}
+	}
+
+	template<class T>
+	std::byte* store(std::byte* out, const T& stored) noexcept
+	{
+		if constexpr (std::is_same_v<T, std::string_view>)
+		{
+			const auto length = static_cast<std::uint32_t>(stored.size());
+			std::memcpy(out, &length, sizeof(length));
+			std::memcpy(out + sizeof(length), stored.data(), stored.size());
+			return out + sizeof(length) + stored.size();
+		}
+		else
+		{
+			std::memcpy(out, &stored, sizeof(T));
+			return out + sizeof(T);
+		}
+	}
+
+	constexpr size_t argSize(const ArgType type) noexcept
+	{
+		switch (type)
+		{
+		case ArgType::BOOL:
+		case ArgType::CHAR:
+			return 1u;
+		case ArgType::INT32:
+		case ArgType::UINT32:
+		case ArgType::FLOAT:
+		case ArgType::STRING:
+			return 4u;
+		default:
+			return 8u;
+		}
+	}
+
+	inline const char* severityName(const std::uint8_t severity) noexcept
+	{
+		// plog's severityToString names
+		constexpr const char* names[] = { "NONE", "FATAL", "ERROR", "WARN", "INFO", "DEBUG", "VERB" };
+		return severity < std::size(names) ? names[severity] : "?";
+	}
+
+	// Append the stored argument at data as text and return what follows it, or nullptr when it runs past end
+	inline const std::byte* appendArgument(std::string& out, const ArgType type, const std::byte* data, const std::byte* end)
+	{
+		const auto read = [&data, end](auto& value)
+			{
+				if (static_cast<size_t>(end - data) < sizeof(value))
+				{
+					return false;
+				}
+				std::memcpy(&value, data, sizeof(value));
+				data += sizeof(value);
+				return true;
+			};
+		const auto number = [&out](const auto value)
+			{
+				char text[24];
+				const auto result = std::to_chars(std::begin(text), std::end(text), value);
+				out.append(text, result.ptr);
+			};
+
+		switch (type)
+		{
+		case ArgType::BOOL:
+		{
+			bool value;
+			if (!read(value)) { return nullptr; }
+			out += value ? "true" : "false";
+			break;
+		}
+		case ArgType::CHAR:
+		{
+			char value;
+			if (!read(value)) { return nullptr; }
+			out += value;
+			break;
+		}
+		case ArgType::INT32:
+		{
+			std::int32_t value;
+			if (!read(value)) { return nullptr; }
+			number(value);
+			break;
+		}
+		case ArgType::UINT32:
+		{
+			std::uint32_t value;
+			if (!read(value)) { return nullptr; }
+			number(value);
+			break;
+		}
+		case ArgType::INT64:
+		{
+			std::int64_t value;
+			if (!read(value)) { return nullptr; }
+			number(value);
+			break;
+		}
+		case ArgType::UINT64:
+		{
+			std::uint64_t value;
+			if (!read(value)) { return nullptr; }
+			number(value);
+			break;
+		}
+		case ArgType::FLOAT:
+		case ArgType::DOUBLE:
+		{
+			// Six significant digits like a default ostream, so the text matches what plog would have written
+			double value;
+			if (type == ArgType::FLOAT)
+			{
+				float single;
+				if (!read(single)) { return nullptr; }
+				value = single;
+			}
+			else if (!read(value))
+			{
+				return nullptr;
+			}
+			char text[32];
+			const int length = std::snprintf(text, sizeof(text), "%g", value);
+			out.append(text, static_cast<size_t>(length));
+			break;
+		}
+		case ArgType::STRING:
+		{
+			std::uint32_t length;
+			if (!read(length) || static_cast<size_t>(end - data) < length) { return nullptr; }
+			out.append(reinterpret_cast<const char*>(data), length);
+			data += length;
+			break;
+		}
+		case ArgType::POINTER:
+		{
+			std::uint64_t value;
+			if (!read(value)) { return nullptr; }
+			char text[24];
+			const int length = std::snprintf(text, sizeof(text), "0x%016llx", static_cast<unsigned long long>(value));
+			out.append(text, static_cast<size_t>(length));
+			break;
+		}
+		default:
+			return nullptr;
+		}
+		return data;
+	}
+
+	// Fill the {} placeholders of format with the stored arguments; false when they are cut short. Anything
+	// between the braces is skipped, leftover placeholders stay as they are.
+	inline bool formatMessage(std::string& out, const std::string_view format, const std::span<const ArgType> types, const std::byte* data, const std::byte* end)
+	{
+		size_t argument = 0u;
+		for (size_t i = 0u; i < format.size(); i++)
+		{
+			const char c = format[i];
+			if ((c == '{' || c == '}') && i + 1u < format.size() && format[i + 1u] == c)
+			{
+				out += c;
+				i++;
+				continue;
+			}
+			if (c == '{' && argument < types.size())
+			{
+				const size_t close = format.find('}', i);
+				if (close != std::string_view::npos)
+				{
+					data = appendArgument(out, types[argument++], data, end);
+					if (!data)
+					{
+						return false;
+					}
+					i = close;
+					continue;
+				}
+			}
+			out += c;
+		}
+		return true;
+	}
+
+	// The text a binary log site decodes to, for when it is written as text instead
+	template<class... Args>
+	std::string format(const std::string_view format, const Args&... args)
+	{
+		constexpr ArgType types[] = { argType<Args>()..., ArgType::BOOL };
+		std::string stored;
+		stored.resize((size_t{ 0u } + ... + storedSize(toStored(args))));
+		[[maybe_unused]] std::byte* out = reinterpret_cast<std::byte*>(stored.data());
+		((out = store(out, toStored(args))), ...);
+
+		std::string text;
+		const auto* data = reinterpret_cast<const std::byte*>(stored.data());
+		formatMessage(text, format, std::span<const ArgType>(types, sizeof...(Args)), data, data + stored.size());
+		return text;
+	}
+}
@@ -0,0 +1,87 @@
+#include "BindSet.hpp"
+
+#include "BindableIncludes.hpp"
+
+void BindSet::bind(Graphics& graphics) const noexcept
+{
+	for (size_t i = 0; i < count_; i++)
+	{
+		const auto& [kind, handle] = entries_[i];
+		// Qualified calls skip the vtable; the pooled types are stored as exactly these classes
+		switch (kind)
+		{
+		case BindableKind::VertexBuffer:
+			getPool<VertexBuffer>()[handle].VertexBuffer::bind(graphics);
+			break;
+		case BindableKind::IndexBuffer:
+			getPool<IndexBuffer>()[handle].IndexBuffer::bind(graphics);
+			break;
+		case BindableKind::VertexShader:
+			getPool<VertexShader>()[handle].VertexShader::bind(graphics);
+			break;
+		case BindableKind::PixelShader:
+			getPool<PixelShader>()[handle].PixelShader::bind(graphics);
+			break;
+		case BindableKind::InputLayout:
+			getPool<InputLayout>()[handle].InputLayout::bind(graphics);
+			break;
+		case BindableKind::Topology:
+			getPool<Topology>()[handle].Topology::bind(graphics);
+			break;
+		case BindableKind::Sampler:
+			getPool<Sampler>()[handle].Sampler::bind(graphics);
+			break;
+		case BindableKind::Texture:
+			getPool<Texture>()[handle].Texture::bind(graphics);
+			break;
+		case BindableKind::TransformConstantBuffer:
+			getPool<TransformConstantBuffer>()[handle].TransformConstantBuffer::bind(graphics);
+			break;
+		case BindableKind::Other:
+			getPool<std::unique_ptr<Bindable>>()[handle]->bind(graphics);
+			break;
+		}
+	}
+}
+
+void BindSet::clear() noexcept
+{
+	for (size_t i = 0; i < count_; i++)
+	{
+		const auto& [kind, handle] = entries_[i];
+		switch (kind)
+		{
+		case BindableKind::VertexBuffer:
+			getPool<VertexBuffer>().erase(handle);
+			break;
+		case BindableKind::IndexBuffer:
+			getPool<IndexBuffer>().erase(handle);
+			break;
+		case BindableKind::VertexShader:
+			getPool<VertexShader>().erase(handle);
+			break;
+		case BindableKind::PixelShader:
+			getPool<PixelShader>().erase(handle);
+			break;
+		case BindableKind::InputLayout:
+			getPool<InputLayout>().erase(handle);
+			break;
+		case BindableKind::Topology:
+			getPool<Topology>().erase(handle);
+			break;
+		case BindableKind::Sampler:
+			getPool<Sampler>().erase(handle);
+			break;
+		case BindableKind::Texture:
+			getPool<Texture>().erase(handle);
+			break;
+		case BindableKind::TransformConstantBuffer:
+			getPool<TransformConstantBuffer>().erase(handle);
+			break;
+		case BindableKind::Other:
+			getPool<std::unique_ptr<Bindable>>().erase(handle);
+			break;
+		}
+	}
+	count_ = 0u;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <typeinfo>
+
+#include "HandlePool.hpp"
+#include "Logging.hpp"
+#include "MemoryTracker.hpp"
+
+class Bindable;
+class Graphics;
+class IndexBuffer;
+class InputLayout;
+class PixelShader;
+class Sampler;
+class Texture;
+class Topology;
+class TransformConstantBuffer;
+class VertexBuffer;
+class VertexShader;
+
+// Bindable types with a pool of their own. Anything else (templated constant buffers, Texture subclasses) is
+// boxed in the Other pool and bound through its vtable.
+enum class BindableKind : std::uint8_t
+{
+	VertexBuffer,
+	IndexBuffer,
+	VertexShader,
+	PixelShader,
+	InputLayout,
+	Topology,
+	Sampler,
+	Texture,
+	TransformConstantBuffer,
+	Other,
+};
+
+template<class T> constexpr BindableKind bindableKindOf = BindableKind::Other;
+template<> constexpr BindableKind bindableKindOf<VertexBuffer> = BindableKind::VertexBuffer;
+template<> constexpr BindableKind bindableKindOf<IndexBuffer> = BindableKind::IndexBuffer;
+template<> constexpr BindableKind bindableKindOf<VertexShader> = BindableKind::VertexShader;
+template<> constexpr BindableKind bindableKindOf<PixelShader> = BindableKind::PixelShader;
+template<> constexpr BindableKind bindableKindOf<InputLayout> = BindableKind::InputLayout;
+template<> constexpr BindableKind bindableKindOf<Topology> = BindableKind::Topology;
+template<> constexpr BindableKind bindableKindOf<Sampler> = BindableKind::Sampler;
+template<> constexpr BindableKind bindableKindOf<Texture> = BindableKind::Texture;
+template<> constexpr BindableKind bindableKindOf<TransformConstantBuffer> = BindableKind::TransformConstantBuffer;
+
+// A drawable's binds as an inline array of pool handles. Binding switches on the kind and calls the concrete
+// bind() directly, so walking a set touches one small array plus the pooled objects, with no vtable lookups for
+// the common types.
+class BindSet
+{
+public:
+	static constexpr size_t capacity = 12u;
+
+	BindSet() = default;
+	// Releasing is explicit: static sets outlive the pools at shutdown, and the pools destroy what is left
+	~BindSet() = default;
+	BindSet(const BindSet&) = delete;
+	BindSet& operator=(const BindSet&) = delete;
+	BindSet(const BindSet&&) = delete;
+	BindSet& operator=(const BindSet&&) = delete;
+
+	template<class T, class... Args>
+	T& add(Args&&... args)
+	{
+		assert("Bind set is full" && count_ < capacity);
+		// The pools and whatever the binds keep on the heap, buffers and textures scope their own uploads
+		MemoryTracker::Scope scope(MemoryTag::Bindables);
+#ifdef LOG_GRAPHICS_CALLS
+		PLOGV << "binding " << typeid(T).name();
+#endif
+		constexpr BindableKind kind = bindableKindOf<T>;
+		if constexpr (kind == BindableKind::Other)
+		{
+			auto& others = getPool<std::unique_ptr<Bindable>>();
+			const auto handle = others.emplace(std::make_unique<T>(std::forward<Args>(args)...));
+			entries_[count_++] = { kind, handle };
+			return static_cast<T&>(*others[handle]);
+		}
+		else
+		{
+			auto& pool = getPool<T>();
+			const auto handle = pool.emplace(std::forward<Args>(args)...);
+			entries_[count_++] = { kind, handle };
+			return pool[handle];
+		}
+	}
+
+	// First bind of a pooled type, or nullptr
+	template<class T>
+	T* find() noexcept
+	{
+		static_assert(bindableKindOf<T> != BindableKind::Other, "Only pooled bindable types can be looked up");
+		for (size_t i = 0; i < count_; i++)
+		{
+			if (entries_[i].kind == bindableKindOf<T>)
+			{
+				return &getPool<T>()[entries_[i].handle];
+			}
+		}
+		return nullptr;
+	}
+
+	void bind(Graphics& graphics) const noexcept;
+	// Destroy every bind in the set
+	void clear() noexcept;
+
+	[[nodiscard]] size_t size() const noexcept
+	{
+		return count_;
+	}
+
+	template<class T>
+	static HandlePool<T>& getPool() noexcept
+	{
+		static HandlePool<T> pool;
+		return pool;
+	}
+private:
+	struct Entry
+	{
+		BindableKind kind;
+		PoolHandle handle;
+	};
+
+	std::array<Entry, capacity> entries_{};
+	std::uint8_t count_ = 0u;
+};
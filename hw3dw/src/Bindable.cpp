@@ -1,8 +1,10 @@
 #include "Bindable.hpp"
+#include "CommandRecorder.hpp"
+#include "GraphicsThrowMacros.hpp"
 
 ID3D11DeviceContext* Bindable::getContext(const Graphics& graphics) noexcept
 {
-	return graphics.deviceContext_.Get();
+	return graphics.getCurrentContext();
 }
 
 ID3D11Device* Bindable::getDevice(const Graphics& graphics) noexcept
@@ -13,9 +15,68 @@ ID3D11Device* Bindable::getDevice(const Graphics& graphics) noexcept
 DxgiInfoManager& Bindable::getInfoManager(Graphics& graphics) noexcept(IS_DEBUG)
 {
 #if (IS_DEBUG)
+	// Binds recorded on a worker thread report through that thread's recorder
+	if (auto* recorder = CommandRecorder::getActive())
+	{
+		return recorder->getInfoManager();
+	}
 	return graphics.infoManager_;
 #else
 	throw std::logic_error("Access denied: DxgiInfoManager is not accessible in release builds.");
 #endif
 }
 
+
+Microsoft::WRL::ComPtr<ID3D11Buffer> Bindable::createBuffer(Upload& upload, const D3D11_BUFFER_DESC& desc)
+{
+	INFOMAN(upload.graphics_);
+
+	assert("Upload was already turned into a buffer" && upload.data_ != nullptr);
+	assert("Buffer must be the size of the upload" && desc.ByteWidth == upload.size_);
+	ID3D11DeviceContext* context = getContext(upload.graphics_);
+	context->Unmap(upload.staging_.Get(), 0u);
+	upload.data_ = nullptr;
+
+	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+	GFX_THROW_INFO(getDevice(upload.graphics_)->CreateBuffer(&desc, nullptr, &buffer));
+	context->CopyResource(buffer.Get(), upload.staging_.Get());
+	return buffer;
+}
+
+// upload stuff
+Bindable::Upload::Upload(Graphics& graphics, const size_t size)
+	:
+	graphics_(graphics),
+	size_(size)
+{
+	INFOMAN(graphics);
+
+	assert("Uploads go through the immediate context" && !Graphics::isRecording());
+	// Readable as well as writable, so reading back what was generated stays in cached memory
+	const D3D11_BUFFER_DESC stagingDesc = {
+		.ByteWidth = static_cast<UINT>(size_),
+		.Usage = D3D11_USAGE_STAGING,
+		.BindFlags = 0u,
+		.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE | D3D11_CPU_ACCESS_READ,
+		.MiscFlags = 0u,
+		.StructureByteStride = 0u
+	};
+	GFX_THROW_INFO(getDevice(graphics_)->CreateBuffer(&stagingDesc, nullptr, &staging_));
+
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	GFX_THROW_INFO(getContext(graphics_)->Map(staging_.Get(), 0u, D3D11_MAP_READ_WRITE, 0u, &mapped));
+	data_ = mapped.pData;
+}
+
+Bindable::Upload::~Upload()
+{
+	if (data_ != nullptr)
+	{
+		getContext(graphics_)->Unmap(staging_.Get(), 0u);
+	}
+}
+
+size_t Bindable::Upload::getSize() const noexcept
+{
+	return size_;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include "Graphics.hpp"
 
 class Bindable
@@ -12,10 +14,41 @@ public:
 	Bindable& operator=(const Bindable&&) = delete;
 
 	virtual void bind(Graphics& graphics) noexcept = 0;
+
+	// Staging memory a buffer's contents are generated straight into, instead of into a system memory copy the
+	// driver would copy again. It stays mapped for reading and writing until a VertexBuffer or IndexBuffer is made
+	// from it, so anything else that needs the data (a software mesh, say) can be built from the same memory.
+	// Uses the immediate context, so only create one outside of command recording.
+	class Upload
+	{
+	public:
+		Upload(Graphics& graphics, size_t size);
+		~Upload();
+		Upload(const Upload&) = delete;
+		Upload& operator=(const Upload&) = delete;
+		Upload(const Upload&&) = delete;
+		Upload& operator=(const Upload&&) = delete;
+
+		template<class T>
+		[[nodiscard]] std::span<T> as() const noexcept
+		{
+			return { static_cast<T*>(data_), size_ / sizeof(T) };
+		}
+		[[nodiscard]] size_t getSize() const noexcept;
+	private:
+		friend class Bindable;
+
+		Graphics& graphics_;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> staging_;
+		void* data_ = nullptr;
+		size_t size_;
+	};
 protected:
 	Bindable() = default;
 
 	static ID3D11DeviceContext* getContext(const Graphics& graphics) noexcept;
 	static ID3D11Device* getDevice(const Graphics& graphics) noexcept;
 	static DxgiInfoManager& getInfoManager(Graphics& graphics) noexcept(IS_DEBUG);
+	// Unmap upload and copy it into a new buffer described by desc
+	static Microsoft::WRL::ComPtr<ID3D11Buffer> createBuffer(Upload& upload, const D3D11_BUFFER_DESC& desc);
 };
\ No newline at end of file
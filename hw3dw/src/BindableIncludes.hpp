@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Blender.hpp"
 #include "ConstantBuffers.hpp"
 #include "IndexBuffer.hpp"
 #include "InputLayout.hpp"
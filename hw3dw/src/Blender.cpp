@@ -0,0 +1,27 @@
+#include "Blender.hpp"
+#include "GraphicsThrowMacros.hpp"
+
+Blender::Blender(Graphics& graphics, const float opacity)
+	:
+	factors_{ opacity, opacity, opacity, opacity }
+{
+	INFOMAN(graphics);
+
+	D3D11_BLEND_DESC blendDesc = {};
+	auto& target = blendDesc.RenderTarget[0];
+	target.BlendEnable = TRUE;
+	target.SrcBlend = D3D11_BLEND_BLEND_FACTOR;
+	target.DestBlend = D3D11_BLEND_INV_BLEND_FACTOR;
+	target.BlendOp = D3D11_BLEND_OP_ADD;
+	target.SrcBlendAlpha = D3D11_BLEND_ZERO;
+	target.DestBlendAlpha = D3D11_BLEND_ONE;
+	target.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	target.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+	GFX_THROW_INFO(getDevice(graphics)->CreateBlendState(&blendDesc, &blendState_));
+}
+
+void Blender::bind(Graphics& graphics) noexcept
+{
+	getContext(graphics)->OMSetBlendState(blendState_.Get(), factors_, 0xFFFFFFFFu);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Bindable.hpp"
+
+// Blend state that mixes a draw over what is behind it by a constant opacity, for drawables in the blended pass.
+// Nothing resets it per draw: the blended pass comes last, and the scene resolve puts the default state back.
+class Blender : public Bindable
+{
+public:
+	Blender(Graphics& graphics, float opacity);
+
+	Blender() = delete;
+	~Blender() override = default;
+	Blender(const Blender&) = delete;
+	Blender& operator=(const Blender&) = delete;
+	Blender(const Blender&&) = delete;
+	Blender& operator=(const Blender&&) = delete;
+
+	void bind(Graphics& graphics) noexcept override;
+protected:
+	Microsoft::WRL::ComPtr<ID3D11BlendState> blendState_;
+	float factors_[4];
+};
@@ -1,28 +1,11 @@
 #include "Box.hpp"
 
-#include "AtumMath.hpp"
 #include "BindableIncludes.hpp"
 #include "Cube.hpp"
 
-Box::Box(Graphics& graphics,
-         std::mt19937& rng,
-         std::uniform_real_distribution<float>& distance_distribution,									// rdist
-         std::uniform_real_distribution<float>& spherical_coordinate_position_distribution,				// adist
-         std::uniform_real_distribution<float>& rotation_of_drawable_distribution,						// ddist
-         std::uniform_real_distribution<float>& spherical_coordinate_movement_of_drawable_distribution,	// odist
-         std::uniform_real_distribution<float>& z_axis_distortion_distribution							// bdist
-)
+Box::Box(Graphics& graphics, const ScenePopulation::Spawn& spawn)
 	: DrawableStaticStorage(),
-	radiusDistanceFromCenter_(distance_distribution(rng)),
-	theta_(spherical_coordinate_position_distribution(rng)),
-	phi_(spherical_coordinate_position_distribution(rng)),
-	rho_(spherical_coordinate_position_distribution(rng)),
-	droll_(rotation_of_drawable_distribution(rng)),
-	dpitch_(rotation_of_drawable_distribution(rng)),
-	dyaw_(rotation_of_drawable_distribution(rng)),
-	dtheta_(spherical_coordinate_movement_of_drawable_distribution(rng)),
-	dphi_(spherical_coordinate_movement_of_drawable_distribution(rng)),
-	drho_(spherical_coordinate_movement_of_drawable_distribution(rng))
+	orbit_(spawn.orbit)
 {
 	namespace dx = DirectX;
 
@@ -32,17 +15,19 @@ Box::Box(Graphics& graphics,
 		{
 			dx::XMFLOAT3 pos;
 		};
-		const auto model = Cube::make<vertex>();
+		// Generated straight into upload memory, which the software mesh is read back from
+		Bindable::Upload vertices(graphics, Cube::getLayout().vertexCount * sizeof(vertex));
+		Bindable::Upload indices(graphics, Cube::getLayout().indexCount * sizeof(unsigned short));
+		Cube::write(vertices.as<vertex>(), indices.as<unsigned short>());
+		setStaticSoftwareMesh(SoftwareRasterizer::Mesh::from<vertex>(vertices.as<const vertex>(), indices.as<const unsigned short>()));
 
-		addStaticBind(std::make_unique<VertexBuffer>(graphics, model.vertices()));
+		addStaticBind<VertexBuffer>(graphics, vertices, static_cast<UINT>(sizeof(vertex)));
 
-		auto p_vertex_shader = std::make_unique<VertexShader>(graphics, L"ColorIndexVS.cso");
-		auto p_vertex_shader_bytecode = p_vertex_shader->getByteCode();
-		addStaticBind(std::move(p_vertex_shader));
+		auto p_vertex_shader_bytecode = addStaticBind<VertexShader>(graphics, L"ColorIndexVS.cso").getByteCode();
 
-		addStaticBind(std::make_unique<PixelShader>(graphics, L"ColorIndexPS.cso"));
+		addStaticBind<PixelShader>(graphics, L"ColorIndexPS.cso");
 
-		addStaticIndexBuffer(std::make_unique<IndexBuffer>(graphics, model.indices()));
+		addStaticIndexBuffer(graphics, indices);
 
 		struct pixel_shader_constants
 		{
@@ -67,7 +52,15 @@ Box::Box(Graphics& graphics,
 				{0.0f, 1.0f, 1.0f, 1.0f}, // Cyan
 			}
 		};
-		addStaticBind(std::make_unique<PixelConstantBuffer<pixel_shader_constants>>(graphics, constant_buffer));
+		addStaticBind<PixelConstantBuffer<pixel_shader_constants>>(graphics, constant_buffer);
+
+		SoftwareRasterizer::Material material;
+		for (size_t i = 0; i < std::size(constant_buffer.face_colors); i++)
+		{
+			const auto& color = constant_buffer.face_colors[i];
+			material.faceColors[i] = { color.r, color.g, color.b, color.a };
+		}
+		setStaticSoftwareMaterial(material);
 
 		const std::vector<D3D11_INPUT_ELEMENT_DESC> input_element_descs =
 		{
@@ -81,38 +74,30 @@ Box::Box(Graphics& graphics,
 				.InstanceDataStepRate = 0u
 			},
 		};
-		addStaticBind(std::make_unique<InputLayout>(graphics, input_element_descs, p_vertex_shader_bytecode));
+		addStaticBind<InputLayout>(graphics, input_element_descs, p_vertex_shader_bytecode);
 
-		addStaticBind(std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		addStaticBind<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	}
 	else
 	{
 		setIndexBufferFromStaticBinds();
 	}
 
-	Drawable::addBind(std::make_unique<TransformConstantBuffer>(graphics, *this));
+	addBind<TransformConstantBuffer>(graphics, *this);
 
 	// model deformation transform (per instance, not stored as bind)
 	dx::XMStoreFloat3x3(
 		&model_transform_,
-		dx::XMMatrixScaling(1.0f, 1.0f, z_axis_distortion_distribution(rng))
+		dx::XMMatrixScaling(1.0f, 1.0f, spawn.zAxisDistortion)
 	);
 }
 
 void Box::update(const float dt) noexcept
 {
-	roll_ += wrapAngle(droll_ * dt);
-	pitch_ += wrapAngle(dpitch_ * dt);
-	yaw_ += wrapAngle(dyaw_ * dt);
-	theta_ += wrapAngle(dtheta_ * dt);
-	phi_ += wrapAngle(dphi_ * dt);
-	rho_ += wrapAngle(drho_ * dt);
+	orbit_.update(dt);
 }
 
 DirectX::XMMATRIX Box::getTransformXm() const noexcept
 {
-	return DirectX::XMMatrixRotationRollPitchYaw(pitch_, yaw_, roll_) *
-		DirectX::XMMatrixTranslation(radiusDistanceFromCenter_, 0.0f, 0.0f) *
-		DirectX::XMMatrixRotationRollPitchYaw(theta_, phi_, rho_) *
-		DirectX::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+	return orbit_.getTransformXm();
 }
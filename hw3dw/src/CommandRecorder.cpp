@@ -0,0 +1,74 @@
+#include "CommandRecorder.hpp"
+
+#include "GraphicsThrowMacros.hpp"
+
+thread_local CommandRecorder* CommandRecorder::active_ = nullptr;
+
+CommandRecorder::CommandRecorder(Graphics& graphics)
+	:
+	graphics_(graphics)
+{
+	HRESULT hresult;
+	GFX_THROW_INFO(graphics_.device_->CreateDeferredContext(0u, &context_));
+	// Binding ring slices needs the D3D11.1 interface, which any device that has a ring provides
+	if (graphics_.getConstantRing())
+	{
+		GFX_THROW_INFO(context_->QueryInterface(IID_PPV_ARGS(&context1_)));
+	}
+}
+
+void CommandRecorder::begin(std::optional<ConstantRing::Block> constants) noexcept(!IS_DEBUG)
+{
+	assert("Thread is already recording" && Graphics::recordingContext_ == nullptr);
+	Graphics::recordingContext_ = context_.Get();
+	active_ = this;
+	constants_ = context1_ ? constants : std::nullopt;
+	graphics_.bindTargets(context_.Get());
+}
+
+void CommandRecorder::end()
+{
+	Graphics::recordingContext_ = nullptr;
+	active_ = nullptr;
+	constants_.reset();
+
+	HRESULT hresult;
+	GFX_THROW_INFO(context_->FinishCommandList(FALSE, &commandList_));
+}
+
+void CommandRecorder::execute() noexcept(!IS_DEBUG)
+{
+	assert("Command list must be recorded before it is executed" && commandList_);
+	GFX_THROW_INFO_ONLY(graphics_.deviceContext_->ExecuteCommandList(commandList_.Get(), FALSE));
+	commandList_.Reset();
+
+	// Executing without restoring leaves the immediate context in its default state
+	graphics_.bindTargets(graphics_.deviceContext_.Get());
+}
+
+CommandRecorder* CommandRecorder::getActive() noexcept
+{
+	return active_;
+}
+
+bool CommandRecorder::bindVertexConstants(const UINT slot, const void* data, const UINT size) noexcept
+{
+	if (!constants_)
+	{
+		return false;
+	}
+	const auto slice = ConstantRing::upload(*constants_, data, size);
+	if (!slice)
+	{
+		return false;
+	}
+	graphics_.getConstantRing()->bindVertex(context1_.Get(), slot, *slice);
+	return true;
+}
+
+#if (IS_DEBUG)
+DxgiInfoManager& CommandRecorder::getInfoManager() noexcept
+{
+	return infoManager_;
+}
+#endif
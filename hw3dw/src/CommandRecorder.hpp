@@ -0,0 +1,52 @@
+#pragma once
+#include <d3d11_1.h>
+#include <optional>
+
+#include "ConstantRing.hpp"
+#include "Graphics.hpp"
+
+// Records draws on a D3D11 deferred context so drawables can be submitted from worker threads. Between begin()
+// and end(), every Bindable and Graphics::drawIndexed call made on that thread lands in the recorder instead of
+// the immediate context. A recorder may only be used by one thread at a time; execute() belongs to the render
+// thread and replays the recorded list on the immediate context.
+class CommandRecorder
+{
+public:
+	explicit CommandRecorder(Graphics& graphics);
+
+	~CommandRecorder() = default;
+	CommandRecorder(const CommandRecorder&) = delete;
+	CommandRecorder& operator=(const CommandRecorder&) = delete;
+	CommandRecorder(const CommandRecorder&&) = delete;
+	CommandRecorder& operator=(const CommandRecorder&&) = delete;
+
+	// constants is this recorder's part of the frame's mapped constant ring block, if there is one
+	void begin(std::optional<ConstantRing::Block> constants = std::nullopt) noexcept(!IS_DEBUG);
+	void end();
+	void execute() noexcept(!IS_DEBUG);
+
+	// The recorder the calling thread is recording with, nullptr outside of begin() and end()
+	static CommandRecorder* getActive() noexcept;
+	// Write constants into the next slice of the recorder's block and bind it; false once the block is used up
+	bool bindVertexConstants(UINT slot, const void* data, UINT size) noexcept;
+	template<typename T>
+	bool bindVertexConstants(const UINT slot, const T& constants) noexcept
+	{
+		return bindVertexConstants(slot, &constants, sizeof(T));
+	}
+#if (IS_DEBUG)
+	// Draws recorded on worker threads are checked against the recorder's own info manager, so they never
+	// race the render thread over the one Graphics owns
+	DxgiInfoManager& getInfoManager() noexcept;
+#endif
+private:
+	Graphics& graphics_;
+#if (IS_DEBUG)
+	DxgiInfoManager infoManager_;
+#endif
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context_;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1_;
+	Microsoft::WRL::ComPtr<ID3D11CommandList> commandList_;
+	std::optional<ConstantRing::Block> constants_;
+	static thread_local CommandRecorder* active_;
+};
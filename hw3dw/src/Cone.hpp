@@ -1,8 +1,11 @@
 #pragma once
 
+#include <span>
+
 #include "IndexedTriangleList.hpp"
 #include <DirectXMath.h>
 #include "AtumMath.hpp"
+#include "MeshLayout.hpp"
 
 class Cone
 {
@@ -14,49 +17,66 @@ public:
 	}
 
 	template<class V>
-	static IndexedTriangleList<V> makeTessellated(const int longitudinalDivisions, std::function<void(std::vector<V>&)> setAttributes = nullptr) {
+	static IndexedTriangleList<V> makeTessellated(const int longitudinalDivisions, std::function<void(MeshVector<V>&)> setAttributes = nullptr) {
+		const MeshLayout layout = getTessellatedLayout(longitudinalDivisions);
+		MeshVector<V> vertices(layout.vertexCount);
+		MeshVector<unsigned short> indices(layout.indexCount);
+		writeTessellated<V>(longitudinalDivisions, std::span(vertices), std::span(indices));
+
+		if (setAttributes) {
+			setAttributes(vertices);
+		}
+
+		return IndexedTriangleList<V>{std::move(vertices), std::move(indices)};
+	}
+
+	[[nodiscard]] static MeshLayout getTessellatedLayout(const int longitudinalDivisions) noexcept {
+		const size_t divisions = static_cast<size_t>(longitudinalDivisions);
+		return { divisions + 2u, divisions * 6u };
+	}
+
+	// Write the cone into storage sized by getTessellatedLayout (a mapped upload buffer, say). Only positions
+	// are written. Longitudes are split over the pool when one is given.
+	template<class V, class I = unsigned short>
+	static void writeTessellated(const int longitudinalDivisions, std::span<V> vertices, std::span<I> indices, WorkerPool* pool = nullptr) {
 		namespace dx = DirectX;
 		assert(longitudinalDivisions >= 3);
+		const MeshLayout layout = getTessellatedLayout(longitudinalDivisions);
+		assert(vertices.size() == layout.vertexCount && indices.size() == layout.indexCount);
+		assert(layout.fitsIndexType<I>());
 		const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
 		const float longitudeAngle = 2.0f * PI / static_cast<float>(longitudinalDivisions);
-
-		// base vertices
-		std::vector<V> vertices;
-		for (int indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++) {
-			vertices.emplace_back();
-			auto vertex = dx::XMVector3Transform(base, dx::XMMatrixRotationZ(longitudeAngle * static_cast<float>(indexLongitude)));
-			dx::XMStoreFloat3(&vertices.back().pos, vertex);
-		}
+		const size_t divisions = static_cast<size_t>(longitudinalDivisions);
 
 		// the center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f, 0.0f, -1.0f };
-		const auto indexCenter = static_cast<unsigned short>(vertices.size() - 1);
+		const auto indexCenter = static_cast<I>(divisions);
+		vertices[indexCenter].pos = { 0.0f, 0.0f, -1.0f };
 
 		// the tip
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f, 0.0f, 1.0f };
-		const auto indexTip = static_cast<unsigned short>(vertices.size() - 1);
-
-		// base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++) {
-			indices.push_back(indexCenter);
-			indices.push_back((indexLongitude + 1) % longitudinalDivisions);
-			indices.push_back(indexLongitude);
-		}
+		const auto indexTip = static_cast<I>(divisions + 1u);
+		vertices[indexTip].pos = { 0.0f, 0.0f, 1.0f };
 
-		// cone indices
-		for (unsigned short indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++) {
-			indices.push_back(indexLongitude);
-			indices.push_back((indexLongitude + 1) % longitudinalDivisions);
-			indices.push_back(indexTip);
-		}
+		forEachBand(pool, divisions, [&](const size_t first, const size_t last) {
+			for (size_t indexLongitude = first; indexLongitude < last; indexLongitude++) {
+				// base vertices
+				const auto vertex = dx::XMVector3Transform(base, dx::XMMatrixRotationZ(longitudeAngle * static_cast<float>(indexLongitude)));
+				dx::XMStoreFloat3(&vertices[indexLongitude].pos, vertex);
 
-		if (setAttributes) {
-			setAttributes(vertices);
-		}
+				const auto current = static_cast<I>(indexLongitude);
+				const auto next = static_cast<I>((indexLongitude + 1u) % divisions);
 
-		return IndexedTriangleList<V>{std::move(vertices), std::move(indices)};
+				// base indices
+				I* cap = indices.data() + indexLongitude * 3u;
+				cap[0] = indexCenter;
+				cap[1] = next;
+				cap[2] = current;
+
+				// cone indices
+				I* side = indices.data() + divisions * 3u + indexLongitude * 3u;
+				side[0] = current;
+				side[1] = next;
+				side[2] = indexTip;
+			}
+		});
 	}
-};
\ No newline at end of file
+};
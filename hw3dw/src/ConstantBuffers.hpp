@@ -56,10 +56,21 @@ public:
 		INFOMAN(graphics);
 
 		D3D11_MAPPED_SUBRESOURCE mapped_subresource;
-		GFX_THROW_INFO(getContext(graphics)->Map(
-			m_constantBuffer.Get(), 0u,
-			D3D11_MAP_WRITE_DISCARD, 0u,
-			&mapped_subresource));
+		// Recording threads can't share the info manager with the render thread
+		if (Graphics::isRecording())
+		{
+			GFX_THROW_NOINFO(getContext(graphics)->Map(
+				m_constantBuffer.Get(), 0u,
+				D3D11_MAP_WRITE_DISCARD, 0u,
+				&mapped_subresource));
+		}
+		else
+		{
+			GFX_THROW_INFO(getContext(graphics)->Map(
+				m_constantBuffer.Get(), 0u,
+				D3D11_MAP_WRITE_DISCARD, 0u,
+				&mapped_subresource));
+		}
 		memcpy(mapped_subresource.pData, &constant_buffer_struct, sizeof(constant_buffer_struct));
 		getContext(graphics)->Unmap(m_constantBuffer.Get(), 0u);
 	}
@@ -0,0 +1,235 @@
+#include "ConstantRing.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Graphics.hpp"
+#include "GraphicsThrowMacros.hpp"
+#include "Logging.hpp"
+
+ConstantRing::ConstantRing(ID3D11Device* device, ID3D11DeviceContext* context, const UINT capacity)
+	:
+	ring_((capacity + sliceAlignment - 1u) / sliceAlignment * sliceAlignment, sliceAlignment)
+{
+	HRESULT hresult;
+	GFX_THROW_NOINFO(context->QueryInterface(IID_PPV_ARGS(&context_)));
+
+	const D3D11_BUFFER_DESC bufferDesc = {
+		.ByteWidth = ring_.getCapacity(),
+		.Usage = D3D11_USAGE_DYNAMIC,
+		.BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+		.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+		.MiscFlags = 0u,
+		.StructureByteStride = 0u
+	};
+	GFX_THROW_NOINFO(device->CreateBuffer(&bufferDesc, nullptr, &buffer_));
+
+	constexpr D3D11_QUERY_DESC queryDesc = {
+		.Query = D3D11_QUERY_EVENT,
+		.MiscFlags = 0u
+	};
+	for (auto& fence : fences_)
+	{
+		GFX_THROW_NOINFO(device->CreateQuery(&queryDesc, &fence.query));
+		fence.pending = false;
+	}
+
+	PLOGI << "Constant ring: " << ring_.getCapacity() / 1024u << " KiB, " << sliceAlignment << " byte slices";
+}
+
+bool ConstantRing::isSupported(ID3D11Device* device) noexcept
+{
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+	if (FAILED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))))
+	{
+		return false;
+	}
+	return options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer;
+}
+
+UINT ConstantRing::getCapacityFor(const size_t drawsPerFrame) noexcept
+{
+	constexpr UINT maximum = D3D11_REQ_RESOURCE_SIZE_IN_MEGABYTES_EXPRESSION_A_TERM * 1024u * 1024u;
+	return std::min(UploadRing::getCapacityFor(drawsPerFrame, sliceAlignment, sliceAlignment, framesInFlight), maximum);
+}
+
+ConstantRing::Slice ConstantRing::upload(const void* data, const UINT size)
+{
+	const auto allocation = ring_.allocate(size);
+	if (!allocation)
+	{
+		throw GFX_EXCEPT_NOINFO(E_INVALIDARG);
+	}
+
+	HRESULT hresult;
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	GFX_THROW_NOINFO(context_->Map(buffer_.Get(), 0u,
+		allocation->discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0u, &mapped));
+	std::memcpy(static_cast<unsigned char*>(mapped.pData) + allocation->offset, data, size);
+	context_->Unmap(buffer_.Get(), 0u);
+
+	return {
+		.firstConstant = allocation->offset / bytesPerConstant,
+		.numConstants = allocation->size / bytesPerConstant
+	};
+}
+
+void ConstantRing::bindVertex(const UINT slot, const Slice& slice) const noexcept
+{
+	context_->VSSetConstantBuffers1(slot, 1u, buffer_.GetAddressOf(), &slice.firstConstant, &slice.numConstants);
+}
+
+void ConstantRing::bindPixel(const UINT slot, const Slice& slice) const noexcept
+{
+	context_->PSSetConstantBuffers1(slot, 1u, buffer_.GetAddressOf(), &slice.firstConstant, &slice.numConstants);
+}
+
+std::optional<ConstantRing::Block> ConstantRing::mapBlock(const UINT slices)
+{
+	assert("Only one block can be mapped at a time" && !blockMapped_);
+	if (slices == 0u || slices > ring_.getCapacity() / sliceAlignment)
+	{
+		return std::nullopt;
+	}
+	const auto allocation = ring_.allocate(slices * sliceAlignment);
+	if (!allocation)
+	{
+		return std::nullopt;
+	}
+
+	HRESULT hresult;
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	GFX_THROW_NOINFO(context_->Map(buffer_.Get(), 0u,
+		allocation->discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0u, &mapped));
+	blockMapped_ = true;
+
+	return Block{
+		.data = static_cast<unsigned char*>(mapped.pData) + allocation->offset,
+		.firstConstant = allocation->offset / bytesPerConstant,
+		.slices = slices,
+		.used = 0u
+	};
+}
+
+void ConstantRing::unmapBlock() noexcept
+{
+	if (blockMapped_)
+	{
+		context_->Unmap(buffer_.Get(), 0u);
+		blockMapped_ = false;
+	}
+}
+
+std::optional<ConstantRing::Slice> ConstantRing::upload(Block& block, const void* data, const UINT size) noexcept
+{
+	if (block.used == block.slices || size > sliceAlignment)
+	{
+		return std::nullopt;
+	}
+
+	std::memcpy(block.data + block.used * sliceAlignment, data, size);
+	const Slice slice = {
+		.firstConstant = block.firstConstant + block.used * (sliceAlignment / bytesPerConstant),
+		.numConstants = sliceAlignment / bytesPerConstant
+	};
+	block.used++;
+	return slice;
+}
+
+void ConstantRing::bindVertex(ID3D11DeviceContext1* context, const UINT slot, const Slice& slice) const noexcept
+{
+	context->VSSetConstantBuffers1(slot, 1u, buffer_.GetAddressOf(), &slice.firstConstant, &slice.numConstants);
+}
+
+void ConstantRing::setImmediateBlock(const Block& block) noexcept
+{
+	assert("The block must be unmapped before the immediate context draws with it" && !blockMapped_);
+	immediateBlock_ = Block{
+		.data = nullptr,
+		.firstConstant = block.firstConstant,
+		.slices = block.used,
+		.used = 0u
+	};
+}
+
+bool ConstantRing::bindNextVertex(const UINT slot) noexcept
+{
+	if (!immediateBlock_ || immediateBlock_->used == immediateBlock_->slices)
+	{
+		return false;
+	}
+
+	const Slice slice = {
+		.firstConstant = immediateBlock_->firstConstant + immediateBlock_->used * (sliceAlignment / bytesPerConstant),
+		.numConstants = sliceAlignment / bytesPerConstant
+	};
+	immediateBlock_->used++;
+	bindVertex(slot, slice);
+	return true;
+}
+
+ConstantRing::Block ConstantRing::Block::part(const UINT first, const UINT count) const noexcept
+{
+	const UINT begin = std::min(first, slices);
+	return {
+		.data = data + begin * sliceAlignment,
+		.firstConstant = firstConstant + begin * (sliceAlignment / bytesPerConstant),
+		.slices = std::min(count, slices - begin),
+		.used = 0u
+	};
+}
+
+void ConstantRing::endFrame()
+{
+	immediateBlock_.reset();
+	retireCompletedFrames(false);
+
+	// Only wait if the GPU is so far behind that every fence is still outstanding
+	if (fences_[nextFence_].pending)
+	{
+		retireCompletedFrames(true);
+	}
+
+	auto& fence = fences_[nextFence_];
+	fence.frame = ring_.endFrame();
+	fence.pending = true;
+	context_->End(fence.query.Get());
+	nextFence_ = (nextFence_ + 1u) % fences_.size();
+}
+
+UploadRing::Statistics ConstantRing::getStatistics() const noexcept
+{
+	return ring_.getStatistics();
+}
+
+UINT ConstantRing::getCapacity() const noexcept
+{
+	return ring_.getCapacity();
+}
+
+void ConstantRing::retireCompletedFrames(bool wait) noexcept
+{
+	// Fences complete in submission order, so stop at the first one still in flight
+	for (size_t i = 0; i < fences_.size(); i++)
+	{
+		auto& fence = fences_[(nextFence_ + i) % fences_.size()];
+		if (!fence.pending)
+		{
+			continue;
+		}
+
+		BOOL done = FALSE;
+		while (context_->GetData(fence.query.Get(), &done, sizeof(done), wait ? 0u : D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_FALSE)
+		{
+			if (!wait)
+			{
+				return;
+			}
+		}
+		ring_.retire(fence.frame);
+		fence.pending = false;
+		// One free fence is all a waiting caller needs, pick up the rest without blocking
+		wait = false;
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <d3d11_1.h>
+#include <optional>
+#include <wrl/client.h>
+
+#include "UploadRing.hpp"
+
+// Large dynamic constant buffer that per-draw constants are sub-allocated from and bound with
+// *SetConstantBuffers1 offsets. Slices are written with MAP_WRITE_NO_OVERWRITE, so the driver never renames
+// the buffer; an event query per frame tells the UploadRing when a frame's slices may be overwritten.
+// Needs constant buffer offsetting (D3D11.1), check isSupported() first.
+class ConstantRing
+{
+public:
+	struct Slice
+	{
+		UINT firstConstant;
+		UINT numConstants;
+	};
+
+	// Run of slices mapped in one go for draws recorded on other threads. Each recording thread gets its own part
+	// and fills it without any driver calls; the memory stays mapped until unmapBlock().
+	struct Block
+	{
+		unsigned char* data;
+		UINT firstConstant;
+		UINT slices;
+		UINT used;
+
+		[[nodiscard]] Block part(UINT first, UINT count) const noexcept;
+	};
+
+	ConstantRing(ID3D11Device* device, ID3D11DeviceContext* context, UINT capacity = 256u * 1024u);
+
+	~ConstantRing() = default;
+	ConstantRing(const ConstantRing&) = delete;
+	ConstantRing& operator=(const ConstantRing&) = delete;
+	ConstantRing(const ConstantRing&&) = delete;
+	ConstantRing& operator=(const ConstantRing&&) = delete;
+
+	static bool isSupported(ID3D11Device* device) noexcept;
+	// Capacity that keeps drawsPerFrame single-slice draws from ever orphaning the buffer: the frame being
+	// recorded plus the frames DXGI lets the GPU queue behind it, within the largest buffer D3D11 allows
+	static UINT getCapacityFor(size_t drawsPerFrame) noexcept;
+
+	// Copy size bytes into the ring and return where they landed
+	Slice upload(const void* data, UINT size);
+	template<typename T>
+	Slice upload(const T& constants)
+	{
+		return upload(&constants, sizeof(T));
+	}
+
+	void bindVertex(UINT slot, const Slice& slice) const noexcept;
+	void bindPixel(UINT slot, const Slice& slice) const noexcept;
+
+	// Map room for one slice per recorded draw; nothing if the ring can't hold them all at once, in which case
+	// recorded draws fall back to renaming a shared buffer on their own context
+	[[nodiscard]] std::optional<Block> mapBlock(UINT slices);
+	// Unmap the block before the command lists that read it are executed
+	void unmapBlock() noexcept;
+	// Copy size bytes into the next free slice of block, nothing once it is full or for more than a slice
+	[[nodiscard]] static std::optional<Slice> upload(Block& block, const void* data, UINT size) noexcept;
+	// Bind on a recording thread's deferred context
+	void bindVertex(ID3D11DeviceContext1* context, UINT slot, const Slice& slice) const noexcept;
+	// Hand an unmapped block to the draws on the immediate context, which bind its filled slices in order with
+	// bindNextVertex() instead of mapping one each. It is dropped at endFrame().
+	void setImmediateBlock(const Block& block) noexcept;
+	// Bind the next slice of the immediate block; false once it is used up or there is none
+	[[nodiscard]] bool bindNextVertex(UINT slot) noexcept;
+
+	// Fence the frame that was just submitted and release the space of frames the GPU has finished
+	void endFrame();
+
+	[[nodiscard]] UploadRing::Statistics getStatistics() const noexcept;
+	[[nodiscard]] UINT getCapacity() const noexcept;
+private:
+	// D3D11.1 requires offsets and sizes to be multiples of 16 constants of 16 bytes
+	static constexpr UINT sliceAlignment = 256u;
+	static constexpr UINT bytesPerConstant = 16u;
+	// Frames whose fences may still be pending: DXGI's default maximum frame latency, the frame submitted since
+	// the last Present returned, and the frame being recorded
+	static constexpr UINT framesInFlight = 3u + 1u + 1u;
+
+	struct Fence
+	{
+		Microsoft::WRL::ComPtr<ID3D11Query> query;
+		unsigned long long frame;
+		bool pending;
+	};
+
+	void retireCompletedFrames(bool wait) noexcept;
+
+	UploadRing ring_;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context_;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer_;
+	std::array<Fence, 8> fences_;
+	size_t nextFence_ = 0u;
+	bool blockMapped_ = false;
+	std::optional<Block> immediateBlock_;
+};
@@ -1,54 +1,396 @@
 #include "CpuMetric.hpp"
 
-#pragma comment(lib, "winmm.lib")
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
-// Mostly based on code found in this stackoverflow post: https://stackoverflow.com/a/64166
+#ifdef _WIN32
+#include "AtumWindows.hpp"
+#include <Psapi.h>
+#else
+#include <cerrno>
+#include <cstdio>
+#include <charconv>
+#include <cstdlib>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
-void CpuMetric::initialize() {
-	SYSTEM_INFO systemInfo;
-	FILETIME fcreate, fexit, fsys, fuser;
+namespace
+{
+	struct RegisteredThread
+	{
+		std::string name;
+#ifdef _WIN32
+		HANDLE handle = nullptr;
+#endif
+	};
+
+	struct ThreadRegistry
+	{
+#ifdef _WIN32
+		~ThreadRegistry()
+		{
+			for (const auto& [id, thread] : threads)
+			{
+				CloseHandle(thread.handle);
+			}
+		}
+#endif
+		std::mutex mutex;
+		std::unordered_map<std::uint32_t, RegisteredThread> threads;
+	};
+
+	// Built on first use rather than as a static member, threads such as Logging register during static initialisation
+	ThreadRegistry& threadRegistry()
+	{
+		static ThreadRegistry registry;
+		return registry;
+	}
+
+	// A null name keeps the one the thread registered with
+	void registerCurrentThread(const char* name)
+	{
+		ThreadRegistry& registry = threadRegistry();
+		std::lock_guard lock(registry.mutex);
+		RegisteredThread& thread = registry.threads[CpuMetric::currentThreadId()];
+		if (name)
+		{
+			thread.name = name;
+		}
+#ifdef _WIN32
+		// A real handle, GetCurrentThread() only names the calling thread; it also replaces one left by an exited thread with the same id
+		HANDLE handle = nullptr;
+		if (DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &handle,
+			THREAD_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, 0u))
+		{
+			if (thread.handle)
+			{
+				CloseHandle(thread.handle);
+			}
+			thread.handle = handle;
+		}
+#endif
+	}
+
+#ifdef _WIN32
+	std::uint64_t nanoseconds(const FILETIME& time) noexcept
+	{
+		// FILETIMEs count 100 ns intervals
+		return (static_cast<std::uint64_t>(time.dwHighDateTime) << 32u | time.dwLowDateTime) * 100u;
+	}
+#else
+	std::uint64_t nanoseconds(const timespec& time) noexcept
+	{
+		return static_cast<std::uint64_t>(time.tv_sec) * 1000000000u + static_cast<std::uint64_t>(time.tv_nsec);
+	}
+
+	// The small /proc files are read whole into a buffer on the stack; the length, 0 when the file is gone
+	size_t readFile(const char* path, char* buffer, const size_t size) noexcept
+	{
+		const int file = open(path, O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+		{
+			return 0u;
+		}
+		size_t length = 0u;
+		while (length + 1u < size)
+		{
+			const ssize_t count = read(file, buffer + length, size - 1u - length);
+			if (count < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (count <= 0)
+			{
+				break;
+			}
+			length += static_cast<size_t>(count);
+		}
+		close(file);
+		buffer[length] = '\0';
+		return length;
+	}
+
+	std::uint64_t number(const std::string_view text) noexcept
+	{
+		std::uint64_t value = 0u;
+		std::from_chars(text.data(), text.data() + text.size(), value);
+		return value;
+	}
 
-	GetSystemInfo(&systemInfo);
-	numberOfProcessors_ = static_cast<int>(systemInfo.dwNumberOfProcessors);
+	// The value of a "name:\tvalue" line of a status file
+	std::optional<std::uint64_t> statusValue(const std::string_view status, const std::string_view name) noexcept
+	{
+		for (size_t position = status.find(name); position != std::string_view::npos; position = status.find(name, position + 1u))
+		{
+			if ((position == 0u || status[position - 1u] == '\n') && status.substr(position + name.size()).starts_with(':'))
+			{
+				const size_t value = status.find_first_not_of(" \t", position + name.size() + 1u);
+				return value == std::string_view::npos ? std::nullopt : std::optional(number(status.substr(value)));
+			}
+		}
+		return std::nullopt;
+	}
+#endif
+}
 
-	GetSystemTimeAsFileTime(&fexit);
-	memcpy(&lastCpu_, &fexit, sizeof(FILETIME));
+CpuMetric::CpuMetric(const std::chrono::milliseconds window)
+	:
+	window_(window)
+{}
 
-	currentProcess_ = GetCurrentProcess();
-	GetProcessTimes(currentProcess_, &fcreate, &fexit, &fsys, &fuser);
-	memcpy(&lastSysCpu_, &fsys, sizeof(FILETIME));
-	memcpy(&lastUserCpu_, &fuser, sizeof(FILETIME));
-	startTime_ = timeGetTime();
+void CpuMetric::initialize()
+{
+	mainThread_ = currentThreadId();
+	registerCurrentThread(nullptr);
+	sample_.processors = std::max(std::thread::hardware_concurrency(), 1u);
+	lastProcess_ = readProcess();
+	readThreads(lastThreads_);
+	windowStart_ = std::chrono::steady_clock::now();
+	frames_ = 0u;
 }
 
 void CpuMetric::frame()
 {
-	FILETIME fcreate, fexit, fsys, fuser;
-	ULARGE_INTEGER now, sys, user;
-
-	// Update once a second
-	if (timeGetTime() >= (startTime_ + 1000))
+	frames_++;
+	const auto now = std::chrono::steady_clock::now();
+	if (now - windowStart_ < window_)
 	{
-		GetSystemTimeAsFileTime(&fexit);
-		memcpy(&now, &fexit, sizeof(FILETIME));
+		return;
+	}
 
-		GetProcessTimes(currentProcess_, &fcreate, &fexit, &fsys, &fuser);
-		memcpy(&sys, &fsys, sizeof(FILETIME));
-		memcpy(&user, &fuser, sizeof(FILETIME));
-		double percent = static_cast<double>(
-			(sys.QuadPart - lastSysCpu_.QuadPart) +
-			(user.QuadPart - lastUserCpu_.QuadPart));
-		percent /= static_cast<double>(now.QuadPart - lastCpu_.QuadPart);
-		percent /= numberOfProcessors_;
-		cpuUsage_ = percent * 100;
-		lastCpu_ = now;
-		lastUserCpu_ = user;
-		lastSysCpu_ = sys;
-		startTime_ = timeGetTime();
+	const double windowSeconds = std::chrono::duration<double>(now - windowStart_).count();
+	const Counters process = readProcess();
+	readThreads(threads_);
+
+	sample_.windowSeconds = windowSeconds;
+	sample_.frames = frames_;
+	sample_.process = difference(process, lastProcess_, windowSeconds);
+	// Assigned in place rather than rebuilt, the names keep their buffers
+	sample_.threads.resize(threads_.size());
+	{
+		ThreadRegistry& registry = threadRegistry();
+		std::lock_guard lock(registry.mutex);
+		for (size_t i = 0; i < threads_.size(); i++)
+		{
+			const ThreadCounters& thread = threads_[i];
+			ThreadUsage& usage = sample_.threads[i];
+			// A thread that started during the window used all of its time in it
+			const auto last = std::ranges::find(lastThreads_, thread.id, &ThreadCounters::id);
+			static_cast<Usage&>(usage) = difference(thread.counters, last != lastThreads_.end() ? last->counters : Counters{}, windowSeconds);
+			usage.id = thread.id;
+			if (const auto registered = registry.threads.find(thread.id); registered != registry.threads.end() && !registered->second.name.empty())
+			{
+				usage.name = registered->second.name;
+			}
+			else
+			{
+				usage.name = thread.id == mainThread_ ? "Main" : thread.name;
+			}
+		}
 	}
+	std::ranges::sort(sample_.threads, [](const ThreadUsage& a, const ThreadUsage& b) { return a.utilization > b.utilization; });
+
+	lastProcess_ = process;
+	std::swap(lastThreads_, threads_);
+	windowStart_ = now;
+	frames_ = 0u;
 }
 
 double CpuMetric::getCpuPercentage() const
 {
-	return cpuUsage_;
+	return sample_.process.utilization * 100.0 / static_cast<double>(sample_.processors);
+}
+
+const CpuMetric::Sample& CpuMetric::getSample() const noexcept
+{
+	return sample_;
+}
+
+void CpuMetric::nameCurrentThread(const char* name)
+{
+	registerCurrentThread(name);
+#ifdef _WIN32
+	const std::string narrow(name);
+	SetThreadDescription(GetCurrentThread(), std::wstring(narrow.begin(), narrow.end()).c_str());
+#else
+	// Linux keeps 15 characters
+	pthread_setname_np(pthread_self(), std::string(name).substr(0u, 15u).c_str());
+#endif
+}
+
+CpuMetric::Usage CpuMetric::difference(const Counters& now, const Counters& before, const double windowSeconds) noexcept
+{
+	const auto count = [](const std::optional<std::uint64_t>& a, const std::optional<std::uint64_t>& b) -> std::optional<std::uint64_t>
+		{
+			if (!a)
+			{
+				return std::nullopt;
+			}
+			return *a - std::min(*a, b.value_or(0u));
+		};
+
+	Usage usage;
+	const std::uint64_t cpu = now.cpuNanoseconds - std::min(now.cpuNanoseconds, before.cpuNanoseconds);
+	usage.cpuMilliseconds = static_cast<double>(cpu) / 1e6;
+	usage.utilization = windowSeconds > 0.0 ? static_cast<double>(cpu) / 1e9 / windowSeconds : 0.0;
+	usage.voluntarySwitches = count(now.voluntarySwitches, before.voluntarySwitches);
+	usage.involuntarySwitches = count(now.involuntarySwitches, before.involuntarySwitches);
+	usage.pageFaults = count(now.pageFaults, before.pageFaults);
+	usage.majorFaults = count(now.majorFaults, before.majorFaults);
+	return usage;
+}
+
+#ifdef _WIN32
+std::uint32_t CpuMetric::currentThreadId() noexcept
+{
+	return GetCurrentThreadId();
+}
+
+CpuMetric::Counters CpuMetric::readProcess()
+{
+	Counters counters;
+	FILETIME creation, exit, kernel, user;
+	if (GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+	{
+		counters.cpuNanoseconds = nanoseconds(kernel) + nanoseconds(user);
+	}
+	PROCESS_MEMORY_COUNTERS memory = {};
+	if (K32GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory)))
+	{
+		counters.pageFaults = memory.PageFaultCount;
+	}
+	return counters;
+}
+
+void CpuMetric::readThreads(std::vector<ThreadCounters>& threads)
+{
+	threads.clear();
+	ThreadRegistry& registry = threadRegistry();
+	std::lock_guard lock(registry.mutex);
+	for (auto registered = registry.threads.begin(); registered != registry.threads.end();)
+	{
+		const HANDLE handle = registered->second.handle;
+		// Signalled once the thread has exited; its handle goes with it
+		if (handle && WaitForSingleObject(handle, 0u) == WAIT_OBJECT_0)
+		{
+			CloseHandle(handle);
+			registered = registry.threads.erase(registered);
+			continue;
+		}
+		FILETIME creation, exit, kernel, user;
+		if (handle && GetThreadTimes(handle, &creation, &exit, &kernel, &user))
+		{
+			ThreadCounters& counted = threads.emplace_back();
+			counted.id = registered->first;
+			counted.counters.cpuNanoseconds = nanoseconds(kernel) + nanoseconds(user);
+		}
+		++registered;
+	}
+}
+#else
+std::uint32_t CpuMetric::currentThreadId() noexcept
+{
+	return static_cast<std::uint32_t>(syscall(SYS_gettid));
+}
+
+CpuMetric::Counters CpuMetric::readProcess()
+{
+	Counters counters;
+	timespec time;
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) == 0)
+	{
+		counters.cpuNanoseconds = nanoseconds(time);
+	}
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		counters.voluntarySwitches = static_cast<std::uint64_t>(usage.ru_nvcsw);
+		counters.involuntarySwitches = static_cast<std::uint64_t>(usage.ru_nivcsw);
+		counters.pageFaults = static_cast<std::uint64_t>(usage.ru_minflt) + static_cast<std::uint64_t>(usage.ru_majflt);
+		counters.majorFaults = static_cast<std::uint64_t>(usage.ru_majflt);
+	}
+	return counters;
+}
+
+void CpuMetric::readThreads(std::vector<ThreadCounters>& threads)
+{
+	threads.clear();
+	DIR* tasks = opendir("/proc/self/task");
+	if (!tasks)
+	{
+		return;
+	}
+	char path[64];
+	char buffer[2048];
+	while (const dirent* task = readdir(tasks))
+	{
+		char* end = nullptr;
+		const unsigned long id = std::strtoul(task->d_name, &end, 10);
+		if (end == task->d_name || *end != '\0')
+		{
+			continue;
+		}
+
+		// Any thread of the process has a CPU clock with this id, the encoding glibc's pthread_getcpuclockid uses
+		const clockid_t clock = static_cast<clockid_t>(~static_cast<unsigned int>(id) << 3u | 6u);
+		timespec time;
+		if (clock_gettime(clock, &time) != 0)
+		{
+			continue;
+		}
+		ThreadCounters thread;
+		thread.id = static_cast<std::uint32_t>(id);
+		thread.counters.cpuNanoseconds = nanoseconds(time);
+
+		// Fields after the name in brackets, which may itself hold spaces: minflt is the 8th, majflt the 10th
+		std::snprintf(path, sizeof(path), "/proc/self/task/%lu/stat", id);
+		const std::string_view stat(buffer, readFile(path, buffer, sizeof(buffer)));
+		if (const size_t close = stat.rfind(')'); close != std::string_view::npos)
+		{
+			std::string_view fields = stat.substr(close + 2u);
+			std::uint64_t minor = 0u;
+			std::uint64_t major = 0u;
+			for (int field = 0; field < 10 && !fields.empty(); field++)
+			{
+				const size_t space = fields.find(' ');
+				const std::string_view value = fields.substr(0u, space);
+				if (field == 7)
+				{
+					minor = number(value);
+				}
+				else if (field == 9)
+				{
+					major = number(value);
+				}
+				fields = space == std::string_view::npos ? std::string_view() : fields.substr(space + 1u);
+			}
+			thread.counters.pageFaults = minor + major;
+			thread.counters.majorFaults = major;
+		}
+
+		std::snprintf(path, sizeof(path), "/proc/self/task/%lu/status", id);
+		const std::string_view status(buffer, readFile(path, buffer, sizeof(buffer)));
+		thread.counters.voluntarySwitches = statusValue(status, "voluntary_ctxt_switches");
+		thread.counters.involuntarySwitches = statusValue(status, "nonvoluntary_ctxt_switches");
+
+		std::snprintf(path, sizeof(path), "/proc/self/task/%lu/comm", id);
+		std::string_view name(buffer, readFile(path, buffer, sizeof(buffer)));
+		if (name.ends_with('\n'))
+		{
+			name.remove_suffix(1u);
+		}
+		thread.name = name;
+		threads.push_back(std::move(thread));
+	}
+	closedir(tasks);
 }
+#endif
@@ -1,24 +1,101 @@
 #pragma once
-#include "AtumWindows.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
 
+// Process and per-thread CPU use, over windows of a fixed length so the numbers settle. frame() is called once a
+// frame and only reads the clock until the window is over; then it reads the counters of the process and of every
+// one of its threads and works out what each used during the window.
+//
+// On Windows only the app's own threads are read, the ones named through nameCurrentThread and the one that called
+// initialize(), each through a handle kept when it registered; threads the driver or runtime start are not listed.
+// Their times come from GetThreadTimes. Windows keeps no per thread context switch or page fault counts, and no
+// process context switch count, so those stay empty there. On Linux the threads come from /proc/self/task, their
+// time from their CPU clocks, and their switches and faults from their stat and status files.
 class CpuMetric
 {
 public:
-	CpuMetric() = default;
+	struct Usage
+	{
+		// CPU time over the window as a fraction of one core
+		double utilization = 0.0;
+		double cpuMilliseconds = 0.0;
+		// Counts over the window, empty where the platform does not keep them
+		std::optional<std::uint64_t> voluntarySwitches;
+		std::optional<std::uint64_t> involuntarySwitches;
+		std::optional<std::uint64_t> pageFaults;
+		// The page faults that had to wait for the disk
+		std::optional<std::uint64_t> majorFaults;
+	};
+
+	struct ThreadUsage : Usage
+	{
+		std::uint32_t id = 0u;
+		std::string name;
+	};
+
+	struct Sample
+	{
+		double windowSeconds = 0.0;
+		unsigned int frames = 0u;
+		unsigned int processors = 1u;
+		Usage process;
+		// Busiest first
+		std::vector<ThreadUsage> threads;
+	};
+
+public:
+	explicit CpuMetric(std::chrono::milliseconds window = std::chrono::milliseconds(500));
 	~CpuMetric() = default;
 	CpuMetric(const CpuMetric&) = delete;
 	CpuMetric& operator=(const CpuMetric&) = delete;
 	CpuMetric(const CpuMetric&&) = delete;
 	CpuMetric& operator=(const CpuMetric&&) = delete;
 
+	// From the thread that calls frame(), which the breakdown calls Main unless it has a name
 	void initialize();
 	void frame();
+	// Process CPU time over the last window as a percentage of all cores
 	[[nodiscard]] double getCpuPercentage() const;
+	[[nodiscard]] const Sample& getSample() const noexcept;
+
+	// Name the calling thread for the breakdown and for debuggers
+	static void nameCurrentThread(const char* name);
+	[[nodiscard]] static std::uint32_t currentThreadId() noexcept;
 
 private:
-	unsigned long startTime_;
-	ULARGE_INTEGER lastCpu_, lastSysCpu_, lastUserCpu_;
-	int numberOfProcessors_;
-	HANDLE currentProcess_;
-	double cpuUsage_;
+	// Raw counters, totals since the process or thread started
+	struct Counters
+	{
+		std::uint64_t cpuNanoseconds = 0u;
+		std::optional<std::uint64_t> voluntarySwitches;
+		std::optional<std::uint64_t> involuntarySwitches;
+		std::optional<std::uint64_t> pageFaults;
+		std::optional<std::uint64_t> majorFaults;
+	};
+
+	struct ThreadCounters
+	{
+		std::uint32_t id = 0u;
+		std::string name;
+		Counters counters;
+	};
+
+	[[nodiscard]] static Counters readProcess();
+	// The threads of the process, on Windows the registered ones; threads that have exited are left out
+	static void readThreads(std::vector<ThreadCounters>& threads);
+
+	static Usage difference(const Counters& now, const Counters& before, double windowSeconds) noexcept;
+
+	std::chrono::steady_clock::duration window_;
+	std::chrono::steady_clock::time_point windowStart_;
+	unsigned int frames_ = 0u;
+	std::uint32_t mainThread_ = 0u;
+	Counters lastProcess_;
+	// The two readings swap each window, so steady frames reuse their storage
+	std::vector<ThreadCounters> lastThreads_;
+	std::vector<ThreadCounters> threads_;
+	Sample sample_;
 };
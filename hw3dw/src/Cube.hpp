@@ -1,19 +1,40 @@
 #pragma once
 
+#include <algorithm>
+#include <span>
+
 #include "IndexedTriangleList.hpp"
 #include "DirectXMath.h"
+#include "MeshLayout.hpp"
 
 class Cube
 {
 public:
 	template<class V>
 	static IndexedTriangleList<V> make()
+	{
+		const MeshLayout layout = getLayout();
+		MeshVector<V> vertices(layout.vertexCount);
+		MeshVector<unsigned short> indices(layout.indexCount);
+		write<V>(std::span(vertices), std::span(indices));
+		return IndexedTriangleList<V>{ std::move(vertices), std::move(indices) };
+	}
+
+	[[nodiscard]] static constexpr MeshLayout getLayout() noexcept
+	{
+		return { 8u, 36u };
+	}
+
+	// Write the cube into storage sized by getLayout (a mapped upload buffer, say). Only positions are written.
+	template<class V, class I = unsigned short>
+	static void write(std::span<V> vertices, std::span<I> indices)
 	{
 		namespace dx = DirectX;
+		assert(vertices.size() == getLayout().vertexCount && indices.size() == getLayout().indexCount);
 
 		constexpr float side = 1.0f / 2.0f;
 
-		std::vector<dx::XMFLOAT3> vertices = {
+		constexpr dx::XMFLOAT3 positions[] = {
 			//    6-------7
 			//   /|      /|
 			//  2-------3 |
@@ -32,44 +53,69 @@ public:
 			{side, side, side},	// Top-right-back vertex
 		};
 
-		std::vector<V> indices(vertices.size());
-		for (size_t i = 0; i < vertices.size(); i++)
+		for (size_t i = 0; i < std::size(positions); i++)
 		{
-			indices[i].pos = vertices[i];
+			vertices[i].pos = positions[i];
 		}
 
-		return IndexedTriangleList<V>{
-			std::move(indices), {
-				//         2------6
-				//         | 4  //|
-				//	       |  //  |
-				//	       |//  5 |
-				//  2------3------7------6------2
-				//  |\\  1 |\\  3 |\\  7 | 9  //|
-				//  |  \\  |  \\  |  \\  |  //  |
-				//  | 0  \\| 2  \\| 6  \\|//  8 |
-				//  0------1------5------4------0
-				//         |\\ 11 |
-				//	       |  \\  |
-				//	       | 10 \\|
-				//	       0------4
-
-				0, 2, 1,   2, 3, 1, // Front
-				1, 3, 5,   3, 7, 5, // Right
-				2, 6, 3,   3, 6, 7, // Top
-				4, 5, 7,   4, 7, 6, // Back
-				0, 4, 2,   2, 4, 6, // Left
-				0, 1, 4,   1, 5, 4, // Bottom
-			}
+		constexpr I cubeIndices[] = {
+			//         2------6
+			//         | 4  //|
+			//	       |  //  |
+			//	       |//  5 |
+			//  2------3------7------6------2
+			//  |\\  1 |\\  3 |\\  7 | 9  //|
+			//  |  \\  |  \\  |  \\  |  //  |
+			//  | 0  \\| 2  \\| 6  \\|//  8 |
+			//  0------1------5------4------0
+			//         |\\ 11 |
+			//	       |  \\  |
+			//	       | 10 \\|
+			//	       0------4
+
+			0, 2, 1,   2, 3, 1, // Front
+			1, 3, 5,   3, 7, 5, // Right
+			2, 6, 3,   3, 6, 7, // Top
+			4, 5, 7,   4, 7, 6, // Back
+			0, 4, 2,   2, 4, 6, // Left
+			0, 1, 4,   1, 5, 4, // Bottom
 		};
+		std::copy(std::begin(cubeIndices), std::end(cubeIndices), indices.begin());
 	}
 
 	template<class V>
 	static IndexedTriangleList<V> makeSkinned()
 	{
+		const MeshLayout layout = getSkinnedLayout();
+		MeshVector<V> vertices(layout.vertexCount);
+		MeshVector<unsigned short> indices(layout.indexCount);
+		writeSkinned<V>(std::span(vertices), std::span(indices));
+		return IndexedTriangleList<V>{ std::move(vertices), std::move(indices) };
+	}
+
+	[[nodiscard]] static constexpr MeshLayout getSkinnedLayout() noexcept
+	{
+		return { 14u, 36u };
+	}
+
+	// Write the skinned cube into storage sized by getSkinnedLayout. Positions and texture coordinates are written.
+	template<class V, class I = unsigned short>
+	static void writeSkinned(std::span<V> vertices, std::span<I> indices)
+	{
+		assert(vertices.size() == getSkinnedLayout().vertexCount && indices.size() == getSkinnedLayout().indexCount);
+
 		constexpr float side = 1.0f / 2.0f;
 
-		std::vector<V> vertices = {
+		struct Corner
+		{
+			DirectX::XMFLOAT3 pos;
+			struct
+			{
+				float u;
+				float v;
+			} tex;
+		};
+		constexpr Corner corners[] = {
 			//    6-------7
 			//   /|      /|
 			//  2-------3 |
@@ -133,35 +179,41 @@ public:
 			{{-side, side, side},	{4.0f / 4.0f, 1.0f / 3.0f}},
 		};
 
-		return{
-			std::move(vertices),{
-				//         6------7
-				//         |M\   P|
-				//	       | 4\\5 |
-				//	       |N   \O|
-				//  9------2------3-----11-----13
-				//  |E\   H|A\   D|I\   L|U\   X|
-				//  | 0\\1 | 2\\3 | 6\\7 | 9\\8 |
-				//  |F   \G|B   \C|J   \K|V   \W|
-				//  8------0------1-----10-----12
-				//         |Q\   T|
-				//	       |10\\11|
-				//	       |R   \S|
-				//	       4------5
-
-				// Front
-				0, 2, 1,		2, 3, 1,
-				// Bottom
-				4, 0, 5,		0, 1, 5,
-				// Top
-				2, 6, 3,		6, 7, 3,
-				// Left
-				8, 9, 0,		9, 2, 0,
-				// Right
-				1, 3, 10,		3, 11, 10,
-				// Back
-				10, 11, 12,		11, 13, 12
-			}
+		for (size_t i = 0; i < std::size(corners); i++)
+		{
+			vertices[i].pos = corners[i].pos;
+			vertices[i].tex.u = corners[i].tex.u;
+			vertices[i].tex.v = corners[i].tex.v;
+		}
+
+		constexpr I cubeIndices[] = {
+			//         6------7
+			//         |M\   P|
+			//	       | 4\\5 |
+			//	       |N   \O|
+			//  9------2------3-----11-----13
+			//  |E\   H|A\   D|I\   L|U\   X|
+			//  | 0\\1 | 2\\3 | 6\\7 | 9\\8 |
+			//  |F   \G|B   \C|J   \K|V   \W|
+			//  8------0------1-----10-----12
+			//         |Q\   T|
+			//	       |10\\11|
+			//	       |R   \S|
+			//	       4------5
+
+			// Front
+			0, 2, 1,		2, 3, 1,
+			// Bottom
+			4, 0, 5,		0, 1, 5,
+			// Top
+			2, 6, 3,		6, 7, 3,
+			// Left
+			8, 9, 0,		9, 2, 0,
+			// Right
+			1, 3, 10,		3, 11, 10,
+			// Back
+			10, 11, 12,		11, 13, 12
 		};
+		std::copy(std::begin(cubeIndices), std::end(cubeIndices), indices.begin());
 	}
 };
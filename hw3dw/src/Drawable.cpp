@@ -1,47 +1,73 @@
 #include "Drawable.hpp"
 
-#include <regex>
-
 #include "IndexBuffer.hpp"
-#include "Logging.hpp"
+
+Drawable::~Drawable()
+{
+	binds_.clear();
+}
 
 void Drawable::draw(Graphics& graphics) const noexcept(!IS_DEBUG)
 {
-	for (auto& bindable : binds_)
+	draw(graphics, true);
+}
+
+void Drawable::submit(RenderQueue& queue, const Graphics& graphics) const noexcept(!IS_DEBUG)
+{
+	const auto viewPosition = DirectX::XMVector3Transform(DirectX::XMVectorZero(), getRenderTransformXm() * graphics.getCamera()->getView());
+	// Drawables with their own mesh get told apart by index buffer, shared meshes all land on the same id
+	queue.push(RenderQueue::makeKey(getPass(), getMaterialId(), indexBuffer_->getMeshId(), DirectX::XMVectorGetZ(viewPosition)), this);
+}
+
+void Drawable::drawPackets(Graphics& graphics, const std::span<const RenderQueue::Packet> packets) noexcept(!IS_DEBUG)
+{
+	const BindSet* boundStatics = nullptr;
+	for (const auto& packet : packets)
 	{
-		bindable->bind(graphics);
+		const auto& drawable = *packet.drawable;
+		const BindSet* statics = &drawable.getStaticBinds();
+		drawable.draw(graphics, statics != boundStatics);
+		boundStatics = statics;
 	}
-	for (auto& bindable : getStaticBinds())
+}
+
+RenderQueue::Pass Drawable::getPass() const noexcept
+{
+	return RenderQueue::Pass::Opaque;
+}
+
+void Drawable::rasterize(SoftwareRasterizer& rasterizer, DirectX::FXMMATRIX viewProjection) const
+{
+	const auto* mesh = getSoftwareMesh();
+	const auto* material = getSoftwareMaterial();
+	if (mesh != nullptr && material != nullptr)
 	{
-		bindable->bind(graphics);
+		rasterizer.draw(*mesh, *material, getRenderTransformXm() * viewProjection);
 	}
-	graphics.drawIndexed(indexBuffer_->getCount());
 }
 
-static std::string cleanTypeName(const std::string& typeName) {
-	// Regular expression to match the core type and strip out unnecessary parts
-	const std::regex re(R"((.+?)(?=<struct))");
-	if (std::smatch match; std::regex_search(typeName, match, re)) {
-		return match.str();
-	}
-	return typeName;
+std::uint16_t Drawable::nextMaterialId() noexcept
+{
+	static std::uint16_t next = 0u;
+	return next++;
 }
 
-void Drawable::addBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG)
+const SoftwareRasterizer::Mesh* Drawable::getSoftwareMesh() const noexcept
 {
-#ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "binding " << cleanTypeName(typeid(*bind).name());
-#endif
-	assert("*Must* use addIndexBuffer or add_static_index_buffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer));
-	binds_.push_back(std::move(bind));
+	return nullptr;
 }
 
-void Drawable::addIndexBuffer(std::unique_ptr<IndexBuffer> indexBuffer) noexcept
+const SoftwareRasterizer::Material* Drawable::getSoftwareMaterial() const noexcept
 {
-#ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "index buffer";
-#endif
-	assert("Attempting to add index buffer a second time" && indexBuffer_ == nullptr);
-	indexBuffer_ = indexBuffer.get();
-	binds_.push_back(std::move(indexBuffer));
+	return nullptr;
+}
+
+void Drawable::draw(Graphics& graphics, const bool bindStatic) const noexcept(!IS_DEBUG)
+{
+	binds_.bind(graphics);
+	if (bindStatic)
+	{
+		getStaticBinds().bind(graphics);
+	}
+	graphics.drawIndexed(indexBuffer_->getCount());
 }
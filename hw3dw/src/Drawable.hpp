@@ -1,35 +1,65 @@
 #pragma once
+#include "BindSet.hpp"
 #include "Graphics.hpp"
+#include "RenderQueue.hpp"
+#include "SceneObject.hpp"
+#include "SoftwareRasterizer.hpp"
 #include <DirectXMath.h>
+#include <span>
 
 class IndexBuffer;
 class Bindable;
 
-class Drawable
+class Drawable : public SceneObject
 {
 	template<class T>
 	friend class DrawableStaticStorage;
 
 public:
 	Drawable() = default;
-	virtual ~Drawable() = default;
+	virtual ~Drawable();
 	Drawable(const Drawable&) = delete;
 	Drawable& operator=(const Drawable&) = delete;
 	Drawable(const Drawable&&) = delete;
 	Drawable& operator=(const Drawable&&) = delete;
 
-	virtual DirectX::XMMATRIX getTransformXm() const noexcept = 0;
 	void draw(Graphics& graphics) const noexcept(!IS_DEBUG);
-	virtual void update(float dt) noexcept = 0;
+
+	// Queue this drawable keyed by its state and view depth instead of drawing it right away
+	void submit(RenderQueue& queue, const Graphics& graphics) const noexcept(!IS_DEBUG);
+	// Draw sorted packets in order, skipping the static binds a packet shares with the one before it
+	static void drawPackets(Graphics& graphics, std::span<const RenderQueue::Packet> packets) noexcept(!IS_DEBUG);
+	virtual RenderQueue::Pass getPass() const noexcept;
+	// Queue this drawable on the software rasterizer, drawables without a CPU copy of their geometry are skipped
+	void rasterize(SoftwareRasterizer& rasterizer, DirectX::FXMMATRIX viewProjection) const;
 
 protected:
-	virtual void addBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG);
-	virtual void addIndexBuffer(std::unique_ptr<IndexBuffer> indexBuffer) noexcept;
+	template<class T, class... Args>
+	T& addBind(Args&&... args)
+	{
+		static_assert(!std::is_same_v<T, IndexBuffer>, "*Must* use addIndexBuffer or addStaticIndexBuffer to bind index buffer");
+		return binds_.add<T>(std::forward<Args>(args)...);
+	}
+
+	template<class... Args>
+	void addIndexBuffer(Args&&... args) noexcept(!IS_DEBUG)
+	{
+		assert("Attempting to add index buffer a second time" && indexBuffer_ == nullptr);
+		indexBuffer_ = &binds_.add<IndexBuffer>(std::forward<Args>(args)...);
+	}
+
+	static std::uint16_t nextMaterialId() noexcept;
 
 private:
-	virtual const std::vector<std::unique_ptr<Bindable>>& getStaticBinds() const noexcept = 0;
+	void draw(Graphics& graphics, bool bindStatic) const noexcept(!IS_DEBUG);
+	virtual const BindSet& getStaticBinds() const noexcept = 0;
+	// Identifies the static bind set, so every drawable of a type shares one material
+	virtual std::uint16_t getMaterialId() const noexcept = 0;
+	// CPU copies of what the binds upload, for the software rasterizer
+	virtual const SoftwareRasterizer::Mesh* getSoftwareMesh() const noexcept;
+	virtual const SoftwareRasterizer::Material* getSoftwareMaterial() const noexcept;
 
 private:
 	const IndexBuffer* indexBuffer_ = nullptr;
-	std::vector<std::unique_ptr<Bindable>> binds_;
+	BindSet binds_;
 };
@@ -1,5 +1,5 @@
 #pragma once
-#include <regex>
+#include <optional>
 
 #include "Drawable.hpp"
 #include "IndexBuffer.hpp"
@@ -18,59 +18,75 @@ public:
 
 	static bool isStaticInitialized() noexcept
 	{
-		return !staticBinds_.empty();
+		return staticBinds_.size() > 0u;
 	}
 
-	static std::string cleanTypeName(const std::string& typeName) {
-		// Regular expression to match the core type and strip out unnecessary parts
-		const std::regex re(R"((.+?)(?=<struct))");
-		if (std::smatch match; std::regex_search(typeName, match, re)) {
-			return match.str();
-		}
-		return typeName;
-	}
-
-	static void addStaticBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG)
+	template<class T, class... Args>
+	static T& addStaticBind(Args&&... args)
 	{
-#ifdef LOG_GRAPHICS_CALLS
-		PLOGV << "binding " << cleanTypeName(typeid(*bind).name());
-#endif
-		assert("*Must* use add_index_buffer or addStaticIndexBuffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer));
-		staticBinds_.push_back(std::move(bind));
+		static_assert(!std::is_same_v<T, IndexBuffer>, "*Must* use addIndexBuffer or addStaticIndexBuffer to bind index buffer");
+		return staticBinds_.add<T>(std::forward<Args>(args)...);
 	}
 
-	void addStaticIndexBuffer(std::unique_ptr<IndexBuffer> indexBuffer) noexcept(!IS_DEBUG)
+	template<class... Args>
+	void addStaticIndexBuffer(Args&&... args) noexcept(!IS_DEBUG)
 	{
 #ifdef LOG_GRAPHICS_CALLS
 		PLOGV << "index buffer";
 #endif
 		assert("Attempting to add index buffer a second time" && indexBuffer_ == nullptr);
-		indexBuffer_ = indexBuffer.get();
-		staticBinds_.push_back(std::move(indexBuffer));
+		indexBuffer_ = &staticBinds_.add<IndexBuffer>(std::forward<Args>(args)...);
+	}
+
+	static void setStaticSoftwareMesh(SoftwareRasterizer::Mesh mesh)
+	{
+		softwareMesh_ = std::move(mesh);
+	}
+
+	static void setStaticSoftwareMaterial(SoftwareRasterizer::Material material)
+	{
+		softwareMaterial_ = std::move(material);
 	}
 
 	void setIndexBufferFromStaticBinds() noexcept(!IS_DEBUG)
 	{
 		assert("Attempting to add index buffer a second time" && indexBuffer_ == nullptr);
-		for (const auto& bind : staticBinds_)
-		{
-			if (const auto indexBuffer = dynamic_cast<IndexBuffer*>(bind.get()))
-			{
-				indexBuffer_ = indexBuffer;
-				return;
-			}
-		}
+		indexBuffer_ = staticBinds_.find<IndexBuffer>();
 	}
 
 private:
-	const std::vector<std::unique_ptr<Bindable>>& getStaticBinds() const noexcept override
+	const BindSet& getStaticBinds() const noexcept override
 	{
 		return staticBinds_;
 	}
 
+	std::uint16_t getMaterialId() const noexcept override
+	{
+		static const std::uint16_t materialId = nextMaterialId();
+		return materialId;
+	}
+
+	const SoftwareRasterizer::Mesh* getSoftwareMesh() const noexcept override
+	{
+		return softwareMesh_ ? &*softwareMesh_ : nullptr;
+	}
+
+	const SoftwareRasterizer::Material* getSoftwareMaterial() const noexcept override
+	{
+		return softwareMaterial_ ? &*softwareMaterial_ : nullptr;
+	}
+
 private:
-	static std::vector<std::unique_ptr<Bindable>> staticBinds_;
+	static BindSet staticBinds_;
+	static std::optional<SoftwareRasterizer::Mesh> softwareMesh_;
+	static std::optional<SoftwareRasterizer::Material> softwareMaterial_;
 };
 
 template<class T>
-std::vector<std::unique_ptr<Bindable>> DrawableStaticStorage<T>::staticBinds_;
+BindSet DrawableStaticStorage<T>::staticBinds_;
+
+template<class T>
+std::optional<SoftwareRasterizer::Mesh> DrawableStaticStorage<T>::softwareMesh_;
+
+template<class T>
+std::optional<SoftwareRasterizer::Material> DrawableStaticStorage<T>::softwareMaterial_;
@@ -0,0 +1,173 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Fixed capacity single producer, single consumer queue for input events that never allocates or blocks. When it
+// is full a push overwrites the oldest event, the same as trimming a queue back to its capacity.
+//
+// The producer and the consumer may run on different threads. The producer never looks at the read index: it
+// writes its slot and moves on, so a slow consumer can not hold it up. Every slot carries a sequence number,
+// odd while the producer writes it and tied to the event's index once written, and the consumer checks it before
+// and after copying an event out (a seqlock per slot). An event the producer overwrote before or during the copy
+// fails the check and counts as dropped. Slots are stored as relaxed atomic words, so neither side needs a locked
+// instruction and a copy racing a write is well defined.
+template<class T, size_t Capacity>
+class EventRing
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Events are copied as raw words");
+	static_assert(Capacity > 0u && (Capacity & (Capacity - 1u)) == 0u, "Capacity must be a power of two");
+
+public:
+	EventRing() = default;
+	~EventRing() = default;
+	EventRing(const EventRing&) = delete;
+	EventRing& operator=(const EventRing&) = delete;
+	EventRing(const EventRing&&) = delete;
+	EventRing& operator=(const EventRing&&) = delete;
+
+	// Producer side
+	void push(const T& event) noexcept
+	{
+		const size_t tail = tail_.load(std::memory_order_relaxed);
+		Slot& slot = slots_[tail & mask];
+		Words words{};
+		std::memcpy(words.data(), &event, sizeof(T));
+
+		slot.sequence.store(writingSequence(tail), std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t i = 0; i < wordCount; i++)
+		{
+			slot.words[i].store(words[i], std::memory_order_relaxed);
+		}
+		slot.sequence.store(writtenSequence(tail), std::memory_order_release);
+		tail_.store(tail + 1u, std::memory_order_release);
+	}
+
+	// Consumer side
+	std::optional<T> pop() noexcept
+	{
+		const size_t tail = tail_.load(std::memory_order_acquire);
+		size_t head = skipOverwritten(tail);
+		std::optional<T> event;
+		while (head != tail && !event)
+		{
+			event = read(head++);
+		}
+		head_.store(head, std::memory_order_release);
+		return event;
+	}
+
+	// Hand every queued event to consume(const T&) oldest first and return how many there were
+	template<class F>
+	size_t drain(F&& consume) noexcept(noexcept(consume(std::declval<const T&>())))
+	{
+		const size_t tail = tail_.load(std::memory_order_acquire);
+		size_t consumed = 0u;
+		for (size_t index = skipOverwritten(tail); index != tail; index++)
+		{
+			if (const auto event = read(index))
+			{
+				consume(*event);
+				consumed++;
+			}
+		}
+		head_.store(tail, std::memory_order_release);
+		return consumed;
+	}
+
+	// Consumer side
+	void clear() noexcept
+	{
+		head_.store(tail_.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+	[[nodiscard]] bool isEmpty() const noexcept
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+	[[nodiscard]] size_t size() const noexcept
+	{
+		const size_t head = head_.load(std::memory_order_acquire);
+		const size_t tail = tail_.load(std::memory_order_acquire);
+		return tail - head < Capacity ? tail - head : Capacity;
+	}
+
+	// Events the consumer found overwritten before it got to them
+	[[nodiscard]] unsigned long long getOverwritten() const noexcept
+	{
+		return overwritten_.load(std::memory_order_relaxed);
+	}
+
+	static constexpr size_t capacity() noexcept
+	{
+		return Capacity;
+	}
+
+private:
+	static constexpr size_t mask = Capacity - 1u;
+	static constexpr size_t wordCount = (sizeof(T) + sizeof(std::uint64_t) - 1u) / sizeof(std::uint64_t);
+	using Words = std::array<std::uint64_t, wordCount>;
+
+	struct Slot
+	{
+		std::atomic<std::uint64_t> sequence{ 0u };
+		std::array<std::atomic<std::uint64_t>, wordCount> words{};
+	};
+
+	static constexpr std::uint64_t writingSequence(const size_t index) noexcept
+	{
+		return 2u * static_cast<std::uint64_t>(index) + 1u;
+	}
+
+	static constexpr std::uint64_t writtenSequence(const size_t index) noexcept
+	{
+		return 2u * static_cast<std::uint64_t>(index) + 2u;
+	}
+
+	// Move the read index up to the oldest event the producer can not have overwritten yet
+	size_t skipOverwritten(const size_t tail) noexcept
+	{
+		const size_t head = head_.load(std::memory_order_relaxed);
+		if (tail - head <= Capacity)
+		{
+			return head;
+		}
+		overwritten_.fetch_add(tail - Capacity - head, std::memory_order_relaxed);
+		return tail - Capacity;
+	}
+
+	std::optional<T> read(const size_t index) noexcept
+	{
+		const Slot& slot = slots_[index & mask];
+		const std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+		Words words;
+		for (size_t i = 0; i < wordCount; i++)
+		{
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (before != writtenSequence(index) || slot.sequence.load(std::memory_order_relaxed) != before)
+		{
+			overwritten_.fetch_add(1u, std::memory_order_relaxed);
+			return std::nullopt;
+		}
+
+		std::array<std::byte, sizeof(T)> bytes;
+		std::memcpy(bytes.data(), words.data(), sizeof(T));
+		return std::bit_cast<T>(bytes);
+	}
+
+	std::array<Slot, Capacity> slots_{};
+	// Read and write ends on their own cache lines
+	alignas(64) std::atomic<size_t> head_{ 0u };
+	std::atomic<unsigned long long> overwritten_{ 0ull };
+	alignas(64) std::atomic<size_t> tail_{ 0u };
+};
@@ -0,0 +1,53 @@
+#include "FixedTimestep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(const float tickRate, const unsigned int maxTicksPerFrame) noexcept
+	:
+	step_(tickRate > 0.0f ? 1.0 / static_cast<double>(tickRate) : 0.0),
+	maxTicksPerFrame_(std::max(maxTicksPerFrame, 1u))
+{}
+
+unsigned int FixedTimestep::advance(const float frameSeconds) noexcept
+{
+	if (step_ == 0.0)
+	{
+		variableStep_ = frameSeconds;
+		tickCount_++;
+		return 1u;
+	}
+
+	accumulator_ += static_cast<double>(std::max(frameSeconds, 0.0f));
+	auto ticks = static_cast<unsigned int>(std::min(accumulator_ / step_, static_cast<double>(maxTicksPerFrame_)));
+	accumulator_ -= static_cast<double>(ticks) * step_;
+	if (ticks == maxTicksPerFrame_ && accumulator_ >= step_)
+	{
+		// Keep the fraction so interpolation stays continuous, drop the whole ticks that did not fit
+		const double excess = accumulator_ - std::fmod(accumulator_, step_);
+		droppedSeconds_ += excess;
+		accumulator_ -= excess;
+	}
+	tickCount_ += ticks;
+	return ticks;
+}
+
+float FixedTimestep::getStep() const noexcept
+{
+	return step_ == 0.0 ? variableStep_ : static_cast<float>(step_);
+}
+
+float FixedTimestep::getAlpha() const noexcept
+{
+	return step_ == 0.0 ? 1.0f : static_cast<float>(std::clamp(accumulator_ / step_, 0.0, 1.0));
+}
+
+unsigned long long FixedTimestep::getTickCount() const noexcept
+{
+	return tickCount_;
+}
+
+double FixedTimestep::getDroppedSeconds() const noexcept
+{
+	return droppedSeconds_;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Accumulator for running the simulation at a fixed rate independent of the frame rate. Each frame adds its
+// duration and gets back the number of fixed ticks to simulate; what is left over becomes the interpolation
+// factor between the last two simulated states. At most maxTicksPerFrame ticks run per frame, time beyond
+// that is dropped so one long frame can not snowball into ever longer catch-up frames.
+//
+// A tick rate of 0 turns the accumulator off: every frame is one tick of the frame's own duration.
+class FixedTimestep
+{
+public:
+	FixedTimestep(float tickRate, unsigned int maxTicksPerFrame) noexcept;
+	~FixedTimestep() = default;
+	FixedTimestep(const FixedTimestep&) = delete;
+	FixedTimestep& operator=(const FixedTimestep&) = delete;
+	FixedTimestep(const FixedTimestep&&) = delete;
+	FixedTimestep& operator=(const FixedTimestep&&) = delete;
+
+	// Add a frame's duration and return how many ticks of getStep() seconds to run
+	unsigned int advance(float frameSeconds) noexcept;
+
+	[[nodiscard]] float getStep() const noexcept;
+	// How far the frame lies between the last two ticks, in [0, 1]; always 1 without a tick rate
+	[[nodiscard]] float getAlpha() const noexcept;
+	[[nodiscard]] unsigned long long getTickCount() const noexcept;
+	// Simulation time given up to the catch-up cap
+	[[nodiscard]] double getDroppedSeconds() const noexcept;
+private:
+	double step_;
+	unsigned int maxTicksPerFrame_;
+	double accumulator_ = 0.0;
+	float variableStep_ = 0.0f;
+	unsigned long long tickCount_ = 0ull;
+	double droppedSeconds_ = 0.0;
+};
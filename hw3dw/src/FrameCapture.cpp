@@ -0,0 +1,150 @@
+#include "FrameCapture.hpp"
+
+#include <format>
+#include <fstream>
+
+#include "CpuMetric.hpp"
+#include "Logging.hpp"
+#include "QoiEncoder.hpp"
+
+FrameCapture::FrameCapture(std::filesystem::path directory, const size_t poolSize)
+	:
+	directory_(std::move(directory))
+{
+	std::filesystem::create_directories(directory_);
+
+	pool_.reserve(poolSize);
+	free_.reserve(poolSize);
+	for (size_t i = 0; i < poolSize; i++)
+	{
+		pool_.push_back(std::make_unique<Surface>(1u, 1u));
+		free_.push_back(pool_.back().get());
+	}
+
+	PLOGI << "Capturing frames to " << directory_.string();
+	encoder_ = std::thread(&FrameCapture::encodeLoop, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+	flush();
+	{
+		std::lock_guard lock(mutex_);
+		stop_ = true;
+	}
+	queueCondition_.notify_one();
+	encoder_.join();
+
+	const auto [submitted, encoded, dropped, bytesWritten, queued, peakQueued] = getStatistics();
+	PLOGI << "Frame capture: " << encoded << " of " << submitted + dropped << " frames written ("
+		<< dropped << " dropped, peak queue " << peakQueued << ", " << bytesWritten / 1024ull << " KiB)";
+}
+
+Surface* FrameCapture::acquire(const unsigned int width, const unsigned int height)
+{
+	Surface* frame;
+	{
+		std::lock_guard lock(mutex_);
+		if (free_.empty())
+		{
+			++dropped_;
+			return nullptr;
+		}
+		frame = free_.back();
+		free_.pop_back();
+	}
+
+	// Only reallocates when the swap chain has been resized
+	if (frame->getWidth() != width || frame->getHeight() != height)
+	{
+		*frame = Surface(width, height);
+	}
+	return frame;
+}
+
+void FrameCapture::submit(Surface* frame)
+{
+	{
+		std::lock_guard lock(mutex_);
+		queue_.emplace_back(frameNumber_++, frame);
+		peakQueued_ = std::max(peakQueued_, queue_.size());
+	}
+	++submitted_;
+	queueCondition_.notify_one();
+}
+
+void FrameCapture::release(Surface* frame)
+{
+	std::lock_guard lock(mutex_);
+	free_.push_back(frame);
+}
+
+void FrameCapture::drop(const unsigned long long frames) noexcept
+{
+	dropped_ += frames;
+}
+
+void FrameCapture::flush()
+{
+	std::unique_lock lock(mutex_);
+	idleCondition_.wait(lock, [this] { return queue_.empty() && !encoding_; });
+}
+
+FrameCapture::Statistics FrameCapture::getStatistics() const
+{
+	std::lock_guard lock(mutex_);
+	return {
+		.submitted = submitted_,
+		.encoded = encoded_,
+		.dropped = dropped_,
+		.bytesWritten = bytesWritten_,
+		.queued = queue_.size(),
+		.peakQueued = peakQueued_,
+	};
+}
+
+void FrameCapture::encodeLoop()
+{
+	CpuMetric::nameCurrentThread("Capture");
+	std::vector<unsigned char> encoded;
+	while (true)
+	{
+		std::pair<unsigned long long, Surface*> item;
+		{
+			std::unique_lock lock(mutex_);
+			queueCondition_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+			if (queue_.empty())
+			{
+				return;
+			}
+			item = queue_.front();
+			queue_.pop_front();
+			encoding_ = true;
+		}
+
+		const auto& [number, frame] = item;
+		QoiEncoder::encode(*frame, encoded);
+
+		{
+			std::lock_guard lock(mutex_);
+			free_.push_back(frame);
+		}
+
+		const auto path = directory_ / std::format("frame_{:06}.qoi", number);
+		if (std::ofstream file(path, std::ios::binary); file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size())))
+		{
+			++encoded_;
+			bytesWritten_ += encoded.size();
+		}
+		else
+		{
+			PLOGW << "Failed to write " << path.string();
+		}
+
+		{
+			std::lock_guard lock(mutex_);
+			encoding_ = false;
+		}
+		idleCondition_.notify_all();
+	}
+}
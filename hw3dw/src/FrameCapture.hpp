@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Surface.hpp"
+
+// Streams captured frames to disk without stalling the render loop. Frames are copied into Surfaces taken
+// from a fixed pool and handed to a background thread which encodes them as QOI. When every pooled Surface
+// is still waiting to be encoded the frame is dropped rather than blocking the caller.
+class FrameCapture
+{
+public:
+	struct Statistics
+	{
+		unsigned long long submitted;
+		unsigned long long encoded;
+		unsigned long long dropped;
+		unsigned long long bytesWritten;
+		size_t queued;
+		size_t peakQueued;
+	};
+
+	FrameCapture(std::filesystem::path directory, size_t poolSize = 4u);
+	~FrameCapture();
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+	FrameCapture(const FrameCapture&&) = delete;
+	FrameCapture& operator=(const FrameCapture&&) = delete;
+
+	// Returns a Surface of the requested size to copy the frame into, or nullptr if the frame must be dropped
+	Surface* acquire(unsigned int width, unsigned int height);
+	// Queue an acquired Surface for encoding
+	void submit(Surface* frame);
+	// Give back an acquired Surface that was not filled
+	void release(Surface* frame);
+	// Count frames the caller lost before they reached acquire(), such as copies still in flight on a resize
+	void drop(unsigned long long frames = 1ull) noexcept;
+	// Block until everything that was submitted has been written
+	void flush();
+
+	[[nodiscard]] Statistics getStatistics() const;
+private:
+	void encodeLoop();
+
+	std::filesystem::path directory_;
+	std::vector<std::unique_ptr<Surface>> pool_;
+	std::vector<Surface*> free_;
+	std::deque<std::pair<unsigned long long, Surface*>> queue_;
+	mutable std::mutex mutex_;
+	std::condition_variable queueCondition_;
+	std::condition_variable idleCondition_;
+	bool stop_ = false;
+	bool encoding_ = false;
+	unsigned long long frameNumber_ = 0ull;
+	size_t peakQueued_ = 0u;
+	std::atomic<unsigned long long> submitted_ = 0ull;
+	std::atomic<unsigned long long> encoded_ = 0ull;
+	std::atomic<unsigned long long> dropped_ = 0ull;
+	std::atomic<unsigned long long> bytesWritten_ = 0ull;
+	std::thread encoder_;
+};
@@ -0,0 +1,191 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include "AtumWindows.hpp"
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+namespace
+{
+	// Sleeps shorter than this are not worth the wake up uncertainty, the pacer spins instead
+	constexpr double minimumSleepMicroseconds = 200.0;
+	// Older overshoot samples fade out so the estimate follows changes in system load
+	constexpr unsigned long long overshootWindow = 64ull;
+
+	double toMicroseconds(const FramePacer::clock::duration duration) noexcept
+	{
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+}
+
+FramePacer::FramePacer(const double framesPerSecond) noexcept
+	:
+	FramePacer(framesPerSecond, {
+		[] { return clock::now(); },
+		[](const std::chrono::duration<double, std::micro> duration) { std::this_thread::sleep_for(duration); },
+		[] { std::this_thread::yield(); }
+	})
+{}
+
+FramePacer::FramePacer(const double framesPerSecond, TimeSource timeSource) noexcept
+	:
+	timeSource_(std::move(timeSource))
+{
+	setTargetRate(framesPerSecond);
+}
+
+FramePacer::~FramePacer()
+{
+	setFineTimer(false);
+}
+
+void FramePacer::wait() noexcept
+{
+	frames_++;
+	if (period_ == clock::duration::zero())
+	{
+		recordInterval(timeSource_.now());
+		return;
+	}
+
+	const auto now = timeSource_.now();
+	if (!started_)
+	{
+		started_ = true;
+		deadline_ = now;
+	}
+	deadline_ += period_;
+
+	if (now >= deadline_)
+	{
+		// Running behind: restart the timeline rather than owing the missed frames
+		missedDeadlines_++;
+		deadline_ = now;
+		recordInterval(now);
+		return;
+	}
+
+	sleepUntil(deadline_);
+	auto woke = timeSource_.now();
+	while (woke < deadline_)
+	{
+		timeSource_.yield();
+		woke = timeSource_.now();
+	}
+
+	const double error = toMicroseconds(woke - deadline_);
+	pacedFrames_++;
+	errorSum_ += error;
+	errorMax_ = std::max(errorMax_, error);
+	recordInterval(woke);
+}
+
+void FramePacer::setTargetRate(const double framesPerSecond) noexcept
+{
+	period_ = framesPerSecond > 0.0
+		? std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond))
+		: clock::duration::zero();
+	started_ = false;
+	setFineTimer(period_ != clock::duration::zero());
+}
+
+void FramePacer::setFineTimer(const bool fine) noexcept
+{
+	if (fine == fineTimer_)
+	{
+		return;
+	}
+	fineTimer_ = fine;
+#if defined(_WIN32)
+	// The default 15.6ms scheduler tick makes sleeps far too coarse to pace with, but raising the system wide
+	// timer rate costs power, so it is only held while frames are paced
+	if (fine)
+	{
+		timeBeginPeriod(1u);
+	}
+	else
+	{
+		timeEndPeriod(1u);
+	}
+#endif
+}
+
+double FramePacer::getTargetRate() const noexcept
+{
+	return period_ == clock::duration::zero() ? 0.0 : 1.0 / std::chrono::duration<double>(period_).count();
+}
+
+FramePacer::Statistics FramePacer::getStatistics() const noexcept
+{
+	return {
+		.frames = frames_,
+		.missedDeadlines = missedDeadlines_,
+		.meanErrorMicroseconds = pacedFrames_ > 0ull ? errorSum_ / static_cast<double>(pacedFrames_) : 0.0,
+		.maxErrorMicroseconds = errorMax_,
+		.meanIntervalMicroseconds = intervalMean_,
+		.intervalJitterMicroseconds = intervals_ > 1ull ? std::sqrt(intervalM2_ / static_cast<double>(intervals_ - 1ull)) : 0.0,
+		.sleepOvershootMicroseconds = overshootMean_
+	};
+}
+
+void FramePacer::resetStatistics() noexcept
+{
+	frames_ = 0ull;
+	missedDeadlines_ = 0ull;
+	pacedFrames_ = 0ull;
+	errorSum_ = 0.0;
+	errorMax_ = 0.0;
+	intervals_ = 0ull;
+	intervalMean_ = 0.0;
+	intervalM2_ = 0.0;
+	lastWake_ = {};
+}
+
+void FramePacer::sleepUntil(const clock::time_point deadline) noexcept
+{
+	// Sleep in slices so every wake refines the overshoot estimate, and stop once a sleep could wake late
+	while (true)
+	{
+		const double overshootDeviation = overshootSamples_ > 1ull ? std::sqrt(overshootM2_ / static_cast<double>(overshootSamples_ - 1ull)) : 0.0;
+		const double margin = overshootMean_ + 2.0 * overshootDeviation;
+		const double remaining = toMicroseconds(deadline - timeSource_.now());
+		if (remaining - margin < minimumSleepMicroseconds)
+		{
+			return;
+		}
+
+		const double request = std::min(remaining - margin, 1000.0);
+		const auto before = timeSource_.now();
+		timeSource_.sleepFor(std::chrono::duration<double, std::micro>(request));
+		const double overshoot = toMicroseconds(timeSource_.now() - before) - request;
+
+		overshootSamples_ = std::min(overshootSamples_ + 1ull, overshootWindow);
+		const double delta = overshoot - overshootMean_;
+		overshootMean_ += delta / static_cast<double>(overshootSamples_);
+		overshootM2_ += delta * (overshoot - overshootMean_);
+		if (overshootSamples_ == overshootWindow)
+		{
+			// Keep the variance on the same window as the mean
+			overshootM2_ *= static_cast<double>(overshootWindow - 1ull) / static_cast<double>(overshootWindow);
+		}
+	}
+}
+
+void FramePacer::recordInterval(const clock::time_point woke) noexcept
+{
+	if (lastWake_ != clock::time_point{})
+	{
+		const double interval = toMicroseconds(woke - lastWake_);
+		intervals_++;
+		const double delta = interval - intervalMean_;
+		intervalMean_ += delta / static_cast<double>(intervals_);
+		intervalM2_ += delta * (interval - intervalMean_);
+	}
+	lastWake_ = woke;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <functional>
+
+// Holds frames to a target rate. Frames are scheduled on an absolute timeline (deadline += period) so rounding
+// in each wait never accumulates into drift; after a hitch longer than a frame the timeline restarts from now
+// instead of rushing a burst of frames to catch up.
+//
+// Waiting sleeps for most of the interval and spins for the rest. The OS oversleeps by a varying amount, so
+// the pacer tracks how late its sleeps wake up and stops sleeping early enough that even a slow wake lands
+// before the deadline; the spin then hits it within microseconds.
+class FramePacer
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	struct Statistics
+	{
+		unsigned long long frames;
+		unsigned long long missedDeadlines; // Frames that arrived after their deadline (no wait happened)
+		double meanErrorMicroseconds;       // Wake time past the deadline, over paced frames
+		double maxErrorMicroseconds;
+		double meanIntervalMicroseconds;    // Time between consecutive wakes
+		double intervalJitterMicroseconds;  // Standard deviation of that interval
+		double sleepOvershootMicroseconds;  // Current estimate of how late sleeps wake
+	};
+
+	// Where the pacer reads the time and how it lets time pass; the system clock unless a test drives its own
+	struct TimeSource
+	{
+		std::function<clock::time_point()> now;
+		std::function<void(std::chrono::duration<double, std::micro>)> sleepFor;
+		std::function<void()> yield;
+	};
+
+public:
+	// framesPerSecond 0 leaves frames unpaced but still measures their intervals
+	explicit FramePacer(double framesPerSecond) noexcept;
+	FramePacer(double framesPerSecond, TimeSource timeSource) noexcept;
+	~FramePacer();
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+	FramePacer(const FramePacer&&) = delete;
+	FramePacer& operator=(const FramePacer&&) = delete;
+
+	// Block until the next frame is due
+	void wait() noexcept;
+	void setTargetRate(double framesPerSecond) noexcept;
+	[[nodiscard]] double getTargetRate() const noexcept;
+	[[nodiscard]] Statistics getStatistics() const noexcept;
+	void resetStatistics() noexcept;
+private:
+	// Raise the OS timer resolution while pacing, and give it back when not
+	void setFineTimer(bool fine) noexcept;
+	void sleepUntil(clock::time_point deadline) noexcept;
+	void recordInterval(clock::time_point woke) noexcept;
+
+	TimeSource timeSource_;
+	clock::duration period_{};
+	clock::time_point deadline_{};
+	clock::time_point lastWake_{};
+	bool started_ = false;
+	bool fineTimer_ = false;
+
+	// Running mean and variance (Welford) of how far sleeps overshoot, in microseconds
+	double overshootMean_ = 1000.0;
+	double overshootM2_ = 0.0;
+	unsigned long long overshootSamples_ = 0ull;
+
+	unsigned long long frames_ = 0ull;
+	unsigned long long missedDeadlines_ = 0ull;
+	unsigned long long pacedFrames_ = 0ull;
+	double errorSum_ = 0.0;
+	double errorMax_ = 0.0;
+	unsigned long long intervals_ = 0ull;
+	double intervalMean_ = 0.0;
+	double intervalM2_ = 0.0;
+};
@@ -1,7 +1,12 @@
 // ReSharper disable CppClangTidyClangDiagnosticExtraSemiStmt
 #include "Graphics.hpp"
 #include "GraphicsThrowMacros.hpp"
+#include "AtlasTexture.hpp"
+#include "CommandRecorder.hpp"
+#include "ConstantRing.hpp"
 #include "DXErr.h"
+#include "FrameCapture.hpp"
+#include "ShaderLibrary.hpp"
 
 #include "Logging.hpp"
 
@@ -11,15 +16,20 @@ const static WindowsMessageMap windowsMessageMap;
 #endif
 
 #include <d3dcompiler.h>
+#include <algorithm>
+#include <cmath>
 #include <DirectXMath.h>
 #include <functional>
 #include <sstream>
+#include <utility>
 
 #define UNCAPPED_FRAMERATE FALSE
 
 namespace wrl = Microsoft::WRL;
 namespace dx = DirectX;
 
+thread_local ID3D11DeviceContext* Graphics::recordingContext_ = nullptr;
+
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "D3DCompiler.lib")
 
@@ -37,13 +47,13 @@ namespace dx = DirectX;
 // -----------------------------
 // Lifecycle
 // -----------------------------
-Graphics::Graphics(HWND parent, int width, int height) :
+Graphics::Graphics(HWND parent, int width, int height, const D3D_DRIVER_TYPE driverType) :
 	parent_(parent),
 	width_(static_cast<float>(width)),
 	height_(static_cast<float>(height)),
 	projection_()
 {
-	PLOGI << "Initialize Graphics";
+	PLOGI << "Initialize Graphics" << (driverType == D3D_DRIVER_TYPE_WARP ? " on WARP" : "");
 
 	PLOGD << "Initialize Swap Chain";
 	DXGI_SWAP_CHAIN_DESC swapChainDesc = {};
@@ -81,7 +91,7 @@ Graphics::Graphics(HWND parent, int width, int height) :
 #endif
 	GFX_THROW_INFO(D3D11CreateDeviceAndSwapChain(
 		nullptr,
-		D3D_DRIVER_TYPE_HARDWARE,
+		driverType,
 		nullptr,
 		swapCreateFlags,
 		featureLevelsArray,
@@ -110,68 +120,21 @@ Graphics::Graphics(HWND parent, int width, int height) :
 		.BackFace = {}
 	};
 
-	wrl::ComPtr<ID3D11DepthStencilState> depthStencilState;
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "device_->CreateDepthStencilState(&depthStencilDesc, &depthStencilState)";
+	PLOGV << "device_->CreateDepthStencilState(&depthStencilDesc, &depthStencilState_)";
 #endif
-	GFX_THROW_INFO(device_->CreateDepthStencilState(&depthStencilDesc, &depthStencilState));
+	GFX_THROW_INFO(device_->CreateDepthStencilState(&depthStencilDesc, &depthStencilState_));
 
 	PLOGD << "Bind depth state to the pipeline";
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "deviceContext_->OMSetDepthStencilState(depthStencilState.Get(), 0u);";
+	PLOGV << "deviceContext_->OMSetDepthStencilState(depthStencilState_.Get(), 0u);";
 #endif
-	deviceContext_->OMSetDepthStencilState(depthStencilState.Get(), 0u);
+	deviceContext_->OMSetDepthStencilState(depthStencilState_.Get(), 0u);
 
-	PLOGV << "Create depth stencil texture";
-	D3D11_TEXTURE2D_DESC depthDesc = {
-		.Width = static_cast<UINT>(width),
-		.Height = static_cast<UINT>(height),
-		.MipLevels = 1u,
-		.ArraySize = 1u,
-		.Format = DXGI_FORMAT_D32_FLOAT,
-		.SampleDesc = {
-			.Count = 1u,
-			.Quality = 0u
-		},
-		.Usage = D3D11_USAGE_DEFAULT,
-		.BindFlags = D3D11_BIND_DEPTH_STENCIL,
-		.CPUAccessFlags = 0u,
-		.MiscFlags = 0u
-	};
+	createSceneTarget(static_cast<UINT>(width), static_cast<UINT>(height));
 
-	wrl::ComPtr<ID3D11Texture2D> depthStencil;
-#ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "device_->CreateTexture2D(&depthDesc, nullptr, &depthStencil)";
-#endif
-	GFX_THROW_INFO(device_->CreateTexture2D(&depthDesc, nullptr, &depthStencil));
-
-	PLOGV << "Create view of the depth stencil texture";
-	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc = {
-		.Format = DXGI_FORMAT_D32_FLOAT,
-		// May also be DXGI_FORMAT::DXGI_FORMAT_UNKNOWN, and it will use the same as the depth_desc
-		.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D,
-		.Flags = 0u,
-		.Texture2D = {
-			.MipSlice = 0u,
-		}
-	};
-
-#ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "device_->CreateDepthStencilView(depthStencil.Get(), &depthStencilViewDesc, &depthStencilView_))";
-#endif
-	GFX_THROW_INFO(
-		device_->CreateDepthStencilView(depthStencil.Get(), &depthStencilViewDesc, &depthStencilView_));
-
-	PLOGD << "Bind the render target and stencil views";
-#ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "deviceContext_->OMSetRenderTargets(1u, renderTargetView_.GetAddressOf(), depthStencilView_.Get())";
-#endif
-	//  - Output Merger
-	deviceContext_->OMSetRenderTargets(1u, renderTargetView_.GetAddressOf(), depthStencilView_.Get());
-
-	PLOGD << "Configure and set the viewport";
-	//  - Rasterizer
-	const D3D11_VIEWPORT viewport = {
+	PLOGD << "Configure the back buffer viewport";
+	viewport_ = {
 		.TopLeftX = 0,
 		.TopLeftY = 0,
 		.Width = width_,
@@ -179,11 +142,42 @@ Graphics::Graphics(HWND parent, int width, int height) :
 		.MinDepth = 0,
 		.MaxDepth = 1
 	};
-	deviceContext_->RSSetViewports(1u, &viewport);
+
+	PLOGD << "Bind the scene target and depth stencil views";
+#ifdef LOG_GRAPHICS_CALLS
+	PLOGV << "deviceContext_->OMSetRenderTargets(1u, sceneTargetView_.GetAddressOf(), depthStencilView_.Get())";
+#endif
+	//  - Output Merger
+	deviceContext_->OMSetRenderTargets(1u, sceneTargetView_.GetAddressOf(), depthStencilView_.Get());
+	//  - Rasterizer
+	setRenderScale(1.0f);
+
+	createUpscalePass();
+
+	const D3D11_QUERY_DESC disjointDesc = { .Query = D3D11_QUERY_TIMESTAMP_DISJOINT, .MiscFlags = 0u };
+	const D3D11_QUERY_DESC timestampDesc = { .Query = D3D11_QUERY_TIMESTAMP, .MiscFlags = 0u };
+	for (auto& timer : gpuTimers_)
+	{
+		GFX_THROW_INFO(device_->CreateQuery(&disjointDesc, &timer.disjoint));
+		GFX_THROW_INFO(device_->CreateQuery(&timestampDesc, &timer.begin));
+		GFX_THROW_INFO(device_->CreateQuery(&timestampDesc, &timer.end));
+	}
+
+	if (ConstantRing::isSupported(device_.Get()))
+	{
+		constantRing_ = std::make_unique<ConstantRing>(device_.Get(), deviceContext_.Get());
+	}
+	else
+	{
+		PLOGW << "Constant buffer offsetting is not supported, per-draw constants use Map/DISCARD";
+	}
 }
 
 Graphics::~Graphics()
 {
+	// The library and the atlas view outlive any one device, so their objects have to go before this one does
+	ShaderLibrary::release();
+	AtlasTexture::release();
 	deviceContext_->ClearState();
 	deviceContext_->Flush();
 #if (IS_DEBUG)
@@ -206,7 +200,7 @@ bool Graphics::beginFrame(const unsigned int targetWidth, const unsigned int tar
 {
 	// Handle window being minimized or screen locked
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "swapChain_->Present(0, DXGI_PRESENT_TEST)";
+	BLOGV("swapChain_->Present(0, DXGI_PRESENT_TEST)");
 #endif
 	if (swapChainOccluded_ && swapChain_->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED)
 	{
@@ -245,8 +239,6 @@ bool Graphics::beginFrame(const unsigned int targetWidth, const unsigned int tar
 			GFX_THROW_INFO(device_->CreateRenderTargetView(buffer, nullptr, renderTargetView_.GetAddressOf()));
 			buffer->Release();
 
-			deviceContext_->OMSetRenderTargets(1, renderTargetView_.GetAddressOf(), nullptr);
-
 			// ReSharper disable once CppInitializedValueIsAlwaysRewritten
 			D3D11_VIEWPORT vp{};
 			vp.Width = static_cast<float>(targetWidth);
@@ -255,26 +247,44 @@ bool Graphics::beginFrame(const unsigned int targetWidth, const unsigned int tar
 			vp.MaxDepth = 1.0f;
 			vp.TopLeftX = 0;
 			vp.TopLeftY = 0;
-			deviceContext_->RSSetViewports(1, &vp);
+			viewport_ = vp;
+			width_ = vp.Width;
+			height_ = vp.Height;
+
+			// The scene target follows the window, the render scale carries over
+			createSceneTarget(targetWidth, targetHeight);
+			deviceContext_->OMSetRenderTargets(1, sceneTargetView_.GetAddressOf(), depthStencilView_.Get());
+			setRenderScale(renderScale_);
 		}
 	}
+
 	return true;
 }
 
+void Graphics::beginScene() noexcept
+{
+	beginGpuTimer();
+}
+
 void Graphics::endFrame()
 {
 	HRESULT hresult;
+	if (constantRing_)
+	{
+		constantRing_->endFrame();
+	}
+
 #if (IS_DEBUG)
 	infoManager_.set();
 #endif
 #if (UNCAPPED_FRAMERATE)
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "swapChain_->Present(0u, 0u)";
+	BLOGV("swapChain_->Present(0u, 0u)");
 #endif
 	if (FAILED(hresult = swapChain_->Present(0u, 0u)))
 #else
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "swapChain_->Present(1u, 0u)";
+	BLOGV("swapChain_->Present(1u, 0u)");
 #endif
 	if (FAILED(hresult = swapChain_->Present(1u, 0u)))
 #endif
@@ -286,9 +296,11 @@ void Graphics::endFrame()
 		throw GFX_EXCEPT(hresult);
 	}
 	swapChainOccluded_ = (hresult == DXGI_STATUS_OCCLUDED);
+	inputLatency_.present();
 
-	// Rebind render target view after Present for flip-model swap chains
-	deviceContext_->OMSetRenderTargets(1, renderTargetView_.GetAddressOf(), depthStencilView_.Get());
+	// resolveScene() left the back buffer bound, the next frame's scene draws into the scene target again
+	deviceContext_->OMSetRenderTargets(1, sceneTargetView_.GetAddressOf(), depthStencilView_.Get());
+	deviceContext_->RSSetViewports(1u, &sceneViewport_);
 }
 
 void Graphics::clearBuffer(const ImVec4& clearColor) const
@@ -300,27 +312,201 @@ void Graphics::clearBuffer(const float red, const float green, const float blue,
 {
 	const float clearColorWithAlpha[4] = { red * alpha, green * alpha, blue * alpha, alpha };
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "deviceContext_->ClearRenderTargetView";
+	BLOGV("deviceContext_->ClearRenderTargetView");
 #endif
-	deviceContext_->ClearRenderTargetView(renderTargetView_.Get(), clearColorWithAlpha);
+	deviceContext_->ClearRenderTargetView(sceneTargetView_.Get(), clearColorWithAlpha);
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "deviceContext_->ClearDepthStencilView";
+	BLOGV("deviceContext_->ClearDepthStencilView");
 #endif
 	deviceContext_->ClearDepthStencilView(depthStencilView_.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0u);
 }
 
+void Graphics::resolveScene()
+{
+	struct UpscaleConstants
+	{
+		float uvScale[2];
+		float uvMax[2];
+	};
+	D3D11_TEXTURE2D_DESC sceneDesc;
+	sceneTexture_->GetDesc(&sceneDesc);
+	const float textureWidth = static_cast<float>(sceneDesc.Width);
+	const float textureHeight = static_cast<float>(sceneDesc.Height);
+	const UpscaleConstants constants = {
+		.uvScale = { sceneViewport_.Width / textureWidth, sceneViewport_.Height / textureHeight },
+		// Stop half a texel inside the scaled region, the texels past it hold whatever a larger scale left behind
+		.uvMax = { (sceneViewport_.Width - 0.5f) / textureWidth, (sceneViewport_.Height - 0.5f) / textureHeight }
+	};
+	deviceContext_->UpdateSubresource(upscaleConstants_.Get(), 0u, nullptr, &constants, 0u, 0u);
+
+#ifdef LOG_GRAPHICS_CALLS
+	BLOGV("Upscale the scene onto the back buffer");
+#endif
+	deviceContext_->OMSetRenderTargets(1u, renderTargetView_.GetAddressOf(), nullptr);
+	// The blended pass leaves its blend state bound, the upscale replaces what is there and so do the next frame's opaque draws
+	deviceContext_->OMSetBlendState(nullptr, nullptr, 0xFFFFFFFFu);
+	deviceContext_->RSSetViewports(1u, &viewport_);
+	deviceContext_->IASetInputLayout(nullptr);
+	deviceContext_->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	deviceContext_->VSSetShader(upscaleVertexShader_.Get(), nullptr, 0u);
+	deviceContext_->PSSetShader(upscalePixelShader_.Get(), nullptr, 0u);
+	deviceContext_->PSSetConstantBuffers(0u, 1u, upscaleConstants_.GetAddressOf());
+	deviceContext_->PSSetShaderResources(0u, 1u, sceneResourceView_.GetAddressOf());
+	deviceContext_->PSSetSamplers(0u, 1u, upscaleSampler_.GetAddressOf());
+	GFX_THROW_INFO_ONLY(deviceContext_->Draw(3u, 0u));
+
+	// Unbind the scene texture before the next frame binds it as a render target again
+	ID3D11ShaderResourceView* const nullView = nullptr;
+	deviceContext_->PSSetShaderResources(0u, 1u, &nullView);
+	endGpuTimer();
+}
+
+void Graphics::setRenderScale(const float scale) noexcept
+{
+	renderScale_ = std::clamp(scale, 0.0625f, 1.0f);
+	sceneViewport_ = {
+		.TopLeftX = 0,
+		.TopLeftY = 0,
+		.Width = std::max(1.0f, std::round(width_ * renderScale_)),
+		.Height = std::max(1.0f, std::round(height_ * renderScale_)),
+		.MinDepth = 0,
+		.MaxDepth = 1
+	};
+	deviceContext_->RSSetViewports(1u, &sceneViewport_);
+}
+
+float Graphics::getRenderScale() const noexcept
+{
+	return renderScale_;
+}
+
+std::optional<float> Graphics::takeGpuFrameMilliseconds() noexcept
+{
+	return std::exchange(gpuFrameMilliseconds_, std::nullopt);
+}
+
+void Graphics::captureFrame(FrameCapture& capture)
+{
+	HRESULT hresult;
+
+	wrl::ComPtr<ID3D11Texture2D> backBuffer;
+	GFX_THROW_INFO(swapChain_->GetBuffer(0, IID_PPV_ARGS(&backBuffer)));
+	D3D11_TEXTURE2D_DESC backBufferDesc;
+	backBuffer->GetDesc(&backBufferDesc);
+
+	// Recreate the ring when the swap chain has been resized; anything still in flight is lost
+	if (captureStaging_[0])
+	{
+		D3D11_TEXTURE2D_DESC stagingDesc;
+		captureStaging_[0]->GetDesc(&stagingDesc);
+		if (stagingDesc.Width != backBufferDesc.Width || stagingDesc.Height != backBufferDesc.Height)
+		{
+			for (auto& staging : captureStaging_)
+			{
+				staging.Reset();
+			}
+			capture.drop(capturePending_);
+			captureNext_ = 0u;
+			capturePending_ = 0u;
+		}
+	}
+	if (!captureStaging_[0])
+	{
+		D3D11_TEXTURE2D_DESC stagingDesc = backBufferDesc;
+		stagingDesc.MipLevels = 1u;
+		stagingDesc.ArraySize = 1u;
+		stagingDesc.SampleDesc = { .Count = 1u, .Quality = 0u };
+		stagingDesc.Usage = D3D11_USAGE_STAGING;
+		stagingDesc.BindFlags = 0u;
+		stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+		stagingDesc.MiscFlags = 0u;
+		for (auto& staging : captureStaging_)
+		{
+			GFX_THROW_INFO(device_->CreateTexture2D(&stagingDesc, nullptr, &staging));
+		}
+	}
+
+	// Drain every copy the GPU has finished without waiting on the ones it has not
+	while (capturePending_ > 0u)
+	{
+		const size_t oldest = (captureNext_ + captureStaging_.size() - capturePending_) % captureStaging_.size();
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		hresult = deviceContext_->Map(captureStaging_[oldest].Get(), 0u, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+		if (hresult == DXGI_ERROR_WAS_STILL_DRAWING)
+		{
+			break;
+		}
+		if (FAILED(hresult))
+		{
+			throw GFX_EXCEPT(hresult);
+		}
+
+		if (Surface* frame = capture.acquire(backBufferDesc.Width, backBufferDesc.Height))
+		{
+			// The back buffer is RGBA, Surface stores BGRA
+			Surface::color* destination = frame->getBufferPtr();
+			for (UINT y = 0; y < backBufferDesc.Height; y++)
+			{
+				const auto* source = static_cast<const unsigned char*>(mapped.pData) + static_cast<size_t>(y) * mapped.RowPitch;
+				for (UINT x = 0; x < backBufferDesc.Width; x++, source += 4)
+				{
+					*destination++ = Surface::color(source[3], source[0], source[1], source[2]);
+				}
+			}
+			capture.submit(frame);
+		}
+		deviceContext_->Unmap(captureStaging_[oldest].Get(), 0u);
+		capturePending_--;
+	}
+
+	// Every copy is still in flight, this frame is dropped rather than stall the render loop
+	if (capturePending_ == captureStaging_.size())
+	{
+		capture.drop();
+		return;
+	}
+
+#ifdef LOG_GRAPHICS_CALLS
+	BLOGV("deviceContext_->CopyResource(captureStaging_[{}], backBuffer)", captureNext_);
+#endif
+	deviceContext_->CopyResource(captureStaging_[captureNext_].Get(), backBuffer.Get());
+	captureNext_ = (captureNext_ + 1u) % captureStaging_.size();
+	capturePending_++;
+}
+
 // -----------------------------
 // Rendering
 // -----------------------------
 // ReSharper disable once CppMemberFunctionMayBeConst
 void Graphics::drawIndexed(const UINT count) noexcept(!IS_DEBUG)
 {
+	if (recordingContext_)
+	{
+#if (IS_DEBUG)
+		// Recorded draws are checked by their recorder, the render thread keeps using infoManager_ meanwhile
+		DxgiInfoManager& recorderInfo = CommandRecorder::getActive()->getInfoManager();
+		recorderInfo.set();
+		recordingContext_->DrawIndexed(count, 0u, 0u);
+		if (auto messages = recorderInfo.getMessages(); !messages.empty())
+		{
+			throw InfoException(__LINE__, __FILE__, messages);
+		}
+#else
+		recordingContext_->DrawIndexed(count, 0u, 0u);
+#endif
+		return;
+	}
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "deviceContext_->DrawIndexed( " << count << ", 0u, 0u)";
+	BLOGV("deviceContext_->DrawIndexed( {}, 0u, 0u)", count);
 #endif
 	GFX_THROW_INFO_ONLY(deviceContext_->DrawIndexed(count, 0u, 0u));
 }
 
+bool Graphics::isRecording() noexcept
+{
+	return recordingContext_ != nullptr;
+}
+
 // -----------------------------
 // Camera & Projection
 // -----------------------------
@@ -350,7 +536,8 @@ dx::XMMATRIX Graphics::getProjection() const noexcept
 LRESULT Graphics::WndProcHandler([[maybe_unused]] HWND window, const UINT msg, [[maybe_unused]] const WPARAM wParam, [[maybe_unused]] const LPARAM lParam) noexcept
 {
 #ifdef LOG_WINDOW_MESSAGES
-	PLOGV << windowsMessageMap(msg, lParam, wParam).c_str();
+	char message[WindowsMessageMap::bufferSize];
+	PLOGV << windowsMessageMap(message, msg, lParam, wParam);
 #endif
 	// Right now this WndProcHandler doesn't do anything, so return 1.
 	return 1;
@@ -369,9 +556,190 @@ ID3D11DeviceContext* Graphics::getDeviceContext() const noexcept
 	return deviceContext_.Get();
 }
 
+InputLatency& Graphics::getInputLatency() noexcept
+{
+	return inputLatency_;
+}
+
+ConstantRing* Graphics::getConstantRing() const noexcept
+{
+	return constantRing_.get();
+}
+
+void Graphics::reserveDraws(const size_t drawsPerFrame)
+{
+	if (!constantRing_)
+	{
+		return;
+	}
+
+	// A replaced buffer stays alive until the GPU is done with the frames that still reference it
+	const UINT capacity = ConstantRing::getCapacityFor(drawsPerFrame);
+	if (capacity > constantRing_->getCapacity())
+	{
+		constantRing_ = std::make_unique<ConstantRing>(device_.Get(), deviceContext_.Get(), capacity);
+	}
+}
+
 // -----------------------------
 // Internal Helpers
 // -----------------------------
+ID3D11DeviceContext* Graphics::getCurrentContext() const noexcept
+{
+	return recordingContext_ ? recordingContext_ : deviceContext_.Get();
+}
+
+void Graphics::bindTargets(ID3D11DeviceContext* context) const noexcept
+{
+	context->OMSetRenderTargets(1u, sceneTargetView_.GetAddressOf(), depthStencilView_.Get());
+	context->OMSetDepthStencilState(depthStencilState_.Get(), 0u);
+	context->RSSetViewports(1u, &sceneViewport_);
+}
+
+void Graphics::createSceneTarget(const UINT width, const UINT height)
+{
+	HRESULT hresult;
+	sceneResourceView_.Reset();
+	sceneTargetView_.Reset();
+	sceneTexture_.Reset();
+	depthStencilView_.Reset();
+
+	PLOGD << "Create the " << width << "x" << height << " scene target";
+	const D3D11_TEXTURE2D_DESC sceneDesc = {
+		.Width = width,
+		.Height = height,
+		.MipLevels = 1u,
+		.ArraySize = 1u,
+		.Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+		.SampleDesc = {
+			.Count = 1u,
+			.Quality = 0u
+		},
+		.Usage = D3D11_USAGE_DEFAULT,
+		.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE,
+		.CPUAccessFlags = 0u,
+		.MiscFlags = 0u
+	};
+	GFX_THROW_INFO(device_->CreateTexture2D(&sceneDesc, nullptr, &sceneTexture_));
+	GFX_THROW_INFO(device_->CreateRenderTargetView(sceneTexture_.Get(), nullptr, &sceneTargetView_));
+	GFX_THROW_INFO(device_->CreateShaderResourceView(sceneTexture_.Get(), nullptr, &sceneResourceView_));
+
+	PLOGV << "Create depth stencil texture";
+	D3D11_TEXTURE2D_DESC depthDesc = sceneDesc;
+	depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+	depthDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+	wrl::ComPtr<ID3D11Texture2D> depthStencil;
+#ifdef LOG_GRAPHICS_CALLS
+	PLOGV << "device_->CreateTexture2D(&depthDesc, nullptr, &depthStencil)";
+#endif
+	GFX_THROW_INFO(device_->CreateTexture2D(&depthDesc, nullptr, &depthStencil));
+
+	PLOGV << "Create view of the depth stencil texture";
+	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc = {
+		.Format = DXGI_FORMAT_D32_FLOAT,
+		.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D,
+		.Flags = 0u,
+		.Texture2D = {
+			.MipSlice = 0u,
+		}
+	};
+#ifdef LOG_GRAPHICS_CALLS
+	PLOGV << "device_->CreateDepthStencilView(depthStencil.Get(), &depthStencilViewDesc, &depthStencilView_))";
+#endif
+	GFX_THROW_INFO(device_->CreateDepthStencilView(depthStencil.Get(), &depthStencilViewDesc, &depthStencilView_));
+}
+
+void Graphics::createUpscalePass()
+{
+	HRESULT hresult;
+	PLOGD << "Create the scene upscale pass";
+	upscaleVertexShader_ = ShaderLibrary::getVertexShader(*this, L"UpscaleVS.cso").shader;
+	upscalePixelShader_ = ShaderLibrary::getPixelShader(*this, L"UpscalePS.cso");
+
+	const D3D11_SAMPLER_DESC samplerDesc = {
+		.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+		.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP,
+		.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP,
+		.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP,
+		.MipLODBias = 0.0f,
+		.MaxAnisotropy = 1u,
+		.ComparisonFunc = D3D11_COMPARISON_NEVER,
+		.BorderColor = { 0.0f, 0.0f, 0.0f, 0.0f },
+		.MinLOD = 0.0f,
+		.MaxLOD = D3D11_FLOAT32_MAX
+	};
+	GFX_THROW_INFO(device_->CreateSamplerState(&samplerDesc, &upscaleSampler_));
+
+	const D3D11_BUFFER_DESC constantsDesc = {
+		.ByteWidth = 16u,
+		.Usage = D3D11_USAGE_DEFAULT,
+		.BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+		.CPUAccessFlags = 0u,
+		.MiscFlags = 0u,
+		.StructureByteStride = 0u
+	};
+	GFX_THROW_INFO(device_->CreateBuffer(&constantsDesc, nullptr, &upscaleConstants_));
+}
+
+void Graphics::beginGpuTimer() noexcept
+{
+	// Collect every finished timer without waiting; the newest one wins
+	for (size_t i = 1; i <= gpuTimers_.size(); i++)
+	{
+		auto& timer = gpuTimers_[(gpuTimerNext_ + i) % gpuTimers_.size()];
+		if (!timer.pending)
+		{
+			continue;
+		}
+		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+		UINT64 begin;
+		UINT64 end;
+		if (deviceContext_->GetData(timer.disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			deviceContext_->GetData(timer.begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			deviceContext_->GetData(timer.end.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+		{
+			continue;
+		}
+		timer.pending = false;
+		if (!disjoint.Disjoint && end >= begin)
+		{
+			gpuFrameMilliseconds_ = static_cast<float>(static_cast<double>(end - begin) * 1000.0 / static_cast<double>(disjoint.Frequency));
+		}
+	}
+
+	// A frame that began the scene but never resolved it leaves its timer open; close it unread, its span
+	// would take in everything since
+	auto& timer = gpuTimers_[gpuTimerNext_];
+	if (gpuTimerOpen_)
+	{
+		deviceContext_->End(timer.disjoint.Get());
+		gpuTimerOpen_ = false;
+	}
+
+	// Skip timing this frame rather than stall when the GPU is still on the oldest one
+	gpuTimerOpen_ = !timer.pending;
+	if (gpuTimerOpen_)
+	{
+		deviceContext_->Begin(timer.disjoint.Get());
+		deviceContext_->End(timer.begin.Get());
+	}
+}
+
+void Graphics::endGpuTimer() noexcept
+{
+	if (!gpuTimerOpen_)
+	{
+		return;
+	}
+	auto& timer = gpuTimers_[gpuTimerNext_];
+	deviceContext_->End(timer.end.Get());
+	deviceContext_->End(timer.disjoint.Get());
+	timer.pending = true;
+	gpuTimerOpen_ = false;
+	gpuTimerNext_ = (gpuTimerNext_ + 1u) % gpuTimers_.size();
+}
+
 // ImGui::CreateRenderTarget()
 void Graphics::createRenderTarget()
 {
@@ -3,23 +3,31 @@
 #include "AtumException.hpp"
 #include "Camera.hpp"
 #include "DxgiInfoManager.hpp"
+#include "InputLatency.hpp"
 
+#include <array>
 #include <d3d11.h>
 #include <DirectXMath.h>
 #include <locale>
+#include <optional>
 
 #include "imgui/backends/imgui_impl_dx11.h"
 
 struct ImVec4;
+class ConstantRing;
+class FrameCapture;
 
 class Graphics {
     friend class Bindable;
+    friend class CommandRecorder;
+    friend class ShaderLibrary;
 
 public:
     // -----------------------------
     // Lifecycle
     // -----------------------------
-    explicit Graphics(HWND parent, int width, int height);
+    // WARP renders on the CPU, for runs that must not depend on the machine's GPU or driver
+    explicit Graphics(HWND parent, int width, int height, D3D_DRIVER_TYPE driverType = D3D_DRIVER_TYPE_HARDWARE);
     Graphics() = delete;
     ~Graphics();
 
@@ -45,13 +53,30 @@ public:
     // -----------------------------
     bool beginFrame(unsigned int targetWidth, unsigned int targetHeight);
     void endFrame();
+    // Start timing the scene on the GPU. Call it once the CPU has the frame's scene ready to submit, right
+    // before clearing, so the measurement doesn't take in the GPU idling while the CPU works.
+    void beginScene() noexcept;
     void clearBuffer(const ImVec4& clearColor) const;
     void clearBuffer(float red, float green, float blue, float alpha = 1.0f) const;
+    // The 3D scene renders into an offscreen target at the render scale; this upscales it onto the back buffer
+    // and binds the back buffer at native resolution for ImGui. Call after the scene and before ImGui.
+    void resolveScene();
+    // Fraction of the window size the scene renders at, clamped to (0, 1]
+    void setRenderScale(float scale) noexcept;
+    float getRenderScale() const noexcept;
+    // GPU time of the newest frame whose timestamps have come back, from beginScene to the end of resolveScene.
+    // Queries are read a few frames late without stalling; each measurement is handed out once.
+    std::optional<float> takeGpuFrameMilliseconds() noexcept;
+    // Copy the back buffer into a staging ring and hand the oldest finished copy to the capture pipeline.
+    // Call before endFrame(); readback trails the GPU by a few frames so the CPU never waits on it.
+    void captureFrame(FrameCapture& capture);
 
     // -----------------------------
     // Rendering
     // -----------------------------
     void drawIndexed(UINT count) noexcept(!IS_DEBUG);
+    // True while the calling thread has a CommandRecorder active
+    static bool isRecording() noexcept;
 
     // -----------------------------
     // Camera & Projection
@@ -71,12 +96,27 @@ public:
     // -----------------------------
     ID3D11Device* getDevice() const noexcept;
     ID3D11DeviceContext* getDeviceContext() const noexcept;
+    // Frames begun with input are closed here when their Present returns
+    InputLatency& getInputLatency() noexcept;
+    // Per-frame constant upload ring, nullptr when the device can't bind constant buffers with offsets
+    ConstantRing* getConstantRing() const noexcept;
+    // Grow the constant ring to fit drawsPerFrame draws for every frame in flight; call once the scene is built
+    void reserveDraws(size_t drawsPerFrame);
 
 private:
     // -----------------------------
     // Internal Helpers
     // -----------------------------
     void createRenderTarget();
+    // Scene colour and depth at full window size; the render scale only shrinks the viewport inside them
+    void createSceneTarget(UINT width, UINT height);
+    void createUpscalePass();
+    void beginGpuTimer() noexcept;
+    void endGpuTimer() noexcept;
+    // The recording context of the calling thread, otherwise the immediate context
+    ID3D11DeviceContext* getCurrentContext() const noexcept;
+    // Render target, depth state and viewport, which deferred contexts don't inherit
+    void bindTargets(ID3D11DeviceContext* context) const noexcept;
 
     // -----------------------------
     // Members
@@ -94,6 +134,34 @@ private:
     Microsoft::WRL::ComPtr<ID3D11DeviceContext> deviceContext_;
     Microsoft::WRL::ComPtr<ID3D11RenderTargetView> renderTargetView_;
     Microsoft::WRL::ComPtr<ID3D11DepthStencilView> depthStencilView_;
+    Microsoft::WRL::ComPtr<ID3D11DepthStencilState> depthStencilState_;
+    D3D11_VIEWPORT viewport_{};
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> sceneTexture_;
+    Microsoft::WRL::ComPtr<ID3D11RenderTargetView> sceneTargetView_;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> sceneResourceView_;
+    D3D11_VIEWPORT sceneViewport_{};
+    float renderScale_ = 1.0f;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> upscaleVertexShader_;
+    Microsoft::WRL::ComPtr<ID3D11PixelShader> upscalePixelShader_;
+    Microsoft::WRL::ComPtr<ID3D11SamplerState> upscaleSampler_;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> upscaleConstants_;
+    struct GpuTimer
+    {
+        Microsoft::WRL::ComPtr<ID3D11Query> disjoint;
+        Microsoft::WRL::ComPtr<ID3D11Query> begin;
+        Microsoft::WRL::ComPtr<ID3D11Query> end;
+        bool pending = false;
+    };
+    std::array<GpuTimer, 4> gpuTimers_;
+    size_t gpuTimerNext_{};
+    bool gpuTimerOpen_{};
+    std::optional<float> gpuFrameMilliseconds_;
+    InputLatency inputLatency_;
+    static thread_local ID3D11DeviceContext* recordingContext_;
+    std::unique_ptr<ConstantRing> constantRing_;
+    std::array<Microsoft::WRL::ComPtr<ID3D11Texture2D>, 3> captureStaging_;
+    size_t captureNext_{};
+    size_t capturePending_{};
 
 public:
     // -----------------------------
@@ -0,0 +1,166 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 32-bit reference into a HandlePool. The low 24 bits index a slot, the high 8 bits carry the generation the
+// slot had when the handle was issued, so a handle to an erased object is caught instead of aliasing whatever
+// reused the slot.
+struct PoolHandle
+{
+	static constexpr std::uint32_t indexBits = 24u;
+	static constexpr std::uint32_t indexMask = (1u << indexBits) - 1u;
+	static constexpr std::uint32_t nullValue = 0xFFFFFFFFu;
+
+	std::uint32_t value = nullValue;
+
+	[[nodiscard]] constexpr std::uint32_t getIndex() const noexcept
+	{
+		return value & indexMask;
+	}
+	[[nodiscard]] constexpr std::uint32_t getGeneration() const noexcept
+	{
+		return value >> indexBits;
+	}
+	[[nodiscard]] constexpr bool isNull() const noexcept
+	{
+		return value == nullValue;
+	}
+	constexpr bool operator==(const PoolHandle&) const = default;
+};
+
+// Stores objects of a single type in fixed-size chunks. Objects never move once constructed (Bindables can't be
+// moved) and objects created together sit next to each other in memory. Erased slots are recycled through a
+// free list and their generation is bumped.
+template<class T, std::uint32_t ChunkSize = 256u>
+class HandlePool
+{
+public:
+	HandlePool() = default;
+	~HandlePool()
+	{
+		for (std::uint32_t i = 0; i < next_; i++)
+		{
+			if (auto& slot = getSlot(i); slot.live)
+			{
+				std::destroy_at(slot.get());
+			}
+		}
+	}
+	HandlePool(const HandlePool&) = delete;
+	HandlePool& operator=(const HandlePool&) = delete;
+	HandlePool(const HandlePool&&) = delete;
+	HandlePool& operator=(const HandlePool&&) = delete;
+
+	template<class... Args>
+	PoolHandle emplace(Args&&... args)
+	{
+		std::uint32_t index;
+		if (!free_.empty())
+		{
+			index = free_.back();
+			free_.pop_back();
+		}
+		else
+		{
+			assert("Pool is out of handle indices" && next_ < PoolHandle::indexMask);
+			if (next_ % ChunkSize == 0u)
+			{
+				chunks_.push_back(std::make_unique<Slot[]>(ChunkSize));
+			}
+			index = next_++;
+		}
+
+		auto& slot = getSlot(index);
+		try
+		{
+			std::construct_at(slot.get(), std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			free_.push_back(index);
+			throw;
+		}
+		slot.live = true;
+		size_++;
+		return { (static_cast<std::uint32_t>(slot.generation) << PoolHandle::indexBits) | index };
+	}
+
+	void erase(const PoolHandle handle) noexcept(!IS_DEBUG)
+	{
+		assert("Erasing a stale or null handle" && contains(handle));
+		auto& slot = getSlot(handle.getIndex());
+		std::destroy_at(slot.get());
+		slot.live = false;
+		// Skip the generation that would make the all-ones null handle
+		slot.generation = static_cast<std::uint8_t>(slot.generation == 0xFEu ? 0u : slot.generation + 1u);
+		free_.push_back(handle.getIndex());
+		size_--;
+	}
+
+	[[nodiscard]] bool contains(const PoolHandle handle) const noexcept
+	{
+		if (handle.isNull() || handle.getIndex() >= next_)
+		{
+			return false;
+		}
+		const auto& slot = getSlot(handle.getIndex());
+		return slot.live && slot.generation == handle.getGeneration();
+	}
+
+	T& operator[](const PoolHandle handle) noexcept(!IS_DEBUG)
+	{
+		assert("Dereferencing a stale or null handle" && contains(handle));
+		return *getSlot(handle.getIndex()).get();
+	}
+
+	const T& operator[](const PoolHandle handle) const noexcept(!IS_DEBUG)
+	{
+		assert("Dereferencing a stale or null handle" && contains(handle));
+		return *getSlot(handle.getIndex()).get();
+	}
+
+	[[nodiscard]] size_t size() const noexcept
+	{
+		return size_;
+	}
+
+	// Bytes reserved by the pool, live or not
+	[[nodiscard]] size_t getFootprint() const noexcept
+	{
+		return chunks_.size() * ChunkSize * sizeof(Slot) + free_.capacity() * sizeof(std::uint32_t);
+	}
+private:
+	struct Slot
+	{
+		alignas(T) unsigned char storage[sizeof(T)];
+		std::uint8_t generation = 0u;
+		bool live = false;
+
+		T* get() noexcept
+		{
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+		const T* get() const noexcept
+		{
+			return std::launder(reinterpret_cast<const T*>(storage));
+		}
+	};
+
+	Slot& getSlot(const std::uint32_t index) noexcept
+	{
+		return chunks_[index / ChunkSize][index % ChunkSize];
+	}
+	const Slot& getSlot(const std::uint32_t index) const noexcept
+	{
+		return chunks_[index / ChunkSize][index % ChunkSize];
+	}
+
+	std::vector<std::unique_ptr<Slot[]>> chunks_;
+	std::vector<std::uint32_t> free_;
+	std::uint32_t next_ = 0u;
+	size_t size_ = 0u;
+};
@@ -0,0 +1,100 @@
+#include "HeadlessReplay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <format>
+
+#include "AppConfig.hpp"
+#include "Logging.hpp"
+#include "Orbit.hpp"
+#include "ReplayLoop.hpp"
+#include "ScenePopulation.hpp"
+
+namespace
+{
+	// A drawable without its binds, it moves like one and draws nothing
+	class OrbitingObject : public SceneObject
+	{
+	public:
+		explicit OrbitingObject(const Orbit& orbit) noexcept
+			:
+			orbit_(orbit)
+		{}
+
+		void update(const float dt) noexcept override
+		{
+			orbit_.update(dt);
+		}
+
+		DirectX::XMMATRIX getTransformXm() const noexcept override
+		{
+			return orbit_.getTransformXm();
+		}
+	private:
+		Orbit orbit_;
+	};
+
+	// FNV-1a, over the bits so any difference in a transform shows
+	std::uint64_t hash(std::uint64_t value, const DirectX::XMFLOAT4X4& transform) noexcept
+	{
+		unsigned char bytes[sizeof(transform)];
+		std::memcpy(bytes, &transform, sizeof(transform));
+		for (const unsigned char byte : bytes)
+		{
+			value = (value ^ byte) * 0x100000001b3ull;
+		}
+		return value;
+	}
+}
+
+HeadlessReplay::HeadlessReplay(const std::filesystem::path& recording)
+	:
+	replay_(recording)
+{
+	// The same rng draws the app makes for its drawables, so every orbit matches its drawable
+	ScenePopulation population(replay_.getSeed());
+	objects_.reserve(replay_.getDrawableCount());
+	for (std::uint32_t i = 0; i < replay_.getDrawableCount(); i++)
+	{
+		objects_.push_back(std::make_unique<OrbitingObject>(population.next().orbit));
+	}
+}
+
+int HeadlessReplay::run()
+{
+	PLOGI << "Replaying " << replay_.getFrames().size() << " frames headless (" << objects_.size() << " objects)";
+
+	ReplayLoop loop(replay_, static_cast<float>(SIMULATION_TICK_RATE), MAX_TICKS_PER_FRAME);
+	std::uint64_t checksum = 0xcbf29ce484222325ull;
+	double totalMilliseconds = 0.0;
+	double worstMilliseconds = 0.0;
+	while (!loop.isDone())
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const ReplayLoop::Frame frame = loop.next();
+		for (unsigned int tick = 0; tick < frame.ticks; tick++)
+		{
+			for (const auto& object : objects_)
+			{
+				object->tick(frame.step);
+			}
+		}
+		for (const auto& object : objects_)
+		{
+			checksum = hash(checksum, object->interpolateTransform(frame.alpha));
+		}
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		totalMilliseconds += milliseconds;
+		worstMilliseconds = std::max(worstMilliseconds, milliseconds);
+	}
+
+	const auto& timestep = loop.getTimestep();
+	const size_t frames = loop.getFrame();
+	PLOGI << "Replayed " << frames << " frames, " << timestep.getTickCount() << " ticks, " << timestep.getDroppedSeconds() << " s dropped";
+	PLOGI << "Simulation " << totalMilliseconds << " ms, " << (frames > 0u ? totalMilliseconds / static_cast<double>(frames) : 0.0)
+		<< " ms per frame, worst " << worstMilliseconds << " ms";
+	PLOGI << "Transform checksum " << std::format("{:016x}", checksum);
+	return 0;
+}
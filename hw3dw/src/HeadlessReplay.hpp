@@ -0,0 +1,27 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "InputRecording.hpp"
+#include "SceneObject.hpp"
+
+// Replays a recording through the simulation alone: no window, no device, the scene rebuilt from the recording's
+// seed as bare orbits. Runs anywhere the simulation does and reports the simulation's cost and a checksum of every
+// rendered transform, which two runs of the same recording have to agree on.
+class HeadlessReplay
+{
+public:
+	explicit HeadlessReplay(const std::filesystem::path& recording);
+	~HeadlessReplay() = default;
+	HeadlessReplay(const HeadlessReplay&) = delete;
+	HeadlessReplay& operator=(const HeadlessReplay&) = delete;
+	HeadlessReplay(const HeadlessReplay&&) = delete;
+	HeadlessReplay& operator=(const HeadlessReplay&&) = delete;
+
+	// Simulate every recorded frame and log the results, returns the process exit code
+	int run();
+private:
+	InputRecording::Replay replay_;
+	std::vector<std::unique_ptr<SceneObject>> objects_;
+};
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+
 #include "Bindable.hpp"
 
 class IndexBuffer : public Bindable
 {
 public:
 	IndexBuffer() = default;
-	IndexBuffer(const Graphics& graphics, const std::vector<unsigned short>& indices);
+	IndexBuffer(const Graphics& graphics, std::span<const unsigned short> indices);
+	// Take over 16-bit indices generated straight into an upload
+	IndexBuffer(Graphics& graphics, Upload& indices);
 	~IndexBuffer() override = default;
 	IndexBuffer(const IndexBuffer&) = delete;
 	IndexBuffer& operator=(const IndexBuffer&) = delete;
@@ -15,7 +20,14 @@ public:
 
 	void bind(Graphics& graphics) noexcept override;
 	UINT getCount() const noexcept;
+	// Numbered as buffers are created, so it is the same from run to run wherever the buffer lands in memory.
+	// The render queue keys on its low 14 bits.
+	std::uint16_t getMeshId() const noexcept;
 protected:
 	UINT count_;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer_;
+private:
+	static std::uint16_t nextMeshId() noexcept;
+
+	const std::uint16_t meshId_ = nextMeshId();
 };
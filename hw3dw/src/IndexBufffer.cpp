@@ -1,10 +1,12 @@
 #include "GraphicsThrowMacros.hpp"
 #include "IndexBuffer.hpp"
+#include "MemoryTracker.hpp"
 
-IndexBuffer::IndexBuffer(const Graphics& graphics, const std::vector<unsigned short>& indices)
+IndexBuffer::IndexBuffer(const Graphics& graphics, const std::span<const unsigned short> indices)
 	:
 	count_(static_cast<UINT>(indices.size()))
 {
+	MemoryTracker::Scope scope(MemoryTag::Meshes);
 	INFOMAN(graphics);
 
 	const D3D11_BUFFER_DESC bufferDesc = {
@@ -25,6 +27,23 @@ IndexBuffer::IndexBuffer(const Graphics& graphics, const std::vector<unsigned sh
 	GFX_THROW_INFO(getDevice(graphics)->CreateBuffer(&bufferDesc, &subresourceData, &indexBuffer_));
 }
 
+IndexBuffer::IndexBuffer(Graphics& graphics, Upload& indices)
+	:
+	count_(static_cast<UINT>(indices.getSize() / sizeof(unsigned short)))
+{
+	MemoryTracker::Scope scope(MemoryTag::Meshes);
+	const D3D11_BUFFER_DESC bufferDesc = {
+		.ByteWidth = static_cast<UINT>(count_ * sizeof(unsigned short)),
+		.Usage = D3D11_USAGE_DEFAULT,
+		.BindFlags = D3D11_BIND_INDEX_BUFFER,
+		.CPUAccessFlags = 0u,
+		.MiscFlags = 0u,
+		.StructureByteStride = sizeof(unsigned short)
+	};
+
+	indexBuffer_ = createBuffer(indices, bufferDesc);
+}
+
 void IndexBuffer::bind(Graphics& graphics) noexcept
 {
 	getContext(graphics)->IASetIndexBuffer(indexBuffer_.Get(), DXGI_FORMAT_R16_UINT, 0u);
@@ -33,4 +52,15 @@ void IndexBuffer::bind(Graphics& graphics) noexcept
 UINT IndexBuffer::getCount() const noexcept
 {
 	return count_;
+}
+
+std::uint16_t IndexBuffer::getMeshId() const noexcept
+{
+	return meshId_;
+}
+
+std::uint16_t IndexBuffer::nextMeshId() noexcept
+{
+	static std::uint16_t next = 0u;
+	return next++;
 }
\ No newline at end of file
@@ -1,14 +1,24 @@
 #pragma once
+#include <cassert>
 #include <DirectXMath.h>
 #include <functional>
+#include <span>
+#include <utility>
 #include <vector>
 
+#include "MemoryTracker.hpp"
+
+// Meshes keep their vertices and indices on the Meshes tag wherever they are made
+template<class T>
+using MeshVector = std::vector<T, TaggedAllocator<T, MemoryTag::Meshes>>;
+
 template<class T>
 class IndexedTriangleList
 {
 public:
 	IndexedTriangleList() = default;
-	IndexedTriangleList(std::vector<T> vertices, std::vector<unsigned short> indices)
+	// The generators build their storage as MeshVectors and move it in
+	IndexedTriangleList(MeshVector<T> vertices, MeshVector<unsigned short> indices)
 		:
 		vertices_(std::move(vertices)),
 		indices_(std::move(indices))
@@ -19,20 +29,41 @@ public:
 
 	void transform(DirectX::FXMMATRIX& matrix)
 	{
-		for (auto& vertex : vertices_)
+		transform(std::span(vertices_), matrix);
+	}
+
+	// Rewrite [0,1] texture coordinates into the sub-rectangle at (uOffset, vOffset) of size (uScale, vScale)
+	void remapTextureCoordinates(const float uOffset, const float vOffset, const float uScale, const float vScale)
+	{
+		remapTextureCoordinates(std::span(vertices_), uOffset, vOffset, uScale, vScale);
+	}
+
+	// The same for vertices that live somewhere else, such as a mapped upload
+	static void transform(const std::span<T> vertices, DirectX::FXMMATRIX& matrix)
+	{
+		for (auto& vertex : vertices)
 		{
 			const DirectX::XMVECTOR pos = DirectX::XMLoadFloat3(&vertex.pos);
 			DirectX::XMStoreFloat3(&vertex.pos, DirectX::XMVector3Transform(pos, matrix));
 		}
 	}
 
+	static void remapTextureCoordinates(const std::span<T> vertices, const float uOffset, const float vOffset, const float uScale, const float vScale)
+	{
+		for (auto& vertex : vertices)
+		{
+			vertex.tex.u = uOffset + vertex.tex.u * uScale;
+			vertex.tex.v = vOffset + vertex.tex.v * vScale;
+		}
+	}
+
 	// Getter for vertices (read-only)
-	const std::vector<T>& vertices() const { return vertices_; }
+	const MeshVector<T>& vertices() const { return vertices_; }
 
 	// Getter for indices (read-only)
-	const std::vector<unsigned short>& indices() const { return indices_; }
+	const MeshVector<unsigned short>& indices() const { return indices_; }
 
 private:
-	std::vector<T> vertices_;
-	std::vector<unsigned short> indices_;
+	MeshVector<T> vertices_;
+	MeshVector<unsigned short> indices_;
 };
@@ -0,0 +1,113 @@
+#include "InputLatency.hpp"
+
+#include <algorithm>
+#include <utility>
+
+void InputLatency::input(const clock::time_point arrival, const unsigned int count) noexcept
+{
+	pendingOldest_ = pendingOldest_ ? std::min(*pendingOldest_, arrival) : arrival;
+	pendingInputs_ += count;
+}
+
+void InputLatency::beginFrame() noexcept
+{
+	if (openFrames_ == frames_.size())
+	{
+		// Frames that never presented (a lost device, an occluded window) must not block the ones after them
+		firstFrame_ = (firstFrame_ + 1u) % frames_.size();
+		openFrames_--;
+	}
+	frames_[(firstFrame_ + openFrames_) % frames_.size()] = { std::exchange(pendingOldest_, std::nullopt), std::exchange(pendingInputs_, 0u) };
+	openFrames_++;
+}
+
+void InputLatency::present(const clock::time_point presented) noexcept
+{
+	if (openFrames_ == 0u)
+	{
+		return;
+	}
+	const Frame frame = frames_[firstFrame_];
+	firstFrame_ = (firstFrame_ + 1u) % frames_.size();
+	openFrames_--;
+	if (!frame.oldestInput)
+	{
+		return;
+	}
+
+	const double milliseconds = std::chrono::duration<double, std::milli>(presented - *frame.oldestInput).count();
+	histogram_[std::min(static_cast<size_t>(std::max(milliseconds, 0.0)), bucketCount - 1u)]++;
+	minMilliseconds_ = samples_ == 0ull ? milliseconds : std::min(minMilliseconds_, milliseconds);
+	maxMilliseconds_ = samples_ == 0ull ? milliseconds : std::max(maxMilliseconds_, milliseconds);
+	sumMilliseconds_ += milliseconds;
+	samples_++;
+	inputs_ += frame.inputs;
+}
+
+InputLatency::Statistics InputLatency::getStatistics() const noexcept
+{
+	return {
+		.samples = samples_,
+		.inputs = inputs_,
+		.meanMilliseconds = samples_ > 0ull ? sumMilliseconds_ / static_cast<double>(samples_) : 0.0,
+		.minMilliseconds = minMilliseconds_,
+		.maxMilliseconds = maxMilliseconds_,
+		.p50Milliseconds = percentile(0.50),
+		.p95Milliseconds = percentile(0.95),
+		.p99Milliseconds = percentile(0.99)
+	};
+}
+
+std::span<const unsigned long long, InputLatency::bucketCount> InputLatency::getHistogram() const noexcept
+{
+	return histogram_;
+}
+
+void InputLatency::reset() noexcept
+{
+	histogram_.fill(0ull);
+	samples_ = 0ull;
+	inputs_ = 0ull;
+	sumMilliseconds_ = 0.0;
+	minMilliseconds_ = 0.0;
+	maxMilliseconds_ = 0.0;
+}
+
+double InputLatency::percentile(const double fraction) const noexcept
+{
+	if (samples_ == 0ull)
+	{
+		return 0.0;
+	}
+	const auto rank = static_cast<unsigned long long>(fraction * static_cast<double>(samples_ - 1ull)) + 1ull;
+	unsigned long long seen = 0ull;
+	for (size_t bucket = 0; bucket < bucketCount; bucket++)
+	{
+		seen += histogram_[bucket];
+		if (seen >= rank)
+		{
+			// The overflow bucket has no upper edge, the slowest sample stands in for it
+			return bucket + 1u < bucketCount ? static_cast<double>(bucket + 1u) : maxMilliseconds_;
+		}
+	}
+	return maxMilliseconds_;
+}
+
+void InputLatency::Arrivals::note(const clock::time_point arrival) noexcept
+{
+	const clock::rep ticks = arrival.time_since_epoch().count();
+	clock::rep oldest = oldest_.load(std::memory_order_relaxed);
+	while (ticks < oldest && !oldest_.compare_exchange_weak(oldest, ticks, std::memory_order_relaxed))
+	{}
+	count_.fetch_add(1u, std::memory_order_relaxed);
+}
+
+void InputLatency::Arrivals::reportTo(InputLatency& latency) noexcept
+{
+	const clock::rep oldest = oldest_.exchange(none, std::memory_order_relaxed);
+	const unsigned int count = count_.exchange(0u, std::memory_order_relaxed);
+	if (oldest != none)
+	{
+		latency.input(clock::time_point(clock::duration(oldest)), count);
+	}
+}
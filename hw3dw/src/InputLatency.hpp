@@ -0,0 +1,85 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <span>
+
+// Input to photon latency. Input handlers report when events arrived, beginFrame() hands everything that arrived
+// so far to the frame being built and present() closes that frame once its Present returned. Each frame that
+// carried input adds one sample, the time from its oldest input to the present, to a histogram of 1ms buckets.
+// Up to maxFramesInFlight frames may be open at once, for loops that present a frame later than they build it.
+class InputLatency
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	static constexpr size_t bucketCount = 64u;
+	static constexpr size_t maxFramesInFlight = 4u;
+
+	struct Statistics
+	{
+		unsigned long long samples;
+		unsigned long long inputs;
+		double meanMilliseconds;
+		double minMilliseconds;
+		double maxMilliseconds;
+		// Upper edges of the buckets holding the percentiles, so they are accurate to a millisecond
+		double p50Milliseconds;
+		double p95Milliseconds;
+		double p99Milliseconds;
+	};
+
+	// Oldest arrival and count of the events an input queue took since its last report. The queue's producer
+	// may be on another thread than the one reporting, so both are kept in atomics.
+	class Arrivals
+	{
+	public:
+		void note(clock::time_point arrival) noexcept;
+		void reportTo(InputLatency& latency) noexcept;
+	private:
+		static constexpr clock::rep none = std::numeric_limits<clock::rep>::max();
+		std::atomic<clock::rep> oldest_{ none };
+		std::atomic<unsigned int> count_{ 0u };
+	};
+
+public:
+	InputLatency() = default;
+	~InputLatency() = default;
+	InputLatency(const InputLatency&) = delete;
+	InputLatency& operator=(const InputLatency&) = delete;
+	InputLatency(const InputLatency&&) = delete;
+	InputLatency& operator=(const InputLatency&&) = delete;
+
+	// An input arrived; it is waiting for the next beginFrame()
+	void input(clock::time_point arrival, unsigned int count = 1u) noexcept;
+	void beginFrame() noexcept;
+	void present(clock::time_point presented = clock::now()) noexcept;
+
+	[[nodiscard]] Statistics getStatistics() const noexcept;
+	// Sample counts per millisecond, the last bucket also holds everything slower
+	[[nodiscard]] std::span<const unsigned long long, bucketCount> getHistogram() const noexcept;
+	void reset() noexcept;
+private:
+	struct Frame
+	{
+		std::optional<clock::time_point> oldestInput;
+		unsigned int inputs;
+	};
+
+	[[nodiscard]] double percentile(double fraction) const noexcept;
+
+	std::optional<clock::time_point> pendingOldest_;
+	unsigned int pendingInputs_ = 0u;
+	std::array<Frame, maxFramesInFlight> frames_{};
+	size_t firstFrame_ = 0u;
+	size_t openFrames_ = 0u;
+
+	std::array<unsigned long long, bucketCount> histogram_{};
+	unsigned long long samples_ = 0ull;
+	unsigned long long inputs_ = 0ull;
+	double sumMilliseconds_ = 0.0;
+	double minMilliseconds_ = 0.0;
+	double maxMilliseconds_ = 0.0;
+};
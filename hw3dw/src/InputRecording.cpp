@@ -0,0 +1,381 @@
+#include "InputRecording.hpp"
+
+#include <array>
+#include <bit>
+#include <iterator>
+#include <sstream>
+
+#include "Logging.hpp"
+
+namespace
+{
+	constexpr std::array<char, 4> magic = { 'A', 'T', 'I', 'R' };
+	constexpr std::uint32_t version = 2u;
+	// The first version, without the simulation lag
+	constexpr std::uint32_t unlaggedVersion = 1u;
+
+	// Record tags, the Input devices follow FRAME
+	constexpr std::uint8_t frameTag = 0u;
+	constexpr std::uint8_t firstInputTag = 1u;
+	constexpr std::uint8_t lastInputTag = firstInputTag + static_cast<std::uint8_t>(InputRecording::Input::Device::CHAR);
+
+	void putWord(std::ofstream& file, const std::uint32_t word)
+	{
+		const std::array<char, 4> bytes = {
+			static_cast<char>(word & 0xffu),
+			static_cast<char>((word >> 8u) & 0xffu),
+			static_cast<char>((word >> 16u) & 0xffu),
+			static_cast<char>(word >> 24u)
+		};
+		file.write(bytes.data(), bytes.size());
+	}
+
+	class Reader
+	{
+	public:
+		explicit Reader(const std::vector<unsigned char>& bytes) noexcept
+			:
+			bytes_(bytes)
+		{}
+
+		[[nodiscard]] bool atEnd() const noexcept
+		{
+			return position_ == bytes_.size();
+		}
+
+		[[nodiscard]] size_t getPosition() const noexcept
+		{
+			return position_;
+		}
+
+		bool byte(std::uint8_t& value) noexcept
+		{
+			if (bytes_.size() - position_ < 1u)
+			{
+				return false;
+			}
+			value = bytes_[position_++];
+			return true;
+		}
+
+		bool half(std::int16_t& value) noexcept
+		{
+			if (bytes_.size() - position_ < 2u)
+			{
+				return false;
+			}
+			value = static_cast<std::int16_t>(bytes_[position_] | (bytes_[position_ + 1u] << 8u));
+			position_ += 2u;
+			return true;
+		}
+
+		bool word(std::uint32_t& value) noexcept
+		{
+			if (bytes_.size() - position_ < 4u)
+			{
+				return false;
+			}
+			value = static_cast<std::uint32_t>(bytes_[position_]) | (static_cast<std::uint32_t>(bytes_[position_ + 1u]) << 8u)
+				| (static_cast<std::uint32_t>(bytes_[position_ + 2u]) << 16u) | (static_cast<std::uint32_t>(bytes_[position_ + 3u]) << 24u);
+			position_ += 4u;
+			return true;
+		}
+	private:
+		const std::vector<unsigned char>& bytes_;
+		size_t position_ = 0u;
+	};
+}
+
+// --- Recorder ---
+InputRecording::Recorder::Recorder(const std::filesystem::path& path, const unsigned int seed, const std::uint32_t drawableCount,
+	const std::uint32_t simulationLag)
+	:
+	file_(path, std::ios::binary | std::ios::trunc)
+{
+	if (!file_)
+	{
+		throw Exception(__LINE__, __FILE__, "Opening " + path.string() + " to record the input failed.");
+	}
+	file_.write(magic.data(), magic.size());
+	putWord(file_, version);
+	putWord(file_, seed);
+	putWord(file_, drawableCount);
+	putWord(file_, simulationLag);
+	PLOGI << "Recording input into " << path.string() << " (seed " << seed << ", " << drawableCount << " drawables, simulation lag "
+		<< simulationLag << ")";
+}
+
+void InputRecording::Recorder::record(const Mouse::Event& event)
+{
+	const auto [x, y] = event.getPos();
+	write({ Input::Device::MOUSE, static_cast<std::uint8_t>(event.getType()), static_cast<std::int16_t>(x), static_cast<std::int16_t>(y) });
+}
+
+void InputRecording::Recorder::record(const Keyboard::Event& event)
+{
+	const auto type = event.isPress() ? Keyboard::Event::PRESS : event.isRelease() ? Keyboard::Event::RELEASE : Keyboard::Event::INVALID;
+	write({ Input::Device::KEY, static_cast<std::uint8_t>(type), static_cast<std::int16_t>(event.getCode()), 0 });
+}
+
+void InputRecording::Recorder::recordChar(const char character)
+{
+	write({ Input::Device::CHAR, 0u, static_cast<std::int16_t>(static_cast<unsigned char>(character)), 0 });
+}
+
+void InputRecording::Recorder::endFrame(const float seconds)
+{
+	file_.put(static_cast<char>(frameTag));
+	putWord(file_, std::bit_cast<std::uint32_t>(seconds));
+	frameCount_++;
+}
+
+unsigned long long InputRecording::Recorder::getFrameCount() const noexcept
+{
+	return frameCount_;
+}
+
+void InputRecording::Recorder::write(const Input& input)
+{
+	const auto tag = static_cast<std::uint8_t>(firstInputTag + static_cast<std::uint8_t>(input.device));
+	file_.put(static_cast<char>(tag));
+	file_.put(static_cast<char>(input.type));
+	switch (input.device)
+	{
+	case Input::Device::MOUSE:
+	{
+		const auto x = static_cast<std::uint16_t>(input.x);
+		const auto y = static_cast<std::uint16_t>(input.y);
+		const std::array<char, 4> bytes = {
+			static_cast<char>(x & 0xffu), static_cast<char>(x >> 8u), static_cast<char>(y & 0xffu), static_cast<char>(y >> 8u)
+		};
+		file_.write(bytes.data(), bytes.size());
+		break;
+	}
+	case Input::Device::KEY:
+	case Input::Device::CHAR:
+		file_.put(static_cast<char>(input.x));
+		break;
+	}
+}
+
+// --- Replay ---
+InputRecording::Replay::Replay(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw Exception(__LINE__, __FILE__, "Opening the input recording " + path.string() + " failed.");
+	}
+	const std::vector<unsigned char> bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+	Reader reader(bytes);
+	std::array<std::uint8_t, 4> fileMagic{};
+	std::uint32_t fileVersion = 0u;
+	std::uint32_t seed = 0u;
+	for (auto& letter : fileMagic)
+	{
+		reader.byte(letter);
+	}
+	if (std::bit_cast<std::array<char, 4>>(fileMagic) != magic || !reader.word(fileVersion) || !reader.word(seed) || !reader.word(drawableCount_))
+	{
+		throw Exception(__LINE__, __FILE__, path.string() + " is not an input recording.");
+	}
+	if (fileVersion != version && fileVersion != unlaggedVersion)
+	{
+		throw Exception(__LINE__, __FILE__, path.string() + " is an input recording of version " + std::to_string(fileVersion)
+			+ ", this build reads versions " + std::to_string(unlaggedVersion) + " to " + std::to_string(version) + ".");
+	}
+	if (fileVersion == version && !reader.word(simulationLag_))
+	{
+		throw Exception(__LINE__, __FILE__, path.string() + " is not an input recording.");
+	}
+	seed_ = seed;
+
+	Frame frame;
+	while (!reader.atEnd())
+	{
+		const size_t recordStart = reader.getPosition();
+		std::uint8_t tag = 0u;
+		reader.byte(tag);
+		bool complete = false;
+		if (tag == frameTag)
+		{
+			std::uint32_t seconds = 0u;
+			complete = reader.word(seconds);
+			frame.seconds = std::bit_cast<float>(seconds);
+			if (complete)
+			{
+				frames_.push_back(std::move(frame));
+				frame = {};
+			}
+		}
+		else if (tag >= firstInputTag && tag <= lastInputTag)
+		{
+			Input input{ static_cast<Input::Device>(tag - firstInputTag), 0u, 0, 0 };
+			if (input.device == Input::Device::MOUSE)
+			{
+				complete = reader.byte(input.type) && reader.half(input.x) && reader.half(input.y);
+			}
+			else
+			{
+				std::uint8_t code = 0u;
+				complete = reader.byte(input.type) && reader.byte(code);
+				input.x = code;
+			}
+			frame.inputs.push_back(input);
+		}
+		else
+		{
+			std::ostringstream out;
+			out << path.string() << " has an unknown record " << static_cast<unsigned int>(tag) << " at byte " << recordStart << ".";
+			throw Exception(__LINE__, __FILE__, out.str());
+		}
+
+		if (!complete)
+		{
+			// A recording cut short by a crash still replays up to its last whole frame
+			PLOGW << path.string() << " ends inside a record at byte " << recordStart << ", replaying the " << frames_.size() << " complete frames";
+			break;
+		}
+	}
+	PLOGI << "Replaying " << frames_.size() << " frames from " << path.string() << " (seed " << seed_ << ", " << drawableCount_ << " drawables, simulation lag "
+		<< simulationLag_ << ")";
+}
+
+float InputRecording::Replay::apply(const size_t frame, Mouse& mouse, Keyboard& keyboard) const
+{
+	using enum Mouse::Event::EventType;
+	if (frame < simulationLag_)
+	{
+		return 0.0f;
+	}
+	const Frame& recorded = frames_.at(frame - simulationLag_);
+	for (const Input& input : recorded.inputs)
+	{
+		const int x = input.x;
+		const int y = input.y;
+		switch (input.device)
+		{
+		case Input::Device::MOUSE:
+			// There are no double click handlers, the press they stand for is what changed the state
+			switch (static_cast<Mouse::Event::EventType>(input.type))
+			{
+			case L_PRESS:
+			case L_DOUBLE:
+				mouse.onLeftPressed(x, y);
+				break;
+			case L_RELEASE:
+				mouse.onLeftReleased(x, y);
+				break;
+			case R_PRESS:
+			case R_DOUBLE:
+				mouse.onRightPressed(x, y);
+				break;
+			case R_RELEASE:
+				mouse.onRightReleased(x, y);
+				break;
+			case M_PRESS:
+			case M_DOUBLE:
+				mouse.onMiddlePressed(x, y);
+				break;
+			case M_RELEASE:
+				mouse.onMiddleReleased(x, y);
+				break;
+			case X1_PRESS:
+				mouse.onX1Pressed(x, y);
+				break;
+			case X1_RELEASE:
+				mouse.onX1Released(x, y);
+				break;
+			case X2_PRESS:
+				mouse.onX2Pressed(x, y);
+				break;
+			case X2_RELEASE:
+				mouse.onX2Released(x, y);
+				break;
+			case WHEEL_UP:
+				mouse.onWheelUp(x, y);
+				break;
+			case WHEEL_DOWN:
+				mouse.onWheelDown(x, y);
+				break;
+			case WHEEL_RIGHT:
+				mouse.onWheelRight(x, y);
+				break;
+			case WHEEL_LEFT:
+				mouse.onWheelLeft(x, y);
+				break;
+			case MOVE:
+				mouse.onMouseMove(x, y);
+				break;
+			case ENTER:
+				mouse.onMouseEnter(x, y);
+				break;
+			case LEAVE:
+				mouse.onMouseLeave();
+				break;
+			}
+			break;
+		case Input::Device::KEY:
+			if (input.type == static_cast<std::uint8_t>(Keyboard::Event::PRESS))
+			{
+				keyboard.onKeyPressed(static_cast<unsigned char>(input.x));
+			}
+			else if (input.type == static_cast<std::uint8_t>(Keyboard::Event::RELEASE))
+			{
+				keyboard.onKeyReleased(static_cast<unsigned char>(input.x));
+			}
+			break;
+		case Input::Device::CHAR:
+			keyboard.onChar(static_cast<unsigned char>(input.x));
+			break;
+		}
+	}
+	return recorded.seconds;
+}
+
+unsigned int InputRecording::Replay::getSeed() const noexcept
+{
+	return seed_;
+}
+
+std::uint32_t InputRecording::Replay::getDrawableCount() const noexcept
+{
+	return drawableCount_;
+}
+
+std::uint32_t InputRecording::Replay::getSimulationLag() const noexcept
+{
+	return simulationLag_;
+}
+
+const std::vector<InputRecording::Frame>& InputRecording::Replay::getFrames() const noexcept
+{
+	return frames_;
+}
+
+// input recording exception stuff
+InputRecording::Exception::Exception(const int line, const char* file, std::string note) noexcept
+	:
+	AtumException(line, file),
+	note_(std::move(note))
+{}
+
+const char* InputRecording::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AtumException::what() << "\n"
+		<< "[Note] " << getNote();
+	whatBuffer_ = oss.str();
+	return whatBuffer_.c_str();
+}
+
+const char* InputRecording::Exception::getType() const noexcept
+{
+	return "Atum Input Recording Exception";
+}
+
+const std::string& InputRecording::Exception::getNote() const noexcept
+{
+	return note_;
+}
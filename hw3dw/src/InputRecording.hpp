@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "AtumException.hpp"
+#include "Keyboard.hpp"
+#include "Mouse.hpp"
+
+// Everything that makes two runs differ: the scene seed, each frame's Timer::mark() duration and the mouse
+// and keyboard events the frame consumed. Recorder writes them into a compact binary log while the app runs,
+// Replay reads one back and feeds each frame's events to the Mouse and Keyboard handlers, so a replay
+// (--replay <file> headless, or --regression <directory> --replay <file> with rendering) repeats the recorded
+// session frame for frame.
+//
+// Frames are counted the way the simulation sees them. With the pipelined simulation, rendered frame n hands its
+// time and input to simulated frame n + 1, so the recording keeps that lag and Replay::apply() shifts by it.
+//
+// The log is little endian: a header of "ATIR", version, seed, drawable count and simulation lag as 32 bit
+// words, then one record per event, a tag byte followed by its fields, with a FRAME record holding the frame's
+// duration closing every frame. A frame without input costs 5 bytes, a mouse event 6. Version 1 recordings have
+// no lag word and replay without one.
+class InputRecording
+{
+public:
+	class Exception : public AtumException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* getType() const noexcept override;
+		const std::string& getNote() const noexcept;
+	private:
+		std::string note_;
+	};
+
+	struct Input
+	{
+		enum class Device : std::uint8_t
+		{
+			MOUSE,
+			KEY,
+			CHAR
+		};
+
+		Device device;
+		// Mouse::Event::EventType or Keyboard::Event::EventType
+		std::uint8_t type;
+		// Mouse position, or the key code and character in x
+		std::int16_t x;
+		std::int16_t y;
+	};
+
+	struct Frame
+	{
+		float seconds = 0.0f;
+		std::vector<Input> inputs;
+	};
+
+	class Recorder
+	{
+	public:
+		// simulationLag is how many frames the simulation runs behind the input, 1 when it is pipelined
+		Recorder(const std::filesystem::path& path, unsigned int seed, std::uint32_t drawableCount, std::uint32_t simulationLag);
+		~Recorder() = default;
+		Recorder(const Recorder&) = delete;
+		Recorder& operator=(const Recorder&) = delete;
+		Recorder(const Recorder&&) = delete;
+		Recorder& operator=(const Recorder&&) = delete;
+
+		void record(const Mouse::Event& event);
+		void record(const Keyboard::Event& event);
+		void recordChar(char character);
+		// Close the frame with its Timer::mark() duration
+		void endFrame(float seconds);
+
+		[[nodiscard]] unsigned long long getFrameCount() const noexcept;
+	private:
+		void write(const Input& input);
+
+		std::ofstream file_;
+		unsigned long long frameCount_ = 0ull;
+	};
+
+	class Replay
+	{
+	public:
+		explicit Replay(const std::filesystem::path& path);
+		~Replay() = default;
+		Replay(const Replay&) = delete;
+		Replay& operator=(const Replay&) = delete;
+		Replay(const Replay&&) = delete;
+		Replay& operator=(const Replay&&) = delete;
+
+		// Run the input that reached simulated frame `frame` through the handlers that produced it and return the
+		// time it simulates. The first getSimulationLag() frames had no input yet and simulate no time.
+		float apply(size_t frame, Mouse& mouse, Keyboard& keyboard) const;
+
+		[[nodiscard]] unsigned int getSeed() const noexcept;
+		[[nodiscard]] std::uint32_t getDrawableCount() const noexcept;
+		[[nodiscard]] std::uint32_t getSimulationLag() const noexcept;
+		[[nodiscard]] const std::vector<Frame>& getFrames() const noexcept;
+	private:
+		unsigned int seed_ = 0u;
+		std::uint32_t drawableCount_ = 0u;
+		std::uint32_t simulationLag_ = 0u;
+		std::vector<Frame> frames_;
+	};
+};
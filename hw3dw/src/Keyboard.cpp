@@ -23,31 +23,39 @@ bool Keyboard::isKeyPressed(const unsigned char keyCode) const noexcept
 	return keyState_[keyCode];
 }
 
+void Keyboard::queueEvent(const Event::EventType eventType, const unsigned char keyCode) noexcept
+{
+	const Event event(eventType, keyCode);
+	eventBuffer_.push(event);
+	arrivals_.note(event.getTimestamp());
+}
+
+void Keyboard::reportArrivals(InputLatency& latency) noexcept
+{
+	arrivals_.reportTo(latency);
+}
+
 std::optional<Keyboard::Event> Keyboard::readKey() noexcept
 {
-	if (!eventBuffer_.empty())
-	{
-		const Event e = eventBuffer_.front();
-		eventBuffer_.pop();
-		return e;
-	}
-	return {};
+	return eventBuffer_.pop();
 }
 
 bool Keyboard::isKeyEmpty() const noexcept
 {
-	return eventBuffer_.empty();
+	return eventBuffer_.isEmpty();
 }
 
 void Keyboard::clearEventBuffer() noexcept
 {
-	eventBuffer_ = std::queue<Event>();
+	eventBuffer_.clear();
 }
 
+#if defined(_WIN32)
 LRESULT Keyboard::WndProcHandler([[maybe_unused]] HWND window, const UINT msg, const WPARAM wParam, const LPARAM lParam) noexcept
 {
 #ifdef LOG_WINDOW_MESSAGES
-	PLOGV << windowsMessageMap(msg, lParam, wParam).c_str();
+	char message[WindowsMessageMap::bufferSize];
+	PLOGV << windowsMessageMap(message, msg, lParam, wParam);
 #endif
 	switch (msg)
 	{
@@ -71,15 +79,16 @@ LRESULT Keyboard::WndProcHandler([[maybe_unused]] HWND window, const UINT msg, c
 	}
 	return 0;
 }
+#endif
 
 bool Keyboard::isCharEmpty() const noexcept
 {
-	return charBuffer_.empty();
+	return charBuffer_.isEmpty();
 }
 
 void Keyboard::clearCharBuffer() noexcept
 {
-	charBuffer_ = std::queue<char>();
+	charBuffer_.clear();
 }
 
 void Keyboard::clear() noexcept
@@ -106,27 +115,26 @@ bool Keyboard::isAutorepeatEnabled() noexcept
 void Keyboard::onKeyPressed(unsigned char keyCode) noexcept
 {
 	keyState_[keyCode] = true;
-	eventBuffer_.emplace(Event::EventType::PRESS, keyCode);
-	trimBuffer(eventBuffer_);
+	queueEvent(Event::EventType::PRESS, keyCode);
 #ifdef LOG_KEYBOARD_MESSAGES // defined in LoggingConfig.h
-	PLOGV << "keydown: " << virtualKeyMap(keyCode);
+	char keyName[VirtualKeyMap::bufferSize];
+	PLOGV << "keydown: " << virtualKeyMap(keyName, keyCode);
 #endif
 }
 
 void Keyboard::onKeyReleased(unsigned char keyCode) noexcept
 {
 	keyState_[keyCode] = false;
-	eventBuffer_.emplace(Event::EventType::RELEASE, keyCode);
-	trimBuffer(eventBuffer_);
+	queueEvent(Event::EventType::RELEASE, keyCode);
 #ifdef LOG_KEYBOARD_MESSAGES // defined in LoggingConfig.h
-	PLOGV << "keyup: " << virtualKeyMap(keyCode);
+	char keyName[VirtualKeyMap::bufferSize];
+	PLOGV << "keyup: " << virtualKeyMap(keyName, keyCode);
 #endif
 }
 
 void Keyboard::onChar(unsigned char character) noexcept
 {
-	charBuffer_.emplace(character);
-	trimBuffer(charBuffer_);
+	charBuffer_.push(static_cast<char>(character));
 #ifdef LOG_KEYBOARD_CHARS // defined in LoggingConfig.h
 	PLOGV << "char: " << character;
 #endif
@@ -137,25 +145,7 @@ void Keyboard::clearState() noexcept
 	keyState_.reset();
 }
 
-template <typename T>
-void Keyboard::trimBuffer(std::queue<T>& buffer) noexcept
-{
-	while (buffer.size() > BUFFER_SIZE)
-	{
-		buffer.pop();
-	}
-}
-
 std::optional<char> Keyboard::readChar() noexcept
 {
-	if (!charBuffer_.empty())
-	{
-		const char charCode = charBuffer_.front();
-		charBuffer_.pop();
-		return charCode;
-	}
-	else
-	{
-		return {};
-	}
+	return charBuffer_.pop();
 }
@@ -2,9 +2,13 @@
 
 #include <bitset>
 #include <optional>
-#include <queue>
+#include <utility>
 
+#if defined(_WIN32)
 #include "AtumWindows.hpp"
+#endif
+#include "EventRing.hpp"
+#include "InputLatency.hpp"
 
 class Keyboard
 {
@@ -31,13 +35,16 @@ public:
 	private:
 		EventType eventType_;
 		unsigned char code_;
+		InputLatency::clock::time_point timestamp_;
 
 	public:
 		Event() = delete;
 		Event(const EventType eventType, const unsigned char code) noexcept
 			:
 			eventType_(eventType),
-			code_(code)
+			code_(code),
+			// Events are built by the message handler, so this is when the key arrived
+			timestamp_(InputLatency::clock::now())
 		{}
 
 		[[nodiscard]] bool isPress() const noexcept
@@ -54,24 +61,35 @@ public:
 		{
 			return code_;
 		}
-	};
 
-	// key event and char event management
-private:
-	template<typename T>
-	static void trimBuffer(std::queue<T>& buffer) noexcept;
+		[[nodiscard]] InputLatency::clock::time_point getTimestamp() const noexcept
+		{
+			return timestamp_;
+		}
+	};
 
 	// key event management
 private:
+	void queueEvent(Event::EventType eventType, unsigned char keyCode) noexcept;
 	std::optional<Event> readKey() noexcept;
 	[[nodiscard]] bool isKeyEmpty() const noexcept;
 	void clearEventBuffer() noexcept;
 public:
+#if defined(_WIN32)
 	LRESULT WndProcHandler(HWND window, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+#endif
 	[[nodiscard]] bool isKeyPressed(unsigned char keyCode) const noexcept;
 	void onKeyPressed(unsigned char keyCode) noexcept;
 	void onKeyReleased(unsigned char keyCode) noexcept;
 	void clearState() noexcept;
+	// Hand the arrival times of the key events queued since the last call to the latency tracker
+	void reportArrivals(InputLatency& latency) noexcept;
+	// Hand every queued key event to consume(const Event&) oldest first, return how many there were
+	template<class F>
+	size_t drainKeys(F&& consume)
+	{
+		return eventBuffer_.drain(std::forward<F>(consume));
+	}
 
 	// char event management
 private:
@@ -81,6 +99,12 @@ private:
 	void clear() noexcept;
 public:
 	void onChar(unsigned char character) noexcept;
+	// Hand every queued character to consume(char) oldest first, return how many there were
+	template<class F>
+	size_t drainChars(F&& consume)
+	{
+		return charBuffer_.drain(std::forward<F>(consume));
+	}
 
 	// auto repeat control
 public:
@@ -93,6 +117,7 @@ private:
 	static constexpr unsigned int BUFFER_SIZE = 16u;
 	static bool autorepeatEnabled_;
 	std::bitset<NUMBER_OF_KEYS> keyState_;
-	std::queue<Event> eventBuffer_;
-	std::queue<char> charBuffer_;
+	EventRing<Event, BUFFER_SIZE> eventBuffer_;
+	EventRing<char, BUFFER_SIZE> charBuffer_;
+	InputLatency::Arrivals arrivals_;
 };
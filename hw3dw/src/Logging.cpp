@@ -1,60 +1,253 @@
 #include "Logging.hpp"
 
 #include <3rdParty/plog/Init.h>
-#include <3rdParty/plog/Appenders/ColorConsoleAppender.h>
-#include <3rdParty/plog/Appenders/DebugOutputAppender.h>
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <optional>
+#include <sstream>
 
-plog::DynamicAppender Logging::dynamicAppender_;
+#include "AtumWindows.hpp"
+
+namespace
+{
+	using nostringstream = std::basic_ostringstream<plog::util::nchar>;
+
+	// How long a flush waits for the logging thread
+	constexpr std::chrono::milliseconds flushTimeout{ 500 };
+
+	// plog's TxtFormatter layout
+	void formatTxt(nostringstream& out, const AsyncAppender::Entry& entry)
+	{
+		tm t;
+		localtime_s(&t, &entry.time);
+		out << t.tm_year + 1900 << "-" << std::setfill(PLOG_NSTR('0')) << std::setw(2) << t.tm_mon + 1 << "-" << std::setw(2) << t.tm_mday << " "
+			<< std::setw(2) << t.tm_hour << ":" << std::setw(2) << t.tm_min << ":" << std::setw(2) << t.tm_sec << "." << std::setw(3) << entry.milliseconds << " "
+			<< std::setfill(PLOG_NSTR(' ')) << std::setw(5) << std::left << plog::severityToString(entry.severity) << std::right << " "
+			<< "[" << entry.tid << "] "
+			<< "[" << entry.func << "@" << entry.line << "] "
+			<< entry.message << "\n";
+	}
+
+	// The console gets plog's FuncMessageFormatter layout in ColorConsoleAppender's colours
+	class ConsoleSink : public AsyncAppender::Sink
+	{
+	public:
+		explicit ConsoleSink(const plog::Severity maxSeverity) noexcept
+			:
+			Sink(maxSeverity),
+			output_(GetStdHandle(STD_OUTPUT_HANDLE))
+		{
+			CONSOLE_SCREEN_BUFFER_INFO info;
+			if (GetConsoleScreenBufferInfo(output_, &info))
+			{
+				originalAttributes_ = info.wAttributes;
+			}
+		}
+
+		void write(const std::span<const AsyncAppender::Entry> entries) noexcept override
+		{
+			// Runs of the same severity share a colour and a single console write
+			nostringstream out;
+			plog::Severity current = plog::none;
+			for (const auto& entry : entries)
+			{
+				if (!checkSeverity(entry.severity))
+				{
+					continue;
+				}
+				if (entry.severity != current)
+				{
+					writeOut(out, current);
+					current = entry.severity;
+				}
+				out << entry.func << "@" << entry.line << ": " << entry.message << "\n";
+			}
+			writeOut(out, current);
+		}
+	private:
+		void writeOut(nostringstream& out, const plog::Severity severity) const noexcept
+		{
+			const auto text = out.str();
+			if (text.empty())
+			{
+				return;
+			}
+			SetConsoleTextAttribute(output_, attributes(severity));
+			DWORD written = 0;
+			WriteConsoleW(output_, text.c_str(), static_cast<DWORD>(text.size()), &written, nullptr);
+			SetConsoleTextAttribute(output_, originalAttributes_);
+			out.str({});
+		}
+
+		[[nodiscard]] WORD attributes(const plog::Severity severity) const noexcept
+		{
+			const WORD background = originalAttributes_ & 0xf0u;
+			switch (severity)
+			{
+			case plog::fatal:
+				return FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY | BACKGROUND_RED;
+			case plog::error:
+				return FOREGROUND_RED | FOREGROUND_INTENSITY | background;
+			case plog::warning:
+				return FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY | background;
+			case plog::debug:
+			case plog::verbose:
+				return FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY | background;
+			default:
+				return originalAttributes_;
+			}
+		}
+
+		HANDLE output_;
+		WORD originalAttributes_ = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
+	};
+
+	// One OutputDebugString per batch instead of one per record
+	class DebugOutputSink : public AsyncAppender::Sink
+	{
+	public:
+		using Sink::Sink;
+
+		void write(const std::span<const AsyncAppender::Entry> entries) noexcept override
+		{
+			nostringstream out;
+			for (const auto& entry : entries)
+			{
+				if (checkSeverity(entry.severity))
+				{
+					formatTxt(out, entry);
+				}
+			}
+			const auto text = out.str();
+			if (!text.empty())
+			{
+				OutputDebugStringW(text.c_str());
+			}
+		}
+	};
+
+	// Defined ahead of the appender so they are still there for its last write at exit
+	std::optional<ConsoleSink> consoleSink;
+	std::optional<DebugOutputSink> debugOutputSink;
+	std::optional<BinaryLog> binaryLog;
+
+	LONG WINAPI flushOnCrash([[maybe_unused]] EXCEPTION_POINTERS* exception)
+	{
+		Logging::flush();
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+}
+
+AsyncAppender Logging::asyncAppender_({
+	.blocks = LOG_ASYNC_BLOCKS,
+	.overflow = LOG_ASYNC_BLOCK_WHEN_FULL ? AsyncAppender::OverflowPolicy::BLOCK : AsyncAppender::OverflowPolicy::DROP,
+	.neverDrop = plog::warning,
+	.interval = std::chrono::milliseconds(LOG_ASYNC_INTERVAL)
+});
 
 void Logging::initialize(const plog::Severity maxSeverity) {
-	rootLogger_ = &plog::init<PLOG_DEFAULT_INSTANCE_ID>(maxSeverity, &dynamicAppender_);
+	rootSeverity_ = maxSeverity;
+	rootLogger_ = &plog::init<PLOG_DEFAULT_INSTANCE_ID>(maxSeverity, &asyncAppender_);
+
+	// Whatever is still queued when the process goes down is what explains it
+	SetUnhandledExceptionFilter(flushOnCrash);
+	static const std::terminate_handler previousTerminate = std::set_terminate([]
+		{
+			Logging::flush();
+			if (previousTerminate)
+			{
+				previousTerminate();
+			}
+			std::abort();
+		});
 }
 
 void Logging::initializeConsoleLogger(const plog::Severity maxSeverity) {
 	PLOGI << "Initializing Console Logger";
-	static plog::ColorConsoleAppender<plog::FuncMessageFormatter> console_appender;
-	plog::Logger<CONSOLE>& console_logger = plog::init<CONSOLE>(maxSeverity, &console_appender);
-	consoleLogger_ = &console_logger;
-	dynamicAppender_.addAppender(&console_logger);
+	consoleSink.emplace(maxSeverity);
+	consoleSink_ = &*consoleSink;
+	asyncAppender_.addSink(*consoleSink);
+	updateRootSeverity();
 	PLOGV << "Console Logger Initialized";
 }
 
 void Logging::initializeDebugOutputLogger(const plog::Severity maxSeverity) {
 	PLOGI << "Initializing DebugOutput Logger";
-	static plog::DebugOutputAppender<plog::TxtFormatter> debug_output_appender;
-	plog::Logger<DEBUG_OUTPUT>& debug_output_logger = plog::init<DEBUG_OUTPUT>(maxSeverity, &debug_output_appender);
-	debugOutputLogger_ = &debug_output_logger;
-	dynamicAppender_.addAppender(&debug_output_logger);
+	debugOutputSink.emplace(maxSeverity);
+	debugOutputSink_ = &*debugOutputSink;
+	asyncAppender_.addSink(*debugOutputSink);
+	updateRootSeverity();
 	PLOGV << "DebugOutput Logger Initialized";
 }
 
+void Logging::initializeBinaryLogger(const std::filesystem::path& path, const plog::Severity maxSeverity)
+{
+	PLOGI << "Initializing Binary Logger to " << path.string();
+	binaryLog.emplace(path, size_t{ LOG_BINARY_MEGABYTES } << 20u, maxSeverity);
+	BinaryLog::set(&*binaryLog);
+	BLOGV("Binary Logger Initialized");
+}
+
 void Logging::setLoggerSeverity(const plog::Severity maxSeverity)
 {
-	rootLogger_->setMaxSeverity(maxSeverity);
+	rootSeverity_ = maxSeverity;
+	updateRootSeverity();
 }
 
 void Logging::setConsoleLoggerSeverity(const plog::Severity maxSeverity)
 {
-	consoleLogger_->setMaxSeverity(maxSeverity);
+	consoleSink_->setMaxSeverity(maxSeverity);
+	updateRootSeverity();
 }
 
 void Logging::setDebugOutputLoggerSeverity(const plog::Severity maxSeverity)
 {
-	debugOutputLogger_->setMaxSeverity(maxSeverity);
+	debugOutputSink_->setMaxSeverity(maxSeverity);
+	updateRootSeverity();
 }
 
 void Logging::shutdownConsoleLogger() {
-	if (consoleLogger_) {
-		dynamicAppender_.removeAppender(consoleLogger_);
-		consoleLogger_ = nullptr;
+	if (consoleSink_) {
+		// The console is about to go away, so what was logged to it goes out first
+		asyncAppender_.flush(flushTimeout);
+		asyncAppender_.removeSink(*consoleSink_);
+		consoleSink_ = nullptr;
+		updateRootSeverity();
 	}
 	PLOGI << "Shutdown Console Logger";
 }
 
 void Logging::shutdownDebugOutputLogger() {
-	if (debugOutputLogger_) {
-		dynamicAppender_.removeAppender(debugOutputLogger_);
-		debugOutputLogger_ = nullptr;
+	if (debugOutputSink_) {
+		asyncAppender_.flush(flushTimeout);
+		asyncAppender_.removeSink(*debugOutputSink_);
+		debugOutputSink_ = nullptr;
+		updateRootSeverity();
 	}
 	PLOGI << "Shutdown DebugOutput Logger";
 }
+
+void Logging::updateRootSeverity()
+{
+	rootLogger_->setMaxSeverity(std::min(rootSeverity_, asyncAppender_.getMaxSinkSeverity()));
+}
+
+void Logging::flush() noexcept
+{
+	asyncAppender_.flush(flushTimeout);
+}
+
+AsyncAppender::Statistics Logging::getStatistics() noexcept
+{
+	return asyncAppender_.getStatistics();
+}
+
+std::optional<BinaryLog::Statistics> Logging::getBinaryStatistics() noexcept
+{
+	if (!binaryLog)
+	{
+		return std::nullopt;
+	}
+	return binaryLog->getStatistics();
+}
@@ -1,16 +1,38 @@
 #pragma once
 #include <3rdParty/plog/Log.h>
-#include <3rdParty/plog/Appenders/DynamicAppender.h>
 #include <3rdParty/plog/Formatters/FuncMessageFormatter.h>
 #include <3rdParty/plog/Formatters/TxtFormatter.h>
+#include <filesystem>
+#include <optional>
 
 // ReSharper disable once CppUnusedIncludeDirective
 #include "LoggingConfig.hpp"
+#include "AsyncAppender.hpp"
+#include "BinaryLog.hpp"
 
+// The check is a constant, so a site below LOG_LEVEL_COMPILED leaves no code behind while its arguments are still
+// type checked. Sites that stay go through plog's runtime check, which skips building and formatting the record.
+#define LOG_IF_COMPILED_(severity) if constexpr ((severity) > LOG_LEVEL_COMPILED) {;} else
+
+#undef PLOGV
+#undef PLOGD
+#undef PLOGI
+#undef PLOGW
+#undef PLOGE
+#undef PLOGF
+#define PLOGV LOG_IF_COMPILED_(plog::verbose) PLOG_VERBOSE
+#define PLOGD LOG_IF_COMPILED_(plog::debug) PLOG_DEBUG
+#define PLOGI LOG_IF_COMPILED_(plog::info) PLOG_INFO
+#define PLOGW LOG_IF_COMPILED_(plog::warning) PLOG_WARNING
+#define PLOGE LOG_IF_COMPILED_(plog::error) PLOG_ERROR
+#define PLOGF LOG_IF_COMPILED_(plog::fatal) PLOG_FATAL
+
+// Every logger writes through one AsyncAppender, the console and debug output are its sinks. Their output
+// keeps the formats of plog's FuncMessageFormatter and TxtFormatter. The root logger's level is held to the most
+// verbose sink's, so a record no sink would write is never formatted. BLOG sites go to the binary logger instead
+// once it is initialized.
 class Logging {
 public:
-	enum : std::uint8_t { DEBUG_OUTPUT = 1, CONSOLE };
-
 	static void initialize(plog::Severity maxSeverity);
 	static void initializeConsoleLogger(plog::Severity maxSeverity);
 	static void initializeDebugOutputLogger(plog::Severity maxSeverity);
@@ -19,9 +41,19 @@ public:
 	static void setDebugOutputLoggerSeverity(plog::Severity maxSeverity);
 	static void shutdownConsoleLogger();
 	static void shutdownDebugOutputLogger();
+	// The file stays open until the process exits, so only threads that have stopped by then may log to it
+	static void initializeBinaryLogger(const std::filesystem::path& path, plog::Severity maxSeverity);
+	// Write out everything logged so far; the crash handlers installed by initialize() call it as well
+	static void flush() noexcept;
+	[[nodiscard]] static AsyncAppender::Statistics getStatistics() noexcept;
+	// Nothing when there is no binary logger
+	[[nodiscard]] static std::optional<BinaryLog::Statistics> getBinaryStatistics() noexcept;
 private:
-	static plog::DynamicAppender dynamicAppender_;
+	static void updateRootSeverity();
+
+	static AsyncAppender asyncAppender_;
+	static inline plog::Severity rootSeverity_ = plog::none;
 	static inline plog::Logger<PLOG_DEFAULT_INSTANCE_ID>* rootLogger_;
-	static inline plog::Logger<CONSOLE>* consoleLogger_;
-	static inline plog::Logger<DEBUG_OUTPUT>* debugOutputLogger_;
+	static inline AsyncAppender::Sink* consoleSink_;
+	static inline AsyncAppender::Sink* debugOutputSink_;
 };
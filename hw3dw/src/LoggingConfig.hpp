@@ -20,6 +20,29 @@
 #define LOG_LEVEL_DEBUG_OUTPUT plog::verbose
 #endif
 
+/* Compile time severity - Logging.hpp */
+// Call sites less severe than this compile to nothing, arguments and severity check included. Runtime levels
+// above it have no effect, so it stays at verbose where the runtime level can be raised to verbose.
+#if defined(LOG_LEVEL_FULL) || !defined(NDEBUG)
+#define LOG_LEVEL_COMPILED plog::verbose
+#else
+#define LOG_LEVEL_COMPILED plog::info
+#endif
+
+/* Asynchronous logging - Logging.cpp */
+// Queue size in 128 byte blocks, about one block per short record
+#define LOG_ASYNC_BLOCKS 4096
+// 1 makes a full queue block the thread that logs, 0 drops its record; warnings and worse always wait
+#define LOG_ASYNC_BLOCK_WHEN_FULL 0
+// Milliseconds records collect before the logging thread writes them
+#define LOG_ASYNC_INTERVAL 5
+
+/* Binary logging - Logging.cpp, WinMain.cpp */
+// hw3dw --binary-log <file> sends the BLOG sites to a memory mapped file for hw3dlog to decode, see BinaryLog.hpp
+#define LOG_LEVEL_BINARY plog::verbose
+// Size of the file; records past it are dropped
+#define LOG_BINARY_MEGABYTES 256
+
 /* Log the Window Messages - App.cpp */
 //#define LOG_WINDOW_MESSAGES
 //#define LOG_WINDOW_MOUSE_MESSAGES
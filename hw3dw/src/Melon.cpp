@@ -3,34 +3,16 @@
 #include "BindableIncludes.hpp"
 #include "Sphere.hpp"
 
-Melon::Melon(Graphics& graphics,
-             std::mt19937& rng,
-             std::uniform_real_distribution<float>& distanceDistribution,								// rdist
-             std::uniform_real_distribution<float>& sphericalCoordinatePositionDistribution,			// adist
-             std::uniform_real_distribution<float>& rotationOfDrawableDistribution,						// ddist
-             std::uniform_real_distribution<float>& sphericalCoordinateMovementOfDrawableDistribution,	// odist
-             std::uniform_int_distribution<int>& latitudeDistribution,
-             std::uniform_int_distribution<int>& longitudeDistribution)
+Melon::Melon(Graphics& graphics, const ScenePopulation::Spawn& spawn)
 	:
-	radiusDistanceFromCenter_(distanceDistribution(rng)),
-	theta_(sphericalCoordinatePositionDistribution(rng)),
-	phi_(sphericalCoordinatePositionDistribution(rng)),
-	rho_(sphericalCoordinatePositionDistribution(rng)),
-	droll_(rotationOfDrawableDistribution(rng)),
-	dpitch_(rotationOfDrawableDistribution(rng)),
-	dyaw_(rotationOfDrawableDistribution(rng)),
-	dtheta_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	dphi_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	drho_(sphericalCoordinateMovementOfDrawableDistribution(rng))
+	orbit_(spawn.orbit)
 {
 	namespace dx = DirectX;
 	if (!isStaticInitialized())
 	{
-		auto vertexShader = std::make_unique<VertexShader>(graphics, L"ColorIndexVS.cso");
-		auto vertexShaderBytecode = vertexShader->getByteCode();
-		addStaticBind(std::move(vertexShader));
+		auto vertexShaderBytecode = addStaticBind<VertexShader>(graphics, L"ColorIndexVS.cso").getByteCode();
 
-		addStaticBind(std::make_unique<PixelShader>(graphics, L"ColorIndexPS.cso"));
+		addStaticBind<PixelShader>(graphics, L"ColorIndexPS.cso");
 
 		struct PixelShaderConstraints
 		{
@@ -57,7 +39,15 @@ Melon::Melon(Graphics& graphics,
 			}
 		};
 
-		addStaticBind(std::make_unique<PixelConstantBuffer<PixelShaderConstraints>>(graphics, constantBuffer));
+		addStaticBind<PixelConstantBuffer<PixelShaderConstraints>>(graphics, constantBuffer);
+
+		SoftwareRasterizer::Material material;
+		for (size_t i = 0; i < std::size(constantBuffer.faceColors); i++)
+		{
+			const auto& color = constantBuffer.faceColors[i];
+			material.faceColors[i] = { color.r, color.g, color.b, color.a };
+		}
+		setStaticSoftwareMaterial(material);
 
 		constexpr D3D11_INPUT_ELEMENT_DESC positionDesc = {
 			.SemanticName = "Position",
@@ -74,9 +64,9 @@ Melon::Melon(Graphics& graphics,
 			positionDesc
 		};
 
-		addStaticBind(std::make_unique<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode));
+		addStaticBind<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode);
 
-		addStaticBind(std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		addStaticBind<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	}
 
 	struct Vertex
@@ -84,33 +74,38 @@ Melon::Melon(Graphics& graphics,
 		dx::XMFLOAT3 pos;
 	};
 
-	auto model = Sphere::makeTessellated<Vertex>(latitudeDistribution(rng), longitudeDistribution(rng));
+	// Every melon has its own mesh, generated straight into upload memory
+	const int latitudinalDivisions = spawn.latitudinalDivisions;
+	const int longitudinalDivisions = spawn.longitudinalDivisions;
+	const MeshLayout layout = Sphere::getTessellatedLayout(latitudinalDivisions, longitudinalDivisions);
+	Bindable::Upload vertexUpload(graphics, layout.vertexCount * sizeof(Vertex));
+	Bindable::Upload indexUpload(graphics, layout.indexCount * sizeof(unsigned short));
+	const auto vertices = vertexUpload.as<Vertex>();
+	Sphere::writeTessellated(latitudinalDivisions, longitudinalDivisions, vertices, indexUpload.as<unsigned short>());
 
 	// deform vertices of model by linear transformation
-	model.transform(dx::XMMatrixScaling(1.0f, 1.0f, 1.2f));
+	IndexedTriangleList<Vertex>::transform(vertices, dx::XMMatrixScaling(1.0f, 1.0f, 1.2f));
 
-	Drawable::addBind(std::make_unique<VertexBuffer>(graphics, model.vertices()));
+	softwareMesh_ = SoftwareRasterizer::Mesh::from<Vertex>(vertices, indexUpload.as<const unsigned short>());
 
-	Drawable::addIndexBuffer(std::make_unique<IndexBuffer>(graphics, model.indices()));
+	addBind<VertexBuffer>(graphics, vertexUpload, static_cast<UINT>(sizeof(Vertex)));
 
-	Drawable::addBind(std::make_unique<TransformConstantBuffer>(graphics, *this));
+	addIndexBuffer(graphics, indexUpload);
+
+	addBind<TransformConstantBuffer>(graphics, *this);
 }
 
 void Melon::update(const float dt) noexcept
 {
-	roll_ += wrapAngle(droll_ * dt);
-	pitch_ += wrapAngle(dpitch_ * dt);
-	yaw_ += wrapAngle(dyaw_ * dt);
-	theta_ += wrapAngle(dtheta_ * dt);
-	phi_ += wrapAngle(dphi_ * dt);
-	rho_ += wrapAngle(drho_ * dt);
+	orbit_.update(dt);
 }
 
 DirectX::XMMATRIX Melon::getTransformXm() const noexcept
 {
-	namespace dx = DirectX;
-	return dx::XMMatrixRotationRollPitchYaw(pitch_, yaw_, roll_) *
-		dx::XMMatrixTranslation(radiusDistanceFromCenter_, 0.0f, 0.0f) *
-		dx::XMMatrixRotationRollPitchYaw(theta_, phi_, rho_) *
-		dx::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
-}
\ No newline at end of file
+	return orbit_.getTransformXm();
+}
+
+const SoftwareRasterizer::Mesh* Melon::getSoftwareMesh() const noexcept
+{
+	return &softwareMesh_;
+}
@@ -0,0 +1,293 @@
+#include "MemoryTracker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+#include "AppConfig.hpp"
+
+namespace
+{
+	// In front of every block: its size and tag, and how far in from what malloc returned it starts
+	struct Header
+	{
+		size_t bytes;
+		std::uint32_t offset;
+		MemoryTag tag;
+	};
+
+	// malloc aligns to __STDCPP_DEFAULT_NEW_ALIGNMENT__, so up to that the header is all that goes in front
+	constexpr size_t defaultAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+	constexpr size_t headerSpace = (sizeof(Header) + defaultAlignment - 1u) / defaultAlignment * defaultAlignment;
+
+	constexpr const char* tagNames[] = { "Untagged", "Meshes", "Textures", "Bindables", "Logging", "ImGui" };
+	static_assert(std::size(tagNames) == MemoryTracker::tagCount);
+
+	Header* headerOf(void* pointer) noexcept
+	{
+		return reinterpret_cast<Header*>(static_cast<std::byte*>(pointer) - sizeof(Header));
+	}
+}
+
+MemoryTracker::MemoryTracker(const std::chrono::milliseconds window)
+	:
+	window_(window)
+{}
+
+void MemoryTracker::initialize()
+{
+	for (size_t i = 0; i < tagCount; i++)
+	{
+		windowAllocations_[i] = counters_[i].allocations.load(std::memory_order_relaxed);
+		windowBytes_[i] = counters_[i].allocatedBytes.load(std::memory_order_relaxed);
+	}
+	windowStart_ = std::chrono::steady_clock::now();
+	frameStart_ = getAllocationCount();
+	windowPeakFrame_ = 0ull;
+}
+
+void MemoryTracker::frame()
+{
+	const unsigned long long allocations = getAllocationCount();
+	sample_.frameAllocations = allocations - frameStart_;
+	frameStart_ = allocations;
+	windowPeakFrame_ = std::max(windowPeakFrame_, sample_.frameAllocations);
+
+	const auto now = std::chrono::steady_clock::now();
+	if (now - windowStart_ < window_)
+	{
+		return;
+	}
+
+	const double windowSeconds = std::chrono::duration<double>(now - windowStart_).count();
+	sample_.windowSeconds = windowSeconds;
+	sample_.currentBytes = 0u;
+	for (size_t i = 0; i < tagCount; i++)
+	{
+		TagUsage& usage = sample_.tags[i];
+		usage = getUsage(static_cast<MemoryTag>(i));
+		const unsigned long long bytes = counters_[i].allocatedBytes.load(std::memory_order_relaxed);
+		usage.allocationsPerSecond = static_cast<double>(usage.allocations - windowAllocations_[i]) / windowSeconds;
+		usage.bytesPerSecond = static_cast<double>(bytes - windowBytes_[i]) / windowSeconds;
+		windowAllocations_[i] = usage.allocations;
+		windowBytes_[i] = bytes;
+		sample_.currentBytes += usage.currentBytes;
+	}
+	sample_.peakFrameAllocations = windowPeakFrame_;
+	windowPeakFrame_ = 0ull;
+	windowStart_ = now;
+}
+
+const MemoryTracker::Sample& MemoryTracker::getSample() const noexcept
+{
+	return sample_;
+}
+
+void* MemoryTracker::allocate(const size_t bytes, const MemoryTag tag, size_t alignment) noexcept
+{
+	alignment = std::max(alignment, defaultAlignment);
+	// Beyond the default the block is over-allocated and the pointer moved up to the alignment
+	const size_t padding = alignment > defaultAlignment ? alignment + sizeof(Header) : headerSpace;
+	if (bytes > std::numeric_limits<size_t>::max() - padding)
+	{
+		return nullptr;
+	}
+	auto* block = static_cast<std::byte*>(std::malloc(bytes + padding));
+	if (!block)
+	{
+		return nullptr;
+	}
+	std::byte* pointer = block + headerSpace;
+	if (alignment > defaultAlignment)
+	{
+		const auto address = reinterpret_cast<std::uintptr_t>(block) + sizeof(Header);
+		pointer = block + ((address + alignment - 1u) / alignment * alignment - reinterpret_cast<std::uintptr_t>(block));
+	}
+	*headerOf(pointer) = { .bytes = bytes, .offset = static_cast<std::uint32_t>(pointer - block), .tag = tag };
+
+	Counters& counters = counters_[static_cast<size_t>(tag)];
+	counters.allocations.fetch_add(1u, std::memory_order_relaxed);
+	counters.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+	const size_t current = counters.currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+	while (current > peak && !counters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+	{}
+	return pointer;
+}
+
+void MemoryTracker::deallocate(void* pointer) noexcept
+{
+	if (!pointer)
+	{
+		return;
+	}
+	const Header header = *headerOf(pointer);
+	Counters& counters = counters_[static_cast<size_t>(header.tag)];
+	counters.frees.fetch_add(1u, std::memory_order_relaxed);
+	counters.currentBytes.fetch_sub(header.bytes, std::memory_order_relaxed);
+	std::free(static_cast<std::byte*>(pointer) - header.offset);
+}
+
+const char* MemoryTracker::getTagName(const MemoryTag tag) noexcept
+{
+	return tagNames[static_cast<size_t>(tag)];
+}
+
+unsigned long long MemoryTracker::getAllocationCount() noexcept
+{
+	unsigned long long allocations = 0ull;
+	for (const Counters& counters : counters_)
+	{
+		allocations += counters.allocations.load(std::memory_order_relaxed);
+	}
+	return allocations;
+}
+
+MemoryTracker::TagUsage MemoryTracker::getUsage(const MemoryTag tag) noexcept
+{
+	const Counters& counters = counters_[static_cast<size_t>(tag)];
+	TagUsage usage;
+	usage.name = getTagName(tag);
+	usage.currentBytes = counters.currentBytes.load(std::memory_order_relaxed);
+	usage.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	usage.allocations = counters.allocations.load(std::memory_order_relaxed);
+	// Frees are read last, one racing in may be of an allocation the count above missed
+	usage.liveAllocations = usage.allocations - std::min(usage.allocations, counters.frees.load(std::memory_order_relaxed));
+	return usage;
+}
+
+#if (TRACK_ALLOCATIONS)
+// Replaces the global allocation functions, every form of delete frees through the header so the size and
+// alignment arguments are not needed
+namespace
+{
+	void* allocateOrThrow(const size_t bytes, const size_t alignment)
+	{
+		for (;;)
+		{
+			if (void* pointer = MemoryTracker::allocate(bytes, MemoryTracker::getCurrentTag(), alignment))
+			{
+				return pointer;
+			}
+			const std::new_handler handler = std::get_new_handler();
+			if (!handler)
+			{
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+
+	void* allocateOrNull(const size_t bytes, const size_t alignment) noexcept
+	{
+		try
+		{
+			return allocateOrThrow(bytes, alignment);
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+}
+
+void* operator new(const size_t bytes)
+{
+	return allocateOrThrow(bytes, defaultAlignment);
+}
+
+void* operator new[](const size_t bytes)
+{
+	return allocateOrThrow(bytes, defaultAlignment);
+}
+
+void* operator new(const size_t bytes, const std::align_val_t alignment)
+{
+	return allocateOrThrow(bytes, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t bytes, const std::align_val_t alignment)
+{
+	return allocateOrThrow(bytes, static_cast<size_t>(alignment));
+}
+
+void* operator new(const size_t bytes, const std::nothrow_t&) noexcept
+{
+	return allocateOrNull(bytes, defaultAlignment);
+}
+
+void* operator new[](const size_t bytes, const std::nothrow_t&) noexcept
+{
+	return allocateOrNull(bytes, defaultAlignment);
+}
+
+void* operator new(const size_t bytes, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocateOrNull(bytes, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t bytes, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocateOrNull(bytes, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::deallocate(pointer);
+}
+#endif
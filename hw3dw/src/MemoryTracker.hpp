@@ -0,0 +1,177 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+// Subsystems heap memory is charged to
+enum class MemoryTag : std::uint8_t
+{
+	Untagged,
+	Meshes,
+	Textures,
+	Bindables,
+	Logging,
+	ImGui,
+	Count,
+};
+
+// Heap accounting by subsystem. allocate() puts a small header in front of each block with its size and tag, so
+// whoever frees the block, on whatever thread, takes it off the tag it was charged to. With TRACK_ALLOCATIONS the
+// global operator new goes through allocate() as well and charges the innermost Scope of the calling thread;
+// containers that belong to one subsystem wherever they grow take a TaggedAllocator instead.
+//
+// The counters are totals since the process started. An instance samples them like CpuMetric does: once a frame
+// for the allocations the frame made, and over windows of a fixed length for the rates.
+class MemoryTracker
+{
+public:
+	static constexpr size_t tagCount = static_cast<size_t>(MemoryTag::Count);
+
+	// Charges the calling thread's allocations to a tag until it goes out of scope
+	class Scope
+	{
+	public:
+		explicit Scope(const MemoryTag tag) noexcept
+			:
+			previous_(currentTag_)
+		{
+			currentTag_ = tag;
+		}
+		~Scope()
+		{
+			currentTag_ = previous_;
+		}
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope(const Scope&&) = delete;
+		Scope& operator=(const Scope&&) = delete;
+	private:
+		MemoryTag previous_;
+	};
+
+	struct TagUsage
+	{
+		const char* name = "";
+		size_t currentBytes = 0u;
+		size_t peakBytes = 0u;
+		unsigned long long liveAllocations = 0ull;
+		unsigned long long allocations = 0ull;
+		// Over the last window
+		double allocationsPerSecond = 0.0;
+		double bytesPerSecond = 0.0;
+	};
+
+	struct Sample
+	{
+		double windowSeconds = 0.0;
+		std::array<TagUsage, tagCount> tags{};
+		size_t currentBytes = 0u;
+		// Allocations between the last two calls to frame(), and the most any frame of the window made
+		unsigned long long frameAllocations = 0ull;
+		unsigned long long peakFrameAllocations = 0ull;
+	};
+
+public:
+	explicit MemoryTracker(std::chrono::milliseconds window = std::chrono::milliseconds(500));
+	~MemoryTracker() = default;
+	MemoryTracker(const MemoryTracker&) = delete;
+	MemoryTracker& operator=(const MemoryTracker&) = delete;
+	MemoryTracker(const MemoryTracker&&) = delete;
+	MemoryTracker& operator=(const MemoryTracker&&) = delete;
+
+	void initialize();
+	void frame();
+	[[nodiscard]] const Sample& getSample() const noexcept;
+
+	// bytes charged to tag, nullptr when the heap is out of memory
+	[[nodiscard]] static void* allocate(size_t bytes, MemoryTag tag, size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__) noexcept;
+	// Only for blocks from allocate(); nullptr is ignored
+	static void deallocate(void* pointer) noexcept;
+
+	// Run make() with its allocations charged to tag, for members that are allocated in an initializer list
+	template<class Make>
+	static auto tagged(const MemoryTag tag, Make&& make)
+	{
+		Scope scope(tag);
+		return make();
+	}
+
+	[[nodiscard]] static MemoryTag getCurrentTag() noexcept
+	{
+		return currentTag_;
+	}
+	[[nodiscard]] static const char* getTagName(MemoryTag tag) noexcept;
+	// Allocations made so far under every tag, to check a stretch of code allocates nothing
+	[[nodiscard]] static unsigned long long getAllocationCount() noexcept;
+	[[nodiscard]] static TagUsage getUsage(MemoryTag tag) noexcept;
+
+private:
+	struct alignas(64) Counters
+	{
+		std::atomic<size_t> currentBytes;
+		std::atomic<size_t> peakBytes;
+		std::atomic<unsigned long long> allocations;
+		std::atomic<unsigned long long> frees;
+		std::atomic<unsigned long long> allocatedBytes;
+	};
+
+	// Constant initialized, operator new can run before any constructor does
+	static inline constinit std::array<Counters, tagCount> counters_{};
+	static inline constinit thread_local MemoryTag currentTag_ = MemoryTag::Untagged;
+
+	std::chrono::steady_clock::duration window_;
+	std::chrono::steady_clock::time_point windowStart_;
+	unsigned long long frameStart_ = 0ull;
+	unsigned long long windowPeakFrame_ = 0ull;
+	std::array<unsigned long long, tagCount> windowAllocations_{};
+	std::array<unsigned long long, tagCount> windowBytes_{};
+	Sample sample_;
+};
+
+// Standard allocator that charges everything a container allocates to Tag, whichever Scope it grows in
+template<class T, MemoryTag Tag>
+class TaggedAllocator
+{
+public:
+	using value_type = T;
+
+	template<class U>
+	struct rebind
+	{
+		using other = TaggedAllocator<U, Tag>;
+	};
+
+	TaggedAllocator() noexcept = default;
+	template<class U>
+	TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept
+	{}
+
+	[[nodiscard]] T* allocate(const size_t count)
+	{
+		if (count > std::numeric_limits<size_t>::max() / sizeof(T))
+		{
+			throw std::bad_array_new_length();
+		}
+		void* pointer = MemoryTracker::allocate(count * sizeof(T), Tag, alignof(T));
+		if (!pointer)
+		{
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(pointer);
+	}
+
+	void deallocate(T* pointer, size_t) noexcept
+	{
+		MemoryTracker::deallocate(pointer);
+	}
+
+	template<class U>
+	bool operator==(const TaggedAllocator<U, Tag>&) const noexcept
+	{
+		return true;
+	}
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <algorithm>
+#include <limits>
+
+#include "WorkerPool.hpp"
+
+// Exact vertex and index counts of a procedural mesh, known before anything is generated so the caller can
+// size its storage once (or map a buffer of that size) and let the generator write straight into it
+struct MeshLayout
+{
+	size_t vertexCount;
+	size_t indexCount;
+
+	template<class I>
+	[[nodiscard]] bool fitsIndexType() const noexcept
+	{
+		return vertexCount == 0u || vertexCount - 1u <= static_cast<size_t>(std::numeric_limits<I>::max());
+	}
+};
+
+// Split [0, count) into contiguous bands and call body(first, last) for each one, spread over the pool when there
+// is one. Bands never overlap, so generators can write their rows without any synchronisation.
+template<class F>
+void forEachBand(WorkerPool* pool, const size_t count, F&& body)
+{
+	if (pool == nullptr || count < 2u)
+	{
+		body(size_t{ 0 }, count);
+		return;
+	}
+
+	// A few bands per thread keeps the threads busy when rows differ in cost
+	const size_t bandCount = std::min(count, (pool->getThreadCount() + 1u) * 4u);
+	const size_t bandSize = (count + bandCount - 1u) / bandCount;
+	pool->run(bandCount, [&body, count, bandSize](const size_t band)
+		{
+			const size_t first = std::min(band * bandSize, count);
+			const size_t last = std::min(first + bandSize, count);
+			if (first < last)
+			{
+				body(first, last);
+			}
+		});
+}
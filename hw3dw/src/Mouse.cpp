@@ -16,41 +16,162 @@ const static WindowsMessageMap windowsMessageMap;
 const static VirtualKeyMap virtualKeyMap;
 #endif
 
+#if !defined(_WIN32)
+// One notch of the wheel, as Windows reports it
+constexpr int WHEEL_DELTA = 120;
+#endif
+
 using enum Mouse::Event::EventType;
 
-void Mouse::trimBuffer() noexcept
+void Mouse::queueEvent(const Event::EventType eventType) noexcept
 {
-	while (eventBuffer_.size() > bufferSize_)
+	// The merged move happened before this event, keep it in front
+	flushMove();
+	const Event event(eventType, *this);
+	eventBuffer_.push(event);
+	arrivals_.note(event.getTimestamp());
+}
+
+void Mouse::queueMove(const int x, const int y) noexcept
+{
+	const int deltaX = x - x_;
+	const int deltaY = y - y_;
+	x_ = x;
+	y_ = y;
+
+	if (!pendingMove_)
+	{
+		// The merged event keeps the first move's timestamp, the input latency counts from there
+		pendingMove_.emplace(MOVE, *this);
+	}
+	else
 	{
-		eventBuffer_.pop();
+		Event& move = *pendingMove_;
+		move.x_ = x;
+		move.y_ = y;
+		move.leftIsPressed_ = leftIsPressed_;
+		move.rightIsPressed_ = rightIsPressed_;
+		move.middleIsPressed_ = middleIsPressed_;
+		move.x1IsPressed_ = x1IsPressed_;
+		move.x2IsPressed_ = x2IsPressed_;
 	}
+	pendingMove_->deltaX_ += deltaX;
+	pendingMove_->deltaY_ += deltaY;
+	pendingMove_->moveCount_++;
+	arrivals_.note(pendingMove_->getTimestamp());
 }
 
-std::optional<Mouse::Event> Mouse::read() noexcept
+void Mouse::flushMove() noexcept
 {
-	if (!eventBuffer_.empty())
+	if (pendingMove_)
 	{
-		const Event e = eventBuffer_.front();
-		eventBuffer_.pop();
-		return e;
+		eventBuffer_.push(*pendingMove_);
+		pendingMove_.reset();
 	}
-	return {};
+}
+
+Mouse::FrameInput Mouse::collectFrame()
+{
+	return collectFrame([](const Event&) {});
+}
+
+void Mouse::accumulate(FrameInput& input, const Event& event) noexcept
+{
+	switch (event.getType())
+	{
+	case L_PRESS:
+	case L_DOUBLE:
+		input.pressed |= FrameInput::LEFT;
+		break;
+	case L_RELEASE:
+		input.released |= FrameInput::LEFT;
+		break;
+	case R_PRESS:
+	case R_DOUBLE:
+		input.pressed |= FrameInput::RIGHT;
+		break;
+	case R_RELEASE:
+		input.released |= FrameInput::RIGHT;
+		break;
+	case M_PRESS:
+	case M_DOUBLE:
+		input.pressed |= FrameInput::MIDDLE;
+		break;
+	case M_RELEASE:
+		input.released |= FrameInput::MIDDLE;
+		break;
+	case X1_PRESS:
+		input.pressed |= FrameInput::X1;
+		break;
+	case X1_RELEASE:
+		input.released |= FrameInput::X1;
+		break;
+	case X2_PRESS:
+		input.pressed |= FrameInput::X2;
+		break;
+	case X2_RELEASE:
+		input.released |= FrameInput::X2;
+		break;
+	case WHEEL_UP:
+		input.wheel++;
+		break;
+	case WHEEL_DOWN:
+		input.wheel--;
+		break;
+	case WHEEL_RIGHT:
+		input.hWheel++;
+		break;
+	case WHEEL_LEFT:
+		input.hWheel--;
+		break;
+	case MOVE:
+		input.deltaX += event.deltaX_;
+		input.deltaY += event.deltaY_;
+		input.moves += event.moveCount_;
+		break;
+	case ENTER:
+	case LEAVE:
+		break;
+	}
+}
+
+std::uint8_t Mouse::heldButtons() const noexcept
+{
+	return static_cast<std::uint8_t>((leftIsPressed_ ? static_cast<unsigned>(FrameInput::LEFT) : 0u)
+		| (rightIsPressed_ ? static_cast<unsigned>(FrameInput::RIGHT) : 0u)
+		| (middleIsPressed_ ? static_cast<unsigned>(FrameInput::MIDDLE) : 0u)
+		| (x1IsPressed_ ? static_cast<unsigned>(FrameInput::X1) : 0u)
+		| (x2IsPressed_ ? static_cast<unsigned>(FrameInput::X2) : 0u));
+}
+
+void Mouse::reportArrivals(InputLatency& latency) noexcept
+{
+	arrivals_.reportTo(latency);
+}
+
+std::optional<Mouse::Event> Mouse::read() noexcept
+{
+	flushMove();
+	return eventBuffer_.pop();
 }
 
 bool Mouse::isEmpty() const noexcept
 {
-	return eventBuffer_.empty();
+	return !pendingMove_ && eventBuffer_.isEmpty();
 }
 
 void Mouse::clear() noexcept
 {
-	eventBuffer_ = std::queue<Event>();
+	pendingMove_.reset();
+	eventBuffer_.clear();
 }
 
+#if defined(_WIN32)
 LRESULT Mouse::WndProcHandler([[maybe_unused]] HWND window, const UINT msg, const WPARAM wParam, LPARAM l_param) noexcept
 {
 #ifdef LOG_WINDOW_MESSAGES
-	PLOGV << windowsMessageMap(msg, l_param, wParam).c_str();
+	char message[WindowsMessageMap::bufferSize];
+	PLOGV << windowsMessageMap(message, msg, l_param, wParam);
 #endif
 	switch (msg)
 	{
@@ -147,6 +268,7 @@ LRESULT Mouse::WndProcHandler([[maybe_unused]] HWND window, const UINT msg, cons
 	}
 	return 0;
 }
+#endif
 
 std::pair<int, int> Mouse::getPos() const noexcept
 {
@@ -200,11 +322,7 @@ bool Mouse::isX2Pressed() const noexcept
 
 void Mouse::onMouseMove(const int x, const int y) noexcept
 {
-	x_ = x;
-	y_ = y;
-
-	eventBuffer_.emplace(MOVE, *this);
-	trimBuffer();
+	queueMove(x, y);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse move: x:" << x << " y:" << y;
 #endif
@@ -214,8 +332,7 @@ void Mouse::onMouseLeave() noexcept
 {
 	inWindow_ = false;
 
-	eventBuffer_.emplace(LEAVE, *this);
-	trimBuffer();
+	queueEvent(LEAVE);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse leave window";
 #endif
@@ -227,8 +344,7 @@ void Mouse::onMouseEnter(const int x, const int y) noexcept
 	y_ = y;
 	inWindow_ = true;
 
-	eventBuffer_.emplace(ENTER, *this);
-	trimBuffer();
+	queueEvent(ENTER);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse enter window: x:" << x << " y:" << y;
 #endif
@@ -240,8 +356,7 @@ void Mouse::onLeftPressed(const int x, const int y) noexcept
 	y_ = y;
 	leftIsPressed_ = true;
 
-	eventBuffer_.emplace(L_PRESS, *this);
-	trimBuffer();
+	queueEvent(L_PRESS);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse left pressed";
 #endif
@@ -253,8 +368,7 @@ void Mouse::onLeftReleased(const int x, const int y) noexcept
 	y_ = y;
 	leftIsPressed_ = false;
 
-	eventBuffer_.emplace(L_RELEASE, *this);
-	trimBuffer();
+	queueEvent(L_RELEASE);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse left released";
 #endif
@@ -266,8 +380,7 @@ void Mouse::onRightPressed(const int x, const int y) noexcept
 	y_ = y;
 	rightIsPressed_ = true;
 
-	eventBuffer_.emplace(R_PRESS, *this);
-	trimBuffer();
+	queueEvent(R_PRESS);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse right pressed";
 #endif
@@ -279,8 +392,7 @@ void Mouse::onRightReleased(const int x, const int y) noexcept
 	y_ = y;
 	rightIsPressed_ = false;
 
-	eventBuffer_.emplace(R_RELEASE, *this);
-	trimBuffer();
+	queueEvent(R_RELEASE);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse right released";
 #endif
@@ -292,8 +404,7 @@ void Mouse::onMiddlePressed(const int x, const int y) noexcept
 	y_ = y;
 	middleIsPressed_ = true;
 
-	eventBuffer_.emplace(M_PRESS, *this);
-	trimBuffer();
+	queueEvent(M_PRESS);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse middle pressed";
 #endif
@@ -305,8 +416,7 @@ void Mouse::onMiddleReleased(const int x, const int y) noexcept
 	y_ = y;
 	middleIsPressed_ = false;
 
-	eventBuffer_.emplace(M_RELEASE, *this);
-	trimBuffer();
+	queueEvent(M_RELEASE);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse middle released";
 #endif
@@ -318,8 +428,7 @@ void Mouse::onX1Pressed(const int x, const int y) noexcept
 	y_ = y;
 	x1IsPressed_ = true;
 
-	eventBuffer_.emplace(X1_PRESS, *this);
-	trimBuffer();
+	queueEvent(X1_PRESS);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse button 4 pressed";
 #endif
@@ -331,8 +440,7 @@ void Mouse::onX1Released(const int x, const int y) noexcept
 	y_ = y;
 	x1IsPressed_ = false;
 
-	eventBuffer_.emplace(X1_RELEASE, *this);
-	trimBuffer();
+	queueEvent(X1_RELEASE);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse button 4 released";
 #endif
@@ -344,8 +452,7 @@ void Mouse::onX2Pressed(const int x, const int y) noexcept
 	y_ = y;
 	x2IsPressed_ = true;
 
-	eventBuffer_.emplace(X2_PRESS, *this);
-	trimBuffer();
+	queueEvent(X2_PRESS);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse button 5 pressed";
 #endif
@@ -357,8 +464,7 @@ void Mouse::onX2Released(const int x, const int y) noexcept
 	y_ = y;
 	x2IsPressed_ = false;
 
-	eventBuffer_.emplace(X2_RELEASE, *this);
-	trimBuffer();
+	queueEvent(X2_RELEASE);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse button 5 released";
 #endif
@@ -369,8 +475,7 @@ void Mouse::onWheelUp(const int x, const int y) noexcept
 	x_ = x;
 	y_ = y;
 
-	eventBuffer_.emplace(WHEEL_UP, *this);
-	trimBuffer();
+	queueEvent(WHEEL_UP);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse wheel up";
 #endif
@@ -381,8 +486,7 @@ void Mouse::onWheelDown(const int x, const int y) noexcept
 	x_ = x;
 	y_ = y;
 
-	eventBuffer_.emplace(WHEEL_DOWN, *this);
-	trimBuffer();
+	queueEvent(WHEEL_DOWN);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse wheel down";
 #endif
@@ -393,8 +497,7 @@ void Mouse::onWheelRight(const int x, const int y) noexcept
 	x_ = x;
 	y_ = y;
 
-	eventBuffer_.emplace(WHEEL_RIGHT, *this);
-	trimBuffer();
+	queueEvent(WHEEL_RIGHT);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse wheel right";
 #endif
@@ -405,8 +508,7 @@ void Mouse::onWheelLeft(const int x, const int y) noexcept
 	x_ = x;
 	y_ = y;
 
-	eventBuffer_.emplace(WHEEL_LEFT, *this);
-	trimBuffer();
+	queueEvent(WHEEL_LEFT);
 #ifdef LOG_MOUSE_MESSAGES // defined in LoggingConfig.h
 	PLOGV << "mouse wheel left";
 #endif
@@ -1,9 +1,13 @@
 ﻿#pragma once
+#include <cstdint>
 #include <optional>
-#include <queue>
 #include <utility>
 
+#if defined(_WIN32)
 #include "AtumWindows.hpp"
+#endif
+#include "EventRing.hpp"
+#include "InputLatency.hpp"
 
 class Mouse
 {
@@ -45,14 +49,21 @@ public:
 		using enum EventType;
 
 	private:
+		friend class Mouse;
+
 		EventType eventType_;
 		int x_;
 		int y_;
+		// Movement folded into a MOVE event since the event before it, and how many WM_MOUSEMOVEs that took
+		int deltaX_ = 0;
+		int deltaY_ = 0;
+		unsigned int moveCount_ = 0u;
 		bool leftIsPressed_;
 		bool rightIsPressed_;
 		bool middleIsPressed_;
 		bool x1IsPressed_;
 		bool x2IsPressed_;
+		InputLatency::clock::time_point timestamp_;
 
 	public:
 		Event() = delete;
@@ -65,9 +76,31 @@ public:
 			rightIsPressed_(parent.rightIsPressed_),
 			middleIsPressed_(parent.middleIsPressed_),
 			x1IsPressed_(parent.x1IsPressed_),
-			x2IsPressed_(parent.x2IsPressed_)
+			x2IsPressed_(parent.x2IsPressed_),
+			// Events are built by the message handlers, so this is when the input arrived
+			timestamp_(InputLatency::clock::now())
 		{}
 
+		[[nodiscard]] EventType getType() const noexcept
+		{
+			return eventType_;
+		}
+
+		[[nodiscard]] std::pair<int, int> getPos() const noexcept
+		{
+			return { x_, y_ };
+		}
+
+		[[nodiscard]] std::pair<int, int> getDelta() const noexcept
+		{
+			return { deltaX_, deltaY_ };
+		}
+
+		[[nodiscard]] unsigned int getMoveCount() const noexcept
+		{
+			return moveCount_;
+		}
+
 		[[nodiscard]] bool isLeftPressed() const noexcept
 		{
 			return leftIsPressed_;
@@ -92,17 +125,83 @@ public:
 		{
 			return x2IsPressed_;
 		}
+
+		[[nodiscard]] InputLatency::clock::time_point getTimestamp() const noexcept
+		{
+			return timestamp_;
+		}
+	};
+
+	// Everything the mouse did during one frame, folded together by collectFrame()
+	struct FrameInput
+	{
+		enum Button : std::uint8_t
+		{
+			LEFT = 1u << 0u,
+			RIGHT = 1u << 1u,
+			MIDDLE = 1u << 2u,
+			X1 = 1u << 3u,
+			X2 = 1u << 4u
+		};
+
+		// Position and held buttons once every event was applied
+		int x = 0;
+		int y = 0;
+		std::uint8_t held = 0u;
+		bool inWindow = false;
+		// Buttons that went down or up at least once, a click inside one frame sets both
+		std::uint8_t pressed = 0u;
+		std::uint8_t released = 0u;
+		int deltaX = 0;
+		int deltaY = 0;
+		// Whole wheel notches, up and right are positive
+		int wheel = 0;
+		int hWheel = 0;
+		// WM_MOUSEMOVEs received and events delivered after coalescing them
+		unsigned int moves = 0u;
+		unsigned int events = 0u;
 	};
 
 private:
-	void trimBuffer() noexcept;
+	void queueEvent(Event::EventType eventType) noexcept;
+	void queueMove(int x, int y) noexcept;
+	void flushMove() noexcept;
 	std::optional<Event> read() noexcept;
 	[[nodiscard]] bool isEmpty() const noexcept;
 	void clear() noexcept;
 
 public:
 	struct Position { int x, y; };
+#if defined(_WIN32)
 	LRESULT WndProcHandler(HWND window, UINT msg, WPARAM wParam, LPARAM l_param) noexcept;
+#endif
+	// Hand the arrival times of the events queued since the last call to the latency tracker
+	void reportArrivals(InputLatency& latency) noexcept;
+	// Hand every queued event to consume(const Event&) oldest first, return how many there were. Like the message
+	// handlers this has to run on the thread that pumps the window messages, it queues the pending move first.
+	template<class F>
+	size_t drainEvents(F&& consume)
+	{
+		flushMove();
+		return eventBuffer_.drain(std::forward<F>(consume));
+	}
+	// Drain the frame's events into one FrameInput, still handing each to consume(const Event&) in order
+	template<class F>
+	FrameInput collectFrame(F&& consume)
+	{
+		FrameInput input;
+		input.events = static_cast<unsigned int>(drainEvents([&input, &consume](const Event& event)
+			{
+				accumulate(input, event);
+				consume(event);
+			}));
+		input.x = x_;
+		input.y = y_;
+		input.held = heldButtons();
+		input.inWindow = inWindow_;
+		return input;
+	}
+	FrameInput collectFrame();
 	[[nodiscard]] std::pair<int, int> getPos() const noexcept;
 	[[nodiscard]] Position pos() const noexcept;
 	[[nodiscard]] int getPosX() const noexcept;
@@ -134,6 +233,9 @@ public:
 	void onHWheelDelta(int x, int y, int delta) noexcept;
 
 private:
+	static void accumulate(FrameInput& input, const Event& event) noexcept;
+	[[nodiscard]] std::uint8_t heldButtons() const noexcept;
+
 	static constexpr unsigned int bufferSize_ = 16u;
 	int x_ = 0;
 	int y_ = 0;
@@ -145,5 +247,9 @@ private:
 	bool x2IsPressed_ = false;
 	int vWheelDeltaCarry_ = 0;
 	int hWheelDeltaCarry_ = 0;
-	std::queue<Event> eventBuffer_;
+	// Consecutive moves are merged here and only queued once something else happens or the frame collects them,
+	// so a high polling rate mouse can not push the clicks out of the buffer
+	std::optional<Event> pendingMove_;
+	EventRing<Event, bufferSize_> eventBuffer_;
+	InputLatency::Arrivals arrivals_;
 };
@@ -0,0 +1,42 @@
+#include "Orbit.hpp"
+
+#include "AtumMath.hpp"
+
+Orbit::Orbit(std::mt19937& rng,
+             std::uniform_real_distribution<float>& distanceDistribution,								// rdist
+             std::uniform_real_distribution<float>& sphericalCoordinatePositionDistribution,			// adist
+             std::uniform_real_distribution<float>& rotationOfDrawableDistribution,						// ddist
+             std::uniform_real_distribution<float>& sphericalCoordinateMovementOfDrawableDistribution	// odist
+)
+	:
+	radiusDistanceFromCenter_(distanceDistribution(rng)),
+	theta_(sphericalCoordinatePositionDistribution(rng)),
+	phi_(sphericalCoordinatePositionDistribution(rng)),
+	rho_(sphericalCoordinatePositionDistribution(rng)),
+	droll_(rotationOfDrawableDistribution(rng)),
+	dpitch_(rotationOfDrawableDistribution(rng)),
+	dyaw_(rotationOfDrawableDistribution(rng)),
+	dtheta_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
+	dphi_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
+	drho_(sphericalCoordinateMovementOfDrawableDistribution(rng))
+{
+}
+
+void Orbit::update(const float dt) noexcept
+{
+	roll_ += wrapAngle(droll_ * dt);
+	pitch_ += wrapAngle(dpitch_ * dt);
+	yaw_ += wrapAngle(dyaw_ * dt);
+	theta_ += wrapAngle(dtheta_ * dt);
+	phi_ += wrapAngle(dphi_ * dt);
+	rho_ += wrapAngle(drho_ * dt);
+}
+
+DirectX::XMMATRIX Orbit::getTransformXm() const noexcept
+{
+	namespace dx = DirectX;
+	return dx::XMMatrixRotationRollPitchYaw(pitch_, yaw_, roll_) *
+		dx::XMMatrixTranslation(radiusDistanceFromCenter_, 0.0f, 0.0f) *
+		dx::XMMatrixRotationRollPitchYaw(theta_, phi_, rho_) *
+		dx::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+}
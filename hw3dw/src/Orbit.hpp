@@ -0,0 +1,37 @@
+#pragma once
+#include <DirectXMath.h>
+#include <random>
+
+// How every drawable in the scene moves: it spins about its own axes while its arm, radiusDistanceFromCenter_
+// long, turns about the scene centre 20 units in front of the camera. Positions and speeds come from the rng in a
+// fixed order, so a seed always gives the same scene.
+class Orbit
+{
+public:
+	Orbit(std::mt19937& rng,
+		std::uniform_real_distribution<float>& distanceDistribution,								// rdist
+		std::uniform_real_distribution<float>& sphericalCoordinatePositionDistribution,				// adist
+		std::uniform_real_distribution<float>& rotationOfDrawableDistribution,						// ddist
+		std::uniform_real_distribution<float>& sphericalCoordinateMovementOfDrawableDistribution	// odist
+	);
+
+	void update(float dt) noexcept;
+	[[nodiscard]] DirectX::XMMATRIX getTransformXm() const noexcept;
+private:
+	// Positional
+	float radiusDistanceFromCenter_;
+	float roll_ = 0.0f;
+	float pitch_ = 0.0f;
+	float yaw_ = 0.0f;
+	float theta_;
+	float phi_;
+	float rho_;
+
+	// Speed (delta/s)
+	float droll_;
+	float dpitch_;
+	float dyaw_;
+	float dtheta_;
+	float dphi_;
+	float drho_;
+};
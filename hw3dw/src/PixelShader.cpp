@@ -1,17 +1,10 @@
 #include "PixelShader.hpp"
+#include "ShaderLibrary.hpp"
 
-#include <d3dcompiler.h>
-
-#include "GraphicsThrowMacros.hpp"
-
-PixelShader::PixelShader(Graphics& graphics, const std::wstring& path)
-{
-	INFOMAN(graphics);
-
-	Microsoft::WRL::ComPtr<ID3DBlob> blob;
-	GFX_THROW_INFO(D3DReadFileToBlob(path.c_str(), &blob));
-	GFX_THROW_INFO(getDevice(graphics)->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &pixelShader_));
-}
+PixelShader::PixelShader(Graphics& graphics, const std::wstring& path, const std::vector<ShaderCache::Define>& defines)
+	:
+	pixelShader_(ShaderLibrary::getPixelShader(graphics, path, defines))
+{}
 
 void PixelShader::bind(Graphics& graphics) noexcept
 {
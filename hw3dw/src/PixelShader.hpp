@@ -1,10 +1,11 @@
 #pragma once
 #include "Bindable.hpp"
+#include "ShaderCache.hpp"
 
 class PixelShader : public Bindable
 {
 public:
-	PixelShader(Graphics& graphics, const std::wstring& path);
+	PixelShader(Graphics& graphics, const std::wstring& path, const std::vector<ShaderCache::Define>& defines = {});
 
 	~PixelShader() override = default;
 	PixelShader(const PixelShader&) = delete;
@@ -1,28 +1,62 @@
 #pragma once
 #include <array>
+#include <span>
 
 #include "AtumMath.hpp"
 #include "IndexedTriangleList.hpp"
+#include "MeshLayout.hpp"
 
 class Plane
 {
 public:
 	template<class V>
-	static IndexedTriangleList<V> make(std::function<void(std::vector<V>&)> set_attributes = nullptr)
+	static IndexedTriangleList<V> make(std::function<void(MeshVector<V>&)> set_attributes = nullptr)
 	{
 		return makeTessellated<V>(1, 1, set_attributes);
 	}
 
 	template<class V>
-	static IndexedTriangleList<V> makeTessellated(const int divisionsX, const int divisionsY, std::function<void(std::vector<V>&)> setAttributes = nullptr)
+	static IndexedTriangleList<V> makeTessellated(const int divisionsX, const int divisionsY, std::function<void(MeshVector<V>&)> setAttributes = nullptr)
+	{
+		const MeshLayout layout = getTessellatedLayout(divisionsX, divisionsY);
+		MeshVector<V> vertices(layout.vertexCount);
+		MeshVector<unsigned short> indices(layout.indexCount);
+		writeTessellated<V>(divisionsX, divisionsY, std::span(vertices), std::span(indices));
+
+		if (setAttributes) {
+			setAttributes(vertices);
+		}
+
+		return
+		{
+			std::move(vertices),
+			std::move(indices)
+		};
+	}
+
+	[[nodiscard]] static MeshLayout getTessellatedLayout(const int divisionsX, const int divisionsY) noexcept
+	{
+		return
+		{
+			static_cast<size_t>(divisionsX + 1) * static_cast<size_t>(divisionsY + 1),
+			static_cast<size_t>(divisionsX) * static_cast<size_t>(divisionsY) * 6u
+		};
+	}
+
+	// Write the plane into storage sized by getTessellatedLayout (a mapped upload buffer, say). Only positions
+	// are written. Rows are split over the pool when one is given.
+	template<class V, class I = unsigned short>
+	static void writeTessellated(const int divisionsX, const int divisionsY, std::span<V> vertices, std::span<I> indices, WorkerPool* pool = nullptr)
 	{
 		namespace dx = DirectX;
 		assert(divisionsX >= 1);
 		assert(divisionsY >= 1);
+		const MeshLayout layout = getTessellatedLayout(divisionsX, divisionsY);
+		assert(vertices.size() == layout.vertexCount && indices.size() == layout.indexCount);
+		assert(layout.fitsIndexType<I>());
 
-		const int numberVerticesX = divisionsX + 1;
-		const int numberVerticesY = divisionsY + 1;
-		std::vector<V> vertices(numberVerticesX * numberVerticesY);
+		const size_t numberVerticesX = static_cast<size_t>(divisionsX) + 1u;
+		const size_t numberVerticesY = static_cast<size_t>(divisionsY) + 1u;
 		{
 			constexpr float height = 2.0f;
 			constexpr float width = 2.0f;
@@ -32,57 +66,54 @@ public:
 			const float divisionSizeY = height / static_cast<float>(divisionsY);
 			const auto bottomLeft = dx::XMVectorSet(-sideX, -sideY, 0.0f, 0.0f);
 
-			for (int y = 0, i = 0; y < numberVerticesY; y++)
-			{
-				const float yPos = static_cast<float>(y) * divisionSizeY;
-				for (int x = 0; x < numberVerticesX; x++, i++)
+			forEachBand(pool, numberVerticesY, [&](const size_t firstRow, const size_t lastRow)
 				{
-					const auto vertex = dx::XMVectorAdd(
-						bottomLeft,
-						dx::XMVectorSet(static_cast<float>(x) * divisionSizeX, yPos, 0.0f, 0.0f)
-					);
-					dx::XMStoreFloat3(&vertices[i].pos, vertex);
-				}
-			}
+					for (size_t y = firstRow; y < lastRow; y++)
+					{
+						const float yPos = static_cast<float>(y) * divisionSizeY;
+						V* vertex = vertices.data() + y * numberVerticesX;
+						for (size_t x = 0; x < numberVerticesX; x++, vertex++)
+						{
+							const auto position = dx::XMVectorAdd(
+								bottomLeft,
+								dx::XMVectorSet(static_cast<float>(x) * divisionSizeX, yPos, 0.0f, 0.0f)
+							);
+							dx::XMStoreFloat3(&vertex->pos, position);
+						}
+					}
+				});
 		}
 
-		std::vector<unsigned short> indices;
-		indices.reserve(static_cast<std::vector<unsigned short>::size_type>(sq(divisionsX * divisionsY)) * 6);
 		{
 			const auto vertexPosToIndex = [numberVerticesX](const size_t x, const size_t y)
 			{
-				return static_cast<unsigned short>(y * numberVerticesX + x);
+				return static_cast<I>(y * numberVerticesX + x);
 			};
 
-			for (size_t y = 0; y < divisionsY; y++)
-			{
-				for (size_t x = 0; x < divisionsX; x++)
+			const size_t cellsX = static_cast<size_t>(divisionsX);
+			forEachBand(pool, static_cast<size_t>(divisionsY), [&](const size_t firstRow, const size_t lastRow)
 				{
-					const std::array<unsigned short, 4> indexArray =
+					I* index = indices.data() + firstRow * cellsX * 6u;
+					for (size_t y = firstRow; y < lastRow; y++)
 					{
-						vertexPosToIndex(x, y),
-						vertexPosToIndex(x + 1, y),
-						vertexPosToIndex(x, y + 1),
-						vertexPosToIndex(x + 1, y + 1)
-					};
-					indices.push_back(indexArray[0]);
-					indices.push_back(indexArray[2]);
-					indices.push_back(indexArray[1]);
-					indices.push_back(indexArray[1]);
-					indices.push_back(indexArray[2]);
-					indices.push_back(indexArray[3]);
-				}
-			}
-		}
-
-		if (setAttributes) {
-			setAttributes(vertices);
+						for (size_t x = 0; x < cellsX; x++)
+						{
+							const std::array<I, 4> indexArray =
+							{
+								vertexPosToIndex(x, y),
+								vertexPosToIndex(x + 1, y),
+								vertexPosToIndex(x, y + 1),
+								vertexPosToIndex(x + 1, y + 1)
+							};
+							*index++ = indexArray[0];
+							*index++ = indexArray[2];
+							*index++ = indexArray[1];
+							*index++ = indexArray[1];
+							*index++ = indexArray[2];
+							*index++ = indexArray[3];
+						}
+					}
+				});
 		}
-
-		return
-		{
-			std::move(vertices),
-			std::move(indices)
-		};
 	}
 };
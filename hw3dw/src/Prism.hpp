@@ -1,8 +1,11 @@
 #pragma once
 
+#include <span>
+
 #include "IndexedTriangleList.hpp"
 #include <DirectXMath.h>
 #include "AtumMath.hpp"
+#include "MeshLayout.hpp"
 
 class Prism
 {
@@ -15,81 +18,82 @@ public:
 
 	template<class V>
 	static IndexedTriangleList<V> makeTessellated(const int longitudinalDivisions)
+	{
+		const MeshLayout layout = getTessellatedLayout(longitudinalDivisions);
+		MeshVector<V> vertices(layout.vertexCount);
+		MeshVector<unsigned short> indices(layout.indexCount);
+		writeTessellated<V>(longitudinalDivisions, std::span(vertices), std::span(indices));
+
+		return
+		{
+			std::move(vertices),
+			std::move(indices)
+		};
+	}
+
+	[[nodiscard]] static MeshLayout getTessellatedLayout(const int longitudinalDivisions) noexcept
+	{
+		const size_t divisions = static_cast<size_t>(longitudinalDivisions);
+		return { 2u + divisions * 2u, divisions * 12u };
+	}
+
+	// Write the prism into storage sized by getTessellatedLayout (a mapped upload buffer, say). Only positions
+	// are written. Longitudes are split over the pool when one is given.
+	template<class V, class I = unsigned short>
+	static void writeTessellated(const int longitudinalDivisions, std::span<V> vertices, std::span<I> indices, WorkerPool* pool = nullptr)
 	{
 		namespace dx = DirectX;
 		assert(longitudinalDivisions >= 3);
+		const MeshLayout layout = getTessellatedLayout(longitudinalDivisions);
+		assert(vertices.size() == layout.vertexCount && indices.size() == layout.indexCount);
+		assert(layout.fitsIndexType<I>());
 
 		const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
 		const auto offset = dx::XMVectorSet(0.0f, 0.0f, 2.0f, 0.0f);
 		const float longitudeAngle = 2.0f * PI / static_cast<float>(longitudinalDivisions);
+		const size_t divisions = static_cast<size_t>(longitudinalDivisions);
 
 		// near center
-		std::vector<V> vertices;
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f, 0.0f, -1.0f };
-		const auto indexCenterNear = static_cast<unsigned short>(vertices.size() - 1);
+		constexpr I indexCenterNear = 0;
+		vertices[indexCenterNear].pos = { 0.0f, 0.0f, -1.0f };
 
 		// far center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f, 0.0f, 1.0f };
-		const auto indexCenterFar = static_cast<unsigned short>(vertices.size() - 1);
-
-		// base vertices
-		for (int indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++)
-		{
-			// near base
-			{
-				vertices.emplace_back();
-				auto vertex = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * static_cast<float>(indexLongitude))
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, vertex);
-			}
+		constexpr I indexCenterFar = 1;
+		vertices[indexCenterFar].pos = { 0.0f, 0.0f, 1.0f };
 
-			// far base
+		forEachBand(pool, divisions, [&](const size_t first, const size_t last)
 			{
-				vertices.emplace_back();
-				auto vertex = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * static_cast<float>(indexLongitude))
-				);
-				vertex = dx::XMVectorAdd(vertex, offset);
-				dx::XMStoreFloat3(&vertices.back().pos, vertex);
-			}
-		}
+				for (size_t indexLongitude = first; indexLongitude < last; indexLongitude++)
+				{
+					// base vertices, near then far
+					const auto vertex = dx::XMVector3Transform(
+						base,
+						dx::XMMatrixRotationZ(longitudeAngle * static_cast<float>(indexLongitude))
+					);
+					dx::XMStoreFloat3(&vertices[2u + indexLongitude * 2u].pos, vertex);
+					dx::XMStoreFloat3(&vertices[3u + indexLongitude * 2u].pos, dx::XMVectorAdd(vertex, offset));
 
-		// side indices
-		std::vector<unsigned short> indices;
-		for (unsigned short indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++)
-		{
-			const auto index = indexLongitude * 2;
-			const auto mod = longitudinalDivisions * 2;
-			indices.push_back(index + 2);
-			indices.push_back((index + 2) % mod + 2);
-			indices.push_back(index + 1 + 2);
-			indices.push_back((index + 2) % mod + 2);
-			indices.push_back((index + 3) % mod + 2);
-			indices.push_back(index + 1 + 2);
-		}
+					const size_t index = indexLongitude * 2u;
+					const size_t mod = divisions * 2u;
 
-		// base indices
-		for (unsigned short indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++)
-		{
-			const auto index = indexLongitude * 2;
-			const auto mod = longitudinalDivisions * 2;
-			indices.push_back(index + 2);
-			indices.push_back(indexCenterNear);
-			indices.push_back((index + 2) % mod + 2);
-			indices.push_back(indexCenterFar);
-			indices.push_back(index + 1 + 2);
-			indices.push_back((index + 3) % mod + 2);
-		}
+					// side indices
+					I* side = indices.data() + indexLongitude * 6u;
+					side[0] = static_cast<I>(index + 2u);
+					side[1] = static_cast<I>((index + 2u) % mod + 2u);
+					side[2] = static_cast<I>(index + 1u + 2u);
+					side[3] = static_cast<I>((index + 2u) % mod + 2u);
+					side[4] = static_cast<I>((index + 3u) % mod + 2u);
+					side[5] = static_cast<I>(index + 1u + 2u);
 
-		return
-		{
-			std::move(vertices),
-			std::move(indices)
-		};
+					// base indices
+					I* cap = indices.data() + divisions * 6u + indexLongitude * 6u;
+					cap[0] = static_cast<I>(index + 2u);
+					cap[1] = indexCenterNear;
+					cap[2] = static_cast<I>((index + 2u) % mod + 2u);
+					cap[3] = indexCenterFar;
+					cap[4] = static_cast<I>(index + 1u + 2u);
+					cap[5] = static_cast<I>((index + 3u) % mod + 2u);
+				}
+			});
 	}
-};
\ No newline at end of file
+};
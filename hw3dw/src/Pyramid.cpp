@@ -2,24 +2,9 @@
 #include "BindableIncludes.hpp"
 #include "Cone.hpp"
 
-Pyramid::Pyramid(Graphics& graphics,
-                 std::mt19937& rng,
-                 std::uniform_real_distribution<float>& distanceDistribution,								// rdist
-                 std::uniform_real_distribution<float>& sphericalCoordinatePositionDistribution,			// adist
-                 std::uniform_real_distribution<float>& rotationOfDrawableDistribution,						// ddist
-                 std::uniform_real_distribution<float>& sphericalCoordinateMovementOfDrawableDistribution	// odist
-)
+Pyramid::Pyramid(Graphics& graphics, const ScenePopulation::Spawn& spawn)
 	:
-	radiusDistanceFromCenter_(distanceDistribution(rng)),
-	theta_(sphericalCoordinatePositionDistribution(rng)),
-	phi_(sphericalCoordinatePositionDistribution(rng)),
-	rho_(sphericalCoordinatePositionDistribution(rng)),
-	droll_(rotationOfDrawableDistribution(rng)),
-	dpitch_(rotationOfDrawableDistribution(rng)),
-	dyaw_(rotationOfDrawableDistribution(rng)),
-	dtheta_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	dphi_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	drho_(sphericalCoordinateMovementOfDrawableDistribution(rng))
+	orbit_(spawn.orbit)
 {
 	namespace dx = DirectX;
 
@@ -49,28 +34,30 @@ Pyramid::Pyramid(Graphics& graphics,
 			{255, 0, 255, 255},
 		};
 
-		// Lambda to set colors
-		auto setColors = [colors](std::vector<Vertex>& vertices) {
-			for (size_t i = 0; i < vertices.size() && i < colors.size(); ++i) {
-				vertices[i].color = colors[i];
-			}
-		};
-
-		// Create the model with vertices, indices, and the lambda
-		auto model = Cone::makeTessellated<Vertex>(4, setColors);
+		// Generate the model straight into upload memory, then color and deform it there
+		const MeshLayout layout = Cone::getTessellatedLayout(4);
+		Bindable::Upload vertexUpload(graphics, layout.vertexCount * sizeof(Vertex));
+		Bindable::Upload indexUpload(graphics, layout.indexCount * sizeof(unsigned short));
+		const auto vertices = vertexUpload.as<Vertex>();
+		Cone::writeTessellated(4, vertices, indexUpload.as<unsigned short>());
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			vertices[i].color = colors[i % colors.size()];
+		}
 
 		// deform mesh linearly
-		model.transform(dx::XMMatrixScaling(1.0f, 1.0f, 0.7f));
+		IndexedTriangleList<Vertex>::transform(vertices, dx::XMMatrixScaling(1.0f, 1.0f, 0.7f));
+
+		setStaticSoftwareMesh(SoftwareRasterizer::Mesh::from<Vertex>(vertices, indexUpload.as<const unsigned short>()));
 
-		addStaticBind(std::make_unique<VertexBuffer>(graphics, model.vertices()));
+		addStaticBind<VertexBuffer>(graphics, vertexUpload, static_cast<UINT>(sizeof(Vertex)));
 
-		auto vertexShader = std::make_unique<VertexShader>(graphics, L"ColorBlendVS.cso");
-		auto vertexShaderBytecode = vertexShader->getByteCode();
-		addStaticBind(std::move(vertexShader));
+		auto vertexShaderBytecode = addStaticBind<VertexShader>(graphics, L"ColorBlendVS.cso").getByteCode();
 
-		addStaticBind(std::make_unique<PixelShader>(graphics, L"ColorBlendPS.cso"));
+		addStaticBind<PixelShader>(graphics, L"ColorBlendPS.cso");
 
-		addStaticIndexBuffer(std::make_unique<IndexBuffer>(graphics, model.indices()));
+		addStaticIndexBuffer(graphics, indexUpload);
+
+		setStaticSoftwareMaterial({ .shading = SoftwareRasterizer::Shading::VertexColors });
 
 		constexpr D3D11_INPUT_ELEMENT_DESC positionDesc = {
 			.SemanticName = "Position",
@@ -98,33 +85,24 @@ Pyramid::Pyramid(Graphics& graphics,
 			colorDesc
 		};
 
-		addStaticBind(std::make_unique<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode));
+		addStaticBind<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode);
 
-		addStaticBind(std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		addStaticBind<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	}
 	else
 	{
 		setIndexBufferFromStaticBinds();
 	}
 
-	Drawable::addBind(std::make_unique<TransformConstantBuffer>(graphics, *this));
+	addBind<TransformConstantBuffer>(graphics, *this);
 }
 
 void Pyramid::update(const float dt) noexcept
 {
-	roll_ += wrapAngle(droll_ * dt);
-	pitch_ += wrapAngle(dpitch_ * dt);
-	yaw_ += wrapAngle(dyaw_ * dt);
-	theta_ += wrapAngle(dtheta_ * dt);
-	phi_ += wrapAngle(dphi_ * dt);
-	rho_ += wrapAngle(drho_ * dt);
+	orbit_.update(dt);
 }
 
 DirectX::XMMATRIX Pyramid::getTransformXm() const noexcept
 {
-	namespace dx = DirectX;
-	return dx::XMMatrixRotationRollPitchYaw(pitch_, yaw_, roll_) *
-		dx::XMMatrixTranslation(radiusDistanceFromCenter_, 0.0f, 0.0f) *
-		dx::XMMatrixRotationRollPitchYaw(theta_, phi_, rho_) *
-		dx::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+	return orbit_.getTransformXm();
 }
\ No newline at end of file
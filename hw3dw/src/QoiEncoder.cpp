@@ -0,0 +1,143 @@
+#include "QoiEncoder.hpp"
+
+#include <array>
+
+namespace
+{
+	constexpr unsigned char QOI_OP_INDEX = 0x00u; // 00xxxxxx
+	constexpr unsigned char QOI_OP_DIFF = 0x40u;  // 01xxxxxx
+	constexpr unsigned char QOI_OP_LUMA = 0x80u;  // 10xxxxxx
+	constexpr unsigned char QOI_OP_RUN = 0xC0u;   // 11xxxxxx
+	constexpr unsigned char QOI_OP_RGB = 0xFEu;   // 11111110
+	constexpr unsigned char QOI_OP_RGBA = 0xFFu;  // 11111111
+	constexpr size_t headerSize = 14u;
+	constexpr std::array<unsigned char, 8> endMarker = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+	struct Rgba
+	{
+		unsigned char r, g, b, a;
+
+		bool operator==(const Rgba&) const = default;
+
+		[[nodiscard]] unsigned int hash() const noexcept
+		{
+			return (r * 3u + g * 5u + b * 7u + a * 11u) % 64u;
+		}
+	};
+
+	void writeBigEndian(unsigned char* out, const unsigned int value) noexcept
+	{
+		out[0] = static_cast<unsigned char>(value >> 24u);
+		out[1] = static_cast<unsigned char>(value >> 16u);
+		out[2] = static_cast<unsigned char>(value >> 8u);
+		out[3] = static_cast<unsigned char>(value);
+	}
+}
+
+void QoiEncoder::encode(const Surface& surface, std::vector<unsigned char>& output)
+{
+	const unsigned int width = surface.getWidth();
+	const unsigned int height = surface.getHeight();
+	const size_t pixelCount = static_cast<size_t>(width) * height;
+
+	// Worst case is one QOI_OP_RGBA per pixel, so size once and write through a raw pointer
+	output.resize(headerSize + pixelCount * 5u + endMarker.size());
+	unsigned char* out = output.data();
+
+	*out++ = 'q';
+	*out++ = 'o';
+	*out++ = 'i';
+	*out++ = 'f';
+	writeBigEndian(out, width);
+	out += 4;
+	writeBigEndian(out, height);
+	out += 4;
+	*out++ = 4u; // RGBA
+	*out++ = 0u; // sRGB with linear alpha
+
+	std::array<Rgba, 64> seen{};
+	Rgba previous{ 0u, 0u, 0u, 255u };
+	unsigned int run = 0u;
+
+	const Surface::color* pixels = surface.getBufferPtr();
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const auto& c = pixels[i];
+		const Rgba pixel{ c.get_r(), c.get_g(), c.get_b(), c.get_a() };
+
+		if (pixel == previous)
+		{
+			if (++run == 62u || i + 1 == pixelCount)
+			{
+				*out++ = static_cast<unsigned char>(QOI_OP_RUN | (run - 1u));
+				run = 0u;
+			}
+			continue;
+		}
+
+		if (run > 0u)
+		{
+			*out++ = static_cast<unsigned char>(QOI_OP_RUN | (run - 1u));
+			run = 0u;
+		}
+
+		const unsigned int index = pixel.hash();
+		if (seen[index] == pixel)
+		{
+			*out++ = static_cast<unsigned char>(QOI_OP_INDEX | index);
+		}
+		else
+		{
+			seen[index] = pixel;
+
+			if (pixel.a == previous.a)
+			{
+				const int dr = static_cast<signed char>(pixel.r - previous.r);
+				const int dg = static_cast<signed char>(pixel.g - previous.g);
+				const int db = static_cast<signed char>(pixel.b - previous.b);
+				const int drdg = dr - dg;
+				const int dbdg = db - dg;
+
+				if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+				{
+					*out++ = static_cast<unsigned char>(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+				}
+				else if (dg >= -32 && dg <= 31 && drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7)
+				{
+					*out++ = static_cast<unsigned char>(QOI_OP_LUMA | (dg + 32));
+					*out++ = static_cast<unsigned char>((drdg + 8) << 4 | (dbdg + 8));
+				}
+				else
+				{
+					*out++ = QOI_OP_RGB;
+					*out++ = pixel.r;
+					*out++ = pixel.g;
+					*out++ = pixel.b;
+				}
+			}
+			else
+			{
+				*out++ = QOI_OP_RGBA;
+				*out++ = pixel.r;
+				*out++ = pixel.g;
+				*out++ = pixel.b;
+				*out++ = pixel.a;
+			}
+		}
+		previous = pixel;
+	}
+
+	for (const auto byte : endMarker)
+	{
+		*out++ = byte;
+	}
+
+	output.resize(static_cast<size_t>(out - output.data()));
+}
+
+std::vector<unsigned char> QoiEncoder::encode(const Surface& surface)
+{
+	std::vector<unsigned char> output;
+	encode(surface, output);
+	return output;
+}
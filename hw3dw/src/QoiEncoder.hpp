@@ -0,0 +1,16 @@
+#pragma once
+#include <vector>
+
+#include "Surface.hpp"
+
+// Encoder for the "Quite OK Image" format (https://qoiformat.org). It is lossless, single pass and
+// several times faster than PNG, which makes it suitable for dumping every frame of a benchmark run.
+class QoiEncoder
+{
+public:
+	QoiEncoder() = delete;
+
+	// Encodes the surface as 8-bit RGBA, reusing the storage already held by output
+	static void encode(const Surface& surface, std::vector<unsigned char>& output);
+	static std::vector<unsigned char> encode(const Surface& surface);
+};
@@ -0,0 +1,76 @@
+#include "RasterKernel.hpp"
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+RasterKernel::CoverBlock RasterKernel::select() noexcept
+{
+	return isAvx2Supported() ? &coverBlockAvx2 : &coverBlockScalar;
+}
+
+bool RasterKernel::isAvx2Supported() noexcept
+{
+#if defined(_MSC_VER)
+	int registers[4] = {};
+	__cpuid(registers, 0);
+	if (registers[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(registers, 1);
+	const bool osSavesYmm = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6u) == 0x6u;
+	const bool hasFma = (registers[2] & (1 << 12)) != 0;
+	__cpuidex(registers, 7, 0);
+	const bool hasAvx2 = (registers[1] & (1 << 5)) != 0;
+	return osSavesYmm && hasFma && hasAvx2;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+	return false;
+#endif
+}
+
+std::uint64_t RasterKernel::coverBlockScalar(const RasterTriangle& triangle, const int blockX, const int blockY, const std::uint64_t validMask,
+	const bool fullyCovered, float* blockDepth, float& blockMaxDepth) noexcept
+{
+	const float x0 = static_cast<float>(blockX - triangle.originX);
+	const float y0 = static_cast<float>(blockY - triangle.originY);
+
+	std::uint64_t passed = 0ull;
+	float maxDepth = 0.0f;
+	for (int y = 0; y < 8; y++)
+	{
+		const float py = y0 + static_cast<float>(y);
+		for (int x = 0; x < 8; x++)
+		{
+			const int bit = y * 8 + x;
+			const float px = x0 + static_cast<float>(x);
+			float& stored = blockDepth[bit];
+
+			bool inside = (validMask >> bit) & 1ull;
+			if (inside && !fullyCovered)
+			{
+				for (int edge = 0; edge < 3 && inside; edge++)
+				{
+					const float value = triangle.edgeA[edge] * px + (triangle.edgeB[edge] * py + triangle.edgeC[edge]);
+					inside = triangle.edgeInclusive[edge] ? value >= 0.0f : value > 0.0f;
+				}
+			}
+			if (inside)
+			{
+				const float depth = triangle.depthA * px + (triangle.depthB * py + triangle.depthC);
+				if (depth < stored && depth <= 1.0f)
+				{
+					stored = depth;
+					passed |= 1ull << bit;
+				}
+			}
+			maxDepth = std::max(maxDepth, stored);
+		}
+	}
+	blockMaxDepth = maxDepth;
+	return passed;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+
+// Per-triangle state the rasterizer sets up once and evaluates for every 8x8 block it touches. Edge and depth
+// functions are planes in pixel space relative to (originX, originY), so pixel centres sit on integers and the
+// values stay small enough for single precision no matter where on screen the triangle lands.
+struct RasterTriangle
+{
+	// E(x, y) = a * x + b * y + c is positive inside; edge i is the one opposite vertex i
+	float edgeA[3];
+	float edgeB[3];
+	float edgeC[3];
+	// Top-left edges own the pixels that lie exactly on them
+	bool edgeInclusive[3];
+	// NDC depth and 1/w planes
+	float depthA;
+	float depthB;
+	float depthC;
+	float minDepth;
+	float inverseArea;
+	float inverseW[3];
+	// Inclusive pixel bounds of the triangle, clamped to the target
+	int minX;
+	int minY;
+	int maxX;
+	int maxY;
+	int originX;
+	int originY;
+	// Interpolants, colour or texture coordinates depending on the material
+	float attributes[3][4];
+	const void* material;
+	unsigned int primitiveId;
+};
+
+// Coverage and depth for one 8x8 block of pixels. The AVX2 variant lives in its own translation unit so that
+// only it is built with AVX2 code generation; select() picks it when the CPU supports it.
+class RasterKernel
+{
+public:
+	// Returns a bit per pixel (row major, bit = y * 8 + x) that is inside the triangle, inside validMask and
+	// passes the LESS depth test. Passing pixels have their depth written and blockMaxDepth is refreshed.
+	// Set fullyCovered when the block is known to lie inside every edge to skip the edge tests.
+	using CoverBlock = std::uint64_t(*)(const RasterTriangle& triangle, int blockX, int blockY, std::uint64_t validMask,
+		bool fullyCovered, float* blockDepth, float& blockMaxDepth) noexcept;
+
+	RasterKernel() = delete;
+
+	static CoverBlock select() noexcept;
+	static bool isAvx2Supported() noexcept;
+
+	static std::uint64_t coverBlockScalar(const RasterTriangle& triangle, int blockX, int blockY, std::uint64_t validMask,
+		bool fullyCovered, float* blockDepth, float& blockMaxDepth) noexcept;
+	static std::uint64_t coverBlockAvx2(const RasterTriangle& triangle, int blockX, int blockY, std::uint64_t validMask,
+		bool fullyCovered, float* blockDepth, float& blockMaxDepth) noexcept;
+};
@@ -0,0 +1,76 @@
+#include "RasterKernel.hpp"
+
+#include <immintrin.h>
+
+// Built with AVX2 code generation (see the per-file setting in the project) and only ever called after
+// RasterKernel::isAvx2Supported() has confirmed the CPU can run it. Each row of the block is one 8-wide vector.
+// Both kernels build with precise floating point: fusing a multiply and add into an FMA here would round
+// differently from the scalar kernel.
+std::uint64_t RasterKernel::coverBlockAvx2(const RasterTriangle& triangle, const int blockX, const int blockY, const std::uint64_t validMask,
+	const bool fullyCovered, float* blockDepth, float& blockMaxDepth) noexcept
+{
+	const __m256 laneOffsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(blockX - triangle.originX)), laneOffsets);
+	const float y0 = static_cast<float>(blockY - triangle.originY);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	__m256 edgeX[3];
+	for (int edge = 0; edge < 3; edge++)
+	{
+		edgeX[edge] = _mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[edge]), px);
+	}
+	const __m256 depthX = _mm256_mul_ps(_mm256_set1_ps(triangle.depthA), px);
+
+	std::uint64_t passed = 0ull;
+	__m256 maxDepth = zero;
+	for (int y = 0; y < 8; y++)
+	{
+		// Same evaluation order as the scalar kernel, a * x + (b * y + c), so both produce identical results
+		const float py = y0 + static_cast<float>(y);
+		const unsigned int rowValid = static_cast<unsigned int>(validMask >> (y * 8)) & 0xFFu;
+		float* row = blockDepth + y * 8;
+		const __m256 stored = _mm256_loadu_ps(row);
+
+		unsigned int rowMask = rowValid;
+		if (rowMask != 0u && !fullyCovered)
+		{
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int edge = 0; edge < 3; edge++)
+			{
+				const __m256 value = _mm256_add_ps(edgeX[edge], _mm256_set1_ps(triangle.edgeB[edge] * py + triangle.edgeC[edge]));
+				const __m256 test = triangle.edgeInclusive[edge]
+					? _mm256_cmp_ps(value, zero, _CMP_GE_OQ)
+					: _mm256_cmp_ps(value, zero, _CMP_GT_OQ);
+				inside = _mm256_and_ps(inside, test);
+			}
+			rowMask &= static_cast<unsigned int>(_mm256_movemask_ps(inside));
+		}
+
+		__m256 result = stored;
+		if (rowMask != 0u)
+		{
+			const __m256 depthRow = _mm256_add_ps(depthX, _mm256_set1_ps(triangle.depthB * py + triangle.depthC));
+			const __m256 depthPass = _mm256_and_ps(_mm256_cmp_ps(depthRow, stored, _CMP_LT_OQ),
+				_mm256_cmp_ps(depthRow, one, _CMP_LE_OQ));
+			rowMask &= static_cast<unsigned int>(_mm256_movemask_ps(depthPass));
+			if (rowMask != 0u)
+			{
+				// Expand the 8 bit row mask back into lanes to blend the new depths in
+				const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+				const __m256i laneMask = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(rowMask)), bits), bits);
+				result = _mm256_blendv_ps(stored, depthRow, _mm256_castsi256_ps(laneMask));
+				_mm256_storeu_ps(row, result);
+				passed |= static_cast<std::uint64_t>(rowMask) << (y * 8);
+			}
+		}
+		maxDepth = _mm256_max_ps(maxDepth, result);
+	}
+
+	// Horizontal max of the eight lanes
+	__m128 folded = _mm_max_ps(_mm256_castps256_ps128(maxDepth), _mm256_extractf128_ps(maxDepth, 1));
+	folded = _mm_max_ps(folded, _mm_movehl_ps(folded, folded));
+	folded = _mm_max_ss(folded, _mm_shuffle_ps(folded, folded, 1));
+	blockMaxDepth = _mm_cvtss_f32(folded);
+	return passed;
+}
@@ -0,0 +1,313 @@
+#include "RegressionSuite.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "Logging.hpp"
+
+namespace
+{
+	int channelDifference(const Surface::color a, const Surface::color b) noexcept
+	{
+		// Alpha is left out, the BMP round trip does not keep it
+		return std::max({
+			std::abs(static_cast<int>(a.get_r()) - static_cast<int>(b.get_r())),
+			std::abs(static_cast<int>(a.get_g()) - static_cast<int>(b.get_g())),
+			std::abs(static_cast<int>(a.get_b()) - static_cast<int>(b.get_b()))
+		});
+	}
+
+	float median(std::vector<float> values) noexcept
+	{
+		if (values.empty())
+		{
+			return 0.0f;
+		}
+		const auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2u);
+		std::nth_element(values.begin(), middle, values.end());
+		return *middle;
+	}
+}
+
+RegressionSuite::RegressionSuite(Options options)
+	:
+	options_(std::move(options))
+{
+	std::filesystem::create_directories(options_.directory);
+	results_.reserve(options_.frameCount);
+}
+
+void RegressionSuite::addFrame(const Surface& image, const SoftwareRasterizer::Statistics& statistics, const float updateMilliseconds)
+{
+	FrameResult result = {
+		.frame = static_cast<unsigned int>(results_.size()),
+		.updateMilliseconds = updateMilliseconds,
+		.setupMilliseconds = statistics.setupMilliseconds,
+		.rasterMilliseconds = statistics.rasterMilliseconds,
+		.triangles = statistics.triangles,
+		.pixelsShaded = statistics.pixelsShaded,
+		.mismatchedPixels = 0u,
+		.goldenWritten = false,
+		.passed = true
+	};
+
+	const auto goldenPath = framePath(result.frame, "");
+	if (options_.updateGolden)
+	{
+		image.save(goldenPath.string());
+		result.goldenWritten = true;
+		PLOGI << "Regression frame " << result.frame << ": wrote golden image " << goldenPath.string();
+	}
+	else if (!std::filesystem::exists(goldenPath))
+	{
+		const auto actualPath = framePath(result.frame, ".actual");
+		image.save(actualPath.string());
+		result.passed = false;
+		PLOGE << "Regression frame " << result.frame << ": no golden image at " << goldenPath.string() << ", wrote "
+			<< actualPath.string() << " (run with --update-golden to accept it)";
+	}
+	else
+	{
+		const Surface golden = Surface::fromFile(goldenPath.wstring());
+		if (golden.getWidth() != image.getWidth() || golden.getHeight() != image.getHeight())
+		{
+			std::ostringstream out;
+			out << "Comparing frame " << result.frame << ": golden image is " << golden.getWidth() << "x" << golden.getHeight()
+				<< ", the frame is " << image.getWidth() << "x" << image.getHeight() << ".";
+			throw Exception(__LINE__, __FILE__, out.str());
+		}
+
+		result.mismatchedPixels = countMismatches(image, golden);
+		const size_t allowed = static_cast<size_t>(options_.maxMismatchRatio * static_cast<float>(image.getWidth() * image.getHeight()));
+		result.passed = result.mismatchedPixels <= allowed;
+		if (!result.passed)
+		{
+			const auto actualPath = framePath(result.frame, ".actual");
+			image.save(actualPath.string());
+			PLOGE << "Regression frame " << result.frame << ": " << result.mismatchedPixels << " pixels differ from the golden image (allowed "
+				<< allowed << "), wrote " << actualPath.string();
+		}
+	}
+	results_.push_back(result);
+}
+
+bool RegressionSuite::finish(const float wallMilliseconds)
+{
+	std::vector<float> frameMilliseconds;
+	frameMilliseconds.reserve(results_.size());
+	for (const auto& result : results_)
+	{
+		frameMilliseconds.push_back(result.updateMilliseconds + result.setupMilliseconds + result.rasterMilliseconds);
+	}
+	const float medianMilliseconds = median(frameMilliseconds);
+	const bool imagesPassed = std::all_of(results_.begin(), results_.end(), [](const FrameResult& result) { return result.passed; });
+
+	const auto baselinePath = options_.directory / "baseline.json";
+	float baselineMilliseconds = 0.0f;
+	bool timingPassed = true;
+	if (options_.updateGolden)
+	{
+		PLOGI << "Regression median frame time " << medianMilliseconds << "ms becomes the baseline";
+	}
+	else if (readBaseline(baselinePath, baselineMilliseconds))
+	{
+		timingPassed = medianMilliseconds <= baselineMilliseconds * (1.0f + options_.maxSlowdown);
+		std::ostringstream out;
+		out << "Regression median frame time " << medianMilliseconds << "ms against a baseline of " << baselineMilliseconds
+			<< "ms (allowed +" << options_.maxSlowdown * 100.0f << "%)";
+		if (timingPassed)
+		{
+			PLOGI << out.str();
+		}
+		else
+		{
+			PLOGE << out.str();
+		}
+	}
+	else
+	{
+		timingPassed = false;
+		PLOGE << "Regression has no baseline at " << baselinePath.string() << " (run with --update-golden to write one)";
+	}
+
+	const auto reportPath = options_.directory / "report.json";
+	std::ofstream report(reportPath);
+	report << "{\n"
+		<< "  \"seed\": " << options_.seed << ",\n"
+		<< "  \"drawables\": " << options_.drawableCount << ",\n"
+		<< "  \"pipelined\": " << (options_.pipelined ? "true" : "false") << ",\n"
+		<< "  \"replay\": \"" << options_.replay.generic_string() << "\",\n"
+		<< "  \"wallMilliseconds\": " << wallMilliseconds << ",\n"
+		<< "  \"framesPerSecond\": " << (wallMilliseconds > 0.0f ? 1000.0f * static_cast<float>(results_.size()) / wallMilliseconds : 0.0f) << ",\n"
+		<< "  \"medianFrameMilliseconds\": " << medianMilliseconds << ",\n"
+		<< "  \"baselineFrameMilliseconds\": " << baselineMilliseconds << ",\n"
+		<< "  \"imagesPassed\": " << (imagesPassed ? "true" : "false") << ",\n"
+		<< "  \"timingPassed\": " << (timingPassed ? "true" : "false") << ",\n"
+		<< "  \"frames\": [\n";
+	for (size_t i = 0; i < results_.size(); i++)
+	{
+		const auto& result = results_[i];
+		report << "    { \"frame\": " << result.frame
+			<< ", \"updateMilliseconds\": " << result.updateMilliseconds
+			<< ", \"setupMilliseconds\": " << result.setupMilliseconds
+			<< ", \"rasterMilliseconds\": " << result.rasterMilliseconds
+			<< ", \"triangles\": " << result.triangles
+			<< ", \"pixelsShaded\": " << result.pixelsShaded
+			<< ", \"mismatchedPixels\": " << result.mismatchedPixels
+			<< ", \"goldenWritten\": " << (result.goldenWritten ? "true" : "false")
+			<< ", \"passed\": " << (result.passed ? "true" : "false") << " }"
+			<< (i + 1u < results_.size() ? ",\n" : "\n");
+	}
+	report << "  ]\n}\n";
+	report.close();
+
+	if (options_.updateGolden)
+	{
+		std::filesystem::copy_file(reportPath, baselinePath, std::filesystem::copy_options::overwrite_existing);
+		PLOGI << "Regression wrote the baseline " << baselinePath.string();
+	}
+
+	return imagesPassed && timingPassed;
+}
+
+const std::vector<RegressionSuite::FrameResult>& RegressionSuite::getResults() const noexcept
+{
+	return results_;
+}
+
+RegressionSuite::Options RegressionSuite::parseArguments(const std::vector<std::wstring>& arguments)
+{
+	if (arguments.empty() || arguments.front().starts_with(L"--"))
+	{
+		throw Exception(__LINE__, __FILE__, "Parsing --regression: missing the output directory.");
+	}
+
+	Options options;
+	options.directory = arguments.front();
+	for (size_t i = 1; i < arguments.size(); i++)
+	{
+		const auto number = [&arguments, &i](const char* name)
+			{
+				if (i + 1u >= arguments.size())
+				{
+					throw Exception(__LINE__, __FILE__, std::string("Parsing --regression: ") + name + " needs a value.");
+				}
+				const std::wstring& value = arguments[++i];
+				wchar_t* end = nullptr;
+				const unsigned long parsed = std::wcstoul(value.c_str(), &end, 10);
+				if (value.empty() || *end != L'\0' || value.front() == L'-')
+				{
+					throw Exception(__LINE__, __FILE__, std::string("Parsing --regression: ") + name + " needs a number, not "
+						+ std::filesystem::path(value).string() + ".");
+				}
+				return parsed;
+			};
+
+		if (arguments[i] == L"--seed")
+		{
+			options.seed = static_cast<unsigned int>(number("--seed"));
+		}
+		else if (arguments[i] == L"--drawables")
+		{
+			options.drawableCount = number("--drawables");
+		}
+		else if (arguments[i] == L"--frames")
+		{
+			options.frameCount = static_cast<unsigned int>(number("--frames"));
+		}
+		else if (arguments[i] == L"--update-golden")
+		{
+			options.updateGolden = true;
+		}
+		else if (arguments[i] == L"--pipelined")
+		{
+			options.pipelined = true;
+		}
+		else if (arguments[i] == L"--replay")
+		{
+			if (i + 1u >= arguments.size())
+			{
+				throw Exception(__LINE__, __FILE__, "Parsing --regression: --replay needs a recording.");
+			}
+			options.replay = arguments[++i];
+		}
+		else
+		{
+			throw Exception(__LINE__, __FILE__, "Parsing --regression: unknown option " + std::filesystem::path(arguments[i]).string() + ".");
+		}
+	}
+	return options;
+}
+
+size_t RegressionSuite::countMismatches(const Surface& image, const Surface& golden) const noexcept
+{
+	const size_t count = static_cast<size_t>(image.getWidth()) * image.getHeight();
+	const Surface::color* actual = image.getBufferPtr();
+	const Surface::color* expected = golden.getBufferPtr();
+	size_t mismatches = 0u;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (channelDifference(actual[i], expected[i]) > options_.channelTolerance)
+		{
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+std::filesystem::path RegressionSuite::framePath(const unsigned int frame, const char* suffix) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "frame_%03u%s.bmp", frame, suffix);
+	return options_.directory / name;
+}
+
+bool RegressionSuite::readBaseline(const std::filesystem::path& path, float& medianMilliseconds)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		return false;
+	}
+
+	// Baselines are reports written by finish(), so finding the one key is enough
+	const std::string text{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	constexpr std::string_view key = "\"medianFrameMilliseconds\":";
+	const auto position = text.find(key);
+	if (position == std::string::npos)
+	{
+		return false;
+	}
+	medianMilliseconds = std::strtof(text.c_str() + position + key.size(), nullptr);
+	return medianMilliseconds > 0.0f;
+}
+
+// regression suite exception stuff
+RegressionSuite::Exception::Exception(const int line, const char* file, std::string note) noexcept
+	:
+	AtumException(line, file),
+	note_(std::move(note))
+{}
+
+const char* RegressionSuite::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AtumException::what() << "\n"
+		<< "[Note] " << getNote();
+	whatBuffer_ = oss.str();
+	return whatBuffer_.c_str();
+}
+
+const char* RegressionSuite::Exception::getType() const noexcept
+{
+	return "Atum Regression Suite Exception";
+}
+
+const std::string& RegressionSuite::Exception::getNote() const noexcept
+{
+	return note_;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "AtumException.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "Surface.hpp"
+
+// Golden image and frame time regression checks for the headless --regression mode. The App renders a fixed
+// seed scene with the scalar software rasterizer and hands every frame here; each one is compared against
+// frame_NNN.bmp in the directory and its stage timings are collected. finish() writes report.json and fails
+// when the median frame time regressed against baseline.json by more than the allowed ratio. A missing golden
+// image or baseline fails the run; --update-golden writes both from this run instead of checking them.
+class RegressionSuite
+{
+public:
+	class Exception : public AtumException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* getType() const noexcept override;
+		const std::string& getNote() const noexcept;
+	private:
+		std::string note_;
+	};
+
+	struct Options
+	{
+		std::filesystem::path directory;
+		unsigned int seed = 1234u;
+		size_t drawableCount = 180u;
+		unsigned int frameCount = 8u;
+		float frameStep = 1.0f / 60.0f;
+		// A pixel mismatches when any colour channel differs by more than this
+		int channelTolerance = 2;
+		// Fraction of mismatching pixels a frame may have and still pass
+		float maxMismatchRatio = 0.001f;
+		// Allowed growth of the median frame time over the baseline
+		float maxSlowdown = 0.15f;
+		bool updateGolden = false;
+		// Simulate each next frame on a SimulationThread while the current one renders
+		bool pipelined = false;
+		// An InputRecording to repeat instead of the seed, drawable count, frame count and fixed frame step
+		std::filesystem::path replay;
+	};
+
+	struct FrameResult
+	{
+		unsigned int frame;
+		float updateMilliseconds;
+		float setupMilliseconds;
+		float rasterMilliseconds;
+		size_t triangles;
+		size_t pixelsShaded;
+		size_t mismatchedPixels;
+		bool goldenWritten;
+		bool passed;
+	};
+
+public:
+	explicit RegressionSuite(Options options);
+	~RegressionSuite() = default;
+	RegressionSuite(const RegressionSuite&) = delete;
+	RegressionSuite& operator=(const RegressionSuite&) = delete;
+	RegressionSuite(const RegressionSuite&&) = delete;
+	RegressionSuite& operator=(const RegressionSuite&&) = delete;
+
+	void addFrame(const Surface& image, const SoftwareRasterizer::Statistics& statistics, float updateMilliseconds);
+	// Write the report and return whether every frame matched and the frame time held. wallMilliseconds is the
+	// whole run, the number that shows what overlapping the simulation with rendering gained.
+	bool finish(float wallMilliseconds);
+
+	[[nodiscard]] const std::vector<FrameResult>& getResults() const noexcept;
+
+	// Parse the command line arguments following --regression: <directory> [--seed N] [--drawables N]
+	// [--frames N] [--update-golden] [--pipelined] [--replay <recording>]. Anything else throws.
+	static Options parseArguments(const std::vector<std::wstring>& arguments);
+private:
+	[[nodiscard]] size_t countMismatches(const Surface& image, const Surface& golden) const noexcept;
+	[[nodiscard]] std::filesystem::path framePath(unsigned int frame, const char* suffix) const;
+	static bool readBaseline(const std::filesystem::path& path, float& medianMilliseconds);
+
+	Options options_;
+	std::vector<FrameResult> results_;
+};
@@ -0,0 +1,90 @@
+#include "RenderQueue.hpp"
+
+#include <array>
+#include <bit>
+
+namespace
+{
+	constexpr std::uint64_t meshMask = (1ull << 14u) - 1ull;
+
+	std::uint32_t toSortableDepth(const float depth) noexcept
+	{
+		// Non-negative IEEE floats order the same as their bit patterns; NaN and negatives collapse to 0
+		return depth > 0.0f ? std::bit_cast<std::uint32_t>(depth) : 0u;
+	}
+}
+
+std::uint64_t RenderQueue::makeKey(const Pass pass, const std::uint16_t material, const std::uint16_t mesh, const float depth) noexcept
+{
+	const std::uint64_t passBits = static_cast<std::uint64_t>(pass) << 62u;
+	const std::uint64_t sortableDepth = toSortableDepth(depth);
+	if (pass == Pass::Blended)
+	{
+		return passBits | ((~sortableDepth & 0xFFFFFFFFull) << 30u) | (static_cast<std::uint64_t>(material) << 14u) | (mesh & meshMask);
+	}
+	return passBits | (static_cast<std::uint64_t>(material) << 46u) | ((mesh & meshMask) << 32u) | sortableDepth;
+}
+
+void RenderQueue::reserve(const size_t count)
+{
+	packets_.reserve(count);
+	scratch_.reserve(count);
+}
+
+void RenderQueue::clear() noexcept
+{
+	packets_.clear();
+}
+
+void RenderQueue::push(const std::uint64_t key, const Drawable* drawable)
+{
+	packets_.push_back({ key, drawable });
+}
+
+void RenderQueue::sort()
+{
+	const size_t count = packets_.size();
+	if (count < 2u)
+	{
+		return;
+	}
+
+	// One read of the keys builds the histograms for all eight byte positions
+	std::array<std::array<size_t, 256>, 8> histograms{};
+	for (const auto& packet : packets_)
+	{
+		for (size_t byte = 0; byte < 8u; byte++)
+		{
+			histograms[byte][(packet.key >> (byte * 8u)) & 0xFFu]++;
+		}
+	}
+
+	scratch_.resize(count);
+	for (size_t byte = 0; byte < 8u; byte++)
+	{
+		auto& histogram = histograms[byte];
+		const unsigned int shift = static_cast<unsigned int>(byte) * 8u;
+		if (histogram[(packets_.front().key >> shift) & 0xFFu] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0u;
+		for (auto& bucket : histogram)
+		{
+			const size_t bucketSize = bucket;
+			bucket = offset;
+			offset += bucketSize;
+		}
+		for (const auto& packet : packets_)
+		{
+			scratch_[histogram[(packet.key >> shift) & 0xFFu]++] = packet;
+		}
+		packets_.swap(scratch_);
+	}
+}
+
+const std::vector<RenderQueue::Packet>& RenderQueue::getPackets() const noexcept
+{
+	return packets_;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Drawable;
+
+// Draw packets collected for a frame and ordered by a 64-bit key before they are executed. The key groups
+// packets by render state so consecutive draws can skip rebinding what the previous draw already bound:
+//
+//   Opaque:  | pass:2 | material:16 | mesh:14 | depth:32 |   state first, then front to back
+//   Blended: | pass:2 | ~depth:32 | material:16 | mesh:14 |   back to front, then state
+//
+// Sorting is an LSD radix sort over the key bytes, which is stable and skips bytes that are equal for every
+// packet (the pass byte for an all-opaque frame, for instance).
+class RenderQueue
+{
+public:
+	enum class Pass : std::uint8_t
+	{
+		Opaque = 0u,
+		Blended = 1u,
+	};
+
+	struct Packet
+	{
+		std::uint64_t key;
+		const Drawable* drawable;
+	};
+
+	RenderQueue() = default;
+	~RenderQueue() = default;
+	RenderQueue(const RenderQueue&) = delete;
+	RenderQueue& operator=(const RenderQueue&) = delete;
+	RenderQueue(const RenderQueue&&) = delete;
+	RenderQueue& operator=(const RenderQueue&&) = delete;
+
+	// depth is the view space distance, anything behind the camera sorts as 0
+	static std::uint64_t makeKey(Pass pass, std::uint16_t material, std::uint16_t mesh, float depth) noexcept;
+
+	void reserve(size_t count);
+	void clear() noexcept;
+	void push(std::uint64_t key, const Drawable* drawable);
+	void sort();
+
+	[[nodiscard]] const std::vector<Packet>& getPackets() const noexcept;
+private:
+	std::vector<Packet> packets_;
+	std::vector<Packet> scratch_;
+};
@@ -0,0 +1,45 @@
+#include "ReplayLoop.hpp"
+
+#if defined(_WIN32)
+#include "AtumWindows.hpp"
+#else
+// The key App pauses the simulation on
+constexpr unsigned char VK_SPACE = 0x20;
+#endif
+
+ReplayLoop::ReplayLoop(const InputRecording::Replay& replay, const float tickRate, const unsigned int maxTicksPerFrame)
+	:
+	replay_(replay),
+	timestep_(tickRate, maxTicksPerFrame)
+{
+}
+
+bool ReplayLoop::isDone() const noexcept
+{
+	return frame_ >= replay_.getFrames().size();
+}
+
+ReplayLoop::Frame ReplayLoop::next()
+{
+	Frame frame;
+	const float seconds = replay_.apply(frame_++, mouse_, keyboard_);
+	frame.mouse = mouse_.collectFrame();
+	// Only the key states matter, empty the queues the handlers fill like the recording session did
+	keyboard_.drainKeys([](const Keyboard::Event&) {});
+	keyboard_.drainChars([](char) {});
+	frame.paused = keyboard_.isKeyPressed(VK_SPACE);
+	frame.ticks = timestep_.advance(frame.paused ? 0.0f : seconds);
+	frame.step = timestep_.getStep();
+	frame.alpha = timestep_.getAlpha();
+	return frame;
+}
+
+size_t ReplayLoop::getFrame() const noexcept
+{
+	return frame_;
+}
+
+const FixedTimestep& ReplayLoop::getTimestep() const noexcept
+{
+	return timestep_;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "FixedTimestep.hpp"
+#include "InputRecording.hpp"
+#include "Keyboard.hpp"
+#include "Mouse.hpp"
+
+// What the app's frame loop does to a recording's input, minus the window and the device: every simulated frame
+// runs the input that reached it through its own Mouse and Keyboard, pauses while space is held and hands the
+// recorded time to the fixed timestep. The simulation itself is left to the caller.
+class ReplayLoop
+{
+public:
+	struct Frame
+	{
+		// Fixed ticks of step seconds to run, then blend the last two by alpha
+		unsigned int ticks = 0u;
+		float step = 0.0f;
+		float alpha = 1.0f;
+		bool paused = false;
+		Mouse::FrameInput mouse;
+	};
+
+public:
+	ReplayLoop(const InputRecording::Replay& replay, float tickRate, unsigned int maxTicksPerFrame);
+	~ReplayLoop() = default;
+	ReplayLoop(const ReplayLoop&) = delete;
+	ReplayLoop& operator=(const ReplayLoop&) = delete;
+	ReplayLoop(const ReplayLoop&&) = delete;
+	ReplayLoop& operator=(const ReplayLoop&&) = delete;
+
+	[[nodiscard]] bool isDone() const noexcept;
+	// Step to the next simulated frame
+	Frame next();
+
+	[[nodiscard]] size_t getFrame() const noexcept;
+	[[nodiscard]] const FixedTimestep& getTimestep() const noexcept;
+private:
+	const InputRecording::Replay& replay_;
+	Mouse mouse_;
+	Keyboard keyboard_;
+	FixedTimestep timestep_;
+	size_t frame_ = 0u;
+};
@@ -0,0 +1,140 @@
+#include "ResolutionScaler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ResolutionScaler::ResolutionScaler(const Settings& settings) noexcept
+	:
+	settings_(settings),
+	scale_(settings.maxScale)
+{}
+
+float ResolutionScaler::update(const float frameMilliseconds) noexcept
+{
+	if (settings_.targetMilliseconds <= 0.0f)
+	{
+		scale_ = settings_.maxScale;
+		return scale_;
+	}
+
+	averageMilliseconds_ = hasAverage_ ? averageMilliseconds_ + settings_.smoothing * (frameMilliseconds - averageMilliseconds_) : frameMilliseconds;
+	hasAverage_ = true;
+	if (cooldown_ > 0u)
+	{
+		cooldown_--;
+		return scale_;
+	}
+
+	float next = scale_;
+	if (averageMilliseconds_ > settings_.targetMilliseconds)
+	{
+		// Round down so the new scale lands inside the budget rather than just above it
+		next = std::floor(scale_ * std::sqrt(settings_.targetMilliseconds / averageMilliseconds_) / settings_.step) * settings_.step;
+		next = std::min(next, scale_ - settings_.step);
+	}
+	else if (averageMilliseconds_ < settings_.targetMilliseconds * settings_.headroom)
+	{
+		// Only grow as far as the prediction still fits the headroom band
+		const float fits = scale_ * std::sqrt(settings_.targetMilliseconds * settings_.headroom / averageMilliseconds_);
+		if (fits >= scale_ + settings_.step)
+		{
+			next = scale_ + settings_.step;
+		}
+	}
+
+	next = quantise(next);
+	if (next != scale_)
+	{
+		// Start the average from what the new scale should cost, so the old scale's frames do not trigger a second change
+		averageMilliseconds_ *= (next * next) / (scale_ * scale_);
+		scale_ = next;
+		cooldown_ = settings_.cooldownFrames;
+	}
+	return scale_;
+}
+
+void ResolutionScaler::setTargetMilliseconds(const float targetMilliseconds) noexcept
+{
+	settings_.targetMilliseconds = targetMilliseconds;
+	cooldown_ = 0u;
+}
+
+float ResolutionScaler::getScale() const noexcept
+{
+	return scale_;
+}
+
+float ResolutionScaler::getAverageMilliseconds() const noexcept
+{
+	return averageMilliseconds_;
+}
+
+const ResolutionScaler::Settings& ResolutionScaler::getSettings() const noexcept
+{
+	return settings_;
+}
+
+unsigned int ResolutionScaler::scaleExtent(const unsigned int extent, const float scale) noexcept
+{
+	return std::max(1u, static_cast<unsigned int>(std::lround(static_cast<float>(extent) * scale)));
+}
+
+void ResolutionScaler::upscale(const Surface& source, Surface& destination)
+{
+	const unsigned int sourceWidth = source.getWidth();
+	const unsigned int sourceHeight = source.getHeight();
+	const unsigned int width = destination.getWidth();
+	const unsigned int height = destination.getHeight();
+	if (sourceWidth == 0u || sourceHeight == 0u || width == 0u || height == 0u)
+	{
+		return;
+	}
+
+	// The column taps are shared by all rows, and by every frame until the scale or the window size changes
+	if (columns_.size() != width || columnsSourceWidth_ != sourceWidth)
+	{
+		columns_.resize(width);
+		for (unsigned int x = 0; x < width; x++)
+		{
+			columns_[x] = makeTap(x, sourceWidth, width);
+		}
+		columnsSourceWidth_ = sourceWidth;
+	}
+
+	// Blend two packed pixels, red and blue in one lane pair and alpha and green in the other
+	const auto lerp = [](const unsigned int a, const unsigned int b, const unsigned int weight)
+		{
+			const unsigned int redBlue = ((a & 0x00FF00FFu) * (256u - weight) + (b & 0x00FF00FFu) * weight) >> 8u;
+			const unsigned int alphaGreen = (((a >> 8u) & 0x00FF00FFu) * (256u - weight) + ((b >> 8u) & 0x00FF00FFu) * weight) >> 8u;
+			return (redBlue & 0x00FF00FFu) | ((alphaGreen & 0x00FF00FFu) << 8u);
+		};
+
+	const unsigned int* texels = reinterpret_cast<const unsigned int*>(source.getBufferPtr());
+	unsigned int* output = reinterpret_cast<unsigned int*>(destination.getBufferPtr());
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const Tap row = makeTap(y, sourceHeight, height);
+		const unsigned int* top = texels + static_cast<size_t>(row.first) * sourceWidth;
+		const unsigned int* bottom = texels + static_cast<size_t>(row.second) * sourceWidth;
+		unsigned int* line = output + static_cast<size_t>(y) * width;
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const Tap& column = columns_[x];
+			line[x] = lerp(lerp(top[column.first], top[column.second], column.weight),
+				lerp(bottom[column.first], bottom[column.second], column.weight), row.weight);
+		}
+	}
+}
+
+float ResolutionScaler::quantise(const float scale) const noexcept
+{
+	return std::clamp(std::round(scale / settings_.step) * settings_.step, settings_.minScale, settings_.maxScale);
+}
+
+ResolutionScaler::Tap ResolutionScaler::makeTap(const unsigned int index, const unsigned int sourceExtent, const unsigned int extent) noexcept
+{
+	const float position = std::clamp((static_cast<float>(index) + 0.5f) * static_cast<float>(sourceExtent) / static_cast<float>(extent) - 0.5f,
+		0.0f, static_cast<float>(sourceExtent - 1u));
+	const auto first = static_cast<unsigned int>(position);
+	return { first, std::min(first + 1u, sourceExtent - 1u), static_cast<unsigned int>((position - static_cast<float>(first)) * 256.0f) };
+}
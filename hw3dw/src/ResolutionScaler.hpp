@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+
+#include "Surface.hpp"
+
+// Picks the scale the 3D scene renders at so its frame time stays inside a budget. Measured frame times are
+// smoothed; once the average runs over the target the scale drops straight to where the pixel count should fit
+// (cost is taken to grow with the square of the scale), and once it sits below the headroom band the scale grows
+// back a step at a time. Scales are quantised to steps and every change is followed by a cooldown, so the
+// controller does not chase the noise of single frames.
+class ResolutionScaler
+{
+public:
+	struct Settings
+	{
+		// 0 turns the controller off and keeps maxScale
+		float targetMilliseconds = 0.0f;
+		float minScale = 0.5f;
+		float maxScale = 1.0f;
+		float step = 1.0f / 16.0f;
+		// Grow only while the average is below this fraction of the target
+		float headroom = 0.85f;
+		// Weight of the newest frame in the running average
+		float smoothing = 0.1f;
+		unsigned int cooldownFrames = 12u;
+	};
+
+public:
+	explicit ResolutionScaler(const Settings& settings) noexcept;
+	~ResolutionScaler() = default;
+	ResolutionScaler(const ResolutionScaler&) = delete;
+	ResolutionScaler& operator=(const ResolutionScaler&) = delete;
+	ResolutionScaler(const ResolutionScaler&&) = delete;
+	ResolutionScaler& operator=(const ResolutionScaler&&) = delete;
+
+	// Feed the frame time rendered at the current scale and return the scale for the next frame
+	float update(float frameMilliseconds) noexcept;
+	void setTargetMilliseconds(float targetMilliseconds) noexcept;
+
+	[[nodiscard]] float getScale() const noexcept;
+	[[nodiscard]] float getAverageMilliseconds() const noexcept;
+	[[nodiscard]] const Settings& getSettings() const noexcept;
+
+	// Size of one side at a scale, never below one pixel
+	static unsigned int scaleExtent(unsigned int extent, float scale) noexcept;
+	// Bilinear resample of the whole source onto the whole destination, sampling at pixel centres like the GPU pass.
+	// The column taps are kept for the next call and only rebuilt when the widths change with the scale.
+	void upscale(const Surface& source, Surface& destination);
+private:
+	// Source pair and 8 bit weight of the second one for a destination column or row
+	struct Tap
+	{
+		unsigned int first;
+		unsigned int second;
+		unsigned int weight;
+	};
+
+	[[nodiscard]] float quantise(float scale) const noexcept;
+	static Tap makeTap(unsigned int index, unsigned int sourceExtent, unsigned int extent) noexcept;
+
+	Settings settings_;
+	float scale_;
+	float averageMilliseconds_ = 0.0f;
+	bool hasAverage_ = false;
+	unsigned int cooldown_ = 0u;
+	std::vector<Tap> columns_;
+	unsigned int columnsSourceWidth_ = 0u;
+};
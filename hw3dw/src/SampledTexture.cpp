@@ -0,0 +1,321 @@
+#include "SampledTexture.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <emmintrin.h>
+
+#include "MemoryTracker.hpp"
+
+namespace
+{
+	// Texel coordinate after addressing. Done in float with the same operations in the scalar and the SSE2
+	// paths so both land on the same texels; the fix ups catch the division rounding to the wrong side.
+	float addressScalar(const float coordinate, const float size, const float inverseSize, const SampledTexture::Addressing addressing) noexcept
+	{
+		if (addressing == SampledTexture::Addressing::Clamp)
+		{
+			return std::min(std::max(coordinate, 0.0f), size - 1.0f);
+		}
+		float wrapped = coordinate - std::floor(coordinate * inverseSize) * size;
+		wrapped = wrapped >= size ? wrapped - size : wrapped;
+		return wrapped < 0.0f ? wrapped + size : wrapped;
+	}
+
+	// _mm_floor_ps needs SSE4.1; truncate and step down where truncation rounded up
+	__m128 floor4(const __m128 value) noexcept
+	{
+		const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+		return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+	}
+
+	__m128 address4(const __m128 coordinate, const __m128 size, const __m128 inverseSize, const SampledTexture::Addressing addressing) noexcept
+	{
+		if (addressing == SampledTexture::Addressing::Clamp)
+		{
+			return _mm_min_ps(_mm_max_ps(coordinate, _mm_setzero_ps()), _mm_sub_ps(size, _mm_set1_ps(1.0f)));
+		}
+		__m128 wrapped = _mm_sub_ps(coordinate, _mm_mul_ps(floor4(_mm_mul_ps(coordinate, inverseSize)), size));
+		wrapped = _mm_sub_ps(wrapped, _mm_and_ps(_mm_cmpge_ps(wrapped, size), size));
+		return _mm_add_ps(wrapped, _mm_and_ps(_mm_cmplt_ps(wrapped, _mm_setzero_ps()), size));
+	}
+
+	// Texel channels as floats in memory order: b, g, r, a
+	__m128 unpackTexel(const unsigned int texel) noexcept
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(texel));
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+	}
+
+	unsigned int packTexel(const __m128 channels) noexcept
+	{
+		__m128i rounded = _mm_cvttps_epi32(_mm_add_ps(channels, _mm_set1_ps(0.5f)));
+		rounded = _mm_packs_epi32(rounded, rounded);
+		return static_cast<unsigned int>(_mm_cvtsi128_si32(_mm_packus_epi16(rounded, rounded)));
+	}
+
+	// Keeps the float to int conversions well inside the int range
+	constexpr float coordinateLimit = 4194304.0f;
+}
+
+SampledTexture::SampledTexture(const Surface& source, const unsigned int maxLevels)
+{
+	MemoryTracker::Scope scope(MemoryTag::Textures);
+	unsigned int width = source.getWidth();
+	unsigned int height = source.getHeight();
+	size_t texelCount = 0u;
+	while (true)
+	{
+		const unsigned int tilesX = (width + tileSize - 1u) / tileSize;
+		const unsigned int tilesY = (height + tileSize - 1u) / tileSize;
+		levels_.push_back({ width, height, tilesX, texelCount });
+		texelCount += static_cast<size_t>(tilesX) * tilesY * tileTexels;
+		if ((width == 1u && height == 1u) || levels_.size() == maxLevels)
+		{
+			break;
+		}
+		width = std::max(width / 2u, 1u);
+		height = std::max(height / 2u, 1u);
+	}
+
+	// One spare tile so the start can be moved up to a 64 byte boundary
+	storage_.assign(texelCount + tileTexels, 0u);
+	const auto misalignment = reinterpret_cast<std::uintptr_t>(storage_.data()) % (tileTexels * sizeof(unsigned int));
+	unsigned int* texels = storage_.data() + (misalignment == 0u ? 0u : (tileTexels * sizeof(unsigned int) - misalignment) / sizeof(unsigned int));
+	texels_ = texels;
+
+	// Build each level row major from the previous one with a 2x2 box filter, then scatter it into tiles
+	std::vector<unsigned int> current(static_cast<size_t>(source.getWidth()) * source.getHeight());
+	std::transform(source.getBufferPtr(), source.getBufferPtr() + current.size(), current.begin(),
+		[](const Surface::color color) { return color.dword; });
+	std::vector<unsigned int> next;
+	for (size_t index = 0; index < levels_.size(); index++)
+	{
+		const Level& level = levels_[index];
+		for (unsigned int y = 0; y < level.height; y++)
+		{
+			for (unsigned int x = 0; x < level.width; x++)
+			{
+				texels[texelIndex(level, x, y)] = current[static_cast<size_t>(y) * level.width + x];
+			}
+		}
+
+		if (index + 1u == levels_.size())
+		{
+			break;
+		}
+		const Level& smaller = levels_[index + 1u];
+		next.resize(static_cast<size_t>(smaller.width) * smaller.height);
+		for (unsigned int y = 0; y < smaller.height; y++)
+		{
+			const unsigned int y0 = std::min(y * 2u, level.height - 1u);
+			const unsigned int y1 = std::min(y * 2u + 1u, level.height - 1u);
+			for (unsigned int x = 0; x < smaller.width; x++)
+			{
+				const unsigned int x0 = std::min(x * 2u, level.width - 1u);
+				const unsigned int x1 = std::min(x * 2u + 1u, level.width - 1u);
+				const unsigned int quad[4] = {
+					current[static_cast<size_t>(y0) * level.width + x0],
+					current[static_cast<size_t>(y0) * level.width + x1],
+					current[static_cast<size_t>(y1) * level.width + x0],
+					current[static_cast<size_t>(y1) * level.width + x1]
+				};
+				unsigned int averaged = 0u;
+				for (unsigned int shift = 0u; shift < 32u; shift += 8u)
+				{
+					unsigned int sum = 2u;
+					for (const unsigned int texel : quad)
+					{
+						sum += (texel >> shift) & 0xFFu;
+					}
+					averaged |= (sum / 4u) << shift;
+				}
+				next[static_cast<size_t>(y) * smaller.width + x] = averaged;
+			}
+		}
+		current.swap(next);
+	}
+}
+
+void SampledTexture::sampleQuad(const float u[4], const float v[4], const State& state, Surface::color output[4]) const noexcept
+{
+	// Coarse derivatives, one level of detail for the whole quad
+	const float lod = computeLod(u[1] - u[0], v[1] - v[0], u[2] - u[0], v[2] - v[0]);
+	sample4(u, v, lod, state, output);
+}
+
+void SampledTexture::sample4(const float u[4], const float v[4], const float lod, const State& state, Surface::color output[4]) const noexcept
+{
+	unsigned int level;
+	float blend;
+	selectLevels(lod, state.filter, level, blend);
+
+	float colors[4][4];
+	sampleLevel4(levels_[level], u, v, state, colors);
+	if (blend > 0.0f)
+	{
+		float coarser[4][4];
+		sampleLevel4(levels_[level + 1u], u, v, state, coarser);
+		const __m128 weight = _mm_set1_ps(blend);
+		for (int i = 0; i < 4; i++)
+		{
+			const __m128 fine = _mm_loadu_ps(colors[i]);
+			_mm_storeu_ps(colors[i], _mm_add_ps(fine, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(coarser[i]), fine), weight)));
+		}
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		output[i] = Surface::color(packTexel(_mm_loadu_ps(colors[i])));
+	}
+}
+
+Surface::color SampledTexture::sample(const float u, const float v, const float lod, const State& state) const noexcept
+{
+	unsigned int levelIndex;
+	float blend;
+	selectLevels(lod, state.filter, levelIndex, blend);
+
+	const auto bilinear = [this, u, v, &state](const Level& level, float channels[4])
+		{
+			const float width = static_cast<float>(level.width);
+			const float height = static_cast<float>(level.height);
+			const float x = std::clamp(u * width - 0.5f, -coordinateLimit, coordinateLimit);
+			const float y = std::clamp(v * height - 0.5f, -coordinateLimit, coordinateLimit);
+			const float floorX = std::floor(x);
+			const float floorY = std::floor(y);
+			const float fractionX = x - floorX;
+			const float fractionY = y - floorY;
+			const auto x0 = static_cast<unsigned int>(addressScalar(floorX, width, 1.0f / width, state.addressU));
+			const auto x1 = static_cast<unsigned int>(addressScalar(floorX + 1.0f, width, 1.0f / width, state.addressU));
+			const auto y0 = static_cast<unsigned int>(addressScalar(floorY, height, 1.0f / height, state.addressV));
+			const auto y1 = static_cast<unsigned int>(addressScalar(floorY + 1.0f, height, 1.0f / height, state.addressV));
+
+			const unsigned int c00 = texels_[texelIndex(level, x0, y0)];
+			const unsigned int c10 = texels_[texelIndex(level, x1, y0)];
+			const unsigned int c01 = texels_[texelIndex(level, x0, y1)];
+			const unsigned int c11 = texels_[texelIndex(level, x1, y1)];
+			for (unsigned int c = 0; c < 4u; c++)
+			{
+				const auto channel = [c](const unsigned int texel) { return static_cast<float>((texel >> (c * 8u)) & 0xFFu); };
+				const float top = channel(c00) + (channel(c10) - channel(c00)) * fractionX;
+				const float bottom = channel(c01) + (channel(c11) - channel(c01)) * fractionX;
+				channels[c] = top + (bottom - top) * fractionY;
+			}
+		};
+
+	float channels[4];
+	bilinear(levels_[levelIndex], channels);
+	if (blend > 0.0f)
+	{
+		float coarser[4];
+		bilinear(levels_[levelIndex + 1u], coarser);
+		for (int c = 0; c < 4; c++)
+		{
+			channels[c] += (coarser[c] - channels[c]) * blend;
+		}
+	}
+
+	unsigned int packed = 0u;
+	for (unsigned int c = 0; c < 4u; c++)
+	{
+		packed |= static_cast<unsigned int>(std::min(channels[c] + 0.5f, 255.0f)) << (c * 8u);
+	}
+	return { packed };
+}
+
+float SampledTexture::computeLod(const float dudx, const float dvdx, const float dudy, const float dvdy) const noexcept
+{
+	const float width = static_cast<float>(levels_.front().width);
+	const float height = static_cast<float>(levels_.front().height);
+	const float lengthX = std::hypot(dudx * width, dvdx * height);
+	const float lengthY = std::hypot(dudy * width, dvdy * height);
+	return std::log2(std::max(std::max(lengthX, lengthY), 1.0e-6f));
+}
+
+unsigned int SampledTexture::getLevelCount() const noexcept
+{
+	return static_cast<unsigned int>(levels_.size());
+}
+
+unsigned int SampledTexture::getWidth(const unsigned int level) const noexcept
+{
+	return levels_[level].width;
+}
+
+unsigned int SampledTexture::getHeight(const unsigned int level) const noexcept
+{
+	return levels_[level].height;
+}
+
+Surface::color SampledTexture::getTexel(const unsigned int level, const unsigned int x, const unsigned int y) const noexcept
+{
+	return { texels_[texelIndex(levels_[level], x, y)] };
+}
+
+void SampledTexture::selectLevels(const float lod, const Filter filter, unsigned int& level, float& blend) const noexcept
+{
+	const float lastLevel = static_cast<float>(levels_.size() - 1u);
+	if (filter == Filter::Bilinear)
+	{
+		level = static_cast<unsigned int>(std::clamp(std::floor(lod + 0.5f), 0.0f, lastLevel));
+		blend = 0.0f;
+		return;
+	}
+
+	const float clamped = std::clamp(lod, 0.0f, lastLevel);
+	const float whole = std::floor(clamped);
+	level = static_cast<unsigned int>(whole);
+	blend = clamped - whole;
+}
+
+void SampledTexture::sampleLevel4(const Level& level, const float u[4], const float v[4], const State& state, float output[4][4]) const noexcept
+{
+	const __m128 width = _mm_set1_ps(static_cast<float>(level.width));
+	const __m128 height = _mm_set1_ps(static_cast<float>(level.height));
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 limit = _mm_set1_ps(coordinateLimit);
+	const __m128 negativeLimit = _mm_set1_ps(-coordinateLimit);
+
+	const __m128 x = _mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(u), width), half), negativeLimit), limit);
+	const __m128 y = _mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(v), height), half), negativeLimit), limit);
+	const __m128 floorX = floor4(x);
+	const __m128 floorY = floor4(y);
+
+	alignas(16) float fractionX[4];
+	alignas(16) float fractionY[4];
+	_mm_store_ps(fractionX, _mm_sub_ps(x, floorX));
+	_mm_store_ps(fractionY, _mm_sub_ps(y, floorY));
+
+	const __m128 inverseWidth = _mm_set1_ps(1.0f / static_cast<float>(level.width));
+	const __m128 inverseHeight = _mm_set1_ps(1.0f / static_cast<float>(level.height));
+	alignas(16) int x0[4];
+	alignas(16) int x1[4];
+	alignas(16) int y0[4];
+	alignas(16) int y1[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(x0), _mm_cvttps_epi32(address4(floorX, width, inverseWidth, state.addressU)));
+	_mm_store_si128(reinterpret_cast<__m128i*>(x1), _mm_cvttps_epi32(address4(_mm_add_ps(floorX, one), width, inverseWidth, state.addressU)));
+	_mm_store_si128(reinterpret_cast<__m128i*>(y0), _mm_cvttps_epi32(address4(floorY, height, inverseHeight, state.addressV)));
+	_mm_store_si128(reinterpret_cast<__m128i*>(y1), _mm_cvttps_epi32(address4(_mm_add_ps(floorY, one), height, inverseHeight, state.addressV)));
+
+	// SSE2 has no gather, so the four taps are loaded one by one and filtered with all channels in one register
+	for (int i = 0; i < 4; i++)
+	{
+		const __m128 c00 = unpackTexel(texels_[texelIndex(level, x0[i], y0[i])]);
+		const __m128 c10 = unpackTexel(texels_[texelIndex(level, x1[i], y0[i])]);
+		const __m128 c01 = unpackTexel(texels_[texelIndex(level, x0[i], y1[i])]);
+		const __m128 c11 = unpackTexel(texels_[texelIndex(level, x1[i], y1[i])]);
+		const __m128 weightX = _mm_set1_ps(fractionX[i]);
+		const __m128 top = _mm_add_ps(c00, _mm_mul_ps(_mm_sub_ps(c10, c00), weightX));
+		const __m128 bottom = _mm_add_ps(c01, _mm_mul_ps(_mm_sub_ps(c11, c01), weightX));
+		_mm_storeu_ps(output[i], _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), _mm_set1_ps(fractionY[i]))));
+	}
+}
+
+size_t SampledTexture::texelIndex(const Level& level, const unsigned int x, const unsigned int y) const noexcept
+{
+	const size_t tile = static_cast<size_t>(y / tileSize) * level.tilesX + x / tileSize;
+	return level.offset + tile * tileTexels + (y % tileSize) * tileSize + x % tileSize;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+
+#include "Surface.hpp"
+
+// CPU side counterpart of a texture bound with the Sampler bind, for the software rasterizer. The source is
+// turned into a box filtered mip chain stored in 4x4 texel tiles: one tile is 64 bytes, a single cache line,
+// so the 2x2 footprint of a bilinear tap usually touches one line instead of two rows of the image.
+//
+// sampleQuad() takes the texture coordinates of a 2x2 pixel quad, derives the level of detail from the
+// differences across the quad the way the GPU does and filters all four pixels with SSE2. sample() is the
+// plain scalar version of the same filter, kept as a reference.
+class SampledTexture
+{
+public:
+	enum class Filter
+	{
+		Bilinear,  // MIN_MAG_LINEAR_MIP_POINT
+		Trilinear, // MIN_MAG_MIP_LINEAR
+	};
+
+	enum class Addressing
+	{
+		Wrap,
+		Clamp,
+	};
+
+	struct State
+	{
+		Filter filter = Filter::Trilinear;
+		Addressing addressU = Addressing::Wrap;
+		Addressing addressV = Addressing::Wrap;
+	};
+
+public:
+	// maxLevels limits the chain, 0 builds every level down to 1x1
+	explicit SampledTexture(const Surface& source, unsigned int maxLevels = 0u);
+	~SampledTexture() = default;
+	SampledTexture(const SampledTexture&) = delete;
+	SampledTexture& operator=(const SampledTexture&) = delete;
+	SampledTexture(const SampledTexture&&) = delete;
+	SampledTexture& operator=(const SampledTexture&&) = delete;
+
+	// Pixels in quad order: top left, top right, bottom left, bottom right
+	void sampleQuad(const float u[4], const float v[4], const State& state, Surface::color output[4]) const noexcept;
+	// Four samples sharing one level of detail
+	void sample4(const float u[4], const float v[4], float lod, const State& state, Surface::color output[4]) const noexcept;
+	[[nodiscard]] Surface::color sample(float u, float v, float lod, const State& state) const noexcept;
+	// log2 of the larger screen space footprint of a texel step, in level 0 texels
+	[[nodiscard]] float computeLod(float dudx, float dvdx, float dudy, float dvdy) const noexcept;
+
+	[[nodiscard]] unsigned int getLevelCount() const noexcept;
+	[[nodiscard]] unsigned int getWidth(unsigned int level = 0u) const noexcept;
+	[[nodiscard]] unsigned int getHeight(unsigned int level = 0u) const noexcept;
+	[[nodiscard]] Surface::color getTexel(unsigned int level, unsigned int x, unsigned int y) const noexcept;
+
+private:
+	struct Level
+	{
+		unsigned int width;
+		unsigned int height;
+		unsigned int tilesX;
+		size_t offset;
+	};
+
+	// Level and blend weight between it and the next one for a level of detail
+	void selectLevels(float lod, Filter filter, unsigned int& level, float& blend) const noexcept;
+	void sampleLevel4(const Level& level, const float u[4], const float v[4], const State& state, float output[4][4]) const noexcept;
+	size_t texelIndex(const Level& level, unsigned int x, unsigned int y) const noexcept;
+
+	static constexpr unsigned int tileSize = 4u;
+	static constexpr unsigned int tileTexels = tileSize * tileSize;
+
+	std::vector<Level> levels_;
+	std::vector<unsigned int> storage_;
+	// Start of the texels inside storage_, aligned so every tile sits in one cache line
+	const unsigned int* texels_;
+};
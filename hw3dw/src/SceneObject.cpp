@@ -0,0 +1,66 @@
+#include "SceneObject.hpp"
+
+void SceneObject::tick(const float dt) noexcept
+{
+	previousPose_ = hasPose_ ? currentPose_ : capturePose();
+	update(dt);
+	currentPose_ = capturePose();
+	hasPose_ = true;
+}
+
+void SceneObject::interpolate(const float alpha) noexcept
+{
+	setRenderTransform(interpolateTransform(alpha));
+}
+
+DirectX::XMFLOAT4X4 SceneObject::interpolateTransform(const float alpha) noexcept
+{
+	namespace dx = DirectX;
+	if (!hasPose_)
+	{
+		currentPose_ = capturePose();
+		previousPose_ = currentPose_;
+		hasPose_ = true;
+	}
+
+	const auto scale = dx::XMVectorLerp(dx::XMLoadFloat3(&previousPose_.scale), dx::XMLoadFloat3(&currentPose_.scale), alpha);
+	const auto rotation = dx::XMQuaternionSlerp(dx::XMLoadFloat4(&previousPose_.rotation), dx::XMLoadFloat4(&currentPose_.rotation), alpha);
+	const auto translation = dx::XMVectorLerp(dx::XMLoadFloat3(&previousPose_.translation), dx::XMLoadFloat3(&currentPose_.translation), alpha);
+	dx::XMFLOAT4X4 transform;
+	dx::XMStoreFloat4x4(&transform,
+		dx::XMMatrixScalingFromVector(scale) * dx::XMMatrixRotationQuaternion(rotation) * dx::XMMatrixTranslationFromVector(translation));
+	return transform;
+}
+
+void SceneObject::setRenderTransform(const DirectX::XMFLOAT4X4& transform) noexcept
+{
+	renderTransform_ = transform;
+}
+
+DirectX::XMMATRIX SceneObject::getRenderTransformXm() const noexcept
+{
+	return DirectX::XMLoadFloat4x4(&renderTransform_);
+}
+
+SceneObject::Pose SceneObject::capturePose() const noexcept
+{
+	namespace dx = DirectX;
+	dx::XMVECTOR scale;
+	dx::XMVECTOR rotation;
+	dx::XMVECTOR translation;
+	const dx::XMMATRIX transform = getTransformXm();
+	if (!dx::XMMatrixDecompose(&scale, &rotation, &translation, transform))
+	{
+		// Degenerate transforms can not be decomposed; keep the position with an identity scale and rotation
+		// rather than interpolate garbage or collapse the drawable to a point
+		scale = dx::XMVectorSplatOne();
+		rotation = dx::XMQuaternionIdentity();
+		translation = transform.r[3];
+	}
+
+	Pose pose;
+	dx::XMStoreFloat3(&pose.scale, scale);
+	dx::XMStoreFloat4(&pose.rotation, rotation);
+	dx::XMStoreFloat3(&pose.translation, translation);
+	return pose;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <DirectXMath.h>
+
+// The simulated half of a drawable: it moves in fixed steps and hands rendering a pose blended between the last two.
+// Nothing here touches the device, so the headless replay runs the same code the drawables do.
+class SceneObject
+{
+public:
+	SceneObject() = default;
+	virtual ~SceneObject() = default;
+	SceneObject(const SceneObject&) = delete;
+	SceneObject& operator=(const SceneObject&) = delete;
+	SceneObject(const SceneObject&&) = delete;
+	SceneObject& operator=(const SceneObject&&) = delete;
+
+	virtual DirectX::XMMATRIX getTransformXm() const noexcept = 0;
+	virtual void update(float dt) noexcept = 0;
+
+	// Advance the simulation by one step, keeping the pose from before it
+	void tick(float dt) noexcept;
+	// Blend the poses of the last two ticks (0 = previous, 1 = latest) into the transform rendering uses
+	void interpolate(float alpha) noexcept;
+	// interpolate() in two halves for the pipelined loop: the simulation thread blends the poses into a scene
+	// snapshot, the render thread hands the snapshot's transform back. Neither touches the other's state.
+	DirectX::XMFLOAT4X4 interpolateTransform(float alpha) noexcept;
+	void setRenderTransform(const DirectX::XMFLOAT4X4& transform) noexcept;
+	DirectX::XMMATRIX getRenderTransformXm() const noexcept;
+
+private:
+	// getTransformXm() split into scale, rotation and translation so rotations interpolate along the sphere
+	struct Pose
+	{
+		DirectX::XMFLOAT3 scale;
+		DirectX::XMFLOAT4 rotation;
+		DirectX::XMFLOAT3 translation;
+	};
+
+	Pose capturePose() const noexcept;
+
+	Pose previousPose_{};
+	Pose currentPose_{};
+	DirectX::XMFLOAT4X4 renderTransform_{};
+	bool hasPose_ = false;
+};
@@ -0,0 +1,43 @@
+#include "ScenePopulation.hpp"
+
+ScenePopulation::ScenePopulation(const unsigned int seed)
+	:
+	ScenePopulation(seed, Distributions{})
+{
+}
+
+ScenePopulation::ScenePopulation(const unsigned int seed, Distributions distributions)
+	:
+	rng_(seed),
+	distributions_(std::move(distributions))
+{
+}
+
+ScenePopulation::Spawn ScenePopulation::next()
+{
+	return next(static_cast<Kind>(distributions_.drawableType(rng_)));
+}
+
+ScenePopulation::Spawn ScenePopulation::next(const Kind kind)
+{
+	Spawn spawn = {
+		.kind = kind,
+		.orbit = Orbit(rng_, distributions_.distance, distributions_.sphericalCoordinatePosition, distributions_.rotationOfDrawable,
+			distributions_.sphericalCoordinateMovementOfDrawable)
+	};
+
+	// Separate statements, the order the rng is drawn in decides the scene
+	switch (kind)
+	{
+	case Kind::Box:
+		spawn.zAxisDistortion = distributions_.zAxisDistortion(rng_);
+		break;
+	case Kind::Melon:
+		spawn.latitudinalDivisions = distributions_.latitude(rng_);
+		spawn.longitudinalDivisions = distributions_.longitude(rng_);
+		break;
+	default:
+		break;
+	}
+	return spawn;
+}
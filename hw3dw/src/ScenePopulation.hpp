@@ -0,0 +1,56 @@
+#pragma once
+#include <random>
+
+#include "AtumMath.hpp"
+#include "Orbit.hpp"
+
+// The random scene a seed stands for: which kind of drawable comes next and everything it draws from the rng, in
+// a fixed order. App builds Drawables out of the spawns, the headless replay bare orbits, and both end up with the
+// same scene for the same seed.
+class ScenePopulation
+{
+public:
+	enum class Kind
+	{
+		Pyramid,
+		Box,
+		Melon,
+		Sheet,
+		SkinnedBox
+	};
+
+	struct Spawn
+	{
+		Kind kind;
+		Orbit orbit;
+		// Box only
+		float zAxisDistortion = 1.0f;
+		// Melon only
+		int latitudinalDivisions = 0;
+		int longitudinalDivisions = 0;
+	};
+
+	struct Distributions
+	{
+		std::uniform_real_distribution<float> sphericalCoordinatePosition{ 0.0f, PI * 2.0f };		// adist
+		std::uniform_real_distribution<float> rotationOfDrawable{ 0.0f, PI * 0.5f };				// ddist
+		std::uniform_real_distribution<float> sphericalCoordinateMovementOfDrawable{ 0.0f, PI * 0.08f };	// odist
+		std::uniform_real_distribution<float> distance{ 6.0f, 20.0f };								// rdist
+		std::uniform_real_distribution<float> zAxisDistortion{ 0.4f, 3.0f };						// bdist
+		std::uniform_int_distribution<int> latitude{ 5, 20 };										// latdist
+		std::uniform_int_distribution<int> longitude{ 10, 40 };										// longdist
+		std::uniform_int_distribution<int> drawableType{ 0, 4 };									// typedist
+	};
+
+public:
+	explicit ScenePopulation(unsigned int seed);
+	ScenePopulation(unsigned int seed, Distributions distributions);
+
+	// The next drawable of a random kind
+	[[nodiscard]] Spawn next();
+	// The next drawable, of the given kind
+	[[nodiscard]] Spawn next(Kind kind);
+private:
+	std::mt19937 rng_;
+	Distributions distributions_;
+};
@@ -0,0 +1,223 @@
+#include "ShaderCache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#include "Logging.hpp"
+
+namespace
+{
+	std::string toHex(const unsigned long long value)
+	{
+		std::ostringstream out;
+		out << std::hex << std::setw(16) << std::setfill('0') << value;
+		return out.str();
+	}
+
+	template<class T>
+	bool readFile(const std::filesystem::path& path, T& contents)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return !file.bad();
+	}
+}
+
+ShaderCache::ShaderCache(std::filesystem::path directory, const unsigned int flags, Compiler compiler)
+	:
+	directory_(std::move(directory)),
+	flags_(flags),
+	compiler_(std::move(compiler))
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory_, error);
+	if (error)
+	{
+		PLOGW << "Unable to create shader cache directory " << directory_.string() << ": " << error.message();
+	}
+}
+
+ShaderCache::Bytecode ShaderCache::load(const std::filesystem::path& source, const std::vector<Define>& defines,
+	const std::string& entryPoint, const std::string& target)
+{
+	std::string text;
+	if (!readFile(source, text))
+	{
+		throw Exception(__LINE__, __FILE__, "Reading shader source [" + source.string() + "]: file could not be opened.");
+	}
+
+	// The variant picks the file name prefix and the source hash the suffix, so a rebuild can drop stale entries
+	const std::string prefix = source.stem().string() + "_" + toHex(hashVariant(defines, entryPoint, target)) + "_";
+	std::vector<std::filesystem::path> visited;
+	const auto contents = hashIncludes(text, source, hash(text.data(), text.size()), visited);
+	const auto cached = directory_ / (prefix + toHex(contents) + ".cso");
+
+	Bytecode bytecode;
+	if (readFile(cached, bytecode) && !bytecode.empty())
+	{
+		hits_++;
+		PLOGD << "Shader cache hit: " << cached.string();
+		return bytecode;
+	}
+
+	misses_++;
+	PLOGI << "Shader cache miss, compiling " << source.string() << " (" << entryPoint << ", " << target << ")";
+	bytecode = compiler_(text, source, defines, entryPoint, target, flags_);
+
+	// Write next to the final name and rename so a crash never leaves a truncated entry behind
+	const auto temporary = std::filesystem::path(cached).concat(".tmp");
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+		if (!file)
+		{
+			PLOGW << "Unable to write shader cache entry " << cached.string();
+			return bytecode;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporary, cached, error);
+	if (error)
+	{
+		PLOGW << "Unable to write shader cache entry " << cached.string() << ": " << error.message();
+		std::filesystem::remove(temporary, error);
+		return bytecode;
+	}
+
+	prune(prefix, cached);
+	return bytecode;
+}
+
+unsigned int ShaderCache::getHits() const noexcept
+{
+	return hits_;
+}
+
+unsigned int ShaderCache::getMisses() const noexcept
+{
+	return misses_;
+}
+
+unsigned long long ShaderCache::hash(const void* data, const size_t size, unsigned long long seed) noexcept
+{
+	const auto* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		seed ^= bytes[i];
+		seed *= 0x100000001B3ull;
+	}
+	return seed;
+}
+
+unsigned long long ShaderCache::hashVariant(const std::vector<Define>& defines, const std::string& entryPoint, const std::string& target) const noexcept
+{
+	// Separators keep {"AB",""} and {"A","B"} from hashing the same
+	constexpr char separator = '\0';
+	unsigned long long result = hash(&flags_, sizeof(flags_));
+	result = hash(entryPoint.data(), entryPoint.size(), result);
+	result = hash(&separator, 1u, result);
+	result = hash(target.data(), target.size(), result);
+	for (const auto& [name, value] : defines)
+	{
+		result = hash(&separator, 1u, result);
+		result = hash(name.data(), name.size(), result);
+		result = hash("=", 1u, result);
+		result = hash(value.data(), value.size(), result);
+	}
+	return result;
+}
+
+unsigned long long ShaderCache::hashIncludes(const std::string& text, const std::filesystem::path& path, unsigned long long seed,
+	std::vector<std::filesystem::path>& visited)
+{
+	std::istringstream lines(text);
+	std::string line;
+	while (std::getline(lines, line))
+	{
+		// Only "#include" directives matter; anything the preprocessor would skip just costs an extra hash
+		size_t i = line.find_first_not_of(" \t");
+		if (i == std::string::npos || line[i] != '#')
+		{
+			continue;
+		}
+		i = line.find_first_not_of(" \t", i + 1u);
+		if (i == std::string::npos || line.compare(i, 7u, "include") != 0)
+		{
+			continue;
+		}
+		const size_t open = line.find_first_of("\"<", i + 7u);
+		if (open == std::string::npos)
+		{
+			continue;
+		}
+		const size_t close = line.find(line[open] == '"' ? '"' : '>', open + 1u);
+		if (close == std::string::npos)
+		{
+			continue;
+		}
+
+		const auto name = line.substr(open + 1u, close - open - 1u);
+		const auto included = (path.parent_path() / name).lexically_normal();
+		seed = hash(name.data(), name.size(), seed);
+		if (std::find(visited.begin(), visited.end(), included) != visited.end())
+		{
+			continue;
+		}
+		visited.push_back(included);
+
+		std::string contents;
+		if (readFile(included, contents))
+		{
+			seed = hash(contents.data(), contents.size(), seed);
+			seed = hashIncludes(contents, included, seed, visited);
+		}
+	}
+	return seed;
+}
+
+void ShaderCache::prune(const std::string& prefix, const std::filesystem::path& keep) const
+{
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(directory_, error))
+	{
+		const auto name = entry.path().filename().string();
+		if (entry.path() != keep && name.starts_with(prefix) && entry.path().extension() == ".cso")
+		{
+			PLOGD << "Removing stale shader cache entry " << name;
+			std::filesystem::remove(entry.path(), error);
+		}
+	}
+}
+
+// shader cache exception stuff
+ShaderCache::Exception::Exception(const int line, const char* file, std::string note) noexcept
+	:
+	AtumException(line, file),
+	note_(std::move(note))
+{}
+
+const char* ShaderCache::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AtumException::what() << "\n"
+		<< "[Note] " << getNote();
+	whatBuffer_ = oss.str();
+	return whatBuffer_.c_str();
+}
+
+const char* ShaderCache::Exception::getType() const noexcept
+{
+	return "Atum Shader Cache Exception";
+}
+
+const std::string& ShaderCache::Exception::getNote() const noexcept
+{
+	return note_;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "AtumException.hpp"
+
+// On-disk cache of compiled shader bytecode. Entries are named after a hash of the HLSL source and the files it
+// includes, together with the compile flags, defines, entry point and target, so an edited source (or a new
+// variant or build configuration) misses and is recompiled once while unchanged sources are read straight from
+// disk. The compiler is injected, which keeps the cache logic free of any D3D dependency.
+class ShaderCache
+{
+public:
+	using Bytecode = std::vector<unsigned char>;
+
+	struct Define
+	{
+		std::string name;
+		std::string value;
+	};
+
+	using Compiler = std::function<Bytecode(const std::string& source, const std::filesystem::path& path,
+		const std::vector<Define>& defines, const std::string& entryPoint, const std::string& target, unsigned int flags)>;
+
+	class Exception : public AtumException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* getType() const noexcept override;
+		const std::string& getNote() const noexcept;
+	private:
+		std::string note_;
+	};
+
+public:
+	// flags are handed to the compiler unchanged and keep entries built with different flags apart
+	ShaderCache(std::filesystem::path directory, unsigned int flags, Compiler compiler);
+
+	~ShaderCache() = default;
+	ShaderCache(const ShaderCache&) = delete;
+	ShaderCache& operator=(const ShaderCache&) = delete;
+	ShaderCache(const ShaderCache&&) = delete;
+	ShaderCache& operator=(const ShaderCache&&) = delete;
+
+	// Returns the bytecode for the source file, compiling and storing it only if no entry matches
+	Bytecode load(const std::filesystem::path& source, const std::vector<Define>& defines,
+		const std::string& entryPoint, const std::string& target);
+
+	[[nodiscard]] unsigned int getHits() const noexcept;
+	[[nodiscard]] unsigned int getMisses() const noexcept;
+
+	// 64-bit FNV-1a, chained through seed
+	static unsigned long long hash(const void* data, size_t size, unsigned long long seed = 0xCBF29CE484222325ull) noexcept;
+private:
+	unsigned long long hashVariant(const std::vector<Define>& defines, const std::string& entryPoint, const std::string& target) const noexcept;
+	// Chains the contents of every file reached through #include, resolved against the including file's folder
+	// like D3D_COMPILE_STANDARD_FILE_INCLUDE does. Files that can't be read are left for the compiler to report.
+	static unsigned long long hashIncludes(const std::string& text, const std::filesystem::path& path, unsigned long long seed,
+		std::vector<std::filesystem::path>& visited);
+	void prune(const std::string& prefix, const std::filesystem::path& keep) const;
+
+	std::filesystem::path directory_;
+	unsigned int flags_;
+	Compiler compiler_;
+	unsigned int hits_ = 0u;
+	unsigned int misses_ = 0u;
+};
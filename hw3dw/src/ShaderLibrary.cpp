@@ -0,0 +1,146 @@
+#include "ShaderLibrary.hpp"
+
+#include <cstring>
+#include <d3dcompiler.h>
+
+#include "GraphicsThrowMacros.hpp"
+#include "Logging.hpp"
+
+namespace wrl = Microsoft::WRL;
+
+std::unordered_map<std::wstring, wrl::ComPtr<ID3DBlob>> ShaderLibrary::bytecode_;
+std::unordered_map<std::wstring, ShaderLibrary::VertexShaderEntry> ShaderLibrary::vertexShaders_;
+std::unordered_map<std::wstring, wrl::ComPtr<ID3D11PixelShader>> ShaderLibrary::pixelShaders_;
+
+const ShaderLibrary::VertexShaderEntry& ShaderLibrary::getVertexShader(Graphics& graphics, const std::wstring& path,
+	const std::vector<ShaderCache::Define>& defines)
+{
+	const auto key = makeKey(path, defines);
+	if (const auto it = vertexShaders_.find(key); it != vertexShaders_.end())
+	{
+		return it->second;
+	}
+
+	INFOMAN(graphics);
+
+	VertexShaderEntry entry;
+	entry.bytecode = loadBytecode(graphics, path, defines, "vs_4_0");
+	PLOGD << "CreateVertexShader(\"" << path.c_str() << "\")";
+	GFX_THROW_INFO(graphics.getDevice()->CreateVertexShader(entry.bytecode->GetBufferPointer(), entry.bytecode->GetBufferSize(), nullptr, &entry.shader));
+	return vertexShaders_.emplace(key, std::move(entry)).first->second;
+}
+
+wrl::ComPtr<ID3D11PixelShader> ShaderLibrary::getPixelShader(Graphics& graphics, const std::wstring& path,
+	const std::vector<ShaderCache::Define>& defines)
+{
+	const auto key = makeKey(path, defines);
+	if (const auto it = pixelShaders_.find(key); it != pixelShaders_.end())
+	{
+		return it->second;
+	}
+
+	INFOMAN(graphics);
+
+	const auto bytecode = loadBytecode(graphics, path, defines, "ps_4_0");
+	wrl::ComPtr<ID3D11PixelShader> shader;
+	PLOGD << "CreatePixelShader(\"" << path.c_str() << "\")";
+	GFX_THROW_INFO(graphics.getDevice()->CreatePixelShader(bytecode->GetBufferPointer(), bytecode->GetBufferSize(), nullptr, &shader));
+	pixelShaders_.emplace(key, shader);
+	return shader;
+}
+
+std::wstring ShaderLibrary::makeKey(const std::wstring& path, const std::vector<ShaderCache::Define>& defines)
+{
+	std::wstring key = path;
+	for (const auto& [name, value] : defines)
+	{
+		key.push_back(L'|');
+		key.append(name.begin(), name.end());
+		key.push_back(L'=');
+		key.append(value.begin(), value.end());
+	}
+	return key;
+}
+
+void ShaderLibrary::release() noexcept
+{
+	vertexShaders_.clear();
+	pixelShaders_.clear();
+	bytecode_.clear();
+}
+
+wrl::ComPtr<ID3DBlob> ShaderLibrary::loadBytecode(Graphics& graphics, const std::wstring& path,
+	const std::vector<ShaderCache::Define>& defines, const char* target)
+{
+	const auto key = makeKey(path, defines);
+	if (const auto it = bytecode_.find(key); it != bytecode_.end())
+	{
+		return it->second;
+	}
+
+	INFOMAN(graphics);
+
+	wrl::ComPtr<ID3DBlob> blob;
+	if (std::filesystem::path(path).extension() == L".hlsl")
+	{
+		const auto bytecode = getCache().load(path, defines, "main", target);
+		GFX_THROW_INFO(D3DCreateBlob(bytecode.size(), &blob));
+		std::memcpy(blob->GetBufferPointer(), bytecode.data(), bytecode.size());
+	}
+	else
+	{
+		// Precompiled bytecode cannot take defines; they only distinguish the cache key
+		PLOGD << "D3DReadFileToBlob(\"" << path.c_str() << "\")";
+		GFX_THROW_INFO(D3DReadFileToBlob(path.c_str(), &blob));
+	}
+	bytecode_.emplace(key, blob);
+	return blob;
+}
+
+DxgiInfoManager& ShaderLibrary::getInfoManager(Graphics& graphics) noexcept(IS_DEBUG)
+{
+#if (IS_DEBUG)
+	return graphics.infoManager_;
+#else
+	throw std::logic_error("Access denied: DxgiInfoManager is not accessible in release builds.");
+#endif
+}
+
+ShaderCache& ShaderLibrary::getCache()
+{
+	UINT compileFlags = D3DCOMPILE_ENABLE_STRICTNESS;
+#if (IS_DEBUG)
+	compileFlags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+	static ShaderCache cache("shadercache", compileFlags, [](const std::string& source, const std::filesystem::path& path,
+		const std::vector<ShaderCache::Define>& defines, const std::string& entryPoint, const std::string& target, const unsigned int flags)
+		{
+			std::vector<D3D_SHADER_MACRO> macros;
+			macros.reserve(defines.size() + 1u);
+			for (const auto& [name, value] : defines)
+			{
+				macros.push_back({ name.c_str(), value.c_str() });
+			}
+			macros.push_back({ nullptr, nullptr });
+
+			wrl::ComPtr<ID3DBlob> code;
+			wrl::ComPtr<ID3DBlob> errors;
+			const std::string name = path.string();
+			if (FAILED(D3DCompile(source.data(), source.size(), name.c_str(), macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE,
+				entryPoint.c_str(), target.c_str(), flags, 0u, &code, &errors)))
+			{
+				std::string message = "Compiling [" + name + "] failed.";
+				if (errors)
+				{
+					message += "\n";
+					message.append(static_cast<const char*>(errors->GetBufferPointer()), errors->GetBufferSize());
+				}
+				throw ShaderCache::Exception(__LINE__, __FILE__, message);
+			}
+
+			const auto* begin = static_cast<const unsigned char*>(code->GetBufferPointer());
+			return ShaderCache::Bytecode(begin, begin + code->GetBufferSize());
+		});
+	return cache;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics.hpp"
+#include "ShaderCache.hpp"
+
+// Process-wide store of shader bytecode and shader objects keyed by path and defines. Each .cso is read once
+// and each shader object is created once, however many drawable types or bindables ask for it. Paths ending in
+// .hlsl are compiled at runtime through a ShaderCache, so edited sources are rebuilt only when they change.
+class ShaderLibrary
+{
+public:
+	struct VertexShaderEntry
+	{
+		Microsoft::WRL::ComPtr<ID3DBlob> bytecode;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> shader;
+	};
+
+	ShaderLibrary() = delete;
+
+	static const VertexShaderEntry& getVertexShader(Graphics& graphics, const std::wstring& path,
+		const std::vector<ShaderCache::Define>& defines = {});
+	static Microsoft::WRL::ComPtr<ID3D11PixelShader> getPixelShader(Graphics& graphics, const std::wstring& path,
+		const std::vector<ShaderCache::Define>& defines = {});
+	// Drops every shader and bytecode blob; call before the device they were created on is destroyed
+	static void release() noexcept;
+private:
+	static std::wstring makeKey(const std::wstring& path, const std::vector<ShaderCache::Define>& defines);
+	static Microsoft::WRL::ComPtr<ID3DBlob> loadBytecode(Graphics& graphics, const std::wstring& path,
+		const std::vector<ShaderCache::Define>& defines, const char* target);
+	static DxgiInfoManager& getInfoManager(Graphics& graphics) noexcept(IS_DEBUG);
+	static ShaderCache& getCache();
+
+	static std::unordered_map<std::wstring, Microsoft::WRL::ComPtr<ID3DBlob>> bytecode_;
+	static std::unordered_map<std::wstring, VertexShaderEntry> vertexShaders_;
+	static std::unordered_map<std::wstring, Microsoft::WRL::ComPtr<ID3D11PixelShader>> pixelShaders_;
+};
@@ -2,28 +2,14 @@
 #include "BindableIncludes.hpp"
 #include "Plane.hpp"
 #include "Surface.hpp"
-#include "Texture.hpp"
+#include "AtlasTexture.hpp"
+#include "Blender.hpp"
 #include "Sampler.hpp"
 
 
-Sheet::Sheet(Graphics& graphics,
-             std::mt19937& rng,
-             std::uniform_real_distribution<float>& distanceDistribution,								// rdist
-             std::uniform_real_distribution<float>& sphericalCoordinatePositionDistribution,				// adist
-             std::uniform_real_distribution<float>& rotationOfDrawableDistribution,						// ddist
-             std::uniform_real_distribution<float>& sphericalCoordinateMovementOfDrawableDistribution	// odist
-)
+Sheet::Sheet(Graphics& graphics, const ScenePopulation::Spawn& spawn)
 	:
-	radiusDistanceFromCenter_(distanceDistribution(rng)),
-	theta_(sphericalCoordinatePositionDistribution(rng)),
-	phi_(sphericalCoordinatePositionDistribution(rng)),
-	rho_(sphericalCoordinatePositionDistribution(rng)),
-	droll_(rotationOfDrawableDistribution(rng)),
-	dpitch_(rotationOfDrawableDistribution(rng)),
-	dyaw_(rotationOfDrawableDistribution(rng)),
-	dtheta_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	dphi_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	drho_(sphericalCoordinateMovementOfDrawableDistribution(rng))
+	orbit_(spawn.orbit)
 {
 	namespace dx = DirectX;
 
@@ -38,7 +24,7 @@ Sheet::Sheet(Graphics& graphics,
 		struct Vertex
 		{
 			dx::XMFLOAT3 pos;
-			TexturePosition texturePosition;
+			TexturePosition tex;
 		};
 
 		std::vector<TexturePosition> textures = {
@@ -48,28 +34,34 @@ Sheet::Sheet(Graphics& graphics,
 			{ 1.0f,1.0f }
 		};
 
-		// Lambda to set textures
-		auto setTexture = [textures](std::vector<Vertex>& vertices) {
-			for (size_t i = 0; i < vertices.size() && i < textures.size(); ++i) {
-				vertices[i].texturePosition = textures[i];
-			}
-		};
+		// Generate the plane straight into upload memory and texture it there
+		const MeshLayout layout = Plane::getTessellatedLayout(1, 1);
+		Bindable::Upload vertexUpload(graphics, layout.vertexCount * sizeof(Vertex));
+		Bindable::Upload indexUpload(graphics, layout.indexCount * sizeof(unsigned short));
+		const auto vertices = vertexUpload.as<Vertex>();
+		Plane::writeTessellated(1, 1, vertices, indexUpload.as<unsigned short>());
+		assert(vertices.size() == textures.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			vertices[i].tex = textures[i];
+		}
+		AtlasTexture::getAtlas().remap(vertices, L"kappa50.png");
 
-		const auto model = Plane::make<Vertex>(setTexture);
+		addStaticBind<AtlasTexture>(graphics);
 
-		addStaticBind(std::make_unique<Texture>(graphics, Surface::fromFile(L"kappa50.png")));
+		setStaticSoftwareMesh(SoftwareRasterizer::Mesh::from<Vertex>(vertices, indexUpload.as<const unsigned short>()));
 
-		addStaticBind(std::make_unique<VertexBuffer>(graphics, model.vertices()));
+		addStaticBind<VertexBuffer>(graphics, vertexUpload, static_cast<UINT>(sizeof(Vertex)));
 
-		addStaticBind(std::make_unique<Sampler>(graphics));
+		addStaticBind<Sampler>(graphics);
 
-		auto vertexShader = std::make_unique<VertexShader>(graphics, L"TextureVS.cso");
-		auto vertexShaderBytecode = vertexShader->getByteCode();
-		addStaticBind(std::move(vertexShader));
+		auto vertexShaderBytecode = addStaticBind<VertexShader>(graphics, L"TextureVS.cso").getByteCode();
 
-		addStaticBind(std::make_unique<PixelShader>(graphics, L"TexturePS.cso"));
+		addStaticBind<PixelShader>(graphics, L"TexturePS.cso");
 
-		addStaticIndexBuffer(std::make_unique<IndexBuffer>(graphics, model.indices()));
+		setStaticSoftwareMaterial({ .shading = SoftwareRasterizer::Shading::Texture, .texture = &AtlasTexture::getSampledAtlas() });
+
+		addStaticIndexBuffer(graphics, indexUpload);
 
 		constexpr D3D11_INPUT_ELEMENT_DESC positionDesc = {
 			.SemanticName = "Position",
@@ -97,33 +89,31 @@ Sheet::Sheet(Graphics& graphics,
 			texcoordDesc
 		};
 
-		addStaticBind(std::make_unique<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode));
+		addStaticBind<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode);
+
+		addStaticBind<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-		addStaticBind(std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		addStaticBind<Blender>(graphics, 0.75f);
 	}
 	else
 	{
 		setIndexBufferFromStaticBinds();
 	}
 
-	Drawable::addBind(std::make_unique<TransformConstantBuffer>(graphics, *this));
+	addBind<TransformConstantBuffer>(graphics, *this);
 }
 
 void Sheet::update(const float dt) noexcept
 {
-	roll_ += wrapAngle(droll_ * dt);
-	pitch_ += wrapAngle(dpitch_ * dt);
-	yaw_ += wrapAngle(dyaw_ * dt);
-	theta_ += wrapAngle(dtheta_ * dt);
-	phi_ += wrapAngle(dphi_ * dt);
-	rho_ += wrapAngle(drho_ * dt);
+	orbit_.update(dt);
 }
 
 DirectX::XMMATRIX Sheet::getTransformXm() const noexcept
 {
-	namespace dx = DirectX;
-	return dx::XMMatrixRotationRollPitchYaw(pitch_, yaw_, roll_) *
-		dx::XMMatrixTranslation(radiusDistanceFromCenter_, 0.0f, 0.0f) *
-		dx::XMMatrixRotationRollPitchYaw(theta_, phi_, rho_) *
-		dx::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+	return orbit_.getTransformXm();
+}
+
+RenderQueue::Pass Sheet::getPass() const noexcept
+{
+	return RenderQueue::Pass::Blended;
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "SimulationThread.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include "CpuMetric.hpp"
+
+SimulationThread::SimulationThread(Simulate simulate)
+	:
+	simulate_(std::move(simulate)),
+	thread_(&SimulationThread::threadLoop, this)
+{}
+
+SimulationThread::~SimulationThread()
+{
+	stop_.store(true, std::memory_order_relaxed);
+	requested_.fetch_add(1ull, std::memory_order_release);
+	requested_.notify_one();
+	thread_.join();
+}
+
+void SimulationThread::request(const float dt) noexcept
+{
+	// Published to the thread by the release below, and not written again until wait() saw the frame complete
+	pendingDt_ = dt;
+	requested_.fetch_add(1ull, std::memory_order_release);
+	requested_.notify_one();
+}
+
+const SceneSnapshot& SimulationThread::wait()
+{
+	const unsigned long long target = requested_.load(std::memory_order_relaxed);
+	for (unsigned long long done = completed_.load(std::memory_order_acquire); done < target; done = completed_.load(std::memory_order_acquire))
+	{
+		completed_.wait(done, std::memory_order_acquire);
+	}
+
+	if (error_)
+	{
+		std::rethrow_exception(std::exchange(error_, nullptr));
+	}
+	snapshots_.acquire();
+	return snapshots_.front();
+}
+
+const SceneSnapshot& SimulationThread::latest() noexcept
+{
+	snapshots_.acquire();
+	return snapshots_.front();
+}
+
+bool SimulationThread::isBusy() const noexcept
+{
+	return completed_.load(std::memory_order_acquire) < requested_.load(std::memory_order_relaxed);
+}
+
+void SimulationThread::threadLoop() noexcept
+{
+	CpuMetric::nameCurrentThread("Simulation");
+	unsigned long long seen = 0ull;
+	while (true)
+	{
+		requested_.wait(seen, std::memory_order_acquire);
+		if (stop_.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+		seen = requested_.load(std::memory_order_acquire);
+
+		SceneSnapshot& snapshot = snapshots_.back();
+		try
+		{
+			const auto start = std::chrono::steady_clock::now();
+			simulate_(pendingDt_, snapshot);
+			snapshot.updateMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			snapshot.frame = seen;
+			snapshots_.publish();
+		}
+		catch (...)
+		{
+			error_ = std::current_exception();
+		}
+
+		completed_.store(seen, std::memory_order_release);
+		completed_.notify_one();
+	}
+}
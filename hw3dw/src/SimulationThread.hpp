@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "TripleBuffer.hpp"
+
+// Everything the render thread needs from one simulated frame
+struct SceneSnapshot
+{
+	unsigned long long frame = 0ull;
+	std::vector<DirectX::XMFLOAT4X4> transforms;
+	float updateMilliseconds = 0.0f;
+};
+
+// Second stage of the pipelined main loop. request() hands the thread a frame duration and returns at once; the
+// thread runs the simulate callback into a fresh snapshot and publishes it through a triple buffer, so frame N + 1
+// is simulated while the render thread is still drawing frame N. The render thread pays one frame of latency and
+// in exchange a frame takes max(simulate, render) instead of their sum.
+//
+// Requests and completions are counted with atomics and waited on with atomic wait, nothing on the path between
+// the two threads takes a lock. Only one request is in flight at a time: call wait() before the next request().
+class SimulationThread
+{
+public:
+	using Simulate = std::function<void(float dt, SceneSnapshot& snapshot)>;
+
+public:
+	explicit SimulationThread(Simulate simulate);
+	~SimulationThread();
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+	SimulationThread(const SimulationThread&&) = delete;
+	SimulationThread& operator=(const SimulationThread&&) = delete;
+
+	// Start simulating the next frame
+	void request(float dt) noexcept;
+	// Block until the requested frame is published and return it. An exception thrown by the simulate callback is
+	// rethrown here.
+	const SceneSnapshot& wait();
+	// Newest published snapshot without blocking; frame 0 until the first one arrives
+	const SceneSnapshot& latest() noexcept;
+	[[nodiscard]] bool isBusy() const noexcept;
+private:
+	void threadLoop() noexcept;
+
+	Simulate simulate_;
+	TripleBuffer<SceneSnapshot> snapshots_;
+	float pendingDt_ = 0.0f;
+	std::exception_ptr error_;
+	alignas(64) std::atomic<unsigned long long> requested_{ 0ull };
+	alignas(64) std::atomic<unsigned long long> completed_{ 0ull };
+	std::atomic<bool> stop_{ false };
+	std::thread thread_;
+};
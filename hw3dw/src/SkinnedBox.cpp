@@ -1,27 +1,12 @@
 #include "SkinnedBox.hpp"
 
-#include "AtumMath.hpp"
+#include "AtlasTexture.hpp"
 #include "BindableIncludes.hpp"
 #include "Cube.hpp"
 
-SkinnedBox::SkinnedBox(Graphics& graphics,
-                       std::mt19937& rng,
-                       std::uniform_real_distribution<float>& distanceDistribution,									// rdist
-                       std::uniform_real_distribution<float>& sphericalCoordinatePositionDistribution,				// adist
-                       std::uniform_real_distribution<float>& rotationOfDrawableDistribution,						// ddist
-                       std::uniform_real_distribution<float>& sphericalCoordinateMovementOfDrawableDistribution	// odist
-)
+SkinnedBox::SkinnedBox(Graphics& graphics, const ScenePopulation::Spawn& spawn)
 	: DrawableStaticStorage(),
-	radiusDistanceFromCenter_(distanceDistribution(rng)),
-	theta_(sphericalCoordinatePositionDistribution(rng)),
-	phi_(sphericalCoordinatePositionDistribution(rng)),
-	rho_(sphericalCoordinatePositionDistribution(rng)),
-	droll_(rotationOfDrawableDistribution(rng)),
-	dpitch_(rotationOfDrawableDistribution(rng)),
-	dyaw_(rotationOfDrawableDistribution(rng)),
-	dtheta_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	dphi_(sphericalCoordinateMovementOfDrawableDistribution(rng)),
-	drho_(sphericalCoordinateMovementOfDrawableDistribution(rng))
+	orbit_(spawn.orbit)
 {
 	namespace dx = DirectX;
 
@@ -36,21 +21,27 @@ SkinnedBox::SkinnedBox(Graphics& graphics,
 				float v;
 			} tex;
 		};
-		const auto model = Cube::makeSkinned<Vertex>();
+		// Generated straight into upload memory and mapped onto the atlas there
+		Bindable::Upload vertexUpload(graphics, Cube::getSkinnedLayout().vertexCount * sizeof(Vertex));
+		Bindable::Upload indexUpload(graphics, Cube::getSkinnedLayout().indexCount * sizeof(unsigned short));
+		const auto vertices = vertexUpload.as<Vertex>();
+		Cube::writeSkinned(vertices, indexUpload.as<unsigned short>());
+		AtlasTexture::getAtlas().remap(vertices, L"cube.png");
+		setStaticSoftwareMesh(SoftwareRasterizer::Mesh::from<Vertex>(vertices, indexUpload.as<const unsigned short>()));
 
-		addStaticBind(std::make_unique<VertexBuffer>(graphics, model.vertices()));
+		addStaticBind<VertexBuffer>(graphics, vertexUpload, static_cast<UINT>(sizeof(Vertex)));
 
-		addStaticBind(std::make_unique<Sampler>(graphics));
+		addStaticBind<Sampler>(graphics);
 
-		addStaticBind(std::make_unique<Texture>(graphics, Surface::fromFile(L"cube.png")));
+		addStaticBind<AtlasTexture>(graphics);
 
-		auto vertexShader = std::make_unique<VertexShader>(graphics, L"TextureVS.cso");
-		auto vertexShaderBytecode = vertexShader->getByteCode();
-		addStaticBind(std::move(vertexShader));
+		auto vertexShaderBytecode = addStaticBind<VertexShader>(graphics, L"TextureVS.cso").getByteCode();
 
-		addStaticBind(std::make_unique<PixelShader>(graphics, L"TexturePS.cso"));
+		addStaticBind<PixelShader>(graphics, L"TexturePS.cso");
 
-		addStaticIndexBuffer(std::make_unique<IndexBuffer>(graphics, model.indices()));
+		setStaticSoftwareMaterial({ .shading = SoftwareRasterizer::Shading::Texture, .texture = &AtlasTexture::getSampledAtlas() });
+
+		addStaticIndexBuffer(graphics, indexUpload);
 
 		constexpr D3D11_INPUT_ELEMENT_DESC positionDesc = {
 			.SemanticName = "Position",
@@ -75,33 +66,23 @@ SkinnedBox::SkinnedBox(Graphics& graphics,
 			positionDesc,
 			texcoordDesc
 		};
-		addStaticBind(std::make_unique<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode));
+		addStaticBind<InputLayout>(graphics, inputElementDescs, vertexShaderBytecode);
 
-		addStaticBind(std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		addStaticBind<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	}
 	else
 	{
 		setIndexBufferFromStaticBinds();
 	}
-	Drawable::addBind(std::make_unique<TransformConstantBuffer>(graphics, *this));
+	addBind<TransformConstantBuffer>(graphics, *this);
 }
 
 void SkinnedBox::update(const float dt) noexcept
 {
-	roll_ += wrapAngle(droll_ * dt);
-	pitch_ += wrapAngle(dpitch_ * dt);
-	yaw_ += wrapAngle(dyaw_ * dt);
-	theta_ += wrapAngle(dtheta_ * dt);
-	phi_ += wrapAngle(dphi_ * dt);
-	rho_ += wrapAngle(drho_ * dt);
+	orbit_.update(dt);
 }
 
 DirectX::XMMATRIX SkinnedBox::getTransformXm() const noexcept
 {
-	return DirectX::XMMatrixRotationRollPitchYaw(pitch_, yaw_, roll_) *
-		DirectX::XMMatrixTranslation(radiusDistanceFromCenter_, 0.0f, 0.0f) *
-		DirectX::XMMatrixRotationRollPitchYaw(theta_, phi_, rho_) *
-		DirectX::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
-	//  DirectX::XMMatrixTranslation(0.0f, 0.0f, 2.0f); // Move to the front of the frame when rendering a single object
-
+	return orbit_.getTransformXm();
 }
\ No newline at end of file
@@ -1,19 +1,12 @@
 #pragma once
 
-#include <random>
-
 #include "DrawableStaticStorage.hpp"
+#include "ScenePopulation.hpp"
 
 class SkinnedBox : public DrawableStaticStorage<SkinnedBox>
 {
 public:
-	SkinnedBox(Graphics& graphics,
-		std::mt19937& rng,
-		std::uniform_real_distribution<float>& distanceDistribution,									// rdist
-		std::uniform_real_distribution<float>& sphericalCoordinatePositionDistribution,				// adist
-		std::uniform_real_distribution<float>& rotationOfDrawableDistribution,						// ddist
-		std::uniform_real_distribution<float>& sphericalCoordinateMovementOfDrawableDistribution	// odist
-	);
+	SkinnedBox(Graphics& graphics, const ScenePopulation::Spawn& spawn);
 
 	SkinnedBox(const SkinnedBox&) = delete;
 	SkinnedBox& operator=(const SkinnedBox&) = delete;
@@ -23,20 +16,5 @@ public:
 	void update(float dt) noexcept override;
 	DirectX::XMMATRIX getTransformXm() const noexcept override;
 private:
-	// Positional
-	float radiusDistanceFromCenter_;
-	float roll_ = 0.0f;
-	float pitch_ = 0.0f;
-	float yaw_ = 0.0f;
-	float theta_;
-	float phi_;
-	float rho_;
-
-	// Speed (delta/s)
-	float droll_;
-	float dpitch_;
-	float dyaw_;
-	float dtheta_;
-	float dphi_;
-	float drho_;
+	Orbit orbit_;
 };
\ No newline at end of file
@@ -0,0 +1,658 @@
+#include "SoftwareRasterizer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <emmintrin.h>
+#include <functional>
+#include <sstream>
+
+namespace
+{
+	// Vertex positions snap to 1/256 of a pixel, the same sub-pixel precision D3D rasterizes with
+	constexpr float subpixelSteps = 256.0f;
+	// Triangles reaching further than this many pixels from the centre of the target are clipped to it
+	constexpr float guardBandPixels = 8192.0f;
+	constexpr size_t maxClipVertices = 9u;
+
+	unsigned char toUnorm8(const float value) noexcept
+	{
+		return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	Surface::color packColor(const float r, const float g, const float b, const float a) noexcept
+	{
+		return { toUnorm8(a), toUnorm8(r), toUnorm8(g), toUnorm8(b) };
+	}
+
+	// Lowest and highest value of the plane a * x + b * y + c over the rectangle [x0, x1] x [y0, y1]
+	void planeRange(const float a, const float b, const float c, const float x0, const float x1, const float y0, const float y1,
+		float& minimum, float& maximum) noexcept
+	{
+		const float ax0 = a * x0;
+		const float ax1 = a * x1;
+		const float by0 = b * y0;
+		const float by1 = b * y1;
+		minimum = c + std::min(ax0, ax1) + std::min(by0, by1);
+		maximum = c + std::max(ax0, ax1) + std::max(by0, by1);
+	}
+
+	std::uint64_t validBlockMask(const int columns, const int rows) noexcept
+	{
+		if (columns >= 8 && rows >= 8)
+		{
+			return ~0ull;
+		}
+		const std::uint64_t rowBits = (1ull << std::min(columns, 8)) - 1ull;
+		std::uint64_t mask = 0ull;
+		for (int y = 0; y < std::min(rows, 8); y++)
+		{
+			mask |= rowBits << (y * 8);
+		}
+		return mask;
+	}
+}
+
+SoftwareRasterizer::SoftwareRasterizer(const unsigned int width, const unsigned int height, const size_t threadCount, const bool allowAvx2)
+	:
+	width_(width),
+	height_(height),
+	blockColumns_(static_cast<int>((width + blockSize - 1u) / blockSize)),
+	blockRows_(static_cast<int>((height + blockSize - 1u) / blockSize)),
+	tileColumns_(static_cast<int>((width + tileSize - 1u) / tileSize)),
+	tileRows_(static_cast<int>((height + tileSize - 1u) / tileSize)),
+	guardBandX_(0.0f),
+	guardBandY_(0.0f),
+	coverBlock_(allowAvx2 ? RasterKernel::select() : &RasterKernel::coverBlockScalar)
+{
+	if (width == 0u || height == 0u)
+	{
+		throw Exception(__LINE__, __FILE__, "Creating software rasterizer: target size must not be zero.");
+	}
+
+	// Guard band in NDC units, never tighter than the viewport itself
+	guardBandX_ = std::max(1.0f, guardBandPixels / (0.5f * static_cast<float>(width)));
+	guardBandY_ = std::max(1.0f, guardBandPixels / (0.5f * static_cast<float>(height)));
+
+	depth_.resize(static_cast<size_t>(blockColumns_) * blockRows_ * blockSize * blockSize);
+	blockMaxDepth_.resize(static_cast<size_t>(blockColumns_) * blockRows_);
+	tiles_.resize(static_cast<size_t>(tileColumns_) * tileRows_);
+	if (threadCount > 0u)
+	{
+		pool_ = std::make_unique<WorkerPool>(threadCount);
+	}
+}
+
+void SoftwareRasterizer::draw(const Mesh& mesh, const Material& material, DirectX::FXMMATRIX worldViewProjection)
+{
+	assert("Mesh must have positions and whole triangles" && !mesh.positions.empty() && mesh.indices.size() % 3u == 0u);
+	assert("Texture shading needs a texture and texture coordinates" &&
+		(material.shading != Shading::Texture || (material.texture != nullptr && mesh.texcoords.size() == mesh.positions.size())));
+	assert("Vertex colour shading needs vertex colours" &&
+		(material.shading != Shading::VertexColors || mesh.colors.size() == mesh.positions.size()));
+
+	DrawCommand command{ &mesh, &material, {} };
+	DirectX::XMStoreFloat4x4(&command.worldViewProjection, worldViewProjection);
+	commands_.push_back(command);
+}
+
+void SoftwareRasterizer::render(Surface& target, const Surface::color clearColor)
+{
+	if (target.getWidth() != width_ || target.getHeight() != height_)
+	{
+		std::ostringstream out;
+		out << "Rendering to a " << target.getWidth() << "x" << target.getHeight() << " surface: rasterizer was created for "
+			<< width_ << "x" << height_ << ".";
+		throw Exception(__LINE__, __FILE__, out.str());
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	statistics_ = {};
+	statistics_.draws = commands_.size();
+
+	// Vertex processing, clipping and triangle setup, one job per draw
+	triangles_.resize(commands_.size());
+	const auto setupJob = [this](const size_t index) { setupDraw(commands_[index], triangles_[index]); };
+	// Handed over by reference, so the std::function never has to allocate for the captures
+	if (pool_)
+	{
+		pool_->run(commands_.size(), std::ref(setupJob));
+	}
+	else
+	{
+		for (size_t i = 0; i < commands_.size(); i++)
+		{
+			setupJob(i);
+		}
+	}
+	for (size_t i = 0; i < commands_.size(); i++)
+	{
+		statistics_.triangles += commands_[i].mesh->indices.size() / 3u;
+		statistics_.trianglesRasterized += triangles_[i].size();
+	}
+	binTriangles();
+	const auto setupEnd = std::chrono::steady_clock::now();
+
+	// Tiles own disjoint pixels, so they clear and rasterize independently
+	const auto rasterJob = [this, &target, clearColor](const size_t index)
+		{
+			const int tileX = static_cast<int>(index) % tileColumns_;
+			const int tileY = static_cast<int>(index) / tileColumns_;
+			const unsigned int left = static_cast<unsigned int>(tileX * tileSize);
+			const unsigned int top = static_cast<unsigned int>(tileY * tileSize);
+			const unsigned int right = std::min(left + tileSize, width_);
+			const unsigned int bottom = std::min(top + tileSize, height_);
+			for (unsigned int y = top; y < bottom; y++)
+			{
+				std::fill_n(target.getBufferPtr() + static_cast<size_t>(y) * width_ + left, right - left, clearColor);
+			}
+			rasterizeTile(index, target);
+		};
+	if (pool_)
+	{
+		pool_->run(tiles_.size(), std::ref(rasterJob));
+	}
+	else
+	{
+		for (size_t i = 0; i < tiles_.size(); i++)
+		{
+			rasterJob(i);
+		}
+	}
+
+	for (const auto& tile : tiles_)
+	{
+		statistics_.blocksRejected += tile.blocksRejected;
+		statistics_.blocksOccluded += tile.blocksOccluded;
+		statistics_.blocksAccepted += tile.blocksAccepted;
+		statistics_.blocksPartial += tile.blocksPartial;
+		statistics_.pixelsShaded += tile.pixelsShaded;
+	}
+	const auto end = std::chrono::steady_clock::now();
+	statistics_.setupMilliseconds = std::chrono::duration<float, std::milli>(setupEnd - start).count();
+	statistics_.rasterMilliseconds = std::chrono::duration<float, std::milli>(end - setupEnd).count();
+
+	commands_.clear();
+}
+
+unsigned int SoftwareRasterizer::getWidth() const noexcept
+{
+	return width_;
+}
+
+unsigned int SoftwareRasterizer::getHeight() const noexcept
+{
+	return height_;
+}
+
+bool SoftwareRasterizer::isUsingAvx2() const noexcept
+{
+	return coverBlock_ == &RasterKernel::coverBlockAvx2;
+}
+
+const SoftwareRasterizer::Statistics& SoftwareRasterizer::getStatistics() const noexcept
+{
+	return statistics_;
+}
+
+void SoftwareRasterizer::setupDraw(const DrawCommand& command, std::vector<RasterTriangle>& output) const
+{
+	namespace dx = DirectX;
+
+	const Mesh& mesh = *command.mesh;
+	const Material& material = *command.material;
+	const dx::XMMATRIX worldViewProjection = dx::XMLoadFloat4x4(&command.worldViewProjection);
+
+	// ColorBlendVS / ColorIndexVS / TextureVS: mul(float4(pos, 1.0f), wvp) and pass the attribute through
+	// Scratch of whichever thread runs the draw, it keeps its capacity from one draw to the next
+	thread_local std::vector<ClipVertex> vertices;
+	vertices.resize(mesh.positions.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		auto& vertex = vertices[i];
+		dx::XMFLOAT4 position;
+		dx::XMStoreFloat4(&position, dx::XMVector3Transform(dx::XMLoadFloat3(&mesh.positions[i]), worldViewProjection));
+		vertex.position[0] = position.x;
+		vertex.position[1] = position.y;
+		vertex.position[2] = position.z;
+		vertex.position[3] = position.w;
+		if (material.shading == Shading::VertexColors)
+		{
+			const auto& color = mesh.colors[i];
+			vertex.attributes[0] = color.x;
+			vertex.attributes[1] = color.y;
+			vertex.attributes[2] = color.z;
+			vertex.attributes[3] = color.w;
+		}
+		else if (material.shading == Shading::Texture)
+		{
+			vertex.attributes[0] = mesh.texcoords[i].x;
+			vertex.attributes[1] = mesh.texcoords[i].y;
+			vertex.attributes[2] = 0.0f;
+			vertex.attributes[3] = 0.0f;
+		}
+		else
+		{
+			std::fill_n(vertex.attributes, 4, 0.0f);
+		}
+	}
+
+	// Clip planes as (a, b, c, d) with a * x + b * y + c * z + d * w >= 0 inside: near, then the guard band
+	const float planes[5][4] = {
+		{ 0.0f, 0.0f, 1.0f, 0.0f },
+		{ 1.0f, 0.0f, 0.0f, guardBandX_ },
+		{ -1.0f, 0.0f, 0.0f, guardBandX_ },
+		{ 0.0f, 1.0f, 0.0f, guardBandY_ },
+		{ 0.0f, -1.0f, 0.0f, guardBandY_ },
+	};
+	const auto distance = [](const float* plane, const ClipVertex& vertex)
+		{
+			return plane[0] * vertex.position[0] + plane[1] * vertex.position[1] + plane[2] * vertex.position[2] + plane[3] * vertex.position[3];
+		};
+	const auto outcode = [](const ClipVertex& vertex)
+		{
+			const float x = vertex.position[0];
+			const float y = vertex.position[1];
+			const float z = vertex.position[2];
+			const float w = vertex.position[3];
+			return (x < -w ? 1u : 0u) | (x > w ? 2u : 0u) | (y < -w ? 4u : 0u) | (y > w ? 8u : 0u) | (z < 0.0f ? 16u : 0u) | (z > w ? 32u : 0u);
+		};
+
+	output.clear();
+	output.reserve(mesh.indices.size() / 3u);
+	for (size_t index = 0; index + 2u < mesh.indices.size(); index += 3u)
+	{
+		const auto primitiveId = static_cast<unsigned int>(index / 3u);
+		const ClipVertex& v0 = vertices[mesh.indices[index]];
+		const ClipVertex& v1 = vertices[mesh.indices[index + 1u]];
+		const ClipVertex& v2 = vertices[mesh.indices[index + 2u]];
+
+		if ((outcode(v0) & outcode(v1) & outcode(v2)) != 0u)
+		{
+			continue;
+		}
+
+		bool needsClipping = false;
+		for (const auto& plane : planes)
+		{
+			needsClipping = needsClipping || distance(plane, v0) < 0.0f || distance(plane, v1) < 0.0f || distance(plane, v2) < 0.0f;
+		}
+		if (!needsClipping)
+		{
+			setupTriangle(v0, v1, v2, material, primitiveId, output);
+			continue;
+		}
+
+		// Sutherland-Hodgman against each plane, then fan the polygon back into triangles
+		ClipVertex polygon[maxClipVertices] = { v0, v1, v2 };
+		ClipVertex clipped[maxClipVertices];
+		size_t count = 3u;
+		for (const auto& plane : planes)
+		{
+			size_t clippedCount = 0u;
+			for (size_t i = 0; i < count; i++)
+			{
+				const ClipVertex& current = polygon[i];
+				const ClipVertex& next = polygon[(i + 1u) % count];
+				const float currentDistance = distance(plane, current);
+				const float nextDistance = distance(plane, next);
+				if (currentDistance >= 0.0f)
+				{
+					clipped[clippedCount++] = current;
+				}
+				if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f) && clippedCount < maxClipVertices)
+				{
+					const float t = currentDistance / (currentDistance - nextDistance);
+					ClipVertex& intersection = clipped[clippedCount++];
+					for (int c = 0; c < 4; c++)
+					{
+						intersection.position[c] = current.position[c] + (next.position[c] - current.position[c]) * t;
+						intersection.attributes[c] = current.attributes[c] + (next.attributes[c] - current.attributes[c]) * t;
+					}
+				}
+			}
+			std::copy_n(clipped, clippedCount, polygon);
+			count = clippedCount;
+			if (count < 3u)
+			{
+				break;
+			}
+		}
+		for (size_t i = 1; i + 1u < count; i++)
+		{
+			setupTriangle(polygon[0], polygon[i], polygon[i + 1u], material, primitiveId, output);
+		}
+	}
+}
+
+void SoftwareRasterizer::setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, const Material& material,
+	const unsigned int primitiveId, std::vector<RasterTriangle>& output) const
+{
+	const ClipVertex* vertices[3] = { &v0, &v1, &v2 };
+	double x[3];
+	double y[3];
+	float z[3];
+	float inverseW[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const auto& position = vertices[i]->position;
+		inverseW[i] = 1.0f / position[3];
+		// Viewport transform with pixel centres on integer coordinates
+		const float screenX = (position[0] * inverseW[i] * 0.5f + 0.5f) * static_cast<float>(width_) - 0.5f;
+		const float screenY = (0.5f - position[1] * inverseW[i] * 0.5f) * static_cast<float>(height_) - 0.5f;
+		x[i] = std::round(screenX * subpixelSteps) / subpixelSteps;
+		y[i] = std::round(screenY * subpixelSteps) / subpixelSteps;
+		z[i] = position[2] * inverseW[i];
+	}
+
+	// Positive area is clockwise on screen, which is the front face for the default rasterizer state
+	const double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (!(area > 0.0))
+	{
+		return;
+	}
+
+	const int minX = std::max(0, static_cast<int>(std::ceil(std::min({ x[0], x[1], x[2] }))));
+	const int minY = std::max(0, static_cast<int>(std::ceil(std::min({ y[0], y[1], y[2] }))));
+	const int maxX = std::min(static_cast<int>(width_) - 1, static_cast<int>(std::floor(std::max({ x[0], x[1], x[2] }))));
+	const int maxY = std::min(static_cast<int>(height_) - 1, static_cast<int>(std::floor(std::max({ y[0], y[1], y[2] }))));
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	RasterTriangle& triangle = output.emplace_back();
+	triangle.minX = minX;
+	triangle.minY = minY;
+	triangle.maxX = maxX;
+	triangle.maxY = maxY;
+	triangle.originX = minX;
+	triangle.originY = minY;
+
+	const double inverseArea = 1.0 / area;
+	double depthA = 0.0;
+	double depthB = 0.0;
+	double depthC = 0.0;
+	for (int edge = 0; edge < 3; edge++)
+	{
+		const int a = (edge + 1) % 3;
+		const int b = (edge + 2) % 3;
+		const double edgeA = y[a] - y[b];
+		const double edgeB = x[b] - x[a];
+		const double edgeC = edgeB * (minY - y[a]) + edgeA * (minX - x[a]);
+		triangle.edgeA[edge] = static_cast<float>(edgeA);
+		triangle.edgeB[edge] = static_cast<float>(edgeB);
+		triangle.edgeC[edge] = static_cast<float>(edgeC);
+		triangle.edgeInclusive[edge] = edgeA > 0.0 || (edgeA == 0.0 && edgeB > 0.0);
+
+		// Barycentric weight of vertex "edge" is its opposite edge function over the area
+		depthA += edgeA * z[edge];
+		depthB += edgeB * z[edge];
+		depthC += edgeC * z[edge];
+	}
+	triangle.depthA = static_cast<float>(depthA * inverseArea);
+	triangle.depthB = static_cast<float>(depthB * inverseArea);
+	triangle.depthC = static_cast<float>(depthC * inverseArea);
+	triangle.minDepth = std::min({ z[0], z[1], z[2] });
+	triangle.inverseArea = static_cast<float>(inverseArea);
+	for (int i = 0; i < 3; i++)
+	{
+		triangle.inverseW[i] = inverseW[i];
+		std::copy_n(vertices[i]->attributes, 4, triangle.attributes[i]);
+	}
+	triangle.material = &material;
+	triangle.primitiveId = primitiveId;
+}
+
+void SoftwareRasterizer::binTriangles()
+{
+	for (auto& tile : tiles_)
+	{
+		tile.triangles.clear();
+		tile.blocksRejected = 0u;
+		tile.blocksOccluded = 0u;
+		tile.blocksAccepted = 0u;
+		tile.blocksPartial = 0u;
+		tile.pixelsShaded = 0u;
+	}
+
+	// In submission order, so every tile sees its triangles in the order they were drawn
+	for (const auto& drawTriangles : triangles_)
+	{
+		for (const auto& triangle : drawTriangles)
+		{
+			for (int tileY = triangle.minY / tileSize; tileY <= triangle.maxY / tileSize; tileY++)
+			{
+				for (int tileX = triangle.minX / tileSize; tileX <= triangle.maxX / tileSize; tileX++)
+				{
+					tiles_[static_cast<size_t>(tileY) * tileColumns_ + tileX].triangles.push_back(&triangle);
+				}
+			}
+		}
+	}
+}
+
+void SoftwareRasterizer::rasterizeTile(const size_t tileIndex, Surface& target)
+{
+	Tile& tile = tiles_[tileIndex];
+	const int tileX = static_cast<int>(tileIndex) % tileColumns_;
+	const int tileY = static_cast<int>(tileIndex) / tileColumns_;
+	const int firstBlockX = tileX * blocksPerTile;
+	const int firstBlockY = tileY * blocksPerTile;
+	const int lastBlockX = std::min(firstBlockX + blocksPerTile, blockColumns_) - 1;
+	const int lastBlockY = std::min(firstBlockY + blocksPerTile, blockRows_) - 1;
+
+	for (int blockY = firstBlockY; blockY <= lastBlockY; blockY++)
+	{
+		for (int blockX = firstBlockX; blockX <= lastBlockX; blockX++)
+		{
+			const size_t block = static_cast<size_t>(blockY) * blockColumns_ + blockX;
+			std::fill_n(depth_.data() + block * blockSize * blockSize, blockSize * blockSize, 1.0f);
+			blockMaxDepth_[block] = 1.0f;
+		}
+	}
+
+	for (const RasterTriangle* trianglePointer : tile.triangles)
+	{
+		const RasterTriangle& triangle = *trianglePointer;
+		const int startX = std::max(triangle.minX / blockSize, firstBlockX);
+		const int startY = std::max(triangle.minY / blockSize, firstBlockY);
+		const int endX = std::min(triangle.maxX / blockSize, lastBlockX);
+		const int endY = std::min(triangle.maxY / blockSize, lastBlockY);
+
+		for (int blockY = startY; blockY <= endY; blockY++)
+		{
+			const int pixelY = blockY * blockSize;
+			const float y0 = static_cast<float>(pixelY - triangle.originY);
+			const float y1 = y0 + static_cast<float>(blockSize - 1);
+			for (int blockX = startX; blockX <= endX; blockX++)
+			{
+				const int pixelX = blockX * blockSize;
+				const float x0 = static_cast<float>(pixelX - triangle.originX);
+				const float x1 = x0 + static_cast<float>(blockSize - 1);
+
+				// Trivial reject and accept from the edge functions at the block's corner pixels
+				bool outside = false;
+				bool inside = true;
+				for (int edge = 0; edge < 3 && !outside; edge++)
+				{
+					float minimum;
+					float maximum;
+					planeRange(triangle.edgeA[edge], triangle.edgeB[edge], triangle.edgeC[edge], x0, x1, y0, y1, minimum, maximum);
+					outside = triangle.edgeInclusive[edge] ? maximum < 0.0f : maximum <= 0.0f;
+					inside = inside && (triangle.edgeInclusive[edge] ? minimum >= 0.0f : minimum > 0.0f);
+				}
+				if (outside)
+				{
+					tile.blocksRejected++;
+					continue;
+				}
+
+				// Coarse hi-Z: nothing in the block can pass LESS if the nearest the triangle gets is behind the farthest stored depth
+				const size_t block = static_cast<size_t>(blockY) * blockColumns_ + blockX;
+				float nearest;
+				float farthest;
+				planeRange(triangle.depthA, triangle.depthB, triangle.depthC, x0, x1, y0, y1, nearest, farthest);
+				if (std::max(nearest, triangle.minDepth) >= blockMaxDepth_[block])
+				{
+					tile.blocksOccluded++;
+					continue;
+				}
+
+				inside ? tile.blocksAccepted++ : tile.blocksPartial++;
+				const std::uint64_t validMask = validBlockMask(static_cast<int>(width_) - pixelX, static_cast<int>(height_) - pixelY);
+				const std::uint64_t mask = coverBlock_(triangle, pixelX, pixelY, validMask, inside,
+					depth_.data() + block * blockSize * blockSize, blockMaxDepth_[block]);
+				if (mask != 0ull)
+				{
+					shadeBlock(triangle, pixelX, pixelY, mask, target);
+					tile.pixelsShaded += static_cast<size_t>(std::popcount(mask));
+				}
+			}
+		}
+	}
+}
+
+void SoftwareRasterizer::shadeBlock(const RasterTriangle& triangle, const int blockX, const int blockY, std::uint64_t mask, Surface& target) const noexcept
+{
+	const Material& material = *static_cast<const Material*>(triangle.material);
+	if (material.shading == Shading::Texture)
+	{
+		shadeTexturedBlock(triangle, blockX, blockY, mask, target);
+		return;
+	}
+	Surface::color* pixels = target.getBufferPtr();
+
+	Surface::color faceColor;
+	if (material.shading == Shading::FaceColors)
+	{
+		const auto& color = material.faceColors[(triangle.primitiveId / 2u) % 8u];
+		faceColor = packColor(color.x, color.y, color.z, color.w);
+	}
+
+	while (mask != 0ull)
+	{
+		const int bit = std::countr_zero(mask);
+		mask &= mask - 1ull;
+		const int x = blockX + (bit & 7);
+		const int y = blockY + (bit >> 3);
+
+		Surface::color color = faceColor;
+		if (material.shading == Shading::VertexColors)
+		{
+			// Perspective-correct weights: interpolate attribute / w and 1 / w, then divide
+			const float px = static_cast<float>(x - triangle.originX);
+			const float py = static_cast<float>(y - triangle.originY);
+			float weights[3];
+			float weightSum = 0.0f;
+			for (int i = 0; i < 3; i++)
+			{
+				const float barycentric = (triangle.edgeA[i] * px + triangle.edgeB[i] * py + triangle.edgeC[i]) * triangle.inverseArea;
+				weights[i] = barycentric * triangle.inverseW[i];
+				weightSum += weights[i];
+			}
+			const float normalize = 1.0f / weightSum;
+			float attributes[4] = {};
+			for (int c = 0; c < 4; c++)
+			{
+				attributes[c] = (weights[0] * triangle.attributes[0][c] + weights[1] * triangle.attributes[1][c] +
+					weights[2] * triangle.attributes[2][c]) * normalize;
+			}
+			color = packColor(attributes[0], attributes[1], attributes[2], attributes[3]);
+		}
+		pixels[static_cast<size_t>(y) * width_ + x] = color;
+	}
+}
+
+void SoftwareRasterizer::shadeTexturedBlock(const RasterTriangle& triangle, const int blockX, const int blockY, const std::uint64_t mask,
+	Surface& target) const noexcept
+{
+	const Material& material = *static_cast<const Material*>(triangle.material);
+	Surface::color* pixels = target.getBufferPtr();
+
+	// Quad pixel offsets in sampleQuad order: top left, top right, bottom left, bottom right
+	const __m128 quadX = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f);
+	const __m128 quadY = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+	const __m128 inverseArea = _mm_set1_ps(triangle.inverseArea);
+
+	// Shade in 2x2 quads like the GPU: pixels of a quad outside the triangle still get texture coordinates
+	// (extrapolated from the same planes) so the quad can take its derivatives, but only covered ones are written
+	for (int quadY0 = 0; quadY0 < blockSize; quadY0 += 2)
+	{
+		for (int quadX0 = 0; quadX0 < blockSize; quadX0 += 2)
+		{
+			const int bit = quadY0 * blockSize + quadX0;
+			const unsigned int quadMask = static_cast<unsigned int>((mask >> bit) & 0x3ull) |
+				static_cast<unsigned int>((mask >> (bit + blockSize)) & 0x3ull) << 2u;
+			if (quadMask == 0u)
+			{
+				continue;
+			}
+
+			// Perspective-correct weights for the four pixels at once: interpolate attribute / w and 1 / w, then divide
+			const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(blockX + quadX0 - triangle.originX)), quadX);
+			const __m128 py = _mm_add_ps(_mm_set1_ps(static_cast<float>(blockY + quadY0 - triangle.originY)), quadY);
+			__m128 weights[3];
+			__m128 weightSum = _mm_setzero_ps();
+			for (int i = 0; i < 3; i++)
+			{
+				const __m128 edge = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[i]), px),
+					_mm_mul_ps(_mm_set1_ps(triangle.edgeB[i]), py)), _mm_set1_ps(triangle.edgeC[i]));
+				weights[i] = _mm_mul_ps(_mm_mul_ps(edge, inverseArea), _mm_set1_ps(triangle.inverseW[i]));
+				weightSum = _mm_add_ps(weightSum, weights[i]);
+			}
+			const __m128 normalize = _mm_div_ps(_mm_set1_ps(1.0f), weightSum);
+			const auto interpolate = [&weights, &triangle, normalize](const int c)
+				{
+					const __m128 sum = _mm_add_ps(_mm_add_ps(
+						_mm_mul_ps(weights[0], _mm_set1_ps(triangle.attributes[0][c])),
+						_mm_mul_ps(weights[1], _mm_set1_ps(triangle.attributes[1][c]))),
+						_mm_mul_ps(weights[2], _mm_set1_ps(triangle.attributes[2][c])));
+					return _mm_mul_ps(sum, normalize);
+				};
+			alignas(16) float u[4];
+			alignas(16) float v[4];
+			_mm_store_ps(u, interpolate(0));
+			_mm_store_ps(v, interpolate(1));
+
+			Surface::color colors[4];
+			material.texture->sampleQuad(u, v, material.sampler, colors);
+			for (unsigned int i = 0; i < 4u; i++)
+			{
+				if ((quadMask >> i) & 1u)
+				{
+					const size_t x = static_cast<size_t>(blockX + quadX0) + (i & 1u);
+					const size_t y = static_cast<size_t>(blockY + quadY0) + (i >> 1u);
+					pixels[y * width_ + x] = colors[i];
+				}
+			}
+		}
+	}
+}
+
+// software rasterizer exception stuff
+SoftwareRasterizer::Exception::Exception(const int line, const char* file, std::string note) noexcept
+	:
+	AtumException(line, file),
+	note_(std::move(note))
+{}
+
+const char* SoftwareRasterizer::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AtumException::what() << "\n"
+		<< "[Note] " << getNote();
+	whatBuffer_ = oss.str();
+	return whatBuffer_.c_str();
+}
+
+const char* SoftwareRasterizer::Exception::getType() const noexcept
+{
+	return "Atum Software Rasterizer Exception";
+}
+
+const std::string& SoftwareRasterizer::Exception::getNote() const noexcept
+{
+	return note_;
+}
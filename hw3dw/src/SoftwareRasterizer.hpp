@@ -0,0 +1,181 @@
+#pragma once
+#include <DirectXMath.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "AtumException.hpp"
+#include "IndexedTriangleList.hpp"
+#include "MemoryTracker.hpp"
+#include "RasterKernel.hpp"
+#include "SampledTexture.hpp"
+#include "Surface.hpp"
+#include "WorkerPool.hpp"
+
+// CPU renderer for headless capture and benchmarking. It consumes the same vertex and index data the drawables
+// upload plus their world-view-projection, follows the pipeline state Graphics sets up (back face culling with
+// clockwise front faces, D32 depth with LESS) and ports the ColorIndex, ColorBlend and Texture pixel shaders.
+//
+// Draws are queued and executed by render(): triangles are clipped, set up and binned into 64x64 screen tiles,
+// then the tiles are rasterized in parallel in 8x8 blocks. Blocks are trivially accepted or rejected against
+// the edge functions and rejected against a per-block maximum depth before any pixel is tested.
+class SoftwareRasterizer
+{
+public:
+	class Exception : public AtumException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* getType() const noexcept override;
+		const std::string& getNote() const noexcept;
+	private:
+		std::string note_;
+	};
+
+	// Ports of the pixel shaders
+	enum class Shading
+	{
+		FaceColors,   // ColorIndexPS: face_colors[(SV_PrimitiveID / 2) % 8]
+		VertexColors, // ColorBlendPS: interpolated vertex colour
+		Texture,      // TexturePS: sampled through a SampledTexture, 2x2 quads at a time like the GPU
+	};
+
+	struct Material
+	{
+		Shading shading = Shading::FaceColors;
+		std::array<DirectX::XMFLOAT4, 8> faceColors{};
+		const SampledTexture* texture = nullptr;
+		SampledTexture::State sampler{};
+	};
+
+	struct Mesh
+	{
+		std::vector<DirectX::XMFLOAT3> positions;
+		// Only one of these is filled in, depending on what the vertex type carries
+		std::vector<DirectX::XMFLOAT4> colors;
+		std::vector<DirectX::XMFLOAT2> texcoords;
+		std::vector<unsigned short> indices;
+
+		template<class V>
+		static Mesh from(const IndexedTriangleList<V>& model)
+		{
+			return from(std::span<const V>(model.vertices()), std::span<const unsigned short>(model.indices()));
+		}
+
+		// Built from wherever the mesh was generated, a mapped upload for instance
+		template<class V>
+		static Mesh from(const std::span<const V> vertices, const std::span<const unsigned short> indices)
+		{
+			MemoryTracker::Scope scope(MemoryTag::Meshes);
+			Mesh mesh;
+			mesh.positions.reserve(vertices.size());
+			for (const auto& vertex : vertices)
+			{
+				mesh.positions.push_back(vertex.pos);
+				if constexpr (requires { vertex.color.r; })
+				{
+					mesh.colors.push_back({ toUnorm(vertex.color.r), toUnorm(vertex.color.g), toUnorm(vertex.color.b), toUnorm(vertex.color.a) });
+				}
+				else if constexpr (requires { vertex.tex.u; })
+				{
+					mesh.texcoords.push_back({ vertex.tex.u, vertex.tex.v });
+				}
+			}
+			mesh.indices.assign(indices.begin(), indices.end());
+			return mesh;
+		}
+	private:
+		static float toUnorm(const unsigned char value) noexcept { return static_cast<float>(value) / 255.0f; }
+		static float toUnorm(const float value) noexcept { return value; }
+	};
+
+	struct Statistics
+	{
+		size_t draws;
+		size_t triangles;          // Submitted
+		size_t trianglesRasterized; // Left after culling and clipping
+		size_t blocksRejected;     // Outside an edge
+		size_t blocksOccluded;     // Behind the block's maximum depth
+		size_t blocksAccepted;     // Inside every edge
+		size_t blocksPartial;
+		size_t pixelsShaded;
+		float setupMilliseconds;
+		float rasterMilliseconds;
+	};
+
+public:
+	// threadCount extra threads rasterize tiles alongside the caller, 0 renders on the calling thread only.
+	// allowAvx2 = false keeps the scalar coverage kernel, for reference renders.
+	SoftwareRasterizer(unsigned int width, unsigned int height, size_t threadCount = 0u, bool allowAvx2 = true);
+	~SoftwareRasterizer() = default;
+	SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+	SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+	SoftwareRasterizer(const SoftwareRasterizer&&) = delete;
+	SoftwareRasterizer& operator=(const SoftwareRasterizer&&) = delete;
+
+	// Queue a draw; the mesh and material must stay alive until render() returns
+	void draw(const Mesh& mesh, const Material& material, DirectX::FXMMATRIX worldViewProjection);
+	// Clear the target and depth, execute every queued draw into target and empty the queue
+	void render(Surface& target, Surface::color clearColor);
+
+	[[nodiscard]] unsigned int getWidth() const noexcept;
+	[[nodiscard]] unsigned int getHeight() const noexcept;
+	[[nodiscard]] bool isUsingAvx2() const noexcept;
+	[[nodiscard]] const Statistics& getStatistics() const noexcept;
+
+private:
+	struct DrawCommand
+	{
+		const Mesh* mesh;
+		const Material* material;
+		DirectX::XMFLOAT4X4 worldViewProjection;
+	};
+
+	struct ClipVertex
+	{
+		float position[4];
+		float attributes[4];
+	};
+
+	struct Tile
+	{
+		std::vector<const RasterTriangle*> triangles;
+		size_t blocksRejected;
+		size_t blocksOccluded;
+		size_t blocksAccepted;
+		size_t blocksPartial;
+		size_t pixelsShaded;
+	};
+
+	void setupDraw(const DrawCommand& command, std::vector<RasterTriangle>& output) const;
+	void setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, const Material& material,
+		unsigned int primitiveId, std::vector<RasterTriangle>& output) const;
+	void binTriangles();
+	void rasterizeTile(size_t tileIndex, Surface& target);
+	void shadeBlock(const RasterTriangle& triangle, int blockX, int blockY, std::uint64_t mask, Surface& target) const noexcept;
+	void shadeTexturedBlock(const RasterTriangle& triangle, int blockX, int blockY, std::uint64_t mask, Surface& target) const noexcept;
+
+	static constexpr int blockSize = 8;
+	static constexpr int tileSize = 64;
+	static constexpr int blocksPerTile = tileSize / blockSize;
+
+	unsigned int width_;
+	unsigned int height_;
+	int blockColumns_;
+	int blockRows_;
+	int tileColumns_;
+	int tileRows_;
+	float guardBandX_;
+	float guardBandY_;
+	RasterKernel::CoverBlock coverBlock_;
+	std::unique_ptr<WorkerPool> pool_;
+
+	std::vector<DrawCommand> commands_;
+	std::vector<std::vector<RasterTriangle>> triangles_;
+	std::vector<Tile> tiles_;
+	// Depth is stored block by block, 64 floats per 8x8 block, so a block is one contiguous run of memory
+	std::vector<float> depth_;
+	std::vector<float> blockMaxDepth_;
+	Statistics statistics_{};
+};
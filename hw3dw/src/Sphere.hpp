@@ -1,8 +1,11 @@
 #pragma once
 
+#include <span>
+
 #include "IndexedTriangleList.hpp"
 #include <DirectXMath.h>
 #include "AtumMath.hpp"
+#include "MeshLayout.hpp"
 
 class Sphere
 {
@@ -15,100 +18,133 @@ public:
 
 	template<class V>
 	static IndexedTriangleList<V> makeTessellated(const int latitudinalDivisions, const int longitudinalDivisions)
+	{
+		const MeshLayout layout = getTessellatedLayout(latitudinalDivisions, longitudinalDivisions);
+		MeshVector<V> vertices(layout.vertexCount);
+		MeshVector<unsigned short> indices(layout.indexCount);
+		writeTessellated<V>(latitudinalDivisions, longitudinalDivisions, std::span(vertices), std::span(indices));
+
+		return
+		{
+			std::move(vertices),
+			std::move(indices)
+		};
+	}
+
+	[[nodiscard]] static MeshLayout getTessellatedLayout(const int latitudinalDivisions, const int longitudinalDivisions) noexcept
+	{
+		const size_t ringVertices = static_cast<size_t>(latitudinalDivisions - 1) * static_cast<size_t>(longitudinalDivisions);
+		return { ringVertices + 2u, ringVertices * 6u };
+	}
+
+	// Write the sphere into storage sized by getTessellatedLayout (a mapped upload buffer, say). Only positions
+	// are written. The rings of vertices and the bands of indices are independent, so they are split over the
+	// pool when one is given.
+	template<class V, class I = unsigned short>
+	static void writeTessellated(const int latitudinalDivisions, const int longitudinalDivisions, std::span<V> vertices, std::span<I> indices,
+		WorkerPool* pool = nullptr)
 	{
 		namespace dx = DirectX;
 		assert(latitudinalDivisions >= 3);
 		assert(longitudinalDivisions >= 3);
+		const MeshLayout layout = getTessellatedLayout(latitudinalDivisions, longitudinalDivisions);
+		assert(vertices.size() == layout.vertexCount && indices.size() == layout.indexCount);
+		assert(layout.fitsIndexType<I>());
 
 		constexpr float radius = 1.0f;
 		const auto base = dx::XMVectorSet(0.0f, 0.0f, radius, 0.0f);
 		const float latitudinalAngle = PI / static_cast<float>(latitudinalDivisions);
 		const float longitudeAngle = 2.0f * PI / static_cast<float>(longitudinalDivisions);
+		const size_t ringCount = static_cast<size_t>(latitudinalDivisions - 1);
+		const size_t ringSize = static_cast<size_t>(longitudinalDivisions);
 
-		std::vector<V> vertices;
-		for (int indexLatitude = 1; indexLatitude < latitudinalDivisions; indexLatitude++)
-		{
-			const auto latitudeBase = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationX(latitudinalAngle * static_cast<float>(indexLatitude))
-			);
-
-			for (int indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++)
+		forEachBand(pool, ringCount, [&](const size_t firstRing, const size_t lastRing)
 			{
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					latitudeBase,
-					dx::XMMatrixRotationZ(longitudeAngle * static_cast<float>(indexLongitude))
-				);
-
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-			}
-		}
+				for (size_t ring = firstRing; ring < lastRing; ring++)
+				{
+					const auto latitudeBase = dx::XMVector3Transform(
+						base,
+						dx::XMMatrixRotationX(latitudinalAngle * static_cast<float>(ring + 1u))
+					);
+
+					V* vertex = vertices.data() + ring * ringSize;
+					for (int indexLongitude = 0; indexLongitude < longitudinalDivisions; indexLongitude++, vertex++)
+					{
+						const auto v = dx::XMVector3Transform(
+							latitudeBase,
+							dx::XMMatrixRotationZ(longitudeAngle * static_cast<float>(indexLongitude))
+						);
+						dx::XMStoreFloat3(&vertex->pos, v);
+					}
+				}
+			});
 
 		// add the cap vertices
-		const auto indexNorthPole = static_cast<unsigned short>(vertices.size());
-		vertices.emplace_back();
-		dx::XMStoreFloat3(&vertices.back().pos, base);
-
-		const auto indexSouthPole = static_cast<unsigned short>(vertices.size());
-		vertices.emplace_back();
-		dx::XMStoreFloat3(&vertices.back().pos, dx::XMVectorNegate(base));
-
-		// ReSharper disable once CppLambdaCaptureNeverUsed
-		const auto calcIndex = [latitudinalDivisions, longitudinalDivisions](const unsigned short indexLatitude, const unsigned short indexLongitude)
-			{ return indexLatitude * longitudinalDivisions + indexLongitude; };
-
-		std::vector<unsigned short> indices;
-		for (unsigned short indexLatitude = 0; indexLatitude < latitudinalDivisions - 2; indexLatitude++)
-		{
-			for (unsigned short indexLongitude = 0; indexLongitude < longitudinalDivisions - 1; indexLongitude++)
+		const auto indexNorthPole = static_cast<I>(ringCount * ringSize);
+		dx::XMStoreFloat3(&vertices[indexNorthPole].pos, base);
+		const auto indexSouthPole = static_cast<I>(indexNorthPole + 1u);
+		dx::XMStoreFloat3(&vertices[indexSouthPole].pos, dx::XMVectorNegate(base));
+
+		const auto calcIndex = [ringSize](const size_t indexLatitude, const size_t indexLongitude)
+			{ return static_cast<I>(indexLatitude * ringSize + indexLongitude); };
+
+		// Every band between two rings writes 6 indices per longitude, and the caps together write the same
+		// amount after the last band, so row r starts at r * ringSize * 6
+		const size_t bandCount = ringCount - 1u;
+		forEachBand(pool, bandCount + 1u, [&](const size_t firstRow, const size_t lastRow)
 			{
-				indices.push_back(calcIndex(indexLatitude, indexLongitude));
-				indices.push_back(calcIndex(indexLatitude + 1, indexLongitude));
-				indices.push_back(calcIndex(indexLatitude, indexLongitude + 1));
-				indices.push_back(calcIndex(indexLatitude, indexLongitude + 1));
-				indices.push_back(calcIndex(indexLatitude + 1, indexLongitude));
-				indices.push_back(calcIndex(indexLatitude + 1, indexLongitude + 1));
-			}
-
-			// wrap band
-			indices.push_back(calcIndex(indexLatitude, longitudinalDivisions - 1));
-			indices.push_back(calcIndex(indexLatitude + 1, longitudinalDivisions - 1));
-			indices.push_back(calcIndex(indexLatitude, 0));
-			indices.push_back(calcIndex(indexLatitude, 0));
-			indices.push_back(calcIndex(indexLatitude + 1, longitudinalDivisions - 1));
-			indices.push_back(calcIndex(indexLatitude + 1, 0));
-		}
-
-		// cap fans
-		for (unsigned short indexLongitude = 0; indexLongitude < longitudinalDivisions - 1; indexLongitude++)
-		{
-			// north
-			indices.push_back(indexNorthPole);
-			indices.push_back(calcIndex(0, indexLongitude));
-			indices.push_back(calcIndex(0, indexLongitude + 1));
-
-			// south
-			indices.push_back(calcIndex(latitudinalDivisions - 2, indexLongitude + 1));
-			indices.push_back(calcIndex(latitudinalDivisions - 2, indexLongitude));
-			indices.push_back(indexSouthPole);
-		}
-
-		// wrap triangles
-		// north
-		indices.push_back(indexNorthPole);
-		indices.push_back(calcIndex(0, longitudinalDivisions - 1));
-		indices.push_back(calcIndex(0, 0));
-
-		// south
-		indices.push_back(calcIndex(latitudinalDivisions - 2, 0));
-		indices.push_back(calcIndex(latitudinalDivisions - 2, longitudinalDivisions - 1));
-		indices.push_back(indexSouthPole);
-
-		return
-		{
-			std::move(vertices),
-			std::move(indices)
-		};
+				I* index = indices.data() + firstRow * ringSize * 6u;
+				for (size_t row = firstRow; row < lastRow; row++)
+				{
+					if (row < bandCount)
+					{
+						const size_t indexLatitude = row;
+						for (size_t indexLongitude = 0; indexLongitude < ringSize - 1u; indexLongitude++)
+						{
+							*index++ = calcIndex(indexLatitude, indexLongitude);
+							*index++ = calcIndex(indexLatitude + 1u, indexLongitude);
+							*index++ = calcIndex(indexLatitude, indexLongitude + 1u);
+							*index++ = calcIndex(indexLatitude, indexLongitude + 1u);
+							*index++ = calcIndex(indexLatitude + 1u, indexLongitude);
+							*index++ = calcIndex(indexLatitude + 1u, indexLongitude + 1u);
+						}
+
+						// wrap band
+						*index++ = calcIndex(indexLatitude, ringSize - 1u);
+						*index++ = calcIndex(indexLatitude + 1u, ringSize - 1u);
+						*index++ = calcIndex(indexLatitude, 0u);
+						*index++ = calcIndex(indexLatitude, 0u);
+						*index++ = calcIndex(indexLatitude + 1u, ringSize - 1u);
+						*index++ = calcIndex(indexLatitude + 1u, 0u);
+						continue;
+					}
+
+					// cap fans
+					const size_t lastRing = ringCount - 1u;
+					for (size_t indexLongitude = 0; indexLongitude < ringSize - 1u; indexLongitude++)
+					{
+						// north
+						*index++ = indexNorthPole;
+						*index++ = calcIndex(0u, indexLongitude);
+						*index++ = calcIndex(0u, indexLongitude + 1u);
+
+						// south
+						*index++ = calcIndex(lastRing, indexLongitude + 1u);
+						*index++ = calcIndex(lastRing, indexLongitude);
+						*index++ = indexSouthPole;
+					}
+
+					// wrap triangles
+					// north
+					*index++ = indexNorthPole;
+					*index++ = calcIndex(0u, ringSize - 1u);
+					*index++ = calcIndex(0u, 0u);
+
+					// south
+					*index++ = calcIndex(lastRing, 0u);
+					*index++ = calcIndex(lastRing, ringSize - 1u);
+					*index++ = indexSouthPole;
+				}
+			});
 	}
-};
\ No newline at end of file
+};
@@ -22,9 +22,13 @@
 
 #include <algorithm>
 #include <codecvt>
-#include <gdiplus.h>
 #include <sstream>
 
+#include "MemoryTracker.hpp"
+
+#if defined(_WIN32)
+#include <gdiplus.h>
+
 #pragma comment(lib, "gdiplus.lib")
 
 namespace Gdiplus
@@ -32,10 +36,11 @@ namespace Gdiplus
 	using std::min;
 	using std::max;
 }
+#endif
 
 Surface::Surface(const unsigned int width, const unsigned int height) noexcept
 	:
-	buffer_(std::make_unique<color[]>(static_cast<size_t>(width)* height)),
+	buffer_(MemoryTracker::tagged(MemoryTag::Textures, [=] { return std::make_unique<color[]>(static_cast<size_t>(width) * height); })),
 	width_(width),
 	height_(height)
 {}
@@ -101,6 +106,7 @@ const Surface::color* Surface::getBufferPtr() const noexcept
 	return buffer_.get();
 }
 
+#if defined(_WIN32)
 Surface Surface::fromFile(const std::wstring& name) {
 	unsigned int width;
 	unsigned int height;
@@ -119,7 +125,7 @@ Surface Surface::fromFile(const std::wstring& name) {
 
 		height = bitmap->GetHeight();
 		width = bitmap->GetWidth();
-		buffer = std::make_unique<color[]>(static_cast<size_t>(width) * height);
+		buffer = MemoryTracker::tagged(MemoryTag::Textures, [=] { return std::make_unique<color[]>(static_cast<size_t>(width) * height); });
 
 		for (unsigned int y = 0; y < height; y++) {
 			for (unsigned int x = 0; x < width; x++) {
@@ -184,6 +190,22 @@ void Surface::save(const std::string& filename) const
 	}
 }
 
+#else
+// Image files go through GDI+; the portable builds only use surfaces made in memory
+Surface Surface::fromFile(const std::wstring& name) {
+	std::string narrow;
+	for (const wchar_t c : name) {
+		narrow.push_back(c < 0x80 ? static_cast<char>(c) : '?');
+	}
+	throw Exception(__LINE__, __FILE__, "Loading image [" + narrow + "]: image files can only be read on Windows.");
+}
+
+void Surface::save(const std::string& filename) const
+{
+	throw Exception(__LINE__, __FILE__, "Saving surface to [" + filename + "]: image files can only be written on Windows.");
+}
+#endif
+
 void Surface::copy(const Surface& src) noexcept(!IS_DEBUG) {
 	assert(width_ == src.width_);
 	assert(height_ == src.height_);
@@ -20,7 +20,9 @@
 ******************************************************************************************/
 #pragma once
 
+#if defined(_WIN32)
 #include "AtumWindows.hpp"
+#endif
 #include "AtumException.hpp"
 #include <string>
 #include <assert.h>
@@ -52,9 +54,9 @@ public:
 			:
 			dword((r << 16u) | (g << 8u) | b)
 		{}
-		constexpr color(color color, unsigned char x) noexcept
+		constexpr color(color source, unsigned char x) noexcept
 			:
-			color((x << 24u) | color.dword)
+			color((x << 24u) | source.dword)
 		{}
 		color& operator =(color color) noexcept
 		{
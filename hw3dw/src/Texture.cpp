@@ -1,11 +1,23 @@
 #include "Texture.hpp"
 #include "Surface.hpp"
 #include "GraphicsThrowMacros.hpp"
+#include "MemoryTracker.hpp"
 
 namespace wrl = Microsoft::WRL;
 
 Texture::Texture(Graphics& graphics, const Surface& surface)
 {
+	createView(graphics, surface);
+}
+
+void Texture::bind(Graphics& graphics) noexcept
+{
+	getContext(graphics)->PSSetShaderResources(0u, 1u, textureView_.GetAddressOf());
+}
+
+void Texture::createView(Graphics& graphics, const Surface& surface)
+{
+	MemoryTracker::Scope scope(MemoryTag::Textures);
 	INFOMAN(graphics);
 
 	// create texture resource
@@ -49,9 +61,4 @@ Texture::Texture(Graphics& graphics, const Surface& surface)
 	GFX_THROW_INFO(getDevice(graphics)->CreateShaderResourceView(
 		texture.Get(), &shaderResourceViewDesc, &textureView_
 	));
-}
-
-void Texture::bind(Graphics& graphics) noexcept
-{
-	getContext(graphics)->PSSetShaderResources(0u, 1u, textureView_.GetAddressOf());
 }
\ No newline at end of file
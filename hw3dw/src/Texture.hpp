@@ -15,5 +15,7 @@ public:
 
 	void bind(Graphics& graphics) noexcept override;
 protected:
+	void createView(Graphics& graphics, const Surface& surface);
+
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> textureView_;
 };
@@ -0,0 +1,329 @@
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <sstream>
+
+namespace
+{
+	std::string toNarrow(const std::wstring& wide)
+	{
+		std::string narrow;
+		narrow.reserve(wide.size());
+		for (const wchar_t c : wide)
+		{
+			narrow.push_back(c < 0x80 ? static_cast<char>(c) : '?');
+		}
+		return narrow;
+	}
+
+	unsigned int nextPowerOfTwo(unsigned int value) noexcept
+	{
+		unsigned int result = 1u;
+		while (result < value)
+		{
+			result <<= 1u;
+		}
+		return result;
+	}
+}
+
+TextureAtlas::TextureAtlas(const unsigned int padding, const unsigned int alignment, const unsigned int maxPageSize) noexcept
+	:
+	padding_(0u),
+	alignment_(std::max(alignment, 1u)),
+	maxPageSize_(maxPageSize)
+{
+	// Keep the gutter a multiple of the alignment so that region origins stay aligned as well
+	padding_ = align(padding);
+}
+
+void TextureAtlas::add(const std::wstring& name, Surface surface)
+{
+	if (isPacked())
+	{
+		throw Exception(__LINE__, __FILE__, "Adding [" + toNarrow(name) + "] to atlas: atlas has already been packed.");
+	}
+	if (std::ranges::any_of(entries_, [&name](const Entry& entry) { return entry.name == name; }))
+	{
+		throw Exception(__LINE__, __FILE__, "Adding [" + toNarrow(name) + "] to atlas: name is already in use.");
+	}
+	entries_.push_back({ name, std::move(surface) });
+}
+
+void TextureAtlas::pack()
+{
+	if (entries_.empty())
+	{
+		throw Exception(__LINE__, __FILE__, "Packing atlas: no surfaces were added.");
+	}
+
+	unsigned long long area = 0ull;
+	unsigned int widest = 0u;
+	unsigned int tallest = 0u;
+	for (const auto& entry : entries_)
+	{
+		const unsigned int width = align(entry.surface.getWidth() + 2u * padding_);
+		const unsigned int height = align(entry.surface.getHeight() + 2u * padding_);
+		area += static_cast<unsigned long long>(width) * height;
+		widest = std::max(widest, width);
+		tallest = std::max(tallest, height);
+	}
+
+	// Start from the smallest power of two page that could possibly hold everything and grow from there
+	unsigned int side = 1u;
+	while (static_cast<unsigned long long>(side) * side < area)
+	{
+		side <<= 1u;
+	}
+	unsigned int pageWidth = std::max(side, nextPowerOfTwo(widest));
+	unsigned int pageHeight = std::max(side / 2u, nextPowerOfTwo(tallest));
+
+	while (!tryPack(pageWidth, pageHeight))
+	{
+		if (pageWidth <= pageHeight)
+		{
+			pageWidth <<= 1u;
+		}
+		else
+		{
+			pageHeight <<= 1u;
+		}
+
+		if (pageWidth > maxPageSize_ || pageHeight > maxPageSize_)
+		{
+			std::ostringstream out;
+			out << "Packing atlas: " << entries_.size() << " surfaces do not fit in a "
+				<< maxPageSize_ << "x" << maxPageSize_ << " page.";
+			throw Exception(__LINE__, __FILE__, out.str());
+		}
+	}
+
+	page_ = std::make_unique<Surface>(pageWidth, pageHeight);
+	usedTexels_ = 0ull;
+	for (const auto& entry : entries_)
+	{
+		const auto& region = regions_.at(entry.name);
+		blit(entry.surface, region);
+		usedTexels_ += static_cast<unsigned long long>(region.width) * region.height;
+	}
+
+	// The sources have been copied into the page, so there is no need to keep them around
+	entries_.clear();
+	skyline_.clear();
+}
+
+bool TextureAtlas::isPacked() const noexcept
+{
+	return page_ != nullptr;
+}
+
+const TextureAtlas::Region& TextureAtlas::getRegion(const std::wstring& name) const
+{
+	const auto it = regions_.find(name);
+	if (it == regions_.end() || !isPacked())
+	{
+		throw Exception(__LINE__, __FILE__, "Looking up [" + toNarrow(name) + "] in atlas: region does not exist.");
+	}
+	return it->second;
+}
+
+const Surface& TextureAtlas::getPage() const noexcept(!IS_DEBUG)
+{
+	assert("Atlas must be packed before the page is accessed" && isPacked());
+	return *page_;
+}
+
+float TextureAtlas::getOccupancy() const noexcept
+{
+	if (!isPacked())
+	{
+		return 0.0f;
+	}
+	return static_cast<float>(static_cast<double>(usedTexels_) /
+		(static_cast<double>(page_->getWidth()) * page_->getHeight()));
+}
+
+bool TextureAtlas::tryPack(const unsigned int pageWidth, const unsigned int pageHeight)
+{
+	regions_.clear();
+	skyline_.clear();
+	skyline_.push_back({ 0u, 0u, pageWidth });
+
+	// Tallest first, then widest, gives the skyline the flattest profile
+	std::vector<size_t> order(entries_.size());
+	std::iota(order.begin(), order.end(), size_t{ 0 });
+	std::ranges::sort(order, [this](const size_t lhs, const size_t rhs)
+		{
+			const auto& a = entries_[lhs].surface;
+			const auto& b = entries_[rhs].surface;
+			if (a.getHeight() != b.getHeight())
+			{
+				return a.getHeight() > b.getHeight();
+			}
+			return a.getWidth() > b.getWidth();
+		});
+
+	for (const size_t index : order)
+	{
+		const auto& surface = entries_[index].surface;
+		const unsigned int width = align(surface.getWidth() + 2u * padding_);
+		const unsigned int height = align(surface.getHeight() + 2u * padding_);
+
+		unsigned int x = 0u;
+		unsigned int y = 0u;
+		size_t node = 0u;
+		if (!findPosition(width, height, pageWidth, pageHeight, x, y, node))
+		{
+			return false;
+		}
+		addSkylineLevel(node, x, y, width, height);
+
+		const unsigned int left = x + padding_;
+		const unsigned int top = y + padding_;
+		regions_.emplace(entries_[index].name, Region{
+			.x = left,
+			.y = top,
+			.width = surface.getWidth(),
+			.height = surface.getHeight(),
+			.u0 = static_cast<float>(left) / static_cast<float>(pageWidth),
+			.v0 = static_cast<float>(top) / static_cast<float>(pageHeight),
+			.u1 = static_cast<float>(left + surface.getWidth()) / static_cast<float>(pageWidth),
+			.v1 = static_cast<float>(top + surface.getHeight()) / static_cast<float>(pageHeight),
+			});
+	}
+	return true;
+}
+
+bool TextureAtlas::findPosition(const unsigned int width, const unsigned int height, const unsigned int pageWidth, const unsigned int pageHeight,
+	unsigned int& bestX, unsigned int& bestY, size_t& bestIndex) const noexcept
+{
+	unsigned int bestBottom = std::numeric_limits<unsigned int>::max();
+	unsigned int bestWidth = std::numeric_limits<unsigned int>::max();
+	bool found = false;
+
+	for (size_t i = 0; i < skyline_.size(); i++)
+	{
+		const unsigned int x = skyline_[i].x;
+		if (x + width > pageWidth)
+		{
+			break;
+		}
+
+		// The rectangle rests on the highest node it spans
+		unsigned int y = 0u;
+		unsigned int remaining = width;
+		for (size_t j = i; remaining > 0u; j++)
+		{
+			y = std::max(y, skyline_[j].y);
+			remaining -= std::min(remaining, skyline_[j].width);
+		}
+
+		if (y + height > pageHeight)
+		{
+			continue;
+		}
+
+		const unsigned int bottom = y + height;
+		if (bottom < bestBottom || (bottom == bestBottom && skyline_[i].width < bestWidth))
+		{
+			bestBottom = bottom;
+			bestWidth = skyline_[i].width;
+			bestX = x;
+			bestY = y;
+			bestIndex = i;
+			found = true;
+		}
+	}
+	return found;
+}
+
+void TextureAtlas::addSkylineLevel(const size_t index, const unsigned int x, const unsigned int y, const unsigned int width, const unsigned int height)
+{
+	skyline_.insert(skyline_.begin() + static_cast<std::ptrdiff_t>(index), { x, y + height, width });
+
+	// Shrink or remove the nodes now shadowed by the new level
+	for (size_t i = index + 1; i < skyline_.size();)
+	{
+		const auto& previous = skyline_[i - 1];
+		auto& node = skyline_[i];
+		if (node.x >= previous.x + previous.width)
+		{
+			break;
+		}
+
+		const unsigned int shrink = previous.x + previous.width - node.x;
+		if (node.width > shrink)
+		{
+			node.x += shrink;
+			node.width -= shrink;
+			break;
+		}
+		skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(i));
+	}
+
+	// Merge neighbours at the same height
+	for (size_t i = 0; i + 1 < skyline_.size();)
+	{
+		if (skyline_[i].y == skyline_[i + 1].y)
+		{
+			skyline_[i].width += skyline_[i + 1].width;
+			skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void TextureAtlas::blit(const Surface& source, const Region& region) const noexcept(!IS_DEBUG)
+{
+	// Copy the image and extrude its edge texels outward to fill the gutter
+	const unsigned int left = region.x - padding_;
+	const unsigned int top = region.y - padding_;
+	const unsigned int right = std::min(region.x + region.width + padding_, page_->getWidth());
+	const unsigned int bottom = std::min(region.y + region.height + padding_, page_->getHeight());
+
+	for (unsigned int y = top; y < bottom; y++)
+	{
+		const unsigned int sourceY = std::clamp(static_cast<int>(y) - static_cast<int>(region.y), 0, static_cast<int>(region.height) - 1);
+		for (unsigned int x = left; x < right; x++)
+		{
+			const unsigned int sourceX = std::clamp(static_cast<int>(x) - static_cast<int>(region.x), 0, static_cast<int>(region.width) - 1);
+			page_->putPixel(x, y, source.getPixel(sourceX, sourceY));
+		}
+	}
+}
+
+unsigned int TextureAtlas::align(const unsigned int value) const noexcept
+{
+	return (value + alignment_ - 1u) / alignment_ * alignment_;
+}
+
+// atlas exception stuff
+TextureAtlas::Exception::Exception(const int line, const char* file, std::string note) noexcept
+	:
+	AtumException(line, file),
+	note_(std::move(note))
+{}
+
+const char* TextureAtlas::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AtumException::what() << "\n"
+		<< "[Note] " << getNote();
+	whatBuffer_ = oss.str();
+	return whatBuffer_.c_str();
+}
+
+const char* TextureAtlas::Exception::getType() const noexcept
+{
+	return "Atum Texture Atlas Exception";
+}
+
+const std::string& TextureAtlas::Exception::getNote() const noexcept
+{
+	return note_;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AtumException.hpp"
+#include "IndexedTriangleList.hpp"
+#include "Surface.hpp"
+
+// Packs several Surfaces into a single page so that textured drawables of different types can share one
+// texture bind. Packing uses a skyline bottom-left heuristic; every region is surrounded by a gutter of
+// extruded edge texels so linear filtering (and coarser mips) never bleed a neighbour into the region.
+class TextureAtlas
+{
+public:
+	struct Region
+	{
+		unsigned int x;
+		unsigned int y;
+		unsigned int width;
+		unsigned int height;
+		float u0;
+		float v0;
+		float u1;
+		float v1;
+	};
+
+	class Exception : public AtumException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* getType() const noexcept override;
+		const std::string& getNote() const noexcept;
+	private:
+		std::string note_;
+	};
+
+public:
+	// padding is the gutter on each side of a region, alignment is the granularity region origins snap to
+	explicit TextureAtlas(unsigned int padding = 4u, unsigned int alignment = 4u, unsigned int maxPageSize = 4096u) noexcept;
+
+	~TextureAtlas() = default;
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+	TextureAtlas(const TextureAtlas&&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&&) = delete;
+
+	void add(const std::wstring& name, Surface surface);
+	void pack();
+
+	[[nodiscard]] bool isPacked() const noexcept;
+	[[nodiscard]] const Region& getRegion(const std::wstring& name) const;
+	[[nodiscard]] const Surface& getPage() const noexcept(!IS_DEBUG);
+	// Ratio of texels covered by source images to the page area
+	[[nodiscard]] float getOccupancy() const noexcept;
+
+	// Rewrite the [0,1] texture coordinates of a model so they address the named region of the page
+	template<class V>
+	void remap(IndexedTriangleList<V>& model, const std::wstring& name) const
+	{
+		const auto& region = getRegion(name);
+		model.remapTextureCoordinates(region.u0, region.v0, region.u1 - region.u0, region.v1 - region.v0);
+	}
+
+	template<class V>
+	void remap(const std::span<V> vertices, const std::wstring& name) const
+	{
+		const auto& region = getRegion(name);
+		IndexedTriangleList<V>::remapTextureCoordinates(vertices, region.u0, region.v0, region.u1 - region.u0, region.v1 - region.v0);
+	}
+
+private:
+	struct Entry
+	{
+		std::wstring name;
+		Surface surface;
+	};
+
+	struct SkylineNode
+	{
+		unsigned int x;
+		unsigned int y;
+		unsigned int width;
+	};
+
+	bool tryPack(unsigned int pageWidth, unsigned int pageHeight);
+	bool findPosition(unsigned int width, unsigned int height, unsigned int pageWidth, unsigned int pageHeight,
+		unsigned int& bestX, unsigned int& bestY, size_t& bestIndex) const noexcept;
+	void addSkylineLevel(size_t index, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+	void blit(const Surface& source, const Region& region) const noexcept(!IS_DEBUG);
+	unsigned int align(unsigned int value) const noexcept;
+
+	unsigned int padding_;
+	unsigned int alignment_;
+	unsigned int maxPageSize_;
+	std::vector<Entry> entries_;
+	std::vector<SkylineNode> skyline_;
+	std::unordered_map<std::wstring, Region> regions_;
+	std::unique_ptr<Surface> page_;
+	unsigned long long usedTexels_ = 0ull;
+};
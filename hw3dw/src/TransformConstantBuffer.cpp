@@ -1,6 +1,8 @@
 #include "TransformConstantBuffer.hpp"
+#include "CommandRecorder.hpp"
+#include "ConstantRing.hpp"
 
-#include "plog/Log.h"
+#include "Logging.hpp"
 
 TransformConstantBuffer::TransformConstantBuffer(Graphics& graphics, const Drawable& parent)
 	:
@@ -14,8 +16,35 @@ TransformConstantBuffer::TransformConstantBuffer(Graphics& graphics, const Drawa
 
 void TransformConstantBuffer::bind(Graphics& graphics) noexcept
 {
+	// Each draw gets its own slice of the frame's ring rather than renaming one shared buffer. Draws on the
+	// immediate context bind the slice App wrote for them ahead of the frame, and only map their own if it has
+	// none. The ring lives on the immediate context, so draws recorded on other threads write into the part of the
+	// frame's mapped block their recorder was given, and only map the shared buffer on their own context if that
+	// runs out.
+	auto* ring = graphics.getConstantRing();
+	if (ring && !Graphics::isRecording() && ring->bindNextVertex(0u))
+	{
+		return;
+	}
+
+	const auto transform = getTransform(graphics, parent_);
+	if (ring && !Graphics::isRecording())
+	{
+		ring->bindVertex(0u, ring->upload(transform));
+		return;
+	}
+	if (auto* recorder = CommandRecorder::getActive(); recorder && recorder->bindVertexConstants(0u, transform))
+	{
+		return;
+	}
+
+	vertexConstantBuffer_->update(graphics, transform);
+	vertexConstantBuffer_->bind(graphics);
+}
 
-	auto world = parent_.getTransformXm();
+DirectX::XMMATRIX TransformConstantBuffer::getTransform(const Graphics& graphics, const Drawable& drawable) noexcept
+{
+	auto world = drawable.getRenderTransformXm();
 	auto view = graphics.getCamera()->getView();
 	auto proj = graphics.getCamera()->getProjection();
 
@@ -30,14 +59,11 @@ void TransformConstantBuffer::bind(Graphics& graphics) noexcept
 	PLOGD << "Proj: " << p._11 << "," << p._22 << "," << p._33 << "," << p._44;
 #endif
 
-	vertexConstantBuffer_->update(graphics,
-		DirectX::XMMatrixTranspose(
-			world *
-			view *
-			proj
-		)
+	return DirectX::XMMatrixTranspose(
+		world *
+		view *
+		proj
 	);
-	vertexConstantBuffer_->bind(graphics);
 }
 
 std::unique_ptr<VertexConstantBuffer<DirectX::XMMATRIX>> TransformConstantBuffer::vertexConstantBuffer_;
\ No newline at end of file
@@ -18,6 +18,8 @@ public:
 	TransformConstantBuffer& operator=(const TransformConstantBuffer&&) = delete;
 
 	void bind(Graphics& graphics) noexcept override;
+	// The drawable's world-view-projection matrix, transposed for HLSL
+	static DirectX::XMMATRIX getTransform(const Graphics& graphics, const Drawable& drawable) noexcept;
 private:
 	static std::unique_ptr<VertexConstantBuffer<DirectX::XMMATRIX>> vertexConstantBuffer_;
 	const Drawable& parent_;
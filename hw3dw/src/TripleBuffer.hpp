@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+// Single producer, single consumer handoff of whole values without locks. The producer fills back(), publish()
+// swaps it with the shared middle slot; the consumer's acquire() swaps the middle slot with its front() when the
+// producer left something new there. The three slots always belong to exactly one side each, so the producer
+// never waits on the consumer and the consumer always reads the newest complete value.
+template<class T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() = default;
+	~TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+	TripleBuffer(const TripleBuffer&&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&&) = delete;
+
+	// Producer side
+	[[nodiscard]] T& back() noexcept
+	{
+		return slots_[back_];
+	}
+
+	void publish() noexcept
+	{
+		back_ = middle_.exchange(back_ | freshBit, std::memory_order_acq_rel) & indexMask;
+	}
+
+	// Consumer side; returns whether front() changed
+	bool acquire() noexcept
+	{
+		if ((middle_.load(std::memory_order_relaxed) & freshBit) == 0u)
+		{
+			return false;
+		}
+		front_ = middle_.exchange(front_, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+
+	[[nodiscard]] const T& front() const noexcept
+	{
+		return slots_[front_];
+	}
+
+private:
+	static constexpr unsigned int indexMask = 3u;
+	static constexpr unsigned int freshBit = 4u;
+
+	std::array<T, 3> slots_{};
+	// Each side's index on its own cache line, so the hot loops do not invalidate each other
+	alignas(64) unsigned int back_ = 0u;
+	alignas(64) std::atomic<unsigned int> middle_{ 1u };
+	alignas(64) unsigned int front_ = 2u;
+};
@@ -0,0 +1,139 @@
+#include "UploadRing.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+UploadRing::UploadRing(const unsigned int capacity, const unsigned int alignment) noexcept(!IS_DEBUG)
+	:
+	capacity_(capacity),
+	alignment_(alignment)
+{
+	assert("Alignment must be a power of two" && alignment_ != 0u && (alignment_ & (alignment_ - 1u)) == 0u);
+	assert("Capacity must be a multiple of the alignment" && capacity_ % alignment_ == 0u);
+}
+
+unsigned int UploadRing::getCapacityFor(const size_t allocationsPerFrame, const unsigned int size, const unsigned int alignment,
+	const unsigned int framesInFlight) noexcept
+{
+	const unsigned long long alignedSize = (std::max(size, 1u) + alignment - 1ull) & ~(alignment - 1ull);
+	const unsigned long long limit = std::numeric_limits<unsigned int>::max() & ~(alignment - 1ull);
+	const unsigned long long frameBytes = alignedSize * std::max<unsigned long long>(allocationsPerFrame, 1ull);
+	if (frameBytes > limit / std::max(framesInFlight, 1u))
+	{
+		return static_cast<unsigned int>(limit);
+	}
+	return static_cast<unsigned int>(frameBytes * std::max(framesInFlight, 1u));
+}
+
+std::optional<UploadRing::Allocation> UploadRing::allocate(const unsigned int size) noexcept
+{
+	const unsigned int alignedSize = align(std::max(size, 1u));
+	if (alignedSize > capacity_)
+	{
+		return std::nullopt;
+	}
+
+	// Free space is [head, capacity) + [0, tail) while the live region wraps, or [head, tail) once head has wrapped
+	bool discard = false;
+	if (used_ == 0u || head_ > tail_)
+	{
+		if (capacity_ - head_ < alignedSize)
+		{
+			if (used_ != 0u && alignedSize > tail_)
+			{
+				discard = true;
+			}
+			else
+			{
+				// Skip the unusable end of the buffer; those bytes are released with the frame
+				const unsigned int padding = capacity_ - head_;
+				used_ += padding;
+				frameBytes_ += padding;
+				head_ = 0u;
+				statistics_.wraps++;
+			}
+		}
+	}
+	else if (tail_ - head_ < alignedSize)
+	{
+		discard = true;
+	}
+
+	if (discard)
+	{
+		// Everything in flight lives in the orphaned buffer now, so the new one starts empty
+		firstFrame_ = 0u;
+		frameCount_ = 0u;
+		head_ = 0u;
+		tail_ = 0u;
+		used_ = 0u;
+		frameBytes_ = 0u;
+		statistics_.discards++;
+	}
+
+	const Allocation allocation{ head_, alignedSize, discard };
+	head_ += alignedSize;
+	if (head_ == capacity_)
+	{
+		head_ = 0u;
+	}
+	used_ += alignedSize;
+	frameBytes_ += alignedSize;
+
+	statistics_.allocations++;
+	statistics_.peakBytesInFlight = std::max(statistics_.peakBytesInFlight, used_);
+	return allocation;
+}
+
+unsigned long long UploadRing::endFrame() noexcept
+{
+	if (frameBytes_ > 0u)
+	{
+		if (frameCount_ == frames_.size())
+		{
+			// Unrolled so the oldest frame is first, then the free slots are added after the newest
+			std::rotate(frames_.begin(), frames_.begin() + static_cast<std::ptrdiff_t>(firstFrame_), frames_.end());
+			firstFrame_ = 0u;
+			frames_.resize(std::max<size_t>(frames_.size() * 2u, 4u));
+		}
+		frames_[(firstFrame_ + frameCount_) % frames_.size()] = { frameNumber_, head_, frameBytes_ };
+		frameCount_++;
+		frameBytes_ = 0u;
+	}
+	return frameNumber_++;
+}
+
+void UploadRing::retire(const unsigned long long completedFrame) noexcept
+{
+	while (frameCount_ > 0u && frames_[firstFrame_].number <= completedFrame)
+	{
+		tail_ = frames_[firstFrame_].end;
+		used_ -= frames_[firstFrame_].bytes;
+		firstFrame_ = (firstFrame_ + 1u) % frames_.size();
+		frameCount_--;
+	}
+}
+
+unsigned int UploadRing::getCapacity() const noexcept
+{
+	return capacity_;
+}
+
+unsigned int UploadRing::getAlignment() const noexcept
+{
+	return alignment_;
+}
+
+UploadRing::Statistics UploadRing::getStatistics() const noexcept
+{
+	auto statistics = statistics_;
+	statistics.bytesInFlight = used_;
+	statistics.framesInFlight = frameCount_;
+	return statistics;
+}
+
+unsigned int UploadRing::align(const unsigned int value) const noexcept
+{
+	return (value + alignment_ - 1u) & ~(alignment_ - 1u);
+}
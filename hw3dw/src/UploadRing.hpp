@@ -0,0 +1,77 @@
+#pragma once
+#include <optional>
+#include <vector>
+
+// Bookkeeping for a per-frame upload buffer that is sub-allocated front to back and wraps around. Every
+// allocation belongs to the frame that is open when it is made; that frame's bytes only become reusable once
+// the backend reports the frame as completed by the GPU. The ring holds no memory itself, it just hands out
+// offsets, so the same policy drives a D3D buffer or a plain array.
+class UploadRing
+{
+public:
+	struct Allocation
+	{
+		unsigned int offset;
+		unsigned int size;
+		// Set when the ring ran out of retired space; the backend must orphan the buffer (e.g. WRITE_DISCARD)
+		// before writing, after which the allocation starts a fresh, empty ring
+		bool discard;
+	};
+
+	struct Statistics
+	{
+		unsigned long long allocations;
+		unsigned long long discards;
+		unsigned long long wraps;
+		unsigned int bytesInFlight;
+		unsigned int peakBytesInFlight;
+		size_t framesInFlight;
+	};
+
+	UploadRing(unsigned int capacity, unsigned int alignment) noexcept(!IS_DEBUG);
+
+	// Smallest capacity that holds framesInFlight frames of allocationsPerFrame allocations of size bytes, so a
+	// steady load retires space before it needs it and never discards. Saturates at the largest aligned capacity.
+	[[nodiscard]] static unsigned int getCapacityFor(size_t allocationsPerFrame, unsigned int size, unsigned int alignment,
+		unsigned int framesInFlight) noexcept;
+
+	~UploadRing() = default;
+	UploadRing(const UploadRing&) = delete;
+	UploadRing& operator=(const UploadRing&) = delete;
+	UploadRing(const UploadRing&&) = delete;
+	UploadRing& operator=(const UploadRing&&) = delete;
+
+	// Returns nothing if size exceeds the capacity of the whole ring
+	[[nodiscard]] std::optional<Allocation> allocate(unsigned int size) noexcept;
+	// Close the open frame; returns the number the GPU fence for it should carry
+	unsigned long long endFrame() noexcept;
+	// Release the space of every closed frame up to and including completedFrame
+	void retire(unsigned long long completedFrame) noexcept;
+
+	[[nodiscard]] unsigned int getCapacity() const noexcept;
+	[[nodiscard]] unsigned int getAlignment() const noexcept;
+	[[nodiscard]] Statistics getStatistics() const noexcept;
+private:
+	struct Frame
+	{
+		unsigned long long number;
+		unsigned int end;
+		unsigned int bytes;
+	};
+
+	unsigned int align(unsigned int value) const noexcept;
+
+	unsigned int capacity_;
+	unsigned int alignment_;
+	unsigned int head_ = 0u;
+	unsigned int tail_ = 0u;
+	unsigned int used_ = 0u;
+	unsigned int frameBytes_ = 0u;
+	unsigned long long frameNumber_ = 0ull;
+	// Closed frames oldest first, a ring over the vector that only grows with the number of frames in flight; a
+	// deque would free and allocate a block every few dozen frames
+	std::vector<Frame> frames_;
+	size_t firstFrame_ = 0u;
+	size_t frameCount_ = 0u;
+	Statistics statistics_{};
+};
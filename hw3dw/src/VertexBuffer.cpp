@@ -1,5 +1,22 @@
 #include "VertexBuffer.hpp"
 
+VertexBuffer::VertexBuffer(Graphics& graphics, Upload& vertices, const UINT stride)
+	: Bindable(),
+	stride_(stride)
+{
+	MemoryTracker::Scope scope(MemoryTag::Meshes);
+	const D3D11_BUFFER_DESC bufferDesc = {
+		.ByteWidth = static_cast<UINT>(vertices.getSize()),
+		.Usage = D3D11_USAGE::D3D11_USAGE_DEFAULT,
+		.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_VERTEX_BUFFER,
+		.CPUAccessFlags = 0u,
+		.MiscFlags = 0u,
+		.StructureByteStride = stride,
+	};
+
+	vertexBuffer_ = createBuffer(vertices, bufferDesc);
+}
+
 void VertexBuffer::bind(Graphics& graphics) noexcept
 {
 	constexpr UINT offset = 0u;
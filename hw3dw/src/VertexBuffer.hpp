@@ -2,15 +2,17 @@
 
 #include "Bindable.hpp"
 #include "GraphicsThrowMacros.hpp"
+#include "MemoryTracker.hpp"
 
 class VertexBuffer : public Bindable
 {
 public:
-	template<class Vertex>
-	VertexBuffer(Graphics& graphics, const std::vector<Vertex>& vertices)
+	template<class Vertex, class Allocator>
+	VertexBuffer(Graphics& graphics, const std::vector<Vertex, Allocator>& vertices)
 		: Bindable(),
 		stride_(sizeof(Vertex))
 	{
+		MemoryTracker::Scope scope(MemoryTag::Meshes);
 		INFOMAN(graphics);
 
 		const D3D11_BUFFER_DESC bufferDesc = {
@@ -31,6 +33,9 @@ public:
 		GFX_THROW_INFO(getDevice(graphics)->CreateBuffer(&bufferDesc, &subresourceData, &vertexBuffer_));
 	}
 
+	// Take over vertices generated straight into an upload, stride bytes apart
+	VertexBuffer(Graphics& graphics, Upload& vertices, UINT stride);
+
 	VertexBuffer() = delete;
 	~VertexBuffer() override = default;
 	VertexBuffer(const VertexBuffer&) = delete;
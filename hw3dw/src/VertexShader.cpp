@@ -1,17 +1,12 @@
 #include "VertexShader.hpp"
-#include "Logging.hpp"
+#include "ShaderLibrary.hpp"
 
-#include <d3dcompiler.h>
-
-#include "GraphicsThrowMacros.hpp"
-
-VertexShader::VertexShader(Graphics& graphics, const std::wstring& path)
+VertexShader::VertexShader(Graphics& graphics, const std::wstring& path, const std::vector<ShaderCache::Define>& defines)
 {
-	INFOMAN(graphics);
-
-	PLOGD << "D3DReadFileToBlob(\"" << path.c_str() << "\", [bytecodeBlob_]));";
-	GFX_THROW_INFO(D3DReadFileToBlob(path.c_str(), &bytecodeBlob_));
-	GFX_THROW_INFO(getDevice(graphics)->CreateVertexShader(bytecodeBlob_->GetBufferPointer(), bytecodeBlob_->GetBufferSize(), nullptr, &vertexShader_));
+	// Shared with every other VertexShader built from the same path and defines
+	const auto& [bytecode, shader] = ShaderLibrary::getVertexShader(graphics, path, defines);
+	bytecodeBlob_ = bytecode;
+	vertexShader_ = shader;
 }
 
 void VertexShader::bind(Graphics& graphics) noexcept
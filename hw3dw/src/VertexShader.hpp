@@ -1,10 +1,11 @@
 #pragma once
 #include "Bindable.hpp"
+#include "ShaderCache.hpp"
 
 class VertexShader : public Bindable
 {
 public:
-	VertexShader(Graphics& graphics, const std::wstring& path);
+	VertexShader(Graphics& graphics, const std::wstring& path, const std::vector<ShaderCache::Define>& defines = {});
 
 	~VertexShader() override = default;
 	VertexShader(const VertexShader&) = delete;
@@ -1,21 +1,28 @@
 #pragma once
-#include <string>
-#include <unordered_map>
+#include <cstddef>
+#include <span>
+#include <string_view>
 
+#if defined(_WIN32)
 #include "AtumWindows.hpp"
+#endif
 
+// Names of the virtual key codes, a constant table indexed by the code
 class VirtualKeyMap
 {
 public:
-	VirtualKeyMap();
+	// Room for the longest name, terminator included
+	static constexpr size_t bufferSize = 48u;
 
+	constexpr VirtualKeyMap() noexcept = default;
 	~VirtualKeyMap() = default;
 	VirtualKeyMap(const VirtualKeyMap&) = delete;
 	VirtualKeyMap& operator=(const VirtualKeyMap&) = delete;
 	VirtualKeyMap(const VirtualKeyMap&&) = delete;
 	VirtualKeyMap& operator=(const VirtualKeyMap&&) = delete;
 
-	std::string operator()(unsigned char virtualKeyCode) const;
-private:
-	const std::unordered_map<DWORD, std::string> map_;
+	// The first name listed for the code, empty when it has none
+	[[nodiscard]] static std::string_view name(unsigned char virtualKeyCode) noexcept;
+	// Write the name into buffer and return it
+	const char* operator()(std::span<char, bufferSize> buffer, unsigned char virtualKeyCode) const noexcept;
 };
@@ -3,8 +3,11 @@
 #include <iostream>
 #include <tchar.h>
 #include <cwctype>
+#include <algorithm>
+#include <optional>
 
 #include "App.hpp"
+#include "HeadlessReplay.hpp"
 #include "Logging.hpp"
 
 #define WAIT_FOR_DEBUGGER FALSE
@@ -41,6 +44,9 @@ int APIENTRY WinMain(
 	}
 #endif
 
+	// Headless runs report failures through the log and the exit code instead of a message box
+	bool headless = false;
+
 	try
 	{
 		g_rootInstance = hInstance;
@@ -53,6 +59,12 @@ int APIENTRY WinMain(
 		std::wstring commandLine(lpCommandLine, lpCommandLine + strlen(lpCommandLine));
 		std::vector<std::wstring> args = splitCommandLine(&commandLine[0]);
 
+		// --binary-log <file> writes the BLOG sites to a file for hw3dlog instead of formatting them
+		if (const auto flag = std::find(args.begin(), args.end(), L"--binary-log"); flag != args.end() && flag + 1 != args.end())
+		{
+			Logging::initializeBinaryLogger(*(flag + 1), LOG_LEVEL_BINARY);
+		}
+
 		bool allowConsoleLogging = false;
 
 #if (IS_DEBUG)
@@ -78,7 +90,30 @@ int APIENTRY WinMain(
 		}
 #endif
 
-		App app(allowConsoleLogging);
+		// --regression <directory> [options] renders the golden image and timing suite without showing the window
+		std::optional<RegressionSuite::Options> regression;
+		if (const auto flag = std::find(args.begin(), args.end(), L"--regression"); flag != args.end())
+		{
+			regression = RegressionSuite::parseArguments(std::vector<std::wstring>(flag + 1, args.end()));
+			headless = true;
+		}
+
+		// --replay <file> on its own runs a recording through the simulation alone, without a window or device
+		if (const auto flag = std::find(args.begin(), args.end(), L"--replay"); !regression && flag != args.end() && flag + 1 != args.end())
+		{
+			headless = true;
+			HeadlessReplay replay(*(flag + 1));
+			return replay.run();
+		}
+
+		// --record <file> writes the session's seed, frame times and input for a later --replay
+		std::filesystem::path recording;
+		if (const auto flag = std::find(args.begin(), args.end(), L"--record"); flag != args.end() && flag + 1 != args.end())
+		{
+			recording = *(flag + 1);
+		}
+
+		App app(allowConsoleLogging, std::move(regression), recording);
 		PLOGI << "Running App";
 		return app.run();
 
@@ -87,15 +122,27 @@ int APIENTRY WinMain(
 	//BUGBUG : Should be using MessageBox and adjusting text based on target encoding. Currently assuming ASCII to match output of Exception.what().
 	catch (const AtumException& e) {
 		PLOGF << e.getType() << ":" << "\n" << e.what();
-		MessageBoxA(nullptr, e.what(), e.getType(), MB_OK | MB_ICONEXCLAMATION);
+		Logging::flush();
+		if (!headless)
+		{
+			MessageBoxA(nullptr, e.what(), e.getType(), MB_OK | MB_ICONEXCLAMATION);
+		}
 	}
 	catch (const std::exception& e) {
 		PLOGF << "Standard Exception:" << "\n" << e.what();
-		MessageBoxA(nullptr, e.what(), "Standard Exception", MB_OK | MB_ICONEXCLAMATION);
+		Logging::flush();
+		if (!headless)
+		{
+			MessageBoxA(nullptr, e.what(), "Standard Exception", MB_OK | MB_ICONEXCLAMATION);
+		}
 	}
 	catch (...) {
 		PLOGF << "Unknown Exception:" << "\n" << "No further details about the exception are available.";
-		MessageBox(nullptr, TEXT("No details available"), TEXT("Unknown Exception"), MB_OK | MB_ICONEXCLAMATION);
+		Logging::flush();
+		if (!headless)
+		{
+			MessageBox(nullptr, TEXT("No details available"), TEXT("Unknown Exception"), MB_OK | MB_ICONEXCLAMATION);
+		}
 	}
 
 	return -1;
@@ -90,7 +90,8 @@ LRESULT Window::ImGui::WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
 {
 	if (!IsImGuiReady()) { return 1; }
 #ifdef LOG_WINDOW_MESSAGES
-	PLOGV << windowsMessageMap(msg, lParam, wParam).c_str();
+	char message[WindowsMessageMap::bufferSize];
+	PLOGV << windowsMessageMap(message, msg, lParam, wParam);
 #endif
 #ifdef LOG_GRAPHICS_MESSAGES
 	PLOGV << "ImGui_ImplWin32_WndProcHandler";
@@ -270,11 +271,11 @@ Mouse& Window::getMouse() const noexcept { return *mouse_.get(); }
 Keyboard& Window::getKeyboard() const noexcept { return *keyboard_.get(); }
 
 // Window Management
-void Window::create(void* createParams)
+void Window::create(void* createParams, const bool visible, const D3D_DRIVER_TYPE driverType)
 {
 	// createWindow will call CreateWindowEx(..., createParams) which triggers WM_NCCREATE.
 	// The setup thunk stores the createParams (expected to be WndContext*) into GWLP_USERDATA.
-	auto* wndHnd = createWindow(createParams);
+	auto* wndHnd = createWindow(createParams, visible);
 	App::setMainWindowHandle(wndHnd);
 
 	// After CreateWindowEx returns, WM_NCCREATE should have run and GWLP_USERDATA contains the WndContext*
@@ -282,7 +283,7 @@ void Window::create(void* createParams)
 		ctx->windowPtr = this;
 	}
 
-	graphics_ = std::make_unique<Graphics>(windowHandle_, width_, height_);
+	graphics_ = std::make_unique<Graphics>(windowHandle_, width_, height_, driverType);
 
 	// Check for an error
 	if (!graphics_)
@@ -340,7 +341,7 @@ void Window::setPosition(const int x, const int y)
 Window::WindowDimensions Window::getTargetDimensions()
 {
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "getTargetDimensions() : width: " << targetWidth_ << ", height: " << targetHeight_ << "";
+	BLOGV("getTargetDimensions() : width: {}, height: {}", targetWidth_, targetHeight_);
 #endif
 	return { targetWidth_, targetHeight_ };
 }
@@ -348,7 +349,7 @@ Window::WindowDimensions Window::getTargetDimensions()
 void Window::setTargetDimensions(const unsigned int width, const unsigned int height)
 {
 #ifdef LOG_GRAPHICS_CALLS
-	PLOGV << "setTargetDimensions(width: " << width << ", height: " << height << ");";
+	BLOGV("setTargetDimensions(width: {}, height: {});", width, height);
 #endif
 	targetWidth_ = width;
 	targetHeight_ = height;
@@ -437,7 +438,7 @@ HINSTANCE Window::WindowClass::getInstance() const noexcept
 }
 
 // Window Management
-HWND Window::createWindow(void* createParams)
+HWND Window::createWindow(void* createParams, const bool visible)
 {
 	// ReSharper disable once CppInitializedValueIsAlwaysRewritten
 	RECT rect = { 100, 100, 100 + width_, 100 + height_ };
@@ -472,10 +473,13 @@ HWND Window::createWindow(void* createParams)
 
 	ctx->windowPtr = windowHandle_;
 
-	// Newly created windows start off as hidden
-	PLOGI << "Show the Window";
-	ShowWindow(windowHandle_, SW_SHOWDEFAULT);
-	UpdateWindow(windowHandle_);
+	// Newly created windows start off as hidden; headless runs keep it that way
+	if (visible)
+	{
+		PLOGI << "Show the Window";
+		ShowWindow(windowHandle_, SW_SHOWDEFAULT);
+		UpdateWindow(windowHandle_);
+	}
 
 	return windowHandle_;
 }
@@ -484,7 +488,8 @@ HWND Window::createWindow(void* createParams)
 LRESULT CALLBACK Window::WndProcHandlerSetup(const HWND hWnd, const UINT msg, const WPARAM wParam, const LPARAM lParam) noexcept
 {
 #ifdef LOG_WINDOW_MESSAGES // defined in LoggingConfig.h
-	PLOGV << windowsMessageMap(msg, lParam, wParam).c_str();
+	char message[WindowsMessageMap::bufferSize];
+	PLOGV << windowsMessageMap(message, msg, lParam, wParam);
 #endif
 
 	if (msg == WM_NCCREATE)
@@ -64,7 +64,7 @@ public:
     Keyboard& getKeyboard() const noexcept;
 
     // Window Management
-    void create(void* createParams);
+    void create(void* createParams, bool visible = true, D3D_DRIVER_TYPE driverType = D3D_DRIVER_TYPE_HARDWARE);
     void setTitle(const std::wstring& title) const;
     HWND setActive(HWND window) const;
 
@@ -126,7 +126,7 @@ private:
     };
 
     // Window Management
-    HWND createWindow(void* createParams);
+    HWND createWindow(void* createParams, bool visible);
 
     // Message Handlers
     static LRESULT CALLBACK WndProcHandlerSetup(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
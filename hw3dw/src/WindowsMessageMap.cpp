@@ -1,16 +1,24 @@
 #include "WindowsMessageMap.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <format>
-#include <iomanip>
-#include <sstream>
-#include <string>
+#include <type_traits>
 
-#define ALLMESSAGES FALSE
-#define ALLMOUSEMESSAGES ALLMESSAGES | TRUE
+#define ALLMESSAGES 0
+#define ALLMOUSEMESSAGES (ALLMESSAGES | 1)
 
-WindowsMessageMap::WindowsMessageMap()
-	:
-	map_({
+namespace
+{
+	struct Entry
+	{
+		DWORD msg;
+		std::string_view name;
+	};
+
+	// Sorted by value; where a value has several names the first one listed is used
+	constexpr Entry messages[] = {
 		{ 0x0,"WM_NULL" },
 		{ 0x1,"WM_CREATE" },
 		{ 0x2,"WM_DESTROY" },
@@ -1123,27 +1131,51 @@ WindowsMessageMap::WindowsMessageMap()
 #if ALLMESSAGES
 		{0xCCCD,"WM_RASDIALEVENT"},
 #endif // ALLMESSAGES
-		})
-{}
+	};
 
-std::string WindowsMessageMap::operator()(const DWORD msg, const LPARAM lParam, const WPARAM wParam) const
-{
-	constexpr int firstColWidth = 28;
-	const auto it = map_.find(msg);
+	static_assert(std::is_sorted(std::begin(messages), std::end(messages), [](const Entry& a, const Entry& b) { return a.msg < b.msg; }),
+		"Window messages must stay sorted by value");
+
+	// The window messages proper, everything below WM_USER, by index
+	constexpr DWORD directCount = 0x400u;
+	constexpr auto directNames = []
+		{
+			std::array<std::string_view, directCount> names{};
+			for (auto it = std::rbegin(messages); it != std::rend(messages); ++it)
+			{
+				if (it->msg < directCount)
+				{
+					names[it->msg] = it->name;
+				}
+			}
+			return names;
+		}();
 
-	std::ostringstream out;
-	if (it != map_.end())
+	template<class T>
+	std::uint64_t hex(const T value) noexcept
 	{
-		out << std::setw(firstColWidth) << std::left << it->second;
+		// Negative parameters print as their bits, the way the stream formatting did
+		return static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
 	}
-	else
+}
+
+std::string_view WindowsMessageMap::name(const DWORD msg) noexcept
+{
+	if (msg < directCount)
 	{
-		out << std::setw(static_cast<std::streamsize>(firstColWidth) - 8) << std::left << " Unknown message: 0x"
-			<< std::setw(8) << std::right << std::setfill('0') << std::hex << msg;
+		return directNames[msg];
 	}
+	const auto it = std::lower_bound(std::begin(messages), std::end(messages), msg, [](const Entry& entry, const DWORD value) { return entry.msg < value; });
+	return it != std::end(messages) && it->msg == msg ? it->name : std::string_view();
+}
 
-	out << "  LP: 0x" << std::setw(16) << std::setfill('0') << std::hex << lParam
-		<< "  WP: 0x" << std::setw(16) << std::setfill('0') << std::hex << wParam;
-
-	return out.str();
+const char* WindowsMessageMap::operator()(const std::span<char, bufferSize> buffer, const DWORD msg, const LPARAM lParam, const WPARAM wParam) const noexcept
+{
+	constexpr size_t capacity = bufferSize - 1u;
+	const std::string_view messageName = name(msg);
+	const auto result = messageName.empty()
+		? std::format_to_n(buffer.data(), capacity, " Unknown message: 0x{:08x}  LP: 0x{:016x}  WP: 0x{:016x}", msg, hex(lParam), hex(wParam))
+		: std::format_to_n(buffer.data(), capacity, "{:<28}  LP: 0x{:016x}  WP: 0x{:016x}", messageName, hex(lParam), hex(wParam));
+	*result.out = '\0';
+	return buffer.data();
 }
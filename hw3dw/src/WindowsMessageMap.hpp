@@ -1,14 +1,29 @@
 #pragma once
-#include <string>
-#include <unordered_map>
+#include <cstddef>
+#include <span>
+#include <string_view>
 
+#if defined(_WIN32)
 #include "AtumWindows.hpp"
+#else
+#include <cstdint>
+// The message parameter types, so the table builds for the Linux benchmark
+using DWORD = unsigned long;
+using LPARAM = std::intptr_t;
+using WPARAM = std::uintptr_t;
+#endif
 
+// Names of window messages for the message logging. The table is a constant sorted by value: the messages below
+// WM_USER are looked up by index, the control messages above it by binary search, and nothing is built at
+// startup. The line is formatted into a buffer on the caller's stack.
 class WindowsMessageMap
 {
 public:
-	WindowsMessageMap();
-	std::string operator()(DWORD msg, LPARAM lParam, WPARAM wParam) const;
-private:
-	const std::unordered_map<DWORD, std::string> map_;
+	// Room for the longest line, terminator included
+	static constexpr size_t bufferSize = 96u;
+
+	// The first name listed for the message, empty when it has none
+	[[nodiscard]] static std::string_view name(DWORD msg) noexcept;
+	// Format the message into buffer and return it
+	const char* operator()(std::span<char, bufferSize> buffer, DWORD msg, LPARAM lParam, WPARAM wParam) const noexcept;
 };
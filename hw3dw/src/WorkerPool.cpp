@@ -0,0 +1,119 @@
+#include "WorkerPool.hpp"
+
+#include "CpuMetric.hpp"
+
+WorkerPool::WorkerPool(const size_t threadCount)
+{
+	threads_.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		threads_.emplace_back(&WorkerPool::workerLoop, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard lock(mutex_);
+		stop_ = true;
+	}
+	startCondition_.notify_all();
+	for (auto& thread : threads_)
+	{
+		thread.join();
+	}
+}
+
+void WorkerPool::run(const size_t count, const std::function<void(size_t)>& job)
+{
+	if (count == 0u)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock(mutex_);
+		job_ = &job;
+		count_ = count;
+		next_ = 0u;
+		remaining_ = count;
+		error_ = nullptr;
+		batch_++;
+	}
+	startCondition_.notify_all();
+
+	drain();
+
+	std::unique_lock lock(mutex_);
+	doneCondition_.wait(lock, [this] { return remaining_ == 0u; });
+	job_ = nullptr;
+	if (error_)
+	{
+		std::rethrow_exception(std::exchange(error_, nullptr));
+	}
+}
+
+size_t WorkerPool::getThreadCount() const noexcept
+{
+	return threads_.size();
+}
+
+void WorkerPool::workerLoop()
+{
+	CpuMetric::nameCurrentThread("Worker");
+	unsigned long long seen = 0ull;
+	while (true)
+	{
+		{
+			std::unique_lock lock(mutex_);
+			startCondition_.wait(lock, [this, seen] { return stop_ || batch_ != seen; });
+			if (stop_)
+			{
+				return;
+			}
+			seen = batch_;
+		}
+		drain();
+	}
+}
+
+void WorkerPool::drain()
+{
+	while (true)
+	{
+		size_t index;
+		const std::function<void(size_t)>* job;
+		{
+			std::lock_guard lock(mutex_);
+			if (job_ == nullptr || next_ == count_)
+			{
+				return;
+			}
+			index = next_++;
+			job = job_;
+		}
+
+		try
+		{
+			(*job)(index);
+		}
+		catch (...)
+		{
+			std::lock_guard lock(mutex_);
+			if (!error_)
+			{
+				error_ = std::current_exception();
+			}
+		}
+
+		bool finished;
+		{
+			std::lock_guard lock(mutex_);
+			finished = --remaining_ == 0u;
+		}
+		if (finished)
+		{
+			doneCondition_.notify_all();
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed set of threads that fan a batch of indexed jobs out and wait for all of them. The calling thread
+// works on the batch too, so a pool of N threads runs up to N + 1 jobs at once.
+class WorkerPool
+{
+public:
+	explicit WorkerPool(size_t threadCount);
+	~WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+	WorkerPool(const WorkerPool&&) = delete;
+	WorkerPool& operator=(const WorkerPool&&) = delete;
+
+	// Call job(i) for every i in [0, count) and return once they have all finished. The first exception thrown
+	// by a job is rethrown here.
+	void run(size_t count, const std::function<void(size_t)>& job);
+
+	[[nodiscard]] size_t getThreadCount() const noexcept;
+private:
+	void workerLoop();
+	void drain();
+
+	std::vector<std::thread> threads_;
+	std::mutex mutex_;
+	std::condition_variable startCondition_;
+	std::condition_variable doneCondition_;
+	const std::function<void(size_t)>* job_ = nullptr;
+	size_t count_ = 0u;
+	size_t next_ = 0u;
+	size_t remaining_ = 0u;
+	unsigned long long batch_ = 0ull;
+	std::exception_ptr error_;
+	bool stop_ = false;
+};
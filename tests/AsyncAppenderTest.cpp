@@ -0,0 +1,166 @@
+#include "AsyncAppender.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	using namespace std::chrono_literals;
+
+	// A logger of its own, so the records go through plog's macros the way the application's do
+	constexpr int instanceId = 1;
+	constexpr unsigned int producers = 4u;
+	constexpr unsigned int recordsPerProducer = 20000u;
+
+	// Messages run from one block to several, so records wrap around the end of a small queue
+	std::string padding(const unsigned int sequence)
+	{
+		return std::string(sequence % 300u, static_cast<char>('a' + sequence % 26u));
+	}
+
+	void produce(const unsigned int producer)
+	{
+		for (unsigned int sequence = 0u; sequence < recordsPerProducer; sequence++)
+		{
+			PLOG_(instanceId, plog::info) << producer << ' ' << sequence << ' ' << padding(sequence);
+		}
+	}
+
+	// Reads each record back into its producer and sequence, and counts any that come torn, late or with a gap
+	// before them
+	class CheckingSink : public AsyncAppender::Sink
+	{
+	public:
+		CheckingSink()
+			:
+			Sink(plog::verbose),
+			next_(producers, 0u),
+			tids_(producers, 0u)
+		{}
+
+		void write(const std::span<const AsyncAppender::Entry> entries) noexcept override
+		{
+			for (const AsyncAppender::Entry& entry : entries)
+			{
+				if (std::string_view(entry.func) == "AsyncAppender")
+				{
+					dropNotes++;
+					continue;
+				}
+				received++;
+				unsigned int producer = 0u;
+				unsigned int sequence = 0u;
+				const std::string_view message(entry.message);
+				const char* end = message.data() + message.size();
+				const auto [afterProducer, producerError] = std::from_chars(message.data(), end, producer);
+				const auto [afterSequence, sequenceError] = producerError == std::errc() && afterProducer != end
+					? std::from_chars(afterProducer + 1, end, sequence)
+					: std::from_chars_result{ afterProducer, std::errc::invalid_argument };
+				if (sequenceError != std::errc() || producer >= producers || entry.severity != plog::info
+					|| std::string_view(afterSequence, end) != " " + padding(sequence))
+				{
+					corrupt++;
+					continue;
+				}
+				// Every record from one producer comes from the same thread, after the one before it
+				if (tids_[producer] == 0u)
+				{
+					tids_[producer] = entry.tid;
+				}
+				wrongThread += entry.tid != tids_[producer] ? 1u : 0u;
+				outOfOrder += sequence < next_[producer] ? 1u : 0u;
+				skipped += sequence - std::min(sequence, next_[producer]);
+				next_[producer] = sequence + 1u;
+			}
+		}
+
+		[[nodiscard]] unsigned int getNext(const unsigned int producer) const noexcept
+		{
+			return next_[producer];
+		}
+
+		unsigned long long received = 0ull;
+		unsigned long long corrupt = 0ull;
+		unsigned long long outOfOrder = 0ull;
+		unsigned long long skipped = 0ull;
+		unsigned long long wrongThread = 0ull;
+		unsigned long long dropNotes = 0ull;
+	private:
+		std::vector<unsigned int> next_;
+		std::vector<unsigned int> tids_;
+	};
+
+	void run(AsyncAppender& appender)
+	{
+		plog::Logger<instanceId> logger(plog::verbose);
+		logger.addAppender(&appender);
+		std::vector<std::thread> threads;
+		for (unsigned int producer = 0u; producer < producers; producer++)
+		{
+			threads.emplace_back(produce, producer);
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	// Producers racing for a queue far smaller than what they write wait for room, and every record reaches the
+	// sink once, whole and in its producer's order
+	void testBlocking()
+	{
+		CheckingSink sink;
+		AsyncAppender appender({ .blocks = 64u, .overflow = AsyncAppender::OverflowPolicy::BLOCK, .interval = 1ms });
+		appender.addSink(sink);
+		run(appender);
+		CHECK(appender.flush(10s));
+
+		constexpr unsigned long long total = static_cast<unsigned long long>(producers) * recordsPerProducer;
+		CHECK(sink.received == total);
+		CHECK(sink.corrupt == 0u && sink.outOfOrder == 0u && sink.skipped == 0u && sink.wrongThread == 0u);
+		CHECK(sink.dropNotes == 0u);
+		for (unsigned int producer = 0u; producer < producers; producer++)
+		{
+			CHECK(sink.getNext(producer) == recordsPerProducer);
+		}
+		const AsyncAppender::Statistics statistics = appender.getStatistics();
+		CHECK(statistics.written == total && statistics.dropped == 0u);
+		CHECK(statistics.peakBlocks <= 64u);
+		appender.removeSink(sink);
+	}
+
+	// Dropping keeps each producer's order too; what arrives and what was counted dropped add up to what was
+	// logged, and the sink is told about the drops
+	void testDropping()
+	{
+		CheckingSink sink;
+		AsyncAppender appender({ .blocks = 16u, .overflow = AsyncAppender::OverflowPolicy::DROP, .interval = 1ms });
+		appender.addSink(sink);
+		run(appender);
+		CHECK(appender.flush(10s));
+
+		constexpr unsigned long long total = static_cast<unsigned long long>(producers) * recordsPerProducer;
+		const AsyncAppender::Statistics statistics = appender.getStatistics();
+		CHECK(sink.corrupt == 0u && sink.outOfOrder == 0u && sink.wrongThread == 0u);
+		CHECK(sink.received == statistics.written);
+		CHECK(sink.received + statistics.dropped == total);
+		CHECK(sink.skipped <= statistics.dropped);
+		CHECK(statistics.waited == 0u);
+		CHECK(statistics.dropped == 0u || sink.dropNotes > 0u);
+		appender.removeSink(sink);
+	}
+}
+
+int main()
+{
+	testBlocking();
+	testDropping();
+	return checkResult("AsyncAppenderTest");
+}
@@ -0,0 +1,201 @@
+#include "BinaryLog.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "LogDecoder.hpp"
+#include "Logging.hpp"
+
+namespace
+{
+	constexpr unsigned int threads = 4u;
+	constexpr unsigned int recordsPerThread = 1000u;
+
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "BinaryLogTest.blog";
+
+	std::vector<std::byte> readFile()
+	{
+		std::ifstream input(path, std::ios::binary);
+		const std::vector<char> contents{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+		std::vector<std::byte> bytes(contents.size());
+		std::memcpy(bytes.data(), contents.data(), contents.size());
+		return bytes;
+	}
+
+	std::vector<std::string> decodeLines(const LogDecoder& decoder)
+	{
+		std::ostringstream output;
+		CHECK(decoder.write(output) == 0u);
+		std::vector<std::string> lines;
+		std::istringstream input(output.str());
+		for (std::string line; std::getline(input, line);)
+		{
+			lines.push_back(line);
+		}
+		return lines;
+	}
+
+	// Offsets of the records in a closed log, in the order they were reserved
+	std::vector<size_t> recordOffsets(const std::vector<std::byte>& log)
+	{
+		BinaryLogFormat::FileHeader file;
+		std::memcpy(&file, log.data(), sizeof(file));
+		std::vector<size_t> offsets;
+		for (size_t offset = file.headerSize; offset < file.headerSize + file.usedBytes;)
+		{
+			offsets.push_back(offset);
+			std::uint32_t length;
+			std::memcpy(&length, log.data() + offset, sizeof(length));
+			offset += length;
+		}
+		return offsets;
+	}
+
+	// Writes a log from one thread then several, closes it, and leaves it in the file
+	void writeLog()
+	{
+		BinaryLog log(path, 1u << 20u, plog::debug);
+		BinaryLog::set(&log);
+		BLOGI("start {} threads, pi {} str '{}' ptr {} bool {} char {} braces {{}} u64 {}", threads, 3.14159f, "hello",
+			reinterpret_cast<const void*>(0x1234), true, 'x', std::numeric_limits<std::uint64_t>::max());
+		const std::string text = "dyn";
+		BLOGD("string {} view {}", text, std::string_view("sv"));
+		BLOGD("no args at all");
+		// Past the log's severity, so neither the site nor the event is written
+		BLOGV("filtered {}", 1);
+		BLOGE("error {} {}", -5, 2.5);
+
+		std::vector<std::thread> workers;
+		for (unsigned int thread = 0u; thread < threads; thread++)
+		{
+			workers.emplace_back([thread]
+				{
+					for (unsigned int i = 0u; i < recordsPerThread; i++)
+					{
+						BLOGD("DrawIndexed( {}, 0u, 0u) thread {}", i, thread);
+					}
+				});
+		}
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+		const BinaryLog::Statistics statistics = log.getStatistics();
+		CHECK(statistics.sites == 5u && statistics.dropped == 0u);
+		log.close();
+		CHECK(BinaryLog::get() == nullptr);
+	}
+
+	// Every site and event comes back, with the text the same site would have logged through plog
+	void testRoundTrip()
+	{
+		writeLog();
+		const std::vector<std::byte> log = readFile();
+		const LogDecoder decoder(log);
+		CHECK(decoder.getResult() == LogDecoder::Result::OK);
+		CHECK(decoder.getSites().size() == 5u);
+		CHECK(decoder.getEvents().size() == 4u + threads * recordsPerThread);
+		CHECK(decoder.getIncomplete() == 0u);
+
+		const std::vector<std::string> lines = decodeLines(decoder);
+		CHECK(lines.size() == decoder.getEvents().size());
+		CHECK(lines.size() >= 4u);
+		if (lines.size() >= 4u)
+		{
+			CHECK(lines[0].find(" INFO  [") != std::string::npos);
+			CHECK(lines[0].ends_with("] start 4 threads, pi 3.14159 str 'hello' ptr 0x0000000000001234 bool true char x braces {} u64 18446744073709551615"));
+			CHECK(lines[1].find(" DEBUG [") != std::string::npos && lines[1].ends_with("] string dyn view sv"));
+			CHECK(lines[2].ends_with("] no args at all"));
+			CHECK(lines[3].find(" ERROR [") != std::string::npos && lines[3].ends_with("] error -5 2.5"));
+			CHECK(lines[3].ends_with(BinaryLogFormat::format("error {} {}", -5, 2.5)));
+		}
+
+		// Each thread's records come back in its own order
+		std::vector<unsigned int> next(threads, 0u);
+		unsigned int outOfOrder = 0u;
+		for (size_t i = 4u; i < lines.size(); i++)
+		{
+			unsigned int index = 0u;
+			unsigned int thread = 0u;
+			const size_t message = lines[i].rfind("] DrawIndexed( ");
+			if (message == std::string::npos
+				|| std::sscanf(lines[i].c_str() + message, "] DrawIndexed( %u, 0u, 0u) thread %u", &index, &thread) != 2
+				|| thread >= threads)
+			{
+				outOfOrder++;
+				continue;
+			}
+			outOfOrder += index == next[thread] ? 0u : 1u;
+			next[thread] = index + 1u;
+		}
+		CHECK(outOfOrder == 0u);
+		CHECK((next == std::vector<unsigned int>(threads, recordsPerThread)));
+
+		CHECK(LogDecoder(std::span(log).first(sizeof(BinaryLogFormat::FileHeader) - 1u)).getResult() == LogDecoder::Result::TOO_SHORT);
+		std::vector<std::byte> wrongVersion = log;
+		wrongVersion[offsetof(BinaryLogFormat::FileHeader, version)] = std::byte{ 0x7f };
+		CHECK(LogDecoder(wrongVersion).getResult() == LogDecoder::Result::WRONG_VERSION);
+	}
+
+	// A thread that claimed room and died before writing the length leaves zeros in the middle of the log. The
+	// decoder counts the gap once and carries on with the records after it; the zeros past the end of a log that
+	// was never closed are not a gap.
+	void testNeverSized()
+	{
+		writeLog();
+		const std::vector<std::byte> log = readFile();
+		const LogDecoder whole(log);
+		const std::vector<size_t> offsets = recordOffsets(log);
+		CHECK(offsets.size() == 5u + 4u + threads * recordsPerThread);
+
+		// Room for a record of five words, after the first site and its event
+		constexpr size_t gap = 40u;
+		std::vector<std::byte> withGap(log.begin(), log.begin() + static_cast<std::ptrdiff_t>(offsets[2]));
+		withGap.resize(withGap.size() + gap);
+		withGap.insert(withGap.end(), log.begin() + static_cast<std::ptrdiff_t>(offsets[2]), log.end());
+		BinaryLogFormat::FileHeader file;
+		std::memcpy(&file, withGap.data(), sizeof(file));
+		file.usedBytes += gap;
+		std::memcpy(withGap.data(), &file, sizeof(file));
+
+		const LogDecoder skipped(withGap);
+		CHECK(skipped.getResult() == LogDecoder::Result::OK);
+		CHECK(skipped.getIncomplete() == 1u);
+		CHECK(skipped.getSites().size() == whole.getSites().size());
+		CHECK(skipped.getEvents().size() == whole.getEvents().size());
+		CHECK(decodeLines(skipped) == decodeLines(whole));
+
+		// The process died instead of closing the log: no used size, and the rest of the file still zeros
+		file.usedBytes = 0u;
+		std::memcpy(withGap.data(), &file, sizeof(file));
+		withGap.resize(withGap.size() + 4096u);
+		const LogDecoder crashed(withGap);
+		CHECK(crashed.getIncomplete() == 1u);
+		CHECK(crashed.getEvents().size() == whole.getEvents().size());
+
+		// A record that was sized and filled in but never tagged is skipped on its own
+		std::vector<std::byte> untagged = log;
+		const std::uint32_t zero = 0u;
+		std::memcpy(untagged.data() + offsets.back() + offsetof(BinaryLogFormat::RecordHeader, tag), &zero, sizeof(zero));
+		const LogDecoder partial(untagged);
+		CHECK(partial.getIncomplete() == 1u);
+		CHECK(partial.getEvents().size() == whole.getEvents().size() - 1u);
+	}
+}
+
+int main()
+{
+	testRoundTrip();
+	testNeverSized();
+	std::filesystem::remove(path);
+	return checkResult("BinaryLogTest");
+}
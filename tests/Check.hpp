@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdio>
+
+// Minimal checks for the test programs: a failed CHECK is reported and counted, and main returns the result
+// of checkResult() so make check stops at the first failing program.
+inline int& checkFailures() noexcept
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			checkFailures()++; \
+		} \
+	} while (false)
+
+inline int checkResult(const char* name) noexcept
+{
+	if (checkFailures() != 0)
+	{
+		std::fprintf(stderr, "%s: %d check(s) failed\n", name, checkFailures());
+		return 1;
+	}
+	std::printf("%s: ok\n", name);
+	return 0;
+}
@@ -0,0 +1,105 @@
+#include "CpuMetric.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <sys/mman.h>
+
+#include "Check.hpp"
+
+namespace
+{
+	std::atomic<bool> stop = false;
+
+	// Like the logging thread, names itself while static objects are still being built
+	struct EarlyThread
+	{
+		EarlyThread()
+			:
+			thread([] { CpuMetric::nameCurrentThread("Early"); while (!stop) { std::this_thread::sleep_for(std::chrono::milliseconds(10)); } })
+		{}
+
+		std::thread thread;
+	} early;
+
+	const CpuMetric::ThreadUsage* find(const CpuMetric::Sample& sample, const char* name)
+	{
+		for (const auto& thread : sample.threads)
+		{
+			if (thread.name == name)
+			{
+				return &thread;
+			}
+		}
+		return nullptr;
+	}
+}
+
+int main()
+{
+	std::thread busy([] { CpuMetric::nameCurrentThread("Busy"); volatile unsigned long spins = 0u; while (!stop) { spins = spins + 1u; } });
+	std::thread sleeper([] { CpuMetric::nameCurrentThread("Sleeper"); while (!stop) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); } });
+	// Touches fresh pages so it takes minor faults
+	std::thread toucher([]
+		{
+			CpuMetric::nameCurrentThread("Toucher");
+			constexpr size_t size = 1u << 22u;
+			while (!stop)
+			{
+				auto* pages = static_cast<char*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+				for (size_t i = 0u; i < size; i += 4096u)
+				{
+					pages[i] = 1;
+				}
+				munmap(pages, size);
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			}
+		});
+	std::thread unnamed([] { while (!stop) { std::this_thread::sleep_for(std::chrono::milliseconds(50)); } });
+
+	CpuMetric cpu(std::chrono::milliseconds(300));
+	cpu.initialize();
+	for (int window = 0; window < 2; window++)
+	{
+		const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(310);
+		while (std::chrono::steady_clock::now() < end)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(16));
+			cpu.frame();
+		}
+
+		const CpuMetric::Sample& sample = cpu.getSample();
+		CHECK(sample.windowSeconds >= 0.3);
+		CHECK(sample.frames > 0u);
+		CHECK(sample.processors >= 1u);
+		CHECK(sample.process.voluntarySwitches.has_value());
+		CHECK(sample.process.pageFaults.has_value());
+		CHECK(sample.threads.size() == 6u);
+
+		const auto* busyUsage = find(sample, "Busy");
+		const auto* sleeperUsage = find(sample, "Sleeper");
+		const auto* toucherUsage = find(sample, "Toucher");
+		CHECK(busyUsage && sleeperUsage && toucherUsage);
+		CHECK(find(sample, "Early"));
+		// The thread that called initialize() is Main, the unnamed one keeps the name the system gave it
+		CHECK(find(sample, "Main"));
+		if (!busyUsage || !sleeperUsage || !toucherUsage)
+		{
+			continue;
+		}
+		CHECK(sample.threads.front().name == "Busy");
+		CHECK(busyUsage->utilization > 0.5);
+		CHECK(sleeperUsage->utilization < 0.2);
+		CHECK(sleeperUsage->voluntarySwitches.value_or(0u) > 50u);
+		CHECK(toucherUsage->pageFaults.value_or(0u) > 1000u);
+		CHECK(cpu.getCpuPercentage() > 0.0);
+	}
+
+	stop = true;
+	busy.join();
+	sleeper.join();
+	toucher.join();
+	unnamed.join();
+	early.thread.join();
+	return checkResult("CpuMetricTest");
+}
@@ -0,0 +1,189 @@
+#include "EventRing.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	// Three words, so a copy racing a write could mix two events; every field is derived from the sequence
+	struct Event
+	{
+		std::uint32_t sequence;
+		std::uint32_t fields[5];
+
+		static Event make(const std::uint32_t sequence) noexcept
+		{
+			Event event{ sequence, {} };
+			for (std::uint32_t i = 0; i < 5u; i++)
+			{
+				event.fields[i] = sequence * 2654435761u + i;
+			}
+			return event;
+		}
+
+		[[nodiscard]] bool isWhole() const noexcept
+		{
+			for (std::uint32_t i = 0; i < 5u; i++)
+			{
+				if (fields[i] != sequence * 2654435761u + i)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	void testFifo()
+	{
+		EventRing<Event, 8u> ring;
+		CHECK(ring.isEmpty() && ring.size() == 0u && !ring.pop());
+		for (std::uint32_t i = 0; i < 5u; i++)
+		{
+			ring.push(Event::make(i));
+		}
+		CHECK(ring.size() == 5u);
+		for (std::uint32_t i = 0; i < 5u; i++)
+		{
+			const auto event = ring.pop();
+			CHECK(event && event->sequence == i && event->isWhole());
+		}
+		CHECK(ring.isEmpty() && !ring.pop());
+
+		// Wrapping around the slots many times keeps the order
+		std::uint32_t next = 0u;
+		for (std::uint32_t i = 0; i < 100u; i++)
+		{
+			ring.push(Event::make(i));
+			if (i % 3u == 2u)
+			{
+				while (const auto event = ring.pop())
+				{
+					CHECK(event->sequence == next++);
+				}
+			}
+		}
+		while (const auto event = ring.pop())
+		{
+			CHECK(event->sequence == next++);
+		}
+		CHECK(next == 100u && ring.getOverwritten() == 0u);
+	}
+
+	// A full ring drops its oldest events, and the consumer counts them when it gets there
+	void testOverwrite()
+	{
+		EventRing<Event, 8u> ring;
+		for (std::uint32_t i = 0; i < 13u; i++)
+		{
+			ring.push(Event::make(i));
+		}
+		CHECK(ring.size() == 8u);
+		const auto first = ring.pop();
+		CHECK(first && first->sequence == 5u);
+		CHECK(ring.getOverwritten() == 5u);
+		for (std::uint32_t i = 6u; i < 13u; i++)
+		{
+			CHECK(ring.pop()->sequence == i);
+		}
+		CHECK(ring.isEmpty());
+
+		// Lapping the ring several times drops everything but the last Capacity events
+		for (std::uint32_t i = 0; i < 30u; i++)
+		{
+			ring.push(Event::make(100u + i));
+		}
+		std::vector<std::uint32_t> drained;
+		CHECK(ring.drain([&drained](const Event& event) { drained.push_back(event.sequence); }) == 8u);
+		CHECK(drained.size() == 8u && drained.front() == 122u && drained.back() == 129u);
+		CHECK(ring.getOverwritten() == 5u + 22u);
+	}
+
+	void testDrainAndClear()
+	{
+		EventRing<char, 4u> ring;
+		ring.push('a');
+		ring.push('b');
+		ring.push('c');
+		CHECK(ring.pop() == 'a');
+		std::vector<char> drained;
+		CHECK(ring.drain([&drained](const char c) { drained.push_back(c); }) == 2u);
+		CHECK((drained == std::vector<char>{ 'b', 'c' }));
+		CHECK(ring.isEmpty() && ring.drain([](char) {}) == 0u);
+
+		ring.push('d');
+		ring.push('e');
+		ring.clear();
+		CHECK(ring.isEmpty() && !ring.pop());
+		ring.push('f');
+		CHECK(ring.pop() == 'f');
+		CHECK(ring.getOverwritten() == 0u);
+	}
+
+	// The window thread pushes while the frame pops and drains. Every event the consumer gets is whole and newer
+	// than the one before it, and with the ones it was told were overwritten they account for every push.
+	void testTwoThreads()
+	{
+		constexpr std::uint32_t count = 1000000u;
+		EventRing<Event, 64u> ring;
+		std::atomic<bool> done{ false };
+		std::thread producer([&ring, &done]
+			{
+				for (std::uint32_t i = 1u; i <= count; i++)
+				{
+					ring.push(Event::make(i));
+				}
+				done.store(true, std::memory_order_release);
+			});
+
+		unsigned long long received = 0ull;
+		unsigned long long torn = 0ull;
+		unsigned long long outOfOrder = 0ull;
+		std::uint32_t last = 0u;
+		const auto take = [&](const Event& event)
+			{
+				received++;
+				torn += event.isWhole() ? 0u : 1u;
+				outOfOrder += event.sequence > last ? 0u : 1u;
+				last = event.sequence;
+			};
+		for (unsigned int round = 0u; ; round++)
+		{
+			const bool finished = done.load(std::memory_order_acquire);
+			if (round % 2u == 0u)
+			{
+				while (const auto event = ring.pop())
+				{
+					take(*event);
+				}
+			}
+			else
+			{
+				ring.drain(take);
+			}
+			if (finished)
+			{
+				break;
+			}
+		}
+		producer.join();
+
+		CHECK(torn == 0u);
+		CHECK(outOfOrder == 0u);
+		CHECK(last == count);
+		CHECK(received + ring.getOverwritten() == count);
+	}
+}
+
+int main()
+{
+	testFifo();
+	testOverwrite();
+	testDrainAndClear();
+	testTwoThreads();
+	return checkResult("EventRingTest");
+}
@@ -0,0 +1,149 @@
+#include "FixedTimestep.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "AppConfig.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	constexpr float tickRate = static_cast<float>(SIMULATION_TICK_RATE);
+	constexpr double step = 1.0 / SIMULATION_TICK_RATE;
+
+	// Stands in for the frame clock: frames are timestamps on a timeline the test moves by hand, and each
+	// frame hands the accumulator the time since the previous one, as App::doFrame does
+	class ManualClock
+	{
+	public:
+		void advance(const double seconds) noexcept
+		{
+			now_ += seconds;
+		}
+
+		[[nodiscard]] float lap() noexcept
+		{
+			const auto elapsed = static_cast<float>(now_ - last_);
+			last_ = now_;
+			return elapsed;
+		}
+	private:
+		double now_ = 0.0;
+		double last_ = 0.0;
+	};
+
+	bool near(const double a, const double b, const double tolerance = 1.0e-4) noexcept
+	{
+		return std::abs(a - b) <= tolerance;
+	}
+
+	// A hitch longer than the cap runs MAX_TICKS_PER_FRAME ticks, drops the whole ticks beyond them and keeps the
+	// fraction, so the next normal frame is back to one tick
+	void testClamp()
+	{
+		FixedTimestep timestep(tickRate, MAX_TICKS_PER_FRAME);
+		ManualClock clock;
+		clock.advance(1.0 + 0.5 * step);
+		CHECK(timestep.advance(clock.lap()) == MAX_TICKS_PER_FRAME);
+		CHECK(timestep.getTickCount() == MAX_TICKS_PER_FRAME);
+		CHECK(near(timestep.getAlpha(), 0.5));
+		CHECK(near(timestep.getDroppedSeconds(), 1.0 - MAX_TICKS_PER_FRAME * step, 1.0e-6));
+
+		clock.advance(step);
+		CHECK(timestep.advance(clock.lap()) == 1u);
+		CHECK(near(timestep.getAlpha(), 0.5));
+		CHECK(near(timestep.getDroppedSeconds(), 1.0 - MAX_TICKS_PER_FRAME * step, 1.0e-6));
+
+		// Exactly the cap fits without dropping anything
+		FixedTimestep exact(tickRate, MAX_TICKS_PER_FRAME);
+		CHECK(exact.advance(static_cast<float>((MAX_TICKS_PER_FRAME + 0.25) * step)) == MAX_TICKS_PER_FRAME);
+		CHECK(exact.getDroppedSeconds() == 0.0);
+		CHECK(near(exact.getAlpha(), 0.25));
+
+		// Negative frame times from a clock going backwards add nothing
+		FixedTimestep backwards(tickRate, MAX_TICKS_PER_FRAME);
+		CHECK(backwards.advance(-1.0f) == 0u);
+		CHECK(backwards.getAlpha() == 0.0f);
+	}
+
+	// Between ticks alpha is the leftover time over the step; with frames shorter than a tick it ramps up and
+	// wraps each time a tick runs, always inside [0, 1]
+	void testAlpha()
+	{
+		FixedTimestep timestep(tickRate, MAX_TICKS_PER_FRAME);
+		ManualClock clock;
+		clock.advance(0.25 * step);
+		CHECK(timestep.advance(clock.lap()) == 0u);
+		CHECK(near(timestep.getAlpha(), 0.25));
+		clock.advance(0.5 * step);
+		CHECK(timestep.advance(clock.lap()) == 0u);
+		CHECK(near(timestep.getAlpha(), 0.75));
+		clock.advance(0.5 * step);
+		CHECK(timestep.advance(clock.lap()) == 1u);
+		CHECK(near(timestep.getAlpha(), 0.25));
+
+		// A quarter-rate frame time: four frames a tick, alpha stepping by a quarter
+		FixedTimestep slow(tickRate, MAX_TICKS_PER_FRAME);
+		unsigned int ticks = 0u;
+		unsigned int wraps = 0u;
+		float previous = 0.0f;
+		for (int frame = 0; frame < 400; frame++)
+		{
+			clock.advance(0.2499 * step);
+			ticks += slow.advance(clock.lap());
+			const float alpha = slow.getAlpha();
+			CHECK(alpha >= 0.0f && alpha <= 1.0f);
+			wraps += alpha < previous ? 1u : 0u;
+			previous = alpha;
+		}
+		CHECK(ticks == 99u && wraps == ticks);
+	}
+
+	// Whatever the frame times, the same ticks run with the same step, so the simulated state only depends on
+	// how many ticks ran
+	void testFrameRateIndependence()
+	{
+		std::mt19937 rng(3u);
+		std::uniform_real_distribution<double> jitter(0.001, 0.05);
+		std::vector<double> results;
+		for (int pattern = 0; pattern < 3; pattern++)
+		{
+			FixedTimestep timestep(tickRate, MAX_TICKS_PER_FRAME);
+			ManualClock clock;
+			float angle = 0.0f;
+			while (timestep.getTickCount() < 3000u)
+			{
+				clock.advance(pattern == 0 ? step : pattern == 1 ? step / 2.3 : jitter(rng));
+				const unsigned int ticks = timestep.advance(clock.lap());
+				CHECK(ticks <= MAX_TICKS_PER_FRAME);
+				for (unsigned int i = 0; i < ticks && timestep.getTickCount() - ticks + i < 3000u; i++)
+				{
+					angle += 1.7f * timestep.getStep();
+				}
+			}
+			results.push_back(angle);
+		}
+		CHECK(results[0] == results[1] && results[0] == results[2]);
+	}
+
+	// Without a tick rate each frame is one tick of its own duration and nothing is interpolated
+	void testVariableStep()
+	{
+		FixedTimestep timestep(0.0f, MAX_TICKS_PER_FRAME);
+		CHECK(timestep.advance(0.02f) == 1u);
+		CHECK(timestep.getStep() == 0.02f);
+		CHECK(timestep.getAlpha() == 1.0f);
+		CHECK(timestep.advance(2.0f) == 1u);
+		CHECK(timestep.getStep() == 2.0f && timestep.getDroppedSeconds() == 0.0);
+	}
+}
+
+int main()
+{
+	testClamp();
+	testAlpha();
+	testFrameRateIndependence();
+	testVariableStep();
+	return checkResult("FixedTimestepTest");
+}
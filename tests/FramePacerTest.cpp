@@ -0,0 +1,180 @@
+#include "FramePacer.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "Check.hpp"
+
+namespace
+{
+	using namespace std::chrono_literals;
+	using clock = FramePacer::clock;
+
+	// Time only passes when the pacer sleeps or yields, or the test does frame work. Sleeps wake late by a
+	// random overshoot, as the OS scheduler makes them; a yield costs a couple of microseconds.
+	class SimulatedClock
+	{
+	public:
+		SimulatedClock(const double overshootMicroseconds, const double overshootSpread)
+			:
+			overshoot_(overshootMicroseconds - overshootSpread, overshootMicroseconds + overshootSpread)
+		{}
+
+		FramePacer::TimeSource makeTimeSource()
+		{
+			return {
+				[this] { return now_; },
+				[this](const std::chrono::duration<double, std::micro> duration)
+				{
+					const auto slept = std::chrono::duration_cast<clock::duration>(duration + std::chrono::duration<double, std::micro>(overshoot_(rng_)));
+					now_ += slept;
+					sleeps++;
+					sleptFor += slept;
+				},
+				[this]
+				{
+					now_ += yieldCost;
+					yields++;
+				}
+			};
+		}
+
+		void work(const clock::duration duration) noexcept
+		{
+			now_ += duration;
+		}
+
+		[[nodiscard]] clock::time_point now() const noexcept
+		{
+			return now_;
+		}
+
+		static constexpr clock::duration yieldCost = 2us;
+		unsigned long long sleeps = 0ull;
+		unsigned long long yields = 0ull;
+		clock::duration sleptFor{};
+	private:
+		clock::time_point now_ = clock::time_point{} + 1h;
+		std::mt19937 rng_{ 5u };
+		std::uniform_real_distribution<double> overshoot_;
+	};
+
+	double microseconds(const clock::duration duration) noexcept
+	{
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+
+	// At 60 Hz with 3ms of frame work every wake lands on its deadline, one period after the last, and the
+	// timeline does not drift over a thousand frames
+	void testDeadlines()
+	{
+		SimulatedClock time(300.0, 100.0);
+		FramePacer pacer(60.0, time.makeTimeSource());
+		const double period = 1.0e6 / 60.0;
+
+		pacer.wait();
+		const clock::time_point start = time.now();
+		for (int frame = 0; frame < 1000; frame++)
+		{
+			time.work(3ms);
+			pacer.wait();
+		}
+		const auto statistics = pacer.getStatistics();
+		CHECK(statistics.frames == 1001u && statistics.missedDeadlines == 0u);
+		CHECK(statistics.maxErrorMicroseconds < microseconds(SimulatedClock::yieldCost));
+		CHECK(std::abs(statistics.meanIntervalMicroseconds - period) < 0.01);
+		CHECK(statistics.intervalJitterMicroseconds < microseconds(SimulatedClock::yieldCost));
+		CHECK(std::abs(microseconds(time.now() - start) - 1000.0 * period) < microseconds(SimulatedClock::yieldCost));
+	}
+
+	// The pacer learns how late sleeps wake, sleeps away all but that margin and spins only for the rest, and
+	// never sleeps past a deadline once it has learned
+	void testSleepAndSpin()
+	{
+		SimulatedClock time(300.0, 100.0);
+		FramePacer pacer(60.0, time.makeTimeSource());
+		pacer.wait();
+		for (int frame = 0; frame < 100; frame++)
+		{
+			time.work(3ms);
+			pacer.wait();
+		}
+		const double overshoot = pacer.getStatistics().sleepOvershootMicroseconds;
+		CHECK(overshoot > 250.0 && overshoot < 350.0);
+
+		time.sleeps = 0ull;
+		time.yields = 0ull;
+		time.sleptFor = {};
+		pacer.resetStatistics();
+		constexpr int frames = 500;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			time.work(3ms);
+			pacer.wait();
+		}
+		const auto statistics = pacer.getStatistics();
+		CHECK(statistics.maxErrorMicroseconds < microseconds(SimulatedClock::yieldCost));
+		// 13.7ms to wait each frame, in slices of at most a millisecond that each wake about 0.3ms late, stopping a
+		// margin of the overshoot plus two deviations short of the deadline
+		const double waited = (1.0e6 / 60.0 - 3000.0) * frames;
+		const double spun = static_cast<double>(time.yields) * microseconds(SimulatedClock::yieldCost);
+		CHECK(time.sleeps >= 9u * frames && time.sleeps <= 12u * frames);
+		CHECK(microseconds(time.sleptFor) > 0.95 * waited);
+		CHECK(spun / frames > 200.0 && spun / frames < 800.0);
+	}
+
+	// A frame longer than the period misses its deadline without waiting, and the timeline restarts from it
+	// rather than owing the frames it missed
+	void testMissedDeadline()
+	{
+		SimulatedClock time(300.0, 100.0);
+		FramePacer pacer(60.0, time.makeTimeSource());
+		pacer.wait();
+		time.work(3ms);
+		pacer.wait();
+
+		time.work(50ms);
+		const clock::time_point late = time.now();
+		const unsigned long long sleeps = time.sleeps;
+		const unsigned long long yields = time.yields;
+		pacer.wait();
+		CHECK(pacer.getStatistics().missedDeadlines == 1u);
+		CHECK(time.now() == late && time.sleeps == sleeps && time.yields == yields);
+
+		time.work(3ms);
+		pacer.wait();
+		CHECK(std::abs(microseconds(time.now() - late) - 1.0e6 / 60.0) < microseconds(SimulatedClock::yieldCost));
+		CHECK(pacer.getStatistics().missedDeadlines == 1u);
+	}
+
+	// Without a target rate the pacer never waits, but still measures the intervals
+	void testUnpaced()
+	{
+		SimulatedClock time(300.0, 100.0);
+		FramePacer pacer(0.0, time.makeTimeSource());
+		for (int frame = 0; frame < 10; frame++)
+		{
+			time.work(5ms);
+			pacer.wait();
+		}
+		CHECK(time.sleeps == 0u && time.yields == 0u);
+		CHECK(std::abs(pacer.getStatistics().meanIntervalMicroseconds - 5000.0) < 0.01);
+
+		pacer.setTargetRate(144.0);
+		CHECK(std::abs(pacer.getTargetRate() - 144.0) < 1.0e-3);
+		pacer.wait();
+		time.work(1ms);
+		pacer.wait();
+		CHECK(time.sleeps > 0u);
+	}
+}
+
+int main()
+{
+	testDeadlines();
+	testSleepAndSpin();
+	testMissedDeadline();
+	testUnpaced();
+	return checkResult("FramePacerTest");
+}
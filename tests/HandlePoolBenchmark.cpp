@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "HandlePool.hpp"
+
+// The per-instance bind walk of a frame, before and after the pools. Each drawable has a vertex buffer, an index
+// buffer, a texture and a transform. The baseline gives every bind a heap allocation of its own, reached
+// through the drawable's vector of unique_ptrs and bound through the vtable, with the rest of scene loading
+// allocating in between. The pooled side keeps the same objects in per-type HandlePools, reached through an
+// inline handle array and bound with a qualified call after switching on the kind, as BindSet does.
+
+namespace
+{
+	struct State
+	{
+		std::uint64_t hash = 0xCBF29CE484222325ull;
+
+		void fold(const std::uint64_t value) noexcept
+		{
+			hash = (hash ^ value) * 0x100000001B3ull;
+		}
+	};
+
+	class Bindable
+	{
+	public:
+		virtual ~Bindable() = default;
+		virtual void bind(State& state) const noexcept = 0;
+	};
+
+	// Roughly the size of the real binds: a COM pointer, a count or stride and a little bookkeeping
+	class VertexBufferBind : public Bindable
+	{
+	public:
+		explicit VertexBufferBind(const std::uint64_t id)
+			:
+			id_(id), stride_(32u + id % 3u * 16u)
+		{}
+		void bind(State& state) const noexcept override
+		{
+			state.fold(id_ * 3u + stride_);
+		}
+	private:
+		std::uint64_t id_;
+		std::uint32_t stride_;
+	};
+
+	class IndexBufferBind : public Bindable
+	{
+	public:
+		explicit IndexBufferBind(const std::uint64_t id)
+			:
+			id_(id), count_(36u + id % 7u)
+		{}
+		void bind(State& state) const noexcept override
+		{
+			state.fold(id_ * 5u + count_);
+		}
+	private:
+		std::uint64_t id_;
+		std::uint32_t count_;
+	};
+
+	class TextureBind : public Bindable
+	{
+	public:
+		explicit TextureBind(const std::uint64_t id)
+			:
+			id_(id), slot_(static_cast<std::uint32_t>(id % 2u))
+		{}
+		void bind(State& state) const noexcept override
+		{
+			state.fold(id_ * 7u + slot_);
+		}
+	private:
+		std::uint64_t id_;
+		std::uint32_t slot_;
+	};
+
+	class TransformBind : public Bindable
+	{
+	public:
+		explicit TransformBind(const std::uint64_t id)
+			:
+			id_(id)
+		{}
+		void bind(State& state) const noexcept override
+		{
+			state.fold(id_ * 11u);
+		}
+	private:
+		std::uint64_t id_;
+		float cached_[16]{};
+	};
+
+	enum class Kind : std::uint8_t
+	{
+		VertexBuffer,
+		IndexBuffer,
+		Texture,
+		Transform,
+	};
+
+	struct Entry
+	{
+		Kind kind;
+		PoolHandle handle;
+	};
+
+	struct PooledDrawable
+	{
+		std::array<Entry, 4> entries;
+	};
+
+	struct Pools
+	{
+		HandlePool<VertexBufferBind> vertexBuffers;
+		HandlePool<IndexBufferBind> indexBuffers;
+		HandlePool<TextureBind> textures;
+		HandlePool<TransformBind> transforms;
+	};
+
+	void bind(const Pools& pools, const PooledDrawable& drawable, State& state) noexcept
+	{
+		for (const auto& [kind, handle] : drawable.entries)
+		{
+			switch (kind)
+			{
+			case Kind::VertexBuffer:
+				pools.vertexBuffers[handle].VertexBufferBind::bind(state);
+				break;
+			case Kind::IndexBuffer:
+				pools.indexBuffers[handle].IndexBufferBind::bind(state);
+				break;
+			case Kind::Texture:
+				pools.textures[handle].TextureBind::bind(state);
+				break;
+			case Kind::Transform:
+				pools.transforms[handle].TransformBind::bind(state);
+				break;
+			}
+		}
+	}
+
+	template<class F>
+	double milliseconds(F&& work)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		work();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const size_t drawableCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000u;
+	const int frames = argc > 2 ? std::atoi(argv[2]) : 50;
+
+	// Scene loading allocates meshes, names and the like between the binds
+	std::mt19937 rng(1u);
+	std::vector<std::string> clutter;
+	clutter.reserve(drawableCount * 2u);
+	std::vector<std::vector<std::unique_ptr<Bindable>>> heapDrawables(drawableCount);
+	const double heapBuild = milliseconds([&]
+		{
+			for (size_t i = 0; i < drawableCount; i++)
+			{
+				auto& binds = heapDrawables[i];
+				binds.push_back(std::make_unique<VertexBufferBind>(i));
+				clutter.emplace_back(16u + rng() % 200u, 'v');
+				binds.push_back(std::make_unique<IndexBufferBind>(i));
+				binds.push_back(std::make_unique<TextureBind>(i));
+				clutter.emplace_back(16u + rng() % 200u, 'n');
+				binds.push_back(std::make_unique<TransformBind>(i));
+			}
+		});
+
+	Pools pools;
+	std::vector<PooledDrawable> pooledDrawables(drawableCount);
+	const double poolBuild = milliseconds([&]
+		{
+			for (size_t i = 0; i < drawableCount; i++)
+			{
+				pooledDrawables[i].entries = { {
+					{ Kind::VertexBuffer, pools.vertexBuffers.emplace(i) },
+					{ Kind::IndexBuffer, pools.indexBuffers.emplace(i) },
+					{ Kind::Texture, pools.textures.emplace(i) },
+					{ Kind::Transform, pools.transforms.emplace(i) },
+				} };
+			}
+		});
+
+	// The render queue sorts by material and depth, so draws rarely come in the order the drawables were made
+	std::vector<size_t> creationOrder(drawableCount);
+	std::iota(creationOrder.begin(), creationOrder.end(), size_t{ 0u });
+	std::vector<size_t> queueOrder = creationOrder;
+	std::shuffle(queueOrder.begin(), queueOrder.end(), rng);
+
+	std::printf("HandlePoolBenchmark: %zu drawables, 4 binds each, %d frames\n", drawableCount, frames);
+	std::printf("  creating the binds      %8.2f ms heap, %8.2f ms pools\n", heapBuild, poolBuild);
+	for (const auto* order : { &creationOrder, &queueOrder })
+	{
+		State heapState;
+		const double heap = milliseconds([&]
+			{
+				for (int frame = 0; frame < frames; frame++)
+				{
+					for (const size_t i : *order)
+					{
+						for (const auto& bindable : heapDrawables[i])
+						{
+							bindable->bind(heapState);
+						}
+					}
+				}
+			}) / frames;
+		State poolState;
+		const double pooled = milliseconds([&]
+			{
+				for (int frame = 0; frame < frames; frame++)
+				{
+					for (const size_t i : *order)
+					{
+						bind(pools, pooledDrawables[i], poolState);
+					}
+				}
+			}) / frames;
+		if (heapState.hash != poolState.hash)
+		{
+			std::fprintf(stderr, "the two walks bound different state\n");
+			return 1;
+		}
+		std::printf("  walk, %s order  %8.3f ms heap, %8.3f ms pools  %.2fx\n", order == &creationOrder ? "creation" : "queue   ",
+			heap, pooled, heap / pooled);
+	}
+
+	// Replacing every tenth drawable's binds, as a scene that streams objects in and out does
+	const double heapChurn = milliseconds([&]
+		{
+			for (size_t i = 0; i < drawableCount; i += 10u)
+			{
+				heapDrawables[i].clear();
+				heapDrawables[i].push_back(std::make_unique<VertexBufferBind>(i));
+				heapDrawables[i].push_back(std::make_unique<IndexBufferBind>(i));
+				heapDrawables[i].push_back(std::make_unique<TextureBind>(i));
+				heapDrawables[i].push_back(std::make_unique<TransformBind>(i));
+			}
+		});
+	const double poolChurn = milliseconds([&]
+		{
+			for (size_t i = 0; i < drawableCount; i += 10u)
+			{
+				auto& entries = pooledDrawables[i].entries;
+				pools.vertexBuffers.erase(entries[0].handle);
+				pools.indexBuffers.erase(entries[1].handle);
+				pools.textures.erase(entries[2].handle);
+				pools.transforms.erase(entries[3].handle);
+				entries[0].handle = pools.vertexBuffers.emplace(i);
+				entries[1].handle = pools.indexBuffers.emplace(i);
+				entries[2].handle = pools.textures.emplace(i);
+				entries[3].handle = pools.transforms.emplace(i);
+			}
+		});
+	std::printf("  replacing 10%%           %8.2f ms heap, %8.2f ms pools\n", heapChurn, poolChurn);
+	return 0;
+}
@@ -0,0 +1,162 @@
+#include "HandlePool.hpp"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	// Neither copyable nor movable, like the Bindables the pools hold; a negative value throws from the constructor
+	struct Pinned
+	{
+		static inline int alive = 0;
+		int value;
+
+		explicit Pinned(const int initial)
+			:
+			value(initial)
+		{
+			if (initial < 0)
+			{
+				throw initial;
+			}
+			alive++;
+		}
+		~Pinned()
+		{
+			alive--;
+		}
+		Pinned(const Pinned&) = delete;
+		Pinned& operator=(const Pinned&) = delete;
+		Pinned(const Pinned&&) = delete;
+		Pinned& operator=(const Pinned&&) = delete;
+	};
+
+	// A handle to an erased object is rejected, and so is it once the slot has been reused
+	void testStaleHandles()
+	{
+		HandlePool<Pinned, 4u> pool;
+		const PoolHandle first = pool.emplace(1);
+		const PoolHandle second = pool.emplace(2);
+		CHECK(pool.contains(first) && pool.contains(second));
+		CHECK(pool[first].value == 1 && pool[second].value == 2);
+
+		pool.erase(first);
+		CHECK(!pool.contains(first));
+		CHECK(pool.contains(second));
+
+		const PoolHandle reused = pool.emplace(3);
+		CHECK(reused.getIndex() == first.getIndex());
+		CHECK(reused.getGeneration() != first.getGeneration());
+		CHECK(!pool.contains(first));
+		CHECK(pool.contains(reused) && pool[reused].value == 3);
+
+		CHECK(!pool.contains(PoolHandle{}));
+		CHECK(!pool.contains(PoolHandle{ (first.getGeneration() << PoolHandle::indexBits) | 100u }));
+	}
+
+	// Reusing one slot walks through every generation but the one that could make the null handle, and no two
+	// handles in a row are the same
+	void testGenerationWrap()
+	{
+		HandlePool<Pinned, 4u> pool;
+		PoolHandle handle = pool.emplace(0);
+		std::vector<bool> seen(256u, false);
+		for (int i = 1; i < 600; i++)
+		{
+			seen[handle.getGeneration()] = true;
+			pool.erase(handle);
+			const PoolHandle next = pool.emplace(i);
+			CHECK(next.getIndex() == handle.getIndex());
+			CHECK(next.getGeneration() != handle.getGeneration());
+			CHECK(!next.isNull() && next.getGeneration() != 0xFFu);
+			CHECK(!pool.contains(handle));
+			handle = next;
+		}
+		size_t generations = 0u;
+		for (const bool used : seen)
+		{
+			generations += used ? 1u : 0u;
+		}
+		CHECK(generations == 255u && !seen[0xFFu]);
+	}
+
+	// Random emplaces and erases against a map of what should be live: live handles resolve to their values,
+	// every erased handle whose slot was reused is rejected
+	void testChurn()
+	{
+		{
+			HandlePool<Pinned, 16u> pool;
+			std::map<std::uint32_t, int> live;
+			std::vector<PoolHandle> erased;
+			std::vector<const Pinned*> addresses;
+			std::mt19937 rng(1u);
+			for (int i = 0; i < 100000; i++)
+			{
+				if (rng() % 3u != 0u || live.empty())
+				{
+					const int value = static_cast<int>(rng() % 1000u);
+					const PoolHandle handle = pool.emplace(value);
+					CHECK(!live.contains(handle.value));
+					live[handle.value] = value;
+				}
+				else
+				{
+					auto it = live.begin();
+					std::advance(it, rng() % live.size());
+					const PoolHandle handle{ it->first };
+					CHECK(pool[handle].value == it->second);
+					pool.erase(handle);
+					erased.push_back(handle);
+					live.erase(it);
+				}
+			}
+
+			for (const auto& [value, expected] : live)
+			{
+				CHECK(pool.contains(PoolHandle{ value }) && pool[PoolHandle{ value }].value == expected);
+				addresses.push_back(&pool[PoolHandle{ value }]);
+			}
+			for (const PoolHandle handle : erased)
+			{
+				CHECK(live.contains(handle.value) || !pool.contains(handle));
+			}
+			CHECK(pool.size() == live.size());
+			CHECK(Pinned::alive == static_cast<int>(live.size()));
+
+			// A throwing constructor gives its slot back, and growing the pool leaves live objects where they were
+			bool threw = false;
+			try
+			{
+				pool.emplace(-1);
+			}
+			catch (int)
+			{
+				threw = true;
+			}
+			CHECK(threw && pool.size() == live.size());
+			for (int i = 0; i < 1000; i++)
+			{
+				pool.emplace(i);
+			}
+			size_t index = 0u;
+			for (const auto& entry : live)
+			{
+				CHECK(&pool[PoolHandle{ entry.first }] == addresses[index++]);
+			}
+		}
+		// The pool destroys whatever is still live
+		CHECK(Pinned::alive == 0);
+	}
+}
+
+int main()
+{
+	testStaleHandles();
+	testGenerationWrap();
+	testChurn();
+	return checkResult("HandlePoolTest");
+}
@@ -0,0 +1,143 @@
+#include "InputLatency.hpp"
+
+#include <chrono>
+#include <cmath>
+
+#include "Check.hpp"
+
+namespace
+{
+	using namespace std::chrono_literals;
+	using clock = InputLatency::clock;
+
+	// Every time point comes from this timeline instead of the system clock, so each sample is exact
+	const clock::time_point origin = clock::time_point{} + 1h;
+
+	clock::time_point at(const std::chrono::duration<double, std::milli> offset)
+	{
+		return origin + std::chrono::duration_cast<clock::duration>(offset);
+	}
+
+	bool near(const double a, const double b) noexcept
+	{
+		return std::abs(a - b) < 1.0e-6;
+	}
+
+	// One frame with one input, presented latency milliseconds after it
+	void addSample(InputLatency& latency, const double start, const double milliseconds)
+	{
+		latency.input(at(std::chrono::duration<double, std::milli>(start)));
+		latency.beginFrame();
+		latency.present(at(std::chrono::duration<double, std::milli>(start + milliseconds)));
+	}
+
+	// Fifty samples at 0.5, 1.5 ... 49.5ms: percentiles are the upper bucket edges of the nearest rank sample
+	void testPercentiles()
+	{
+		InputLatency latency;
+		for (int i = 0; i < 50; i++)
+		{
+			addSample(latency, i * 100.0, i + 0.5);
+		}
+		const auto statistics = latency.getStatistics();
+		CHECK(statistics.samples == 50u && statistics.inputs == 50u);
+		CHECK(near(statistics.meanMilliseconds, 25.0));
+		CHECK(near(statistics.minMilliseconds, 0.5) && near(statistics.maxMilliseconds, 49.5));
+		// Ranks 25, 47 and 49 of 50
+		CHECK(statistics.p50Milliseconds == 25.0);
+		CHECK(statistics.p95Milliseconds == 47.0);
+		CHECK(statistics.p99Milliseconds == 49.0);
+		for (size_t bucket = 0; bucket < InputLatency::bucketCount; bucket++)
+		{
+			CHECK(latency.getHistogram()[bucket] == (bucket < 50u ? 1u : 0u));
+		}
+
+		// A slow tail lands in the overflow bucket, which reports the slowest sample
+		for (int i = 0; i < 50; i++)
+		{
+			addSample(latency, 10000.0 + i * 100.0, i < 48 ? 10.2 : 80.0 + i);
+		}
+		const auto tail = latency.getStatistics();
+		CHECK(tail.samples == 100u);
+		CHECK(latency.getHistogram()[InputLatency::bucketCount - 1u] == 2u);
+		CHECK(latency.getHistogram()[10] == 49u);
+		CHECK(tail.p50Milliseconds == 11.0);
+		CHECK(tail.p95Milliseconds == 47.0);
+		CHECK(near(tail.p99Milliseconds, 129.0) && near(tail.maxMilliseconds, 129.0));
+
+		latency.reset();
+		const auto empty = latency.getStatistics();
+		CHECK(empty.samples == 0u && empty.p50Milliseconds == 0.0 && empty.p99Milliseconds == 0.0);
+	}
+
+	// A frame's sample runs from its oldest input; frames without input add nothing; a pipelined loop presents a
+	// frame later than it began it, and frames that never present are dropped once too many are open
+	void testFrames()
+	{
+		InputLatency latency;
+		latency.input(at(5ms));
+		latency.input(at(2ms), 3u);
+		latency.input(at(9ms));
+		latency.beginFrame();
+		latency.beginFrame();
+		latency.input(at(20ms));
+		latency.beginFrame();
+		latency.present(at(30ms));
+		latency.present(at(46ms));
+		latency.present(at(50ms));
+		auto statistics = latency.getStatistics();
+		CHECK(statistics.samples == 2u && statistics.inputs == 6u);
+		CHECK(near(statistics.minMilliseconds, 28.0) && near(statistics.maxMilliseconds, 30.0));
+
+		// Presents with nothing open are ignored
+		latency.present(at(60ms));
+		CHECK(latency.getStatistics().samples == 2u);
+
+		latency.reset();
+		for (size_t frame = 0; frame < InputLatency::maxFramesInFlight + 2u; frame++)
+		{
+			latency.input(at(std::chrono::milliseconds(100 + frame)));
+			latency.beginFrame();
+		}
+		for (size_t frame = 0; frame < InputLatency::maxFramesInFlight + 2u; frame++)
+		{
+			latency.present(at(200ms));
+		}
+		statistics = latency.getStatistics();
+		CHECK(statistics.samples == InputLatency::maxFramesInFlight);
+		CHECK(near(statistics.maxMilliseconds, 98.0));
+	}
+
+	// Arrivals hand over the oldest event and the count since the last report, then start over
+	void testArrivals()
+	{
+		InputLatency latency;
+		InputLatency::Arrivals arrivals;
+		arrivals.reportTo(latency);
+		latency.beginFrame();
+		latency.present(at(10ms));
+		CHECK(latency.getStatistics().samples == 0u);
+
+		arrivals.note(at(4ms));
+		arrivals.note(at(1ms));
+		arrivals.note(at(3ms));
+		arrivals.reportTo(latency);
+		arrivals.note(at(6ms));
+		latency.beginFrame();
+		latency.present(at(11ms));
+		arrivals.reportTo(latency);
+		latency.beginFrame();
+		latency.present(at(12ms));
+		const auto statistics = latency.getStatistics();
+		CHECK(statistics.samples == 2u && statistics.inputs == 4u);
+		CHECK(near(statistics.maxMilliseconds, 10.0) && near(statistics.minMilliseconds, 6.0));
+	}
+}
+
+int main()
+{
+	testPercentiles();
+	testFrames();
+	testArrivals();
+	return checkResult("InputLatencyTest");
+}
@@ -0,0 +1,71 @@
+// Built with NDEBUG, so LOG_LEVEL_COMPILED is what a release build strips to
+#include "Logging.hpp"
+
+#include "Check.hpp"
+
+namespace
+{
+	int evaluated = 0;
+
+	// Not constexpr, so constant evaluation fails on any site that still calls it
+	int expensive() noexcept
+	{
+		return ++evaluated;
+	}
+
+	// A site below LOG_LEVEL_COMPILED must be a constant expression: no severity check, no record, and its
+	// arguments never evaluated. Any of those left in the code would stop these static_asserts from compiling.
+	constexpr bool stripsVerbose()
+	{
+		PLOGV << "stripped " << expensive();
+		BLOGV("stripped {}", expensive());
+		return true;
+	}
+
+	constexpr bool stripsDebug()
+	{
+		PLOGD << "stripped " << expensive();
+		BLOGD("stripped {}", expensive());
+		return true;
+	}
+
+	static_assert(LOG_LEVEL_COMPILED == plog::info, "release builds compile in info and worse");
+	static_assert(stripsVerbose());
+	static_assert(stripsDebug());
+
+	class CountingAppender : public plog::IAppender
+	{
+	public:
+		void write(const plog::Record& record) override
+		{
+			written[record.getSeverity()]++;
+		}
+
+		int written[plog::verbose + 1] = {};
+	};
+
+	// With the runtime level at verbose the stripped sites still do nothing, and the sites kept log as before
+	void testRuntime()
+	{
+		CountingAppender appender;
+		plog::Logger<PLOG_DEFAULT_INSTANCE_ID> logger(plog::verbose);
+		logger.addAppender(&appender);
+		CHECK(stripsVerbose() && stripsDebug());
+		CHECK(evaluated == 0);
+		CHECK(appender.written[plog::verbose] == 0 && appender.written[plog::debug] == 0);
+
+		PLOGI << "kept " << expensive();
+		BLOGI("kept {}", expensive());
+		PLOGW << "kept " << expensive();
+		PLOGE << "kept";
+		CHECK(evaluated == 3);
+		CHECK(appender.written[plog::info] == 2 && appender.written[plog::warning] == 1);
+		CHECK(appender.written[plog::error] == 1);
+	}
+}
+
+int main()
+{
+	testRuntime();
+	return checkResult("LoggingTest");
+}
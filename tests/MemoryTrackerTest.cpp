@@ -0,0 +1,113 @@
+#include "MemoryTracker.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+
+// AppConfig.hpp turns TRACK_ALLOCATIONS on, so MemoryTracker.cpp replaces the global operator new here as it does
+// in the app. The program also runs under AddressSanitizer, with ASAN_OPTIONS=allocator_may_return_null=1 for the
+// allocations that are meant to fail.
+namespace
+{
+	struct alignas(256) OverAligned
+	{
+		char bytes[300];
+	};
+}
+
+int main()
+{
+	// A tagged container is charged to its tag and gives it all back
+	const auto meshesBefore = MemoryTracker::getUsage(MemoryTag::Meshes);
+	{
+		std::vector<int, TaggedAllocator<int, MemoryTag::Meshes>> values(1000u);
+		const auto meshes = MemoryTracker::getUsage(MemoryTag::Meshes);
+		CHECK(meshes.currentBytes - meshesBefore.currentBytes == 1000u * sizeof(int));
+		CHECK(meshes.liveAllocations == meshesBefore.liveAllocations + 1u);
+	}
+	CHECK(MemoryTracker::getUsage(MemoryTag::Meshes).currentBytes == meshesBefore.currentBytes);
+	CHECK(MemoryTracker::getUsage(MemoryTag::Meshes).peakBytes >= 1000u * sizeof(int));
+
+	// Scopes nest and new charges the innermost
+	const size_t texturesBefore = MemoryTracker::getUsage(MemoryTag::Textures).currentBytes;
+	const size_t bindablesBefore = MemoryTracker::getUsage(MemoryTag::Bindables).currentBytes;
+	std::unique_ptr<char[]> bindable;
+	std::unique_ptr<char[]> texture;
+	{
+		MemoryTracker::Scope outer(MemoryTag::Bindables);
+		bindable = std::make_unique<char[]>(100u);
+		{
+			MemoryTracker::Scope inner(MemoryTag::Textures);
+			texture = std::make_unique<char[]>(200u);
+		}
+		CHECK(MemoryTracker::getCurrentTag() == MemoryTag::Bindables);
+	}
+	CHECK(MemoryTracker::getCurrentTag() == MemoryTag::Untagged);
+	CHECK(MemoryTracker::getUsage(MemoryTag::Bindables).currentBytes - bindablesBefore == 100u);
+	CHECK(MemoryTracker::getUsage(MemoryTag::Textures).currentBytes - texturesBefore == 200u);
+
+	// A block freed on another thread, under another scope, still comes off the tag it was charged to
+	std::thread([&texture] { MemoryTracker::Scope scope(MemoryTag::Logging); texture.reset(); }).join();
+	CHECK(MemoryTracker::getUsage(MemoryTag::Textures).currentBytes == texturesBefore);
+	bindable.reset();
+	CHECK(MemoryTracker::getUsage(MemoryTag::Bindables).currentBytes == bindablesBefore);
+
+	for (int i = 0; i < 100; i++)
+	{
+		auto* single = new OverAligned;
+		CHECK(reinterpret_cast<std::uintptr_t>(single) % alignof(OverAligned) == 0u);
+		delete single;
+		auto* array = new OverAligned[3];
+		CHECK(reinterpret_cast<std::uintptr_t>(array) % alignof(OverAligned) == 0u);
+		delete[] array;
+	}
+
+	// Out of memory: nothrow new gives nullptr, new throws, allocate() gives nullptr
+	CHECK(new (std::nothrow) char[1ull << 62u] == nullptr);
+	bool threw = false;
+	try
+	{
+		char* volatile huge = new char[1ull << 62u];
+		delete[] huge;
+	}
+	catch (const std::bad_alloc&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(MemoryTracker::allocate(SIZE_MAX - 4u, MemoryTag::ImGui) == nullptr);
+	MemoryTracker::deallocate(nullptr);
+
+	// Frames that allocate show in the sample, and once they stop the frame count drops to 0
+	MemoryTracker tracker(std::chrono::milliseconds(50));
+	tracker.initialize();
+	std::vector<std::string> kept;
+	for (int frame = 0; frame < 20; frame++)
+	{
+		for (int i = 0; i < 10; i++)
+		{
+			kept.emplace_back(40u, 'x');
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		tracker.frame();
+	}
+	CHECK(tracker.getSample().frameAllocations >= 10u);
+	CHECK(tracker.getSample().tags[static_cast<size_t>(MemoryTag::Untagged)].allocationsPerSecond > 1000.0);
+	kept.clear();
+	kept.shrink_to_fit();
+	tracker.frame();
+	for (int frame = 0; frame < 15; frame++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		tracker.frame();
+		CHECK(tracker.getSample().frameAllocations == 0u);
+	}
+	CHECK(tracker.getSample().peakFrameAllocations == 0u);
+
+	return checkResult("MemoryTrackerTest");
+}
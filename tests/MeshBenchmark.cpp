@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "MemoryTracker.hpp"
+#include "Plane.hpp"
+#include "Sphere.hpp"
+#include "WorkerPool.hpp"
+
+// Building a 10M-vertex mesh into upload memory, before and after MeshLayout. The baseline generates the way
+// the generators used to: push_back into vectors that grow as they go, then copy the finished mesh into the
+// upload buffer. The generators now size the mesh up front and write straight into the buffer, serially or
+// split over a WorkerPool. The upload buffers are allocated before timing, as a mapped buffer would be, so
+// the allocation counts are what building the mesh itself costs.
+
+namespace
+{
+	struct Vertex
+	{
+		DirectX::XMFLOAT3 pos;
+	};
+
+	struct Upload
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+
+		explicit Upload(const MeshLayout& layout)
+			:
+			vertices(layout.vertexCount),
+			indices(layout.indexCount)
+		{}
+	};
+
+	struct Measurement
+	{
+		double milliseconds;
+		unsigned long long allocations;
+	};
+
+	template<class F>
+	Measurement measure(F&& work)
+	{
+		const unsigned long long allocations = MemoryTracker::getAllocationCount();
+		const auto start = std::chrono::steady_clock::now();
+		work();
+		const auto end = std::chrono::steady_clock::now();
+		return { std::chrono::duration<double, std::milli>(end - start).count(), MemoryTracker::getAllocationCount() - allocations };
+	}
+
+	// The plane as the generator built it before MeshLayout, with 32-bit indices so it can reach 10M vertices
+	void buildPlaneGrowing(const int divisionsX, const int divisionsY, Upload& upload)
+	{
+		const size_t numberVerticesX = static_cast<size_t>(divisionsX) + 1u;
+		const float divisionSizeX = 2.0f / static_cast<float>(divisionsX);
+		const float divisionSizeY = 2.0f / static_cast<float>(divisionsY);
+
+		std::vector<Vertex> vertices;
+		for (int y = 0; y <= divisionsY; y++)
+		{
+			for (int x = 0; x <= divisionsX; x++)
+			{
+				vertices.emplace_back();
+				vertices.back().pos = { -1.0f + static_cast<float>(x) * divisionSizeX, -1.0f + static_cast<float>(y) * divisionSizeY, 0.0f };
+			}
+		}
+
+		std::vector<unsigned int> indices;
+		for (size_t y = 0; y < static_cast<size_t>(divisionsY); y++)
+		{
+			for (size_t x = 0; x < static_cast<size_t>(divisionsX); x++)
+			{
+				const auto index = static_cast<unsigned int>(y * numberVerticesX + x);
+				const auto above = static_cast<unsigned int>(index + numberVerticesX);
+				indices.push_back(index);
+				indices.push_back(above);
+				indices.push_back(index + 1u);
+				indices.push_back(index + 1u);
+				indices.push_back(above);
+				indices.push_back(above + 1u);
+			}
+		}
+
+		std::memcpy(upload.vertices.data(), vertices.data(), vertices.size() * sizeof(Vertex));
+		std::memcpy(upload.indices.data(), indices.data(), indices.size() * sizeof(unsigned int));
+	}
+
+	void print(const char* name, const Measurement& measurement)
+	{
+		std::printf("  %-28s %9.1f ms %8llu allocations\n", name, measurement.milliseconds, measurement.allocations);
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	// 3161 x 3161 cells and 1001 x 10000 bands both come to just under 10M vertices
+	const int planeDivisions = argc > 1 ? std::atoi(argv[1]) : 3161;
+	const int sphereLatitudes = argc > 2 ? std::atoi(argv[2]) : 1001;
+	const int sphereLongitudes = argc > 3 ? std::atoi(argv[3]) : 10000;
+	WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1u);
+
+	const MeshLayout planeLayout = Plane::getTessellatedLayout(planeDivisions, planeDivisions);
+	Upload growing(planeLayout);
+	Upload serial(planeLayout);
+	Upload pooled(planeLayout);
+	std::printf("MeshBenchmark: plane of %zu vertices and %zu indices, %zu worker threads\n", planeLayout.vertexCount,
+		planeLayout.indexCount, pool.getThreadCount());
+	print("push_back, then copy", measure([&]
+		{
+			buildPlaneGrowing(planeDivisions, planeDivisions, growing);
+		}));
+	print("written in place", measure([&]
+		{
+			Plane::writeTessellated<Vertex, unsigned int>(planeDivisions, planeDivisions, std::span(serial.vertices), std::span(serial.indices));
+		}));
+	print("written in place, pooled", measure([&]
+		{
+			Plane::writeTessellated<Vertex, unsigned int>(planeDivisions, planeDivisions, std::span(pooled.vertices), std::span(pooled.indices), &pool);
+		}));
+	if (growing.indices != serial.indices || serial.indices != pooled.indices
+		|| std::memcmp(growing.vertices.data(), serial.vertices.data(), serial.vertices.size() * sizeof(Vertex)) != 0
+		|| std::memcmp(serial.vertices.data(), pooled.vertices.data(), serial.vertices.size() * sizeof(Vertex)) != 0)
+	{
+		std::fprintf(stderr, "the plane builds differ\n");
+		return 1;
+	}
+
+	const MeshLayout sphereLayout = Sphere::getTessellatedLayout(sphereLatitudes, sphereLongitudes);
+	Upload sphereSerial(sphereLayout);
+	Upload spherePooled(sphereLayout);
+	std::printf("  sphere of %zu vertices and %zu indices\n", sphereLayout.vertexCount, sphereLayout.indexCount);
+	print("written in place", measure([&]
+		{
+			Sphere::writeTessellated<Vertex, unsigned int>(sphereLatitudes, sphereLongitudes, std::span(sphereSerial.vertices),
+				std::span(sphereSerial.indices));
+		}));
+	print("written in place, pooled", measure([&]
+		{
+			Sphere::writeTessellated<Vertex, unsigned int>(sphereLatitudes, sphereLongitudes, std::span(spherePooled.vertices),
+				std::span(spherePooled.indices), &pool);
+		}));
+	if (sphereSerial.indices != spherePooled.indices
+		|| std::memcmp(sphereSerial.vertices.data(), spherePooled.vertices.data(), sphereSerial.vertices.size() * sizeof(Vertex)) != 0)
+	{
+		std::fprintf(stderr, "the sphere builds differ\n");
+		return 1;
+	}
+	return 0;
+}
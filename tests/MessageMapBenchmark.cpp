@@ -0,0 +1,153 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+#include "VirtualKeyMap.hpp"
+#include "WindowsMessageMap.hpp"
+
+// The message logging's name lookups and line formatting, against the maps they replaced: unordered_maps of
+// strings built during static initialisation, formatting through an ostringstream into a new string. The
+// baseline is rebuilt from the tables themselves, so both sides look up the same names.
+
+namespace
+{
+	class MapBaseline
+	{
+	public:
+		using MessageNames = std::vector<std::pair<DWORD, std::string_view>>;
+		using KeyNames = std::vector<std::pair<unsigned char, std::string_view>>;
+
+		MapBaseline(const MessageNames& messages, const KeyNames& keys)
+		{
+			for (const auto& [msg, name] : messages)
+			{
+				messages_.emplace(msg, std::string(name));
+			}
+			for (const auto& [code, name] : keys)
+			{
+				keys_.emplace(code, std::string(name));
+			}
+		}
+
+		[[nodiscard]] std::string message(const DWORD msg, const LPARAM lParam, const WPARAM wParam) const
+		{
+			std::ostringstream out;
+			if (const auto it = messages_.find(msg); it != messages_.end())
+			{
+				out << std::setw(28) << std::left << it->second;
+			}
+			else
+			{
+				out << " Unknown message: 0x" << std::setw(8) << std::right << std::setfill('0') << std::hex << msg;
+			}
+			out << "  LP: 0x" << std::setw(16) << std::setfill('0') << std::hex << lParam
+				<< "  WP: 0x" << std::setw(16) << std::setfill('0') << std::hex << wParam;
+			return out.str();
+		}
+
+		[[nodiscard]] std::string key(const unsigned char code) const
+		{
+			std::ostringstream out;
+			if (const auto it = keys_.find(code); it != keys_.end())
+			{
+				out << it->second;
+			}
+			else
+			{
+				out << " Unknown key: 0x" << std::setw(2) << std::setfill('0') << std::hex << static_cast<unsigned int>(code);
+			}
+			return out.str();
+		}
+	private:
+		std::unordered_map<DWORD, std::string> messages_;
+		std::unordered_map<unsigned char, std::string> keys_;
+	};
+
+	volatile size_t sink;
+
+	template<class F>
+	double nanosecondsPerCall(const int calls, F&& call)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < calls; i++)
+		{
+			call(i);
+		}
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const int calls = argc > 1 ? std::atoi(argv[1]) : 2000000;
+
+	MapBaseline::MessageNames messageNames;
+	for (DWORD msg = 0u; msg < 0x10000u; msg++)
+	{
+		if (const auto name = WindowsMessageMap::name(msg); !name.empty())
+		{
+			messageNames.emplace_back(msg, name);
+		}
+	}
+	MapBaseline::KeyNames keyNames;
+	for (unsigned int code = 0u; code < 256u; code++)
+	{
+		if (const auto name = VirtualKeyMap::name(static_cast<unsigned char>(code)); !name.empty())
+		{
+			keyNames.emplace_back(static_cast<unsigned char>(code), name);
+		}
+	}
+
+	const auto buildStart = std::chrono::steady_clock::now();
+	const MapBaseline baseline(messageNames, keyNames);
+	const double buildMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - buildStart).count();
+	const WindowsMessageMap messages;
+	const VirtualKeyMap keys;
+
+	// A mix like a running window sends: mouse, hit tests, cursor, keys, timers, a control message and unknowns
+	constexpr DWORD mix[] = { 0x200, 0x84, 0x20, 0xFF, 0x100, 0x101, 0x102, 0x113, 0x1020, 0x31F, 0x7777 };
+	std::mt19937 rng(1u);
+	std::vector<DWORD> stream(4096u);
+	for (auto& msg : stream)
+	{
+		msg = mix[rng() % std::size(mix)];
+	}
+
+	std::printf("MessageMapBenchmark: %d calls\n", calls);
+	std::printf("  building the maps       %8.1f us at startup, the tables build at compile time\n", buildMicroseconds);
+	const double mapLine = nanosecondsPerCall(calls, [&](const int i)
+		{
+			sink = baseline.message(stream[i & 4095], i, static_cast<WPARAM>(i) * 3u).size();
+		});
+	const double tableLine = nanosecondsPerCall(calls, [&](const int i)
+		{
+			char buffer[WindowsMessageMap::bufferSize];
+			sink = std::strlen(messages(buffer, stream[i & 4095], i, static_cast<WPARAM>(i) * 3u));
+		});
+	std::printf("  message line            %8.1f ns map, %8.1f ns table  %.2fx\n", mapLine, tableLine, mapLine / tableLine);
+	const double lookup = nanosecondsPerCall(calls, [&](const int i)
+		{
+			sink = WindowsMessageMap::name(stream[i & 4095]).size();
+		});
+	std::printf("  message name lookup     %8.1f ns table\n", lookup);
+	const double mapKey = nanosecondsPerCall(calls, [&](const int i)
+		{
+			sink = baseline.key(static_cast<unsigned char>(i)).size();
+		});
+	const double tableKey = nanosecondsPerCall(calls, [&](const int i)
+		{
+			char buffer[VirtualKeyMap::bufferSize];
+			sink = std::strlen(keys(buffer, static_cast<unsigned char>(i)));
+		});
+	std::printf("  key name                %8.1f ns map, %8.1f ns table  %.2fx\n", mapKey, tableKey, mapKey / tableKey);
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include "Mouse.hpp"
+
+#include <utility>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	constexpr int wheelDelta = 120;
+
+	// A click that starts and ends inside one frame is seen as both pressed and released, and not held
+	void testClickInOneFrame()
+	{
+		Mouse mouse;
+		mouse.onMouseEnter(10, 20);
+		mouse.onLeftPressed(11, 21);
+		mouse.onLeftReleased(12, 22);
+		mouse.onRightPressed(12, 22);
+		Mouse::FrameInput input = mouse.collectFrame();
+		CHECK(input.pressed == (Mouse::FrameInput::LEFT | Mouse::FrameInput::RIGHT));
+		CHECK(input.released == Mouse::FrameInput::LEFT);
+		CHECK(input.held == Mouse::FrameInput::RIGHT);
+		CHECK(input.inWindow && input.x == 12 && input.y == 22);
+		CHECK(input.events == 4u);
+
+		// The next frame still holds the right button but reports no new presses
+		input = mouse.collectFrame();
+		CHECK(input.pressed == 0u && input.released == 0u && input.events == 0u);
+		CHECK(input.held == Mouse::FrameInput::RIGHT);
+
+		mouse.onRightReleased(12, 22);
+		mouse.onX1Pressed(12, 22);
+		mouse.onX2Pressed(12, 22);
+		mouse.onMiddlePressed(12, 22);
+		mouse.onMiddleReleased(12, 22);
+		input = mouse.collectFrame();
+		CHECK(input.released == (Mouse::FrameInput::RIGHT | Mouse::FrameInput::MIDDLE));
+		CHECK(input.pressed == (Mouse::FrameInput::X1 | Mouse::FrameInput::X2 | Mouse::FrameInput::MIDDLE));
+		CHECK(input.held == (Mouse::FrameInput::X1 | Mouse::FrameInput::X2));
+
+		mouse.onMouseLeave();
+		CHECK(!mouse.collectFrame().inWindow);
+	}
+
+	// Wheel deltas below a notch carry over to the next message, in both directions and on both wheels
+	void testWheel()
+	{
+		Mouse mouse;
+		mouse.onVWheelDelta(0, 0, wheelDelta / 2);
+		CHECK(mouse.collectFrame().wheel == 0);
+		mouse.onVWheelDelta(0, 0, wheelDelta / 2);
+		mouse.onVWheelDelta(0, 0, 3 * wheelDelta);
+		Mouse::FrameInput input = mouse.collectFrame();
+		CHECK(input.wheel == 4 && input.events == 4u);
+
+		mouse.onVWheelDelta(0, 0, -wheelDelta / 3);
+		mouse.onVWheelDelta(0, 0, -wheelDelta);
+		mouse.onVWheelDelta(0, 0, wheelDelta / 3);
+		CHECK(mouse.collectFrame().wheel == -1);
+
+		mouse.onHWheelDelta(0, 0, 2 * wheelDelta + 10);
+		mouse.onHWheelDelta(0, 0, -wheelDelta);
+		mouse.onHWheelDelta(0, 0, wheelDelta - 10);
+		input = mouse.collectFrame();
+		CHECK(input.hWheel == 2 && input.wheel == 0);
+	}
+
+	// Moves in a row fold into one event whose delta is their sum; a click between moves splits them, and the
+	// frame's delta still adds up
+	void testMoves()
+	{
+		Mouse mouse;
+		mouse.onMouseEnter(100, 100);
+		mouse.collectFrame();
+
+		for (int i = 1; i <= 50; i++)
+		{
+			mouse.onMouseMove(100 + i, 100 - 2 * i);
+		}
+		std::vector<Mouse::Event> events;
+		Mouse::FrameInput input = mouse.collectFrame([&events](const Mouse::Event& event) { events.push_back(event); });
+		CHECK(events.size() == 1u && events[0].getType() == Mouse::Event::MOVE);
+		CHECK(events[0].getDelta() == std::pair(50, -100) && events[0].getMoveCount() == 50u);
+		CHECK(input.deltaX == 50 && input.deltaY == -100 && input.moves == 50u && input.events == 1u);
+		CHECK(input.x == 150 && input.y == 0);
+
+		// Far more moves than the ring holds do not push the click out
+		events.clear();
+		for (int i = 1; i <= 100; i++)
+		{
+			mouse.onMouseMove(150 + i, 0);
+		}
+		mouse.onLeftPressed(250, 0);
+		for (int i = 1; i <= 100; i++)
+		{
+			mouse.onMouseMove(250, i);
+		}
+		input = mouse.collectFrame([&events](const Mouse::Event& event) { events.push_back(event); });
+		CHECK(events.size() == 3u);
+		CHECK(events[1].getType() == Mouse::Event::L_PRESS && events[1].getPos() == std::pair(250, 0));
+		CHECK(events[2].isLeftPressed() && events[2].getDelta() == std::pair(0, 100));
+		CHECK(input.deltaX == 100 && input.deltaY == 100 && input.moves == 200u);
+		CHECK(input.pressed == Mouse::FrameInput::LEFT && input.held == Mouse::FrameInput::LEFT);
+	}
+}
+
+int main()
+{
+	testClickInOneFrame();
+	testWheel();
+	testMoves();
+	return checkResult("MouseTest");
+}
@@ -0,0 +1,265 @@
+#include "QoiEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	struct Rgba
+	{
+		unsigned char r, g, b, a;
+
+		bool operator==(const Rgba&) const = default;
+	};
+
+	// Ops seen while decoding, in the order the spec lists them
+	struct OpCounts
+	{
+		size_t index = 0u;
+		size_t diff = 0u;
+		size_t luma = 0u;
+		size_t run = 0u;
+		size_t rgb = 0u;
+		size_t rgba = 0u;
+	};
+
+	unsigned int readBigEndian(const unsigned char* in) noexcept
+	{
+		return static_cast<unsigned int>(in[0]) << 24u | static_cast<unsigned int>(in[1]) << 16u | static_cast<unsigned int>(in[2]) << 8u | in[3];
+	}
+
+	// Reference decoder written from the spec. Checks the header and end marker, counts ops and leaves the pixels in
+	// pixels; false when the stream is malformed.
+	bool decode(const std::vector<unsigned char>& data, std::vector<Rgba>& pixels, OpCounts& counts)
+	{
+		constexpr size_t headerSize = 14u;
+		constexpr std::array<unsigned char, 8> endMarker = { 0, 0, 0, 0, 0, 0, 0, 1 };
+		if (data.size() < headerSize + endMarker.size() || data[0] != 'q' || data[1] != 'o' || data[2] != 'i' || data[3] != 'f')
+		{
+			return false;
+		}
+		const unsigned int width = readBigEndian(&data[4]);
+		const unsigned int height = readBigEndian(&data[8]);
+		if (data[12] != 4u || data[13] != 0u)
+		{
+			return false;
+		}
+
+		std::array<Rgba, 64> seen{};
+		Rgba pixel{ 0u, 0u, 0u, 255u };
+		pixels.clear();
+		size_t position = headerSize;
+		const size_t end = data.size() - endMarker.size();
+		unsigned int run = 0u;
+		for (size_t i = 0u; i < static_cast<size_t>(width) * height; i++)
+		{
+			if (run > 0u)
+			{
+				run--;
+			}
+			else
+			{
+				if (position >= end)
+				{
+					return false;
+				}
+				const unsigned char op = data[position++];
+				if (op == 0xFEu)
+				{
+					pixel.r = data[position++];
+					pixel.g = data[position++];
+					pixel.b = data[position++];
+					counts.rgb++;
+				}
+				else if (op == 0xFFu)
+				{
+					pixel.r = data[position++];
+					pixel.g = data[position++];
+					pixel.b = data[position++];
+					pixel.a = data[position++];
+					counts.rgba++;
+				}
+				else if ((op & 0xC0u) == 0x00u)
+				{
+					pixel = seen[op];
+					counts.index++;
+				}
+				else if ((op & 0xC0u) == 0x40u)
+				{
+					pixel.r = static_cast<unsigned char>(pixel.r + ((op >> 4u) & 3u) - 2);
+					pixel.g = static_cast<unsigned char>(pixel.g + ((op >> 2u) & 3u) - 2);
+					pixel.b = static_cast<unsigned char>(pixel.b + (op & 3u) - 2);
+					counts.diff++;
+				}
+				else if ((op & 0xC0u) == 0x80u)
+				{
+					const unsigned char second = data[position++];
+					const int dg = (op & 0x3Fu) - 32;
+					pixel.r = static_cast<unsigned char>(pixel.r + dg - 8 + ((second >> 4u) & 0x0Fu));
+					pixel.g = static_cast<unsigned char>(pixel.g + dg);
+					pixel.b = static_cast<unsigned char>(pixel.b + dg - 8 + (second & 0x0Fu));
+					counts.luma++;
+				}
+				else
+				{
+					run = op & 0x3Fu;
+					counts.run++;
+				}
+				seen[(pixel.r * 3u + pixel.g * 5u + pixel.b * 7u + pixel.a * 11u) % 64u] = pixel;
+			}
+			pixels.push_back(pixel);
+		}
+		return position == end && run == 0u && std::equal(endMarker.begin(), endMarker.end(), data.begin() + static_cast<std::ptrdiff_t>(end));
+	}
+
+	bool roundTrips(const Surface& surface, OpCounts& counts)
+	{
+		std::vector<Rgba> pixels;
+		if (!decode(QoiEncoder::encode(surface), pixels, counts))
+		{
+			return false;
+		}
+		const Surface::color* source = surface.getBufferPtr();
+		for (size_t i = 0u; i < pixels.size(); i++)
+		{
+			if (pixels[i] != Rgba{ source[i].get_r(), source[i].get_g(), source[i].get_b(), source[i].get_a() })
+			{
+				return false;
+			}
+		}
+		return pixels.size() == static_cast<size_t>(surface.getWidth()) * surface.getHeight();
+	}
+
+	// One pixel for each op, checked byte for byte
+	void testOps()
+	{
+		const Surface::color row[] = {
+			{ 255u, 1u, 1u, 1u },     // diff from the implicit black start
+			{ 255u, 11u, 13u, 15u },  // luma: green +12, red and blue 2 either side of it
+			{ 255u, 200u, 0u, 100u }, // rgb
+			{ 7u, 200u, 0u, 100u },   // rgba, only alpha changed
+			{ 255u, 1u, 1u, 1u },     // index 4, seen first
+			{ 255u, 1u, 1u, 1u },     // a run of two that ends the image
+			{ 255u, 1u, 1u, 1u },
+		};
+		Surface surface(static_cast<unsigned int>(std::size(row)), 1u);
+		for (unsigned int x = 0u; x < std::size(row); x++)
+		{
+			surface.putPixel(x, 0u, row[x]);
+		}
+
+		const std::vector<unsigned char> expected = {
+			'q', 'o', 'i', 'f', 0u, 0u, 0u, 7u, 0u, 0u, 0u, 1u, 4u, 0u,
+			0x7Fu,
+			0xACu, 0x6Au,
+			0xFEu, 200u, 0u, 100u,
+			0xFFu, 200u, 0u, 100u, 7u,
+			0x04u,
+			0xC1u,
+			0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u,
+		};
+		CHECK(QoiEncoder::encode(surface) == expected);
+	}
+
+	// Runs stop at 62 pixels; the image starts on the implicit opaque black so it is all runs
+	void testRuns()
+	{
+		Surface surface(130u, 1u);
+		surface.clear(Surface::color(255u, 0u, 0u, 0u));
+		const std::vector<unsigned char> encoded = QoiEncoder::encode(surface);
+		CHECK(encoded.size() == 14u + 3u + 8u);
+		CHECK(encoded[14] == (0xC0u | 61u) && encoded[15] == (0xC0u | 61u) && encoded[16] == (0xC0u | 5u));
+
+		OpCounts counts;
+		CHECK(roundTrips(surface, counts));
+		CHECK(counts.run == 3u);
+	}
+
+	// Random images mixing opaque gradients with small and larger steps, noise and alpha, which between them take
+	// every op; the output buffer is reused across sizes
+	void testRandom()
+	{
+		std::mt19937 rng(1u);
+		OpCounts counts;
+		std::vector<unsigned char> output;
+		for (int image = 0; image < 50; image++)
+		{
+			const unsigned int width = 1u + rng() % 300u;
+			const unsigned int height = 1u + rng() % 200u;
+			Surface surface(width, height);
+			for (unsigned int y = 0u; y < height; y++)
+			{
+				for (unsigned int x = 0u; x < width; x++)
+				{
+					const unsigned int kind = rng() % 6u;
+					unsigned int value = rng();
+					if (kind < 2u)
+					{
+						value = 0xFF000000u | (x / 7u + y / 5u) * 0x010101u;
+					}
+					else if (kind == 2u)
+					{
+						value = 0xFF000000u | (x * 9u + y) * 0x0A0C0Eu;
+					}
+					else if (kind == 5u)
+					{
+						value |= 0xFF000000u;
+					}
+					surface.putPixel(x, y, Surface::color(value));
+				}
+			}
+			CHECK(roundTrips(surface, counts));
+
+			QoiEncoder::encode(surface, output);
+			CHECK(output == QoiEncoder::encode(surface));
+		}
+		CHECK(counts.index > 0u && counts.diff > 0u && counts.luma > 0u && counts.run > 0u && counts.rgb > 0u && counts.rgba > 0u);
+	}
+
+	// A 1080p frame of smooth shading with some noise, roughly what captures hold
+	void measureThroughput()
+	{
+		constexpr unsigned int width = 1920u;
+		constexpr unsigned int height = 1080u;
+		Surface surface(width, height);
+		std::mt19937 rng(2u);
+		for (unsigned int y = 0u; y < height; y++)
+		{
+			for (unsigned int x = 0u; x < width; x++)
+			{
+				const auto noise = static_cast<unsigned char>(rng() % 3u);
+				surface.putPixel(x, y, Surface::color(255u, static_cast<unsigned char>(x / 8u + noise), static_cast<unsigned char>(y / 5u), static_cast<unsigned char>((x + y) / 12u)));
+			}
+		}
+
+		constexpr int frames = 10;
+		std::vector<unsigned char> output;
+		const auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			QoiEncoder::encode(surface, output);
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		const double megabytes = static_cast<double>(width) * height * 4.0 * frames / 1e6;
+		std::printf("QOI: %ux%u encoded at %.0f MB/s, %.1f ms a frame, %.1f%% of the raw size\n", width, height, megabytes / elapsed.count(),
+			elapsed.count() * 1000.0 / frames, 100.0 * static_cast<double>(output.size()) / (width * height * 4.0));
+
+		OpCounts counts;
+		CHECK(roundTrips(surface, counts));
+	}
+}
+
+int main()
+{
+	testOps();
+	testRuns();
+	testRandom();
+	measureThroughput();
+	return checkResult("QoiEncoderTest");
+}
@@ -0,0 +1,216 @@
+#include "SoftwareRasterizer.hpp"
+
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Cube.hpp"
+#include "Sphere.hpp"
+
+#include "Check.hpp"
+
+// The AVX2 coverage kernel against the scalar one. The kernels promise identical results, not merely close ones:
+// both evaluate the planes in the same order, so any difference in coverage, depth or the block's maximum depth
+// is a bug. Checked block by block on random planes, then on whole frames rendered with each kernel.
+namespace
+{
+	namespace dx = DirectX;
+
+	struct Vertex
+	{
+		dx::XMFLOAT3 pos;
+	};
+
+	struct TexturedVertex
+	{
+		dx::XMFLOAT3 pos;
+		struct
+		{
+			float u;
+			float v;
+		} tex;
+	};
+
+	RasterTriangle makeTriangle(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		RasterTriangle triangle{};
+		// Small integer planes land exactly on pixel centres, which is where inclusive and exclusive edges differ
+		const bool onCentres = rng() % 2u == 0u;
+		for (int edge = 0; edge < 3; edge++)
+		{
+			if (onCentres)
+			{
+				triangle.edgeA[edge] = static_cast<float>(static_cast<int>(rng() % 7u) - 3);
+				triangle.edgeB[edge] = static_cast<float>(static_cast<int>(rng() % 7u) - 3);
+				triangle.edgeC[edge] = static_cast<float>(static_cast<int>(rng() % 81u) - 40);
+			}
+			else
+			{
+				triangle.edgeA[edge] = unit(rng);
+				triangle.edgeB[edge] = unit(rng);
+				triangle.edgeC[edge] = unit(rng) * 30.0f;
+			}
+			triangle.edgeInclusive[edge] = rng() % 2u == 0u;
+		}
+		triangle.depthA = unit(rng) * 0.02f;
+		triangle.depthB = unit(rng) * 0.02f;
+		triangle.depthC = 0.55f + unit(rng) * 0.55f;
+		triangle.originX = static_cast<int>(rng() % 512u);
+		triangle.originY = static_cast<int>(rng() % 512u);
+		return triangle;
+	}
+
+	void testKernels()
+	{
+		std::mt19937 rng(1u);
+		std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+		size_t blocks = 0u;
+		size_t differing = 0u;
+		size_t pixelsPassed = 0u;
+		for (int t = 0; t < 20000; t++)
+		{
+			const RasterTriangle triangle = makeTriangle(rng);
+			for (int block = 0; block < 10; block++)
+			{
+				const int blockX = triangle.originX + static_cast<int>(rng() % 64u) - 32;
+				const int blockY = triangle.originY + static_cast<int>(rng() % 64u) - 32;
+				const std::uint64_t validMask = rng() % 2u == 0u ? ~0ull : (static_cast<std::uint64_t>(rng()) << 32u | rng());
+				const bool fullyCovered = rng() % 4u == 0u;
+
+				float scalarDepth[64];
+				float avx2Depth[64];
+				for (float& stored : scalarDepth)
+				{
+					stored = rng() % 4u == 0u ? 1.0f : depth(rng);
+				}
+				std::memcpy(avx2Depth, scalarDepth, sizeof(scalarDepth));
+
+				float scalarMax = -1.0f;
+				float avx2Max = -2.0f;
+				const std::uint64_t scalar = RasterKernel::coverBlockScalar(triangle, blockX, blockY, validMask, fullyCovered, scalarDepth, scalarMax);
+				const std::uint64_t avx2 = RasterKernel::coverBlockAvx2(triangle, blockX, blockY, validMask, fullyCovered, avx2Depth, avx2Max);
+				blocks++;
+				pixelsPassed += static_cast<size_t>(std::popcount(scalar));
+				if (scalar != avx2 || scalarMax != avx2Max || std::memcmp(scalarDepth, avx2Depth, sizeof(scalarDepth)) != 0)
+				{
+					differing++;
+				}
+			}
+		}
+		std::printf("Kernels: %zu blocks, %zu pixels passed, %zu differing\n", blocks, pixelsPassed, differing);
+		CHECK(differing == 0u);
+		CHECK(pixelsPassed > blocks * 4u);
+	}
+
+	struct Object
+	{
+		const SoftwareRasterizer::Mesh* mesh;
+		const SoftwareRasterizer::Material* material;
+		dx::XMMATRIX world;
+	};
+
+	// Spheres in face and vertex colours and textured cubes scattered in front of the camera, many overlapping
+	void renderScene(SoftwareRasterizer& rasterizer, const std::vector<Object>& objects, Surface& target)
+	{
+		const dx::XMMATRIX projection = dx::XMMatrixPerspectiveLH(1.0f, 0.75f, 0.5f, 40.0f);
+		for (const Object& object : objects)
+		{
+			rasterizer.draw(*object.mesh, *object.material, object.world * projection);
+		}
+		rasterizer.render(target, Surface::color(255u, 20u, 30u, 40u));
+	}
+
+	void testFrames()
+	{
+		const SoftwareRasterizer::Mesh sphere = SoftwareRasterizer::Mesh::from(Sphere::makeTessellated<Vertex>(12, 24));
+		SoftwareRasterizer::Mesh blendedSphere = sphere;
+		for (size_t i = 0; i < blendedSphere.positions.size(); i++)
+		{
+			const float shade = static_cast<float>(i % 17u) / 16.0f;
+			blendedSphere.colors.push_back({ shade, 1.0f - shade, 0.5f, 1.0f });
+		}
+		const SoftwareRasterizer::Mesh cube = SoftwareRasterizer::Mesh::from(Cube::makeSkinned<TexturedVertex>());
+
+		Surface checker(64u, 64u);
+		for (unsigned int y = 0u; y < 64u; y++)
+		{
+			for (unsigned int x = 0u; x < 64u; x++)
+			{
+				checker.putPixel(x, y, ((x / 8u + y / 8u) % 2u) != 0u ? Surface::color(255u, 230u, 200u, 40u) : Surface::color(255u, 30u, 60u, 200u));
+			}
+		}
+		const SampledTexture texture(checker);
+
+		SoftwareRasterizer::Material faces;
+		for (size_t i = 0; i < faces.faceColors.size(); i++)
+		{
+			faces.faceColors[i] = { static_cast<float>(i) / 7.0f, 0.4f, 1.0f - static_cast<float>(i) / 7.0f, 1.0f };
+		}
+		const SoftwareRasterizer::Material vertexColors{ .shading = SoftwareRasterizer::Shading::VertexColors };
+		const SoftwareRasterizer::Material textured{ .shading = SoftwareRasterizer::Shading::Texture, .texture = &texture };
+
+		std::mt19937 rng(3u);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::vector<Object> objects;
+		for (int i = 0; i < 300; i++)
+		{
+			const int kind = i % 3;
+			const float scale = 1.4f + 0.6f * unit(rng);
+			objects.push_back({
+				kind == 0 ? &sphere : kind == 1 ? &blendedSphere : &cube,
+				kind == 0 ? &faces : kind == 1 ? &vertexColors : &textured,
+				dx::XMMatrixScaling(scale, scale, scale) * dx::XMMatrixRotationRollPitchYaw(unit(rng) * 3.0f, unit(rng) * 3.0f, unit(rng) * 3.0f)
+					* dx::XMMatrixTranslation(unit(rng) * 5.0f, unit(rng) * 4.0f, 6.0f + 4.0f * (unit(rng) + 1.0f))
+			});
+		}
+
+		// Odd sizes leave partial tiles and blocks along the right and bottom edges
+		constexpr unsigned int width = 333u;
+		constexpr unsigned int height = 251u;
+		SoftwareRasterizer scalar(width, height, 0u, false);
+		SoftwareRasterizer avx2(width, height, 0u, true);
+		SoftwareRasterizer threaded(width, height, 3u, true);
+		CHECK(!scalar.isUsingAvx2());
+		CHECK(avx2.isUsingAvx2());
+
+		Surface scalarFrame(width, height);
+		Surface avx2Frame(width, height);
+		Surface threadedFrame(width, height);
+		renderScene(scalar, objects, scalarFrame);
+		renderScene(avx2, objects, avx2Frame);
+		renderScene(threaded, objects, threadedFrame);
+
+		const size_t bytes = static_cast<size_t>(width) * height * sizeof(Surface::color);
+		CHECK(std::memcmp(scalarFrame.getBufferPtr(), avx2Frame.getBufferPtr(), bytes) == 0);
+		CHECK(std::memcmp(scalarFrame.getBufferPtr(), threadedFrame.getBufferPtr(), bytes) == 0);
+		const auto& scalarStatistics = scalar.getStatistics();
+		const auto& avx2Statistics = avx2.getStatistics();
+		CHECK(scalarStatistics.pixelsShaded == avx2Statistics.pixelsShaded);
+		CHECK(scalarStatistics.blocksPartial == avx2Statistics.blocksPartial);
+
+		// The scene has to cover most of the frame for the comparison to mean anything
+		size_t background = 0u;
+		for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+		{
+			background += scalarFrame.getBufferPtr()[i].dword == Surface::color(255u, 20u, 30u, 40u).dword ? 1u : 0u;
+		}
+		std::printf("Frames: %u triangles rasterized, %zu pixels shaded, %.1f%% background\n", static_cast<unsigned int>(scalarStatistics.trianglesRasterized),
+			scalarStatistics.pixelsShaded, 100.0 * static_cast<double>(background) / (static_cast<double>(width) * height));
+		CHECK(background * 2u < static_cast<size_t>(width) * height);
+	}
+}
+
+int main()
+{
+	if (!RasterKernel::isAvx2Supported())
+	{
+		std::printf("RasterizerTest: the CPU has no AVX2, nothing to compare\n");
+		return checkResult("RasterizerTest");
+	}
+	testKernels();
+	testFrames();
+	return checkResult("RasterizerTest");
+}
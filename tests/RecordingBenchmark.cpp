@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "RenderQueue.hpp"
+#include "UploadRing.hpp"
+#include "WorkerPool.hpp"
+
+// Submission scaling of App::recordDrawables without a GPU. The stub device stands in for D3D11: its recorders
+// fill plain in-memory command buffers the way deferred contexts fill command lists, and executing them in
+// order on the "immediate context" folds every command into a state hash. Each recorded draw does the CPU work
+// a real one does: work out its transform, write it into the recorder's part of the frame's constant block,
+// and record the binds and the draw, skipping statics the previous packet already bound.
+
+// RenderQueue only knows Drawable by pointer, so the benchmark's drawable completes that declaration
+class Drawable
+{
+public:
+	Drawable(const unsigned int index, const std::uint16_t material)
+		:
+		material_(material),
+		radius_(6.0f + static_cast<float>(index % 14u)),
+		theta_(static_cast<float>(index) * 0.37f),
+		phi_(static_cast<float>(index) * 0.11f),
+		spin_(static_cast<float>(index) * 0.05f)
+	{}
+
+	[[nodiscard]] std::uint16_t getMaterial() const noexcept
+	{
+		return material_;
+	}
+
+	void tick(const float dt) noexcept
+	{
+		theta_ += dt * 0.3f;
+		phi_ += dt * 0.2f;
+		spin_ += dt;
+	}
+
+	// Row-major world matrix: a spin about y, then out along the orbit
+	void getTransform(float (&world)[16]) const noexcept
+	{
+		const float c = std::cos(spin_), s = std::sin(spin_);
+		const float x = radius_ * std::cos(theta_) * std::cos(phi_);
+		const float y = radius_ * std::sin(phi_);
+		const float z = 20.0f + radius_ * std::sin(theta_) * std::cos(phi_);
+		const float matrix[16] = {
+			c, 0.0f, -s, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			s, 0.0f, c, 0.0f,
+			x, y, z, 1.0f
+		};
+		std::memcpy(world, matrix, sizeof(matrix));
+	}
+
+	[[nodiscard]] float getDepth() const noexcept
+	{
+		return 20.0f + radius_ * std::sin(theta_) * std::cos(phi_);
+	}
+private:
+	std::uint16_t material_;
+	float radius_, theta_, phi_, spin_;
+};
+
+namespace
+{
+	constexpr unsigned int sliceSize = 256u;
+	constexpr unsigned int staticBindsPerMaterial = 6u;
+	constexpr std::uint16_t materialCount = 5u;
+
+	struct Command
+	{
+		enum class Op : std::uint32_t
+		{
+			BindStatic,
+			BindConstants,
+			Draw,
+		};
+
+		Op op;
+		std::uint32_t argument;
+	};
+
+	// The in-memory half of the stub device: one per recording thread, reused every frame
+	class StubRecorder
+	{
+	public:
+		void begin(unsigned char* constants, const unsigned int firstSlice) noexcept
+		{
+			commands_.clear();
+			constants_ = constants;
+			nextSlice_ = firstSlice;
+		}
+
+		void record(const std::span<const RenderQueue::Packet> packets, const float (&viewProjection)[16])
+		{
+			int boundMaterial = -1;
+			for (const auto& packet : packets)
+			{
+				const auto& drawable = *packet.drawable;
+				if (drawable.getMaterial() != boundMaterial)
+				{
+					for (unsigned int bind = 0u; bind < staticBindsPerMaterial; bind++)
+					{
+						commands_.push_back({ Command::Op::BindStatic, drawable.getMaterial() * staticBindsPerMaterial + bind });
+					}
+					boundMaterial = drawable.getMaterial();
+				}
+
+				float world[16];
+				drawable.getTransform(world);
+				float* transform = reinterpret_cast<float*>(constants_);
+				constants_ += sliceSize;
+				// Transposed world * viewProjection, as TransformConstantBuffer uploads it
+				for (int row = 0; row < 4; row++)
+				{
+					for (int column = 0; column < 4; column++)
+					{
+						float sum = 0.0f;
+						for (int k = 0; k < 4; k++)
+						{
+							sum += world[row * 4 + k] * viewProjection[k * 4 + column];
+						}
+						transform[column * 4 + row] = sum;
+					}
+				}
+				commands_.push_back({ Command::Op::BindConstants, nextSlice_++ });
+				commands_.push_back({ Command::Op::Draw, 36u });
+			}
+		}
+
+		[[nodiscard]] const std::vector<Command>& getCommands() const noexcept
+		{
+			return commands_;
+		}
+	private:
+		std::vector<Command> commands_;
+		unsigned char* constants_ = nullptr;
+		unsigned int nextSlice_ = 0u;
+	};
+
+	// The immediate context: applies command buffers in order and hashes the state every draw sees
+	class StubDevice
+	{
+	public:
+		explicit StubDevice(const unsigned int capacity)
+			:
+			memory_(capacity)
+		{}
+
+		[[nodiscard]] unsigned char* getConstants(const unsigned int offset) noexcept
+		{
+			return memory_.data() + offset;
+		}
+
+		void execute(const std::vector<Command>& commands) noexcept
+		{
+			for (const auto& [op, argument] : commands)
+			{
+				switch (op)
+				{
+				case Command::Op::BindStatic:
+					statics_[argument % staticBindsPerMaterial] = argument;
+					break;
+				case Command::Op::BindConstants:
+					constants_ = argument;
+					break;
+				case Command::Op::Draw:
+					std::uint32_t first;
+					std::memcpy(&first, memory_.data() + static_cast<size_t>(constants_) * sliceSize, sizeof(first));
+					hash_ = (hash_ ^ statics_[0] ^ (static_cast<std::uint64_t>(first) << 32u) ^ argument) * 0x100000001B3ull;
+					break;
+				}
+			}
+		}
+
+		[[nodiscard]] std::uint64_t takeHash() noexcept
+		{
+			return std::exchange(hash_, 0xCBF29CE484222325ull);
+		}
+	private:
+		std::vector<unsigned char> memory_;
+		std::uint32_t statics_[staticBindsPerMaterial]{};
+		std::uint32_t constants_ = 0u;
+		std::uint64_t hash_ = 0xCBF29CE484222325ull;
+	};
+
+	struct Result
+	{
+		double milliseconds;
+		std::vector<std::uint64_t> hashes;
+	};
+
+	// recorders == 0 records straight onto the immediate context's command stream, like RECORDING_THREADS 0
+	Result run(const size_t drawableCount, const int frames, const size_t recorders)
+	{
+		std::vector<Drawable> drawables;
+		drawables.reserve(drawableCount);
+		for (unsigned int i = 0u; i < drawableCount; i++)
+		{
+			drawables.emplace_back(i, static_cast<std::uint16_t>(i * 2654435761u % materialCount));
+		}
+
+		constexpr unsigned int framesInFlight = 5u;
+		UploadRing ring(UploadRing::getCapacityFor(drawableCount, sliceSize, sliceSize, framesInFlight), sliceSize);
+		StubDevice device(ring.getCapacity());
+		std::vector<StubRecorder> stubRecorders(std::max<size_t>(recorders, 1u));
+		std::unique_ptr<WorkerPool> pool = recorders > 1u ? std::make_unique<WorkerPool>(recorders - 1u) : nullptr;
+		RenderQueue queue;
+		queue.reserve(drawableCount);
+
+		const float viewProjection[16] = {
+			1.8f, 0.0f, 0.0f, 0.0f,
+			0.0f, 2.4f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 1.0f,
+			0.0f, 0.0f, -0.5f, 0.0f
+		};
+
+		Result result{ 0.0, {} };
+		for (int frame = 0; frame < frames; frame++)
+		{
+			for (auto& drawable : drawables)
+			{
+				drawable.tick(1.0f / 60.0f);
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			queue.clear();
+			for (const auto& drawable : drawables)
+			{
+				queue.push(RenderQueue::makeKey(RenderQueue::Pass::Opaque, drawable.getMaterial(), 0u, drawable.getDepth()), &drawable);
+			}
+			queue.sort();
+
+			const std::span<const RenderQueue::Packet> packets = queue.getPackets();
+			const auto block = ring.allocate(static_cast<unsigned int>(packets.size()) * sliceSize);
+			if (!block || block->discard)
+			{
+				std::fprintf(stderr, "constant ring is too small for %zu draws\n", packets.size());
+				std::exit(1);
+			}
+			const unsigned int firstSlice = block->offset / sliceSize;
+
+			if (recorders == 0u)
+			{
+				auto& recorder = stubRecorders.front();
+				recorder.begin(device.getConstants(block->offset), firstSlice);
+				recorder.record(packets, viewProjection);
+				device.execute(recorder.getCommands());
+			}
+			else
+			{
+				const size_t rangeSize = (packets.size() + recorders - 1u) / recorders;
+				const auto record = [&](const size_t index)
+					{
+						const size_t first = std::min(index * rangeSize, packets.size());
+						const size_t last = std::min(first + rangeSize, packets.size());
+						auto& recorder = stubRecorders[index];
+						recorder.begin(device.getConstants(block->offset + static_cast<unsigned int>(first) * sliceSize),
+							firstSlice + static_cast<unsigned int>(first));
+						recorder.record(packets.subspan(first, last - first), viewProjection);
+					};
+				if (pool)
+				{
+					pool->run(recorders, record);
+				}
+				else
+				{
+					record(0u);
+				}
+				for (const auto& recorder : stubRecorders)
+				{
+					device.execute(recorder.getCommands());
+				}
+			}
+
+			// The GPU trails by a few frames; everything older than that is retired
+			const auto number = ring.endFrame();
+			if (number >= framesInFlight - 1u)
+			{
+				ring.retire(number - (framesInFlight - 1u));
+			}
+			result.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			result.hashes.push_back(device.takeHash());
+		}
+		result.milliseconds /= frames;
+		return result;
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const size_t drawableCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 12000u;
+	const int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+	const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::printf("RecordingBenchmark: %zu drawables, %d frames, %zu hardware threads\n", drawableCount, frames, hardwareThreads);
+	const auto direct = run(drawableCount, frames, 0u);
+	std::printf("  direct submission    %7.3f ms/frame\n", direct.milliseconds);
+
+	int failures = 0;
+	for (size_t recorders = 1u; recorders <= std::max<size_t>(hardwareThreads, 4u); recorders *= 2u)
+	{
+		const auto recorded = run(drawableCount, frames, recorders);
+		const bool same = recorded.hashes == direct.hashes;
+		std::printf("  %2zu recording threads %7.3f ms/frame  %.2fx%s\n", recorders, recorded.milliseconds,
+			direct.milliseconds / recorded.milliseconds, same ? "" : "  executed commands differ from direct submission");
+		failures += same ? 0 : 1;
+	}
+	return failures == 0 ? 0 : 1;
+}
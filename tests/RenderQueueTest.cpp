@@ -0,0 +1,160 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+
+// RenderQueue only knows Drawable by pointer, so the test's drawable completes that declaration
+class Drawable
+{
+public:
+	RenderQueue::Pass pass;
+	std::uint16_t material;
+	std::uint16_t mesh;
+	float depth;
+};
+
+namespace
+{
+	using Pass = RenderQueue::Pass;
+
+	// The fields come back out of the bits the header documents
+	void testKeyPacking()
+	{
+		const float depth = 12.5f;
+		const std::uint32_t depthBits = 0x41480000u;
+		const std::uint64_t opaque = RenderQueue::makeKey(Pass::Opaque, 0xABCDu, 0x1234u, depth);
+		CHECK(opaque >> 62u == 0u);
+		CHECK((opaque >> 46u & 0xFFFFu) == 0xABCDu);
+		CHECK((opaque >> 32u & 0x3FFFu) == 0x1234u);
+		CHECK((opaque & 0xFFFFFFFFu) == depthBits);
+
+		const std::uint64_t blended = RenderQueue::makeKey(Pass::Blended, 0xABCDu, 0x1234u, depth);
+		CHECK(blended >> 62u == 1u);
+		CHECK((blended >> 30u & 0xFFFFFFFFu) == (~depthBits & 0xFFFFFFFFu));
+		CHECK((blended >> 14u & 0xFFFFu) == 0xABCDu);
+		CHECK((blended & 0x3FFFu) == 0x1234u);
+
+		// Mesh ids keep their low 14 bits and never spill into the material or depth
+		CHECK(RenderQueue::makeKey(Pass::Opaque, 7u, 0xFFFFu, depth) == RenderQueue::makeKey(Pass::Opaque, 7u, 0x3FFFu, depth));
+		CHECK(RenderQueue::makeKey(Pass::Blended, 7u, 0xC000u, depth) == RenderQueue::makeKey(Pass::Blended, 7u, 0u, depth));
+
+		// Behind the camera and NaN sort as 0
+		CHECK(RenderQueue::makeKey(Pass::Opaque, 1u, 0u, -3.0f) == RenderQueue::makeKey(Pass::Opaque, 1u, 0u, 0.0f));
+		CHECK(RenderQueue::makeKey(Pass::Opaque, 1u, 0u, std::numeric_limits<float>::quiet_NaN()) == RenderQueue::makeKey(Pass::Opaque, 1u, 0u, 0.0f));
+
+		// Every opaque key comes before every blended one
+		CHECK(RenderQueue::makeKey(Pass::Opaque, 0xFFFFu, 0x3FFFu, 1e30f) < RenderQueue::makeKey(Pass::Blended, 0u, 0u, 1e30f));
+	}
+
+	// Random keys sort exactly as std::stable_sort sorts them, equal keys keeping the order they were pushed in
+	void testStability()
+	{
+		std::mt19937_64 rng(5u);
+		RenderQueue queue;
+		std::vector<Drawable> drawables(20000u);
+		std::vector<RenderQueue::Packet> expected;
+		for (size_t round = 0; round < 3u; round++)
+		{
+			queue.clear();
+			expected.clear();
+			for (auto& drawable : drawables)
+			{
+				// Few materials, meshes and depths, so most keys have duplicates
+				drawable = {
+					rng() % 4u == 0u ? Pass::Blended : Pass::Opaque,
+					static_cast<std::uint16_t>(rng() % 6u),
+					static_cast<std::uint16_t>(rng() % 20u),
+					static_cast<float>(rng() % 50u) - 5.0f
+				};
+				const std::uint64_t key = RenderQueue::makeKey(drawable.pass, drawable.material, drawable.mesh, drawable.depth);
+				queue.push(key, &drawable);
+				expected.push_back({ key, &drawable });
+			}
+			queue.sort();
+			std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+
+			const auto& packets = queue.getPackets();
+			CHECK(packets.size() == expected.size());
+			bool same = true;
+			for (size_t i = 0; i < packets.size(); i++)
+			{
+				same = same && packets[i].key == expected[i].key && packets[i].drawable == expected[i].drawable;
+			}
+			CHECK(same);
+		}
+
+		// A byte that is the same in every key is skipped, which must not disturb the order
+		queue.clear();
+		for (size_t i = 0; i < 100u; i++)
+		{
+			queue.push(RenderQueue::makeKey(Pass::Opaque, 3u, 1u, 2.0f), &drawables[i]);
+		}
+		queue.sort();
+		bool pushOrder = true;
+		for (size_t i = 0; i < 100u; i++)
+		{
+			pushOrder = pushOrder && queue.getPackets()[i].drawable == &drawables[i];
+		}
+		CHECK(pushOrder);
+	}
+
+	// Opaque draws are grouped by material and mesh and go front to back within a group; blended draws all come
+	// after them, back to front whatever their material
+	void testDrawOrder()
+	{
+		std::mt19937 rng(9u);
+		std::vector<Drawable> drawables(5000u);
+		RenderQueue queue;
+		for (auto& drawable : drawables)
+		{
+			drawable = {
+				rng() % 3u == 0u ? Pass::Blended : Pass::Opaque,
+				static_cast<std::uint16_t>(rng() % 5u),
+				static_cast<std::uint16_t>(rng() % 4u),
+				static_cast<float>(rng() % 100000u) / 100.0f
+			};
+			queue.push(RenderQueue::makeKey(drawable.pass, drawable.material, drawable.mesh, drawable.depth), &drawable);
+		}
+		queue.sort();
+
+		const auto& packets = queue.getPackets();
+		bool blendedSeen = false;
+		bool passesInOrder = true;
+		bool opaqueInOrder = true;
+		bool backToFront = true;
+		for (size_t i = 1; i < packets.size(); i++)
+		{
+			const Drawable& previous = *packets[i - 1u].drawable;
+			const Drawable& current = *packets[i].drawable;
+			blendedSeen = blendedSeen || previous.pass == Pass::Blended;
+			passesInOrder = passesInOrder && !(blendedSeen && current.pass == Pass::Opaque);
+			if (previous.pass == Pass::Opaque && current.pass == Pass::Opaque)
+			{
+				const bool sameGroup = previous.material == current.material && previous.mesh == current.mesh;
+				const bool nextGroup = previous.material < current.material || (previous.material == current.material && previous.mesh < current.mesh);
+				opaqueInOrder = opaqueInOrder && (sameGroup ? previous.depth <= current.depth : nextGroup);
+			}
+			if (previous.pass == Pass::Blended && current.pass == Pass::Blended)
+			{
+				backToFront = backToFront && previous.depth >= current.depth;
+			}
+		}
+		CHECK(passesInOrder);
+		CHECK(opaqueInOrder);
+		CHECK(backToFront);
+	}
+}
+
+int main()
+{
+	testKeyPacking();
+	testStability();
+	testDrawOrder();
+	return checkResult("RenderQueueTest");
+}
@@ -0,0 +1,203 @@
+#include "ReplayLoop.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	constexpr unsigned char space = 0x20;
+	constexpr float tickRate = 60.0f;
+	constexpr unsigned int maxTicksPerFrame = 5u;
+	constexpr unsigned int seed = 424242u;
+	constexpr std::uint32_t drawableCount = 180u;
+	constexpr size_t frameCount = 2000u;
+
+	// What a simulated frame saw, which a replay has to reproduce
+	struct Trace
+	{
+		unsigned int ticks;
+		float alpha;
+		bool paused;
+		int x;
+		int y;
+		unsigned int events;
+
+		bool operator==(const Trace&) const = default;
+	};
+
+	Trace trace(const unsigned int ticks, const FixedTimestep& timestep, const bool paused, const Mouse::FrameInput& mouse)
+	{
+		return { ticks, timestep.getAlpha(), paused, mouse.x, mouse.y, mouse.events };
+	}
+
+	// Records a session the way App's frame loop does: input is pumped and collected, the frame's time recorded,
+	// and the simulation gets both either in the same frame or, pipelined, in the frame after. Returns the trace
+	// of every simulated frame.
+	std::vector<Trace> record(const std::filesystem::path& path, const std::uint32_t simulationLag)
+	{
+		Mouse mouse;
+		Keyboard keyboard;
+		FixedTimestep timestep(tickRate, maxTicksPerFrame);
+		InputRecording::Recorder recorder(path, seed, drawableCount, simulationLag);
+		std::mt19937 wall(1u);
+		std::vector<Trace> simulated;
+		if (simulationLag > 0u)
+		{
+			// The pipeline starts on a frame of no time
+			simulated.push_back(trace(timestep.advance(0.0f), timestep, false, {}));
+		}
+
+		int x = 300;
+		int y = 200;
+		mouse.onMouseEnter(x, y);
+		for (size_t frame = 0; frame < frameCount; frame++)
+		{
+			// Messages pumped during the frame, a fast mouse
+			for (int i = 0; i < 133; i++)
+			{
+				x += static_cast<int>(wall() % 5u) - 2;
+				y += static_cast<int>(wall() % 5u) - 2;
+				mouse.onMouseMove(x, y);
+			}
+			if (frame % 97u == 3u)
+			{
+				mouse.onLeftPressed(x, y);
+			}
+			if (frame % 97u == 9u)
+			{
+				mouse.onLeftReleased(x, y);
+			}
+			if (frame % 50u == 0u)
+			{
+				mouse.onVWheelDelta(x, y, 120);
+			}
+			if (frame % 300u == 100u)
+			{
+				keyboard.onKeyPressed(space);
+			}
+			if (frame % 300u == 160u)
+			{
+				keyboard.onKeyReleased(space);
+			}
+			if (frame % 41u == 0u)
+			{
+				keyboard.onChar(static_cast<unsigned char>('a' + frame % 26u));
+			}
+
+			const Mouse::FrameInput input = mouse.collectFrame([&recorder](const Mouse::Event& event) { recorder.record(event); });
+			keyboard.drainKeys([&recorder](const Keyboard::Event& event) { recorder.record(event); });
+			keyboard.drainChars([&recorder](const char character) { recorder.recordChar(character); });
+			// A jittery wall clock
+			const float dt = static_cast<float>(14000u + wall() % 6000u) / 1e6f;
+			recorder.endFrame(dt);
+
+			const bool paused = keyboard.isKeyPressed(space);
+			simulated.push_back(trace(timestep.advance(paused ? 0.0f : dt), timestep, paused, input));
+		}
+		return simulated;
+	}
+
+	// Replays the recording and counts the simulated frames that differ from the recorded session
+	size_t replay(const std::filesystem::path& path, const std::vector<Trace>& recorded)
+	{
+		InputRecording::Replay replay(path);
+		ReplayLoop loop(replay, tickRate, maxTicksPerFrame);
+		size_t mismatches = 0u;
+		while (!loop.isDone())
+		{
+			const size_t frame = loop.getFrame();
+			const ReplayLoop::Frame replayed = loop.next();
+			if (!(trace(replayed.ticks, loop.getTimestep(), replayed.paused, replayed.mouse) == recorded.at(frame)))
+			{
+				mismatches++;
+			}
+		}
+		CHECK(loop.getFrame() == frameCount);
+		return mismatches;
+	}
+
+	void putWord(std::ofstream& file, const std::uint32_t word)
+	{
+		const std::array<char, 4> bytes = {
+			static_cast<char>(word & 0xffu), static_cast<char>((word >> 8u) & 0xffu), static_cast<char>((word >> 16u) & 0xffu),
+			static_cast<char>(word >> 24u)
+		};
+		file.write(bytes.data(), bytes.size());
+	}
+}
+
+int main()
+{
+	const auto directory = std::filesystem::temp_directory_path();
+	const auto path = directory / "ReplayTest.atir";
+
+	// Same frame and pipelined a frame behind, replayed twice to show it is deterministic
+	for (const std::uint32_t simulationLag : { 0u, 1u })
+	{
+		const auto recorded = record(path, simulationLag);
+		InputRecording::Replay replay(path);
+		CHECK(replay.getSeed() == seed);
+		CHECK(replay.getDrawableCount() == drawableCount);
+		CHECK(replay.getSimulationLag() == simulationLag);
+		CHECK(replay.getFrames().size() == frameCount);
+		CHECK(::replay(path, recorded) == 0u);
+		CHECK(::replay(path, recorded) == 0u);
+	}
+
+	// The lag is what lines the input up: read without it, a pipelined session replays off by a frame
+	{
+		const auto recorded = record(path, 1u);
+		std::vector<Trace> unlagged(recorded.begin() + 1, recorded.end());
+		CHECK(::replay(path, unlagged) == frameCount);
+	}
+
+	// Cut short in the middle of a record, the whole frames still replay
+	{
+		const auto size = std::filesystem::file_size(path);
+		std::filesystem::resize_file(path, size - 3u);
+		InputRecording::Replay replay(path);
+		CHECK(replay.getFrames().size() == frameCount - 1u);
+	}
+
+	// Version 1 has no lag word and replays unlagged
+	{
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file.write("ATIR", 4);
+			putWord(file, 1u);
+			putWord(file, seed);
+			putWord(file, drawableCount);
+			file.put(0);
+			putWord(file, 0x3c888889u);
+		}
+		InputRecording::Replay replay(path);
+		CHECK(replay.getSimulationLag() == 0u);
+		CHECK(replay.getFrames().size() == 1u);
+	}
+
+	// Anything else is rejected
+	{
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file << "nope, not a recording";
+		}
+		bool threw = false;
+		try
+		{
+			InputRecording::Replay replay(path);
+		}
+		catch (const InputRecording::Exception&)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	}
+
+	std::filesystem::remove(path);
+	return checkResult("ReplayTest");
+}
@@ -0,0 +1,223 @@
+#include "ResolutionScaler.hpp"
+
+#include <cmath>
+#include <random>
+#include <utility>
+
+#include "AppConfig.hpp"
+#include "Check.hpp"
+#include "MemoryTracker.hpp"
+
+namespace
+{
+	constexpr float target = static_cast<float>(RESOLUTION_TARGET_MILLISECONDS);
+
+	// A GPU whose frame time grows with the pixel count, plus a little noise
+	struct SimulatedGpu
+	{
+		float fullResolutionMilliseconds;
+		float noise = 0.0f;
+		std::mt19937 rng{ 9u };
+
+		float render(const float scale)
+		{
+			std::uniform_real_distribution<float> jitter(1.0f - noise, 1.0f + noise);
+			return fullResolutionMilliseconds * scale * scale * jitter(rng);
+		}
+	};
+
+	// Renders a run of frames at whatever scale the scaler picks; returns how many of them changed it
+	unsigned int settle(ResolutionScaler& scaler, SimulatedGpu& gpu, const int frames = 600)
+	{
+		unsigned int changes = 0u;
+		float scale = scaler.getScale();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			const float next = scaler.update(gpu.render(scale));
+			changes += next != scale ? 1u : 0u;
+			scale = next;
+		}
+		return changes;
+	}
+
+	bool isStep(const ResolutionScaler& scaler) noexcept
+	{
+		const float steps = scaler.getScale() / scaler.getSettings().step;
+		return std::abs(steps - std::round(steps)) < 1.0e-4f;
+	}
+
+	// From full resolution on scenes 1.3 to 3.5 times the budget, the scale drops and settles where the frame fits
+	// between the headroom band and the target
+	void testConvergence()
+	{
+		for (const float cost : { 2.0f * target, 1.3f * target, 3.5f * target })
+		{
+			ResolutionScaler scaler({ .targetMilliseconds = target });
+			SimulatedGpu gpu{ cost };
+			const unsigned int changes = settle(scaler, gpu);
+			CHECK(changes >= 1u && changes <= 6u);
+			CHECK(isStep(scaler));
+			const float settled = gpu.render(scaler.getScale());
+			CHECK(settled <= target);
+			// One more step would run over the headroom band, or the scale is at its floor
+			const float larger = scaler.getScale() + scaler.getSettings().step;
+			CHECK(gpu.render(larger) >= target * scaler.getSettings().headroom || scaler.getScale() == scaler.getSettings().minScale);
+			CHECK(settle(scaler, gpu) == 0u);
+		}
+
+		// When the scene gets cheap again the scale grows back to full resolution a step at a time
+		ResolutionScaler scaler({ .targetMilliseconds = target });
+		SimulatedGpu gpu{ 2.0f * target };
+		settle(scaler, gpu);
+		const float low = scaler.getScale();
+		gpu.fullResolutionMilliseconds = 0.5f * target;
+		float previous = low;
+		for (int frame = 0; frame < 600; frame++)
+		{
+			const float next = scaler.update(gpu.render(previous));
+			CHECK(next - previous < scaler.getSettings().step * 1.01f);
+			previous = next;
+		}
+		CHECK(low < 1.0f && scaler.getScale() == 1.0f);
+	}
+
+	// The scale stays inside [minScale, maxScale]; without a target it is always maxScale
+	void testClamping()
+	{
+		ResolutionScaler heavy({ .targetMilliseconds = target, .minScale = 0.5f, .maxScale = 1.0f });
+		SimulatedGpu slowGpu{ 100.0f * target };
+		settle(heavy, slowGpu);
+		CHECK(heavy.getScale() == 0.5f);
+
+		ResolutionScaler light({ .targetMilliseconds = target, .minScale = 0.5f, .maxScale = 0.75f });
+		SimulatedGpu fastGpu{ 0.1f * target };
+		settle(light, fastGpu);
+		CHECK(light.getScale() == 0.75f);
+
+		ResolutionScaler off({ .targetMilliseconds = 0.0f, .maxScale = 0.875f });
+		CHECK(off.update(1000.0f) == 0.875f);
+		CHECK(off.update(0.1f) == 0.875f);
+
+		CHECK(ResolutionScaler::scaleExtent(1920u, 0.5f) == 960u);
+		CHECK(ResolutionScaler::scaleExtent(3u, 0.1f) == 1u);
+	}
+
+	// Frame time noise and single spikes do not move a settled scale, and every change waits out the cooldown
+	void testHysteresis()
+	{
+		ResolutionScaler scaler({ .targetMilliseconds = target, .minScale = 0.25f });
+		SimulatedGpu gpu{ 2.0f * target };
+		settle(scaler, gpu);
+		gpu.noise = 0.05f;
+		CHECK(settle(scaler, gpu, 2000) == 0u);
+
+		// A frame over the budget that takes the average half way to the target, then a normal one
+		const float settled = scaler.getScale();
+		const float average = scaler.getAverageMilliseconds();
+		const float spike = average + 0.5f * (target - average) / scaler.getSettings().smoothing;
+		CHECK(spike > target);
+		CHECK(scaler.update(spike) == settled);
+		CHECK(scaler.update(average) == settled);
+
+		// A sustained jump changes the scale once, then holds it for the cooldown whatever the frames say
+		gpu.noise = 0.0f;
+		float scale = settled;
+		int changedAt = -1;
+		for (int frame = 0; frame < 200 && changedAt < 0; frame++)
+		{
+			const float next = scaler.update(4.0f * gpu.render(scale));
+			if (next != scale)
+			{
+				changedAt = frame;
+			}
+			scale = next;
+		}
+		CHECK(changedAt >= 0 && scale < settled);
+		for (unsigned int frame = 0; frame < scaler.getSettings().cooldownFrames; frame++)
+		{
+			CHECK(scaler.update(100.0f * target) == scale);
+		}
+		CHECK(scaler.update(100.0f * target) < scale);
+	}
+
+	// Same size copies, flat colours stay flat, and the cached taps follow a change of either width
+	void testUpscale()
+	{
+		std::mt19937 rng(4u);
+		Surface source(37u, 21u);
+		for (unsigned int y = 0u; y < source.getHeight(); y++)
+		{
+			for (unsigned int x = 0u; x < source.getWidth(); x++)
+			{
+				source.putPixel(x, y, Surface::color(rng()));
+			}
+		}
+
+		ResolutionScaler scaler({});
+		Surface same(37u, 21u);
+		scaler.upscale(source, same);
+		bool identical = true;
+		for (unsigned int y = 0u; y < 21u; y++)
+		{
+			for (unsigned int x = 0u; x < 37u; x++)
+			{
+				identical = identical && same.getPixel(x, y).dword == source.getPixel(x, y).dword;
+			}
+		}
+		CHECK(identical);
+
+		Surface flat(16u, 9u);
+		flat.clear(Surface::color(200u, 10u, 120u, 250u));
+		Surface flatLarge(61u, 33u);
+		scaler.upscale(flat, flatLarge);
+		bool stayedFlat = true;
+		for (unsigned int y = 0u; y < 33u; y++)
+		{
+			for (unsigned int x = 0u; x < 61u; x++)
+			{
+				stayedFlat = stayedFlat && flatLarge.getPixel(x, y).dword == Surface::color(200u, 10u, 120u, 250u).dword;
+			}
+		}
+		CHECK(stayedFlat);
+
+		// Upscaling to one size after another gives what a fresh scaler gives, and repeating a size allocates nothing
+		for (const auto& [sourceWidth, width] : { std::pair{ 37u, 80u }, std::pair{ 20u, 80u }, std::pair{ 37u, 64u } })
+		{
+			Surface smaller(sourceWidth, 21u);
+			for (unsigned int y = 0u; y < 21u; y++)
+			{
+				for (unsigned int x = 0u; x < sourceWidth; x++)
+				{
+					smaller.putPixel(x, y, source.getPixel(x, y));
+				}
+			}
+			Surface reused(width, 40u);
+			Surface fresh(width, 40u);
+			scaler.upscale(smaller, reused);
+			ResolutionScaler freshScaler({});
+			freshScaler.upscale(smaller, fresh);
+			bool matches = true;
+			for (unsigned int y = 0u; y < 40u; y++)
+			{
+				for (unsigned int x = 0u; x < width; x++)
+				{
+					matches = matches && reused.getPixel(x, y).dword == fresh.getPixel(x, y).dword;
+				}
+			}
+			CHECK(matches);
+
+			const unsigned long long allocations = MemoryTracker::getAllocationCount();
+			scaler.upscale(smaller, reused);
+			CHECK(MemoryTracker::getAllocationCount() == allocations);
+		}
+	}
+}
+
+int main()
+{
+	testConvergence();
+	testClamping();
+	testHysteresis();
+	testUpscale();
+	return checkResult("ResolutionScalerTest");
+}
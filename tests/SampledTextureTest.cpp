@@ -0,0 +1,195 @@
+#include "SampledTexture.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <utility>
+
+#include "Check.hpp"
+
+// The SSE2 sampler against the scalar one. sample4() and sampleQuad() must return the same bytes sample() does
+// for every filter, addressing mode and level of detail, including coordinates far outside [0, 1] and textures
+// whose sides are not a multiple of the tile size.
+namespace
+{
+	using Filter = SampledTexture::Filter;
+	using Addressing = SampledTexture::Addressing;
+
+	Surface makeNoise(const unsigned int width, const unsigned int height, std::mt19937& rng)
+	{
+		Surface surface(width, height);
+		for (unsigned int y = 0u; y < height; y++)
+		{
+			for (unsigned int x = 0u; x < width; x++)
+			{
+				surface.putPixel(x, y, Surface::color(rng()));
+			}
+		}
+		return surface;
+	}
+
+	// Level 0 holds the source as is, level 1 averages each 2x2 block rounding to nearest
+	void testMipChain(const Surface& source, const SampledTexture& texture)
+	{
+		const unsigned int width = source.getWidth();
+		const unsigned int height = source.getHeight();
+		unsigned int levels = 1u;
+		for (unsigned int w = width, h = height; w > 1u || h > 1u; w = std::max(w / 2u, 1u), h = std::max(h / 2u, 1u))
+		{
+			levels++;
+		}
+		CHECK(texture.getLevelCount() == levels);
+
+		for (unsigned int y = 0u; y < height; y++)
+		{
+			for (unsigned int x = 0u; x < width; x++)
+			{
+				CHECK(texture.getTexel(0u, x, y).dword == source.getPixel(x, y).dword);
+			}
+		}
+		if (levels > 1u)
+		{
+			const unsigned int quad[4] = {
+				source.getPixel(0u, 0u).dword,
+				source.getPixel(std::min(1u, width - 1u), 0u).dword,
+				source.getPixel(0u, std::min(1u, height - 1u)).dword,
+				source.getPixel(std::min(1u, width - 1u), std::min(1u, height - 1u)).dword
+			};
+			unsigned int expected = 0u;
+			for (unsigned int shift = 0u; shift < 32u; shift += 8u)
+			{
+				unsigned int sum = 2u;
+				for (const unsigned int texel : quad)
+				{
+					sum += (texel >> shift) & 0xFFu;
+				}
+				expected |= (sum / 4u) << shift;
+			}
+			CHECK(texture.getTexel(1u, 0u, 0u).dword == expected);
+		}
+	}
+
+	// Random coordinates and levels of detail through sample4 and the scalar sample, every filter and addressing
+	// combination; returns the number of samples that differ
+	size_t compareSample4(const SampledTexture& texture, std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> coordinate(-3.0f, 3.0f);
+		std::uniform_real_distribution<float> far(-5000.0f, 5000.0f);
+		std::uniform_real_distribution<float> lod(-2.0f, 12.0f);
+		size_t differing = 0u;
+		for (const Filter filter : { Filter::Bilinear, Filter::Trilinear })
+		{
+			for (const Addressing addressU : { Addressing::Wrap, Addressing::Clamp })
+			{
+				for (const Addressing addressV : { Addressing::Wrap, Addressing::Clamp })
+				{
+					const SampledTexture::State state{ filter, addressU, addressV };
+					for (int i = 0; i < 5000; i++)
+					{
+						float u[4];
+						float v[4];
+						for (int k = 0; k < 4; k++)
+						{
+							u[k] = i % 10 == 0 ? far(rng) : coordinate(rng);
+							v[k] = i % 10 == 0 ? far(rng) : coordinate(rng);
+						}
+						const float level = lod(rng);
+						Surface::color simd[4];
+						texture.sample4(u, v, level, state, simd);
+						for (int k = 0; k < 4; k++)
+						{
+							differing += simd[k].dword != texture.sample(u[k], v[k], level, state).dword ? 1u : 0u;
+						}
+					}
+				}
+			}
+		}
+		return differing;
+	}
+
+	// Quads of neighbouring pixels at a random scale and rotation, so the derived level of detail covers the chain
+	size_t compareSampleQuad(const SampledTexture& texture, std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> coordinate(-2.0f, 2.0f);
+		std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+		std::uniform_real_distribution<float> exponent(-12.0f, 2.0f);
+		const SampledTexture::State state{};
+		size_t differing = 0u;
+		for (int i = 0; i < 20000; i++)
+		{
+			const float step = std::exp2(exponent(rng));
+			const float theta = angle(rng);
+			const float dx = std::cos(theta) * step;
+			const float dy = std::sin(theta) * step;
+			const float u0 = coordinate(rng);
+			const float v0 = coordinate(rng);
+			const float u[4] = { u0, u0 + dx, u0 - dy, u0 + dx - dy };
+			const float v[4] = { v0, v0 + dy, v0 + dx, v0 + dy + dx };
+			Surface::color simd[4];
+			texture.sampleQuad(u, v, state, simd);
+			const float lod = texture.computeLod(u[1] - u[0], v[1] - v[0], u[2] - u[0], v[2] - v[0]);
+			for (int k = 0; k < 4; k++)
+			{
+				differing += simd[k].dword != texture.sample(u[k], v[k], lod, state).dword ? 1u : 0u;
+			}
+		}
+		return differing;
+	}
+
+	// Clamped coordinates outside the texture read the edge texels, so they sample the same as the coordinate
+	// moved onto the edge texel centre
+	void testClamp(const SampledTexture& texture, std::mt19937& rng)
+	{
+		const float width = static_cast<float>(texture.getWidth());
+		const float height = static_cast<float>(texture.getHeight());
+		const SampledTexture::State state{ Filter::Bilinear, Addressing::Clamp, Addressing::Clamp };
+		std::uniform_real_distribution<float> coordinate(-3.0f, 3.0f);
+		for (int i = 0; i < 5000; i++)
+		{
+			float u[4];
+			float v[4];
+			float onEdge[2][4];
+			for (int k = 0; k < 4; k++)
+			{
+				u[k] = coordinate(rng);
+				v[k] = coordinate(rng);
+				onEdge[0][k] = std::clamp(u[k], 0.5f / width, 1.0f - 0.5f / width);
+				onEdge[1][k] = std::clamp(v[k], 0.5f / height, 1.0f - 0.5f / height);
+			}
+			Surface::color outside[4];
+			Surface::color inside[4];
+			texture.sample4(u, v, -1.0f, state, outside);
+			texture.sample4(onEdge[0], onEdge[1], -1.0f, state, inside);
+			for (int k = 0; k < 4; k++)
+			{
+				CHECK(outside[k].dword == inside[k].dword);
+			}
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(7u);
+	for (const auto& [width, height] : { std::pair{ 256u, 256u }, std::pair{ 300u, 77u }, std::pair{ 5u, 3u }, std::pair{ 1u, 1u } })
+	{
+		const Surface source = makeNoise(width, height, rng);
+		const SampledTexture texture(source);
+		testMipChain(source, texture);
+		const size_t differing4 = compareSample4(texture, rng);
+		const size_t differingQuad = compareSampleQuad(texture, rng);
+		CHECK(differing4 == 0u);
+		CHECK(differingQuad == 0u);
+		testClamp(texture, rng);
+		if (differing4 != 0u || differingQuad != 0u)
+		{
+			std::printf("SampledTexture %ux%u: %zu sample4 and %zu sampleQuad results differ from sample\n", width, height, differing4, differingQuad);
+		}
+	}
+
+	// A quad stepping four texels a pixel is two levels down
+	const SampledTexture texture(Surface(256u, 256u));
+	CHECK(std::abs(texture.computeLod(4.0f / 256.0f, 0.0f, 0.0f, 4.0f / 256.0f) - 2.0f) < 1.0e-4f);
+	return checkResult("SampledTextureTest");
+}
@@ -0,0 +1,147 @@
+#include "ShaderCache.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	namespace fs = std::filesystem;
+
+	void write(const fs::path& path, const std::string& text)
+	{
+		std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+	}
+
+	size_t countEntries(const fs::path& directory)
+	{
+		size_t count = 0u;
+		for (const auto& entry : fs::directory_iterator(directory))
+		{
+			count += entry.path().extension() == ".cso" ? 1u : 0u;
+		}
+		return count;
+	}
+
+	// Stands in for D3DCompile: counts the compiles and returns bytes that differ for every input the cache keys on
+	struct StubCompiler
+	{
+		unsigned int* compiles;
+
+		ShaderCache::Bytecode operator()(const std::string& source, const fs::path&, const std::vector<ShaderCache::Define>& defines,
+			const std::string& entryPoint, const std::string& target, const unsigned int flags) const
+		{
+			(*compiles)++;
+			std::string text = source + "|" + entryPoint + "|" + target + "|" + std::to_string(flags);
+			for (const auto& [name, value] : defines)
+			{
+				text += "|" + name + "=" + value;
+			}
+			return ShaderCache::Bytecode(text.begin(), text.end());
+		}
+	};
+}
+
+int main()
+{
+	const fs::path root = fs::temp_directory_path() / "ShaderCacheTest";
+	fs::remove_all(root);
+	fs::create_directories(root / "include");
+	const fs::path shader = root / "Shader.hlsl";
+	const fs::path cacheDirectory = root / "cache";
+	write(shader, "#include \"include/Common.hlsli\"\nfloat4 main() : SV_Target { return 1; }\n");
+	write(root / "include" / "Common.hlsli", "  #  include \"Nested.hlsli\"\n");
+	write(root / "include" / "Nested.hlsli", "static const float scale = 1.0f;\n");
+
+	unsigned int compiles = 0u;
+	ShaderCache cache(cacheDirectory, 1u, StubCompiler{ &compiles });
+	const auto load = [&cache, &shader](const std::vector<ShaderCache::Define>& defines, const char* entryPoint = "main", const char* target = "ps_4_0")
+		{
+			return cache.load(shader, defines, entryPoint, target);
+		};
+
+	// The first load compiles and stores, the second reads the entry back
+	const auto compiled = load({});
+	CHECK(compiles == 1u && cache.getMisses() == 1u && cache.getHits() == 0u);
+	CHECK(load({}) == compiled);
+	CHECK(compiles == 1u && cache.getHits() == 1u);
+
+	// Every part of the variant is its own entry, each compiled once
+	const std::vector<std::vector<ShaderCache::Define>> variants = {
+		{ { "SKINNED", "1" } },
+		{ { "SKINNED", "2" } },
+		{ { "SKINNED", "" }, { "FOG", "1" } },
+		{ { "SKINNEDFOG", "" }, { "", "1" } },
+	};
+	for (const auto& defines : variants)
+	{
+		const unsigned int before = compiles;
+		CHECK(load(defines) != compiled);
+		CHECK(compiles == before + 1u);
+		load(defines);
+		CHECK(compiles == before + 1u);
+	}
+	load({}, "mainAlpha");
+	CHECK(compiles == 6u);
+	load({}, "main", "ps_5_0");
+	CHECK(compiles == 7u);
+	load({}, "mainAlpha");
+	load({}, "main", "ps_5_0");
+	CHECK(compiles == 7u && cache.getMisses() == 7u);
+	CHECK(countEntries(cacheDirectory) == 7u);
+
+	// Different flags share the directory without sharing entries
+	ShaderCache debugCache(cacheDirectory, 2u, StubCompiler{ &compiles });
+	CHECK(debugCache.load(shader, {}, "main", "ps_4_0") != compiled);
+	CHECK(compiles == 8u && debugCache.getMisses() == 1u);
+	debugCache.load(shader, {}, "main", "ps_4_0");
+	CHECK(compiles == 8u && debugCache.getHits() == 1u);
+	CHECK(countEntries(cacheDirectory) == 8u);
+
+	// A new cache on the same directory, as on the next run, hits what the last one stored
+	{
+		unsigned int rerunCompiles = 0u;
+		ShaderCache rerun(cacheDirectory, 1u, StubCompiler{ &rerunCompiles });
+		CHECK(rerun.load(shader, {}, "main", "ps_4_0") == compiled);
+		CHECK(rerunCompiles == 0u && rerun.getHits() == 1u);
+	}
+
+	// Editing a file included two levels down misses, and the entry it replaces is deleted while other variants stay
+	write(root / "include" / "Nested.hlsli", "static const float scale = 2.0f;\n");
+	load({});
+	CHECK(compiles == 9u);
+	CHECK(countEntries(cacheDirectory) == 8u);
+	load({});
+	CHECK(compiles == 9u);
+
+	// So does editing the source itself
+	write(shader, "#include \"include/Common.hlsli\"\nfloat4 main() : SV_Target { return 0; }\n");
+	CHECK(load({}) != compiled);
+	CHECK(compiles == 10u);
+	CHECK(countEntries(cacheDirectory) == 8u);
+	load({ { "SKINNED", "1" } });
+	CHECK(compiles == 11u);
+	CHECK(countEntries(cacheDirectory) == 8u);
+
+	// The flags 2 entry was built from the old source; it misses, recompiles and replaces its stale entry
+	debugCache.load(shader, {}, "main", "ps_4_0");
+	CHECK(compiles == 12u && debugCache.getMisses() == 2u);
+	CHECK(countEntries(cacheDirectory) == 8u);
+
+	bool threw = false;
+	try
+	{
+		cache.load(root / "Missing.hlsl", {}, "main", "ps_4_0");
+	}
+	catch (const ShaderCache::Exception&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+
+	fs::remove_all(root);
+	return checkResult("ShaderCacheTest");
+}
@@ -0,0 +1,154 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "CpuMetric.hpp"
+#include "FixedTimestep.hpp"
+#include "InputLatency.hpp"
+#include "MemoryTracker.hpp"
+#include "RenderQueue.hpp"
+#include "UploadRing.hpp"
+#include "WorkerPool.hpp"
+
+#include "Check.hpp"
+
+// Steady-state frames must not allocate. Runs the parts of App's frame that build without Windows, with
+// MemoryTracker's operator new counting every heap allocation: the fixed timestep ticking the scene on the
+// worker pool, the render queue, the per-draw constant ring, input latency and the CPU and memory metrics.
+// Every frame after warm-up has to leave the allocation count where it found it.
+
+// RenderQueue only knows Drawable by pointer, so the test's drawable completes that declaration
+class Drawable
+{
+public:
+	explicit Drawable(const unsigned int index)
+		:
+		material_(static_cast<std::uint16_t>(index % 3u)),
+		radius_(6.0f + static_cast<float>(index % 14u)),
+		theta_(static_cast<float>(index) * 0.37f)
+	{}
+
+	[[nodiscard]] std::uint16_t getMaterial() const noexcept
+	{
+		return material_;
+	}
+
+	void tick(const float dt) noexcept
+	{
+		theta_ += dt * 0.3f;
+	}
+
+	[[nodiscard]] float getDepth() const noexcept
+	{
+		return 20.0f + radius_ * std::sin(theta_);
+	}
+
+	void getTransform(float (&world)[16]) const noexcept
+	{
+		const float matrix[16] = {
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			radius_ * std::cos(theta_), 0.0f, getDepth(), 1.0f
+		};
+		std::memcpy(world, matrix, sizeof(matrix));
+	}
+
+private:
+	std::uint16_t material_;
+	float radius_;
+	float theta_;
+};
+
+int main()
+{
+	constexpr unsigned int drawableCount = 500u;
+	constexpr unsigned int constantSize = 64u;
+	constexpr unsigned int framesInFlight = 3u;
+	std::vector<Drawable> drawables;
+	drawables.reserve(drawableCount);
+	for (unsigned int i = 0u; i < drawableCount; i++)
+	{
+		drawables.emplace_back(i);
+	}
+
+	WorkerPool pool(3u);
+	FixedTimestep timestep(60.0f, 5u);
+	RenderQueue queue;
+	UploadRing ring(UploadRing::getCapacityFor(drawableCount, constantSize, 256u, framesInFlight), 256u);
+	std::vector<unsigned char> constants(ring.getCapacity());
+	InputLatency latency;
+	CpuMetric cpu(std::chrono::milliseconds(50));
+	MemoryTracker memory(std::chrono::milliseconds(50));
+	cpu.initialize();
+	memory.initialize();
+
+	const std::function<void(size_t)> tick = [&drawables, &timestep](const size_t i)
+		{
+			drawables[i].tick(timestep.getStep());
+		};
+
+	// Frames take at least a millisecond, so warm-up spans a few metric windows; the first ones size their buffers
+	constexpr int warmup = 150;
+	constexpr int frames = 240;
+	unsigned long long steadyAllocations = 0ull;
+	for (int frame = 0; frame < warmup + frames; frame++)
+	{
+		const unsigned long long allocationsBefore = MemoryTracker::getAllocationCount();
+		cpu.frame();
+		memory.frame();
+
+		latency.input(InputLatency::clock::now());
+		latency.beginFrame();
+
+		const unsigned int ticks = timestep.advance(1.0f / 60.0f);
+		for (unsigned int t = 0u; t < ticks; t++)
+		{
+			pool.run(drawables.size(), tick);
+		}
+
+		queue.clear();
+		for (const Drawable& drawable : drawables)
+		{
+			queue.push(RenderQueue::makeKey(RenderQueue::Pass::Opaque, drawable.getMaterial(), 0u, drawable.getDepth()), &drawable);
+		}
+		queue.sort();
+
+		for (const auto& packet : queue.getPackets())
+		{
+			const auto allocation = ring.allocate(constantSize);
+			CHECK(allocation.has_value());
+			if (allocation)
+			{
+				float world[16];
+				packet.drawable->getTransform(world);
+				std::memcpy(constants.data() + allocation->offset, world, sizeof(world));
+			}
+		}
+		// The GPU is taken to finish a frame framesInFlight - 1 frames after it was submitted
+		const unsigned long long submitted = ring.endFrame();
+		if (submitted + 1u >= framesInFlight)
+		{
+			ring.retire(submitted + 1u - framesInFlight);
+		}
+
+		latency.present();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		const unsigned long long allocations = MemoryTracker::getAllocationCount() - allocationsBefore;
+		if (frame >= warmup && allocations != 0u)
+		{
+			std::fprintf(stderr, "frame %d allocated %llu times\n", frame, allocations);
+			steadyAllocations += allocations;
+		}
+	}
+	CHECK(steadyAllocations == 0u);
+	CHECK(cpu.getSample().threads.size() >= 4u);
+
+	return checkResult("SteadyFrameTest");
+}
@@ -0,0 +1,178 @@
+#include "TextureAtlas.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	// Every texel of source i is i + 1, so the page shows whose texels ended up where
+	Surface makeSource(const unsigned int width, const unsigned int height, const unsigned int index)
+	{
+		Surface surface(width, height);
+		surface.clear(Surface::color(index + 1u));
+		return surface;
+	}
+
+	struct Rect
+	{
+		unsigned int left;
+		unsigned int top;
+		unsigned int right;
+		unsigned int bottom;
+	};
+
+	// The region with its gutter, as the packer reserved it
+	Rect padded(const TextureAtlas::Region& region, const unsigned int padding)
+	{
+		return { region.x - padding, region.y - padding, region.x + region.width + padding, region.y + region.height + padding };
+	}
+
+	bool overlap(const Rect& a, const Rect& b)
+	{
+		return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+	}
+
+	bool isPowerOfTwo(const unsigned int value)
+	{
+		return value != 0u && (value & (value - 1u)) == 0u;
+	}
+
+	// A fixed set of rects from 8 to 200 texels a side, packed with the given gutter and alignment
+	void testFixedSet(const unsigned int padding, const unsigned int alignment, const double minimumFill)
+	{
+		constexpr unsigned int count = 120u;
+		std::mt19937 rng(1u);
+		std::uniform_int_distribution<unsigned int> side(8u, 200u);
+		TextureAtlas atlas(padding, alignment);
+		for (unsigned int i = 0u; i < count; i++)
+		{
+			const unsigned int width = side(rng);
+			const unsigned int height = side(rng);
+			atlas.add(std::to_wstring(i), makeSource(width, height, i));
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		atlas.pack();
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		const Surface& page = atlas.getPage();
+		CHECK(isPowerOfTwo(page.getWidth()) && isPowerOfTwo(page.getHeight()));
+		CHECK(elapsed.count() < 1000.0);
+
+		// The atlas rounds the gutter up to the alignment
+		const unsigned int gutter = (padding + alignment - 1u) / alignment * alignment;
+		std::vector<Rect> reserved;
+		unsigned long long reservedTexels = 0ull;
+		for (unsigned int i = 0u; i < count; i++)
+		{
+			const auto& region = atlas.getRegion(std::to_wstring(i));
+			const Rect rect = padded(region, gutter);
+			CHECK(region.x >= gutter && region.y >= gutter);
+			CHECK(rect.right <= page.getWidth() && rect.bottom <= page.getHeight());
+			// Padding is rounded up to the alignment, so the region origins are aligned too
+			CHECK(rect.left % alignment == 0u && rect.top % alignment == 0u);
+			CHECK(region.x % alignment == 0u && region.y % alignment == 0u);
+			for (const Rect& other : reserved)
+			{
+				CHECK(!overlap(rect, other));
+			}
+			reserved.push_back(rect);
+			reservedTexels += static_cast<unsigned long long>(rect.right - rect.left) * (rect.bottom - rect.top);
+
+			CHECK(region.u0 == static_cast<float>(region.x) / static_cast<float>(page.getWidth()));
+			CHECK(region.v1 == static_cast<float>(region.y + region.height) / static_cast<float>(page.getHeight()));
+
+			// The image and its gutter hold the source's texels, the gutter extruded from its edges
+			const Surface::color expected(i + 1u);
+			bool filled = true;
+			for (unsigned int y = rect.top; y < rect.bottom; y++)
+			{
+				for (unsigned int x = rect.left; x < rect.right; x++)
+				{
+					filled = filled && page.getPixel(x, y).dword == expected.dword;
+				}
+			}
+			CHECK(filled);
+		}
+
+		// How much of the page the packer covered with images and their gutters, which is what it controls
+		const double fill = static_cast<double>(reservedTexels) / (static_cast<double>(page.getWidth()) * page.getHeight());
+		std::printf("%u rects, padding %u, alignment %u: %ux%u page, %.1f%% filled, %.1f%% occupied by images, packed in %.2f ms\n",
+			count, padding, alignment, page.getWidth(), page.getHeight(), fill * 100.0, atlas.getOccupancy() * 100.0f, elapsed.count());
+		CHECK(fill > minimumFill);
+	}
+
+	// Four 1100 texel squares overflow the 4096x2048 page packing starts from, so the page grows to 4096x4096
+	void testGrowth()
+	{
+		TextureAtlas atlas;
+		for (unsigned int i = 0u; i < 4u; i++)
+		{
+			atlas.add(std::to_wstring(i), makeSource(1100u, 1100u, i));
+		}
+		atlas.pack();
+		CHECK(atlas.getPage().getWidth() == 4096u);
+		CHECK(atlas.getPage().getHeight() == 4096u);
+	}
+
+	// Surfaces that cannot fit in the largest page are refused rather than packed into a bigger one
+	void testLimit()
+	{
+		TextureAtlas atlas(4u, 4u, 512u);
+		for (unsigned int i = 0u; i < 5u; i++)
+		{
+			atlas.add(std::to_wstring(i), makeSource(250u, 250u, i));
+		}
+		bool threw = false;
+		try
+		{
+			atlas.pack();
+		}
+		catch (const TextureAtlas::Exception&)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+		CHECK(!atlas.isPacked());
+	}
+
+	void testMisuse()
+	{
+		TextureAtlas atlas;
+		atlas.add(L"a", makeSource(16u, 16u, 0u));
+		const auto throws = [](auto&& action)
+			{
+				try
+				{
+					action();
+				}
+				catch (const TextureAtlas::Exception&)
+				{
+					return true;
+				}
+				return false;
+			};
+		CHECK(throws([&atlas] { atlas.add(L"a", makeSource(16u, 16u, 1u)); }));
+		CHECK(throws([&atlas] { static_cast<void>(atlas.getRegion(L"a")); }));
+		atlas.pack();
+		CHECK(throws([&atlas] { atlas.add(L"b", makeSource(16u, 16u, 1u)); }));
+		CHECK(throws([&atlas] { static_cast<void>(atlas.getRegion(L"b")); }));
+		CHECK(throws([] { TextureAtlas().pack(); }));
+	}
+}
+
+int main()
+{
+	testFixedSet(4u, 4u, 0.5);
+	testFixedSet(2u, 16u, 0.5);
+	testFixedSet(0u, 1u, 0.5);
+	testGrowth();
+	testLimit();
+	testMisuse();
+	return checkResult("TextureAtlasTest");
+}
@@ -0,0 +1,106 @@
+#include "TripleBuffer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <thread>
+
+#include "Check.hpp"
+
+namespace
+{
+	// Large enough that a torn copy would show: every word is derived from the sequence number
+	struct Snapshot
+	{
+		std::uint64_t sequence;
+		std::array<std::uint64_t, 64> words;
+
+		void fill(const std::uint64_t value) noexcept
+		{
+			sequence = value;
+			for (size_t i = 0; i < words.size(); i++)
+			{
+				words[i] = value * 0x9E3779B97F4A7C15ull + i;
+			}
+		}
+
+		[[nodiscard]] bool isWhole() const noexcept
+		{
+			for (size_t i = 0; i < words.size(); i++)
+			{
+				if (words[i] != sequence * 0x9E3779B97F4A7C15ull + i)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	// On one thread: nothing to acquire until a publish, and the newest of several publishes wins
+	void testHandoff()
+	{
+		TripleBuffer<Snapshot> buffer;
+		CHECK(!buffer.acquire());
+		buffer.back().fill(1u);
+		buffer.publish();
+		CHECK(buffer.acquire());
+		CHECK(buffer.front().sequence == 1u && buffer.front().isWhole());
+		CHECK(!buffer.acquire());
+		CHECK(buffer.front().sequence == 1u);
+
+		for (std::uint64_t sequence = 2u; sequence <= 5u; sequence++)
+		{
+			buffer.back().fill(sequence);
+			buffer.publish();
+		}
+		CHECK(buffer.acquire());
+		CHECK(buffer.front().sequence == 5u && buffer.front().isWhole());
+		CHECK(!buffer.acquire());
+	}
+
+	// A producer publishing as fast as it can against a consumer acquiring as fast as it can: every snapshot
+	// the consumer sees is whole, and once it has seen one it never sees an older one
+	void testTwoThreads()
+	{
+		constexpr std::uint64_t count = 2000000u;
+		TripleBuffer<Snapshot> buffer;
+		std::thread producer([&buffer]
+			{
+				for (std::uint64_t sequence = 1u; sequence <= count; sequence++)
+				{
+					buffer.back().fill(sequence);
+					buffer.publish();
+				}
+			});
+
+		std::uint64_t last = 0u;
+		unsigned long long acquired = 0ull;
+		unsigned long long torn = 0ull;
+		unsigned long long stale = 0ull;
+		while (last < count)
+		{
+			if (!buffer.acquire())
+			{
+				continue;
+			}
+			const Snapshot& snapshot = buffer.front();
+			acquired++;
+			torn += snapshot.isWhole() ? 0u : 1u;
+			stale += snapshot.sequence <= last ? 1u : 0u;
+			last = snapshot.sequence;
+		}
+		producer.join();
+
+		CHECK(torn == 0u);
+		CHECK(stale == 0u);
+		CHECK(acquired > 1u);
+		CHECK(!buffer.acquire() && buffer.front().sequence == count);
+	}
+}
+
+int main()
+{
+	testHandoff();
+	testTwoThreads();
+	return checkResult("TripleBufferTest");
+}
@@ -0,0 +1,191 @@
+#include "UploadRing.hpp"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace
+{
+	// Stands in for the dynamic constant buffer and the GPU that reads it. Every allocation is stamped with its
+	// frame and index, and a frame is only checked and retired latency frames after it was submitted, the way
+	// ConstantRing only retires a frame once its event query comes back. A stamp that changed in between means
+	// the ring handed out bytes the GPU was still reading.
+	class Backend
+	{
+	public:
+		Backend(UploadRing& ring, const unsigned int latency)
+			:
+			ring_(ring),
+			latency_(latency),
+			buffer_(std::make_shared<std::vector<unsigned char>>(ring.getCapacity()))
+		{}
+
+		void upload(const unsigned int size)
+		{
+			const auto allocation = ring_.allocate(size);
+			CHECK(allocation.has_value());
+			if (!allocation)
+			{
+				return;
+			}
+			CHECK(allocation->offset % ring_.getAlignment() == 0u);
+			CHECK(allocation->size % ring_.getAlignment() == 0u);
+			CHECK(allocation->size >= size);
+			CHECK(allocation->offset + allocation->size <= ring_.getCapacity());
+			if (allocation->discard)
+			{
+				// Orphaning: frames in flight keep reading the old buffer
+				buffer_ = std::make_shared<std::vector<unsigned char>>(ring_.getCapacity());
+			}
+
+			const auto stamp = static_cast<unsigned char>(stamps_++ * 31u + 7u);
+			std::fill_n(buffer_->begin() + allocation->offset, allocation->size, stamp);
+			open_.push_back({ buffer_, allocation->offset, allocation->size, stamp });
+		}
+
+		void endFrame()
+		{
+			submitted_.push_back({ ring_.endFrame(), std::move(open_) });
+			open_.clear();
+			while (submitted_.size() > latency_)
+			{
+				for (const auto& written : submitted_.front().uploads)
+				{
+					for (unsigned int i = 0u; i < written.size; i++)
+					{
+						if ((*written.buffer)[written.offset + i] != written.stamp)
+						{
+							overwrites_++;
+							break;
+						}
+					}
+				}
+				ring_.retire(submitted_.front().number);
+				submitted_.pop_front();
+			}
+		}
+
+		[[nodiscard]] unsigned long long getOverwrites() const noexcept
+		{
+			return overwrites_;
+		}
+	private:
+		struct Upload
+		{
+			std::shared_ptr<std::vector<unsigned char>> buffer;
+			unsigned int offset;
+			unsigned int size;
+			unsigned char stamp;
+		};
+		struct Frame
+		{
+			unsigned long long number;
+			std::vector<Upload> uploads;
+		};
+
+		UploadRing& ring_;
+		unsigned int latency_;
+		std::shared_ptr<std::vector<unsigned char>> buffer_;
+		std::vector<Upload> open_;
+		std::deque<Frame> submitted_;
+		unsigned int stamps_ = 0u;
+		unsigned long long overwrites_ = 0ull;
+	};
+
+	void testAlignment()
+	{
+		UploadRing ring(4096u, 256u);
+		Backend backend(ring, 2u);
+		for (unsigned int size : { 1u, 64u, 255u, 256u, 257u, 1000u })
+		{
+			backend.upload(size);
+		}
+		backend.endFrame();
+		CHECK(!ring.allocate(4097u).has_value());
+		CHECK(ring.getStatistics().allocations == 6u);
+	}
+
+	void testWrapAround()
+	{
+		// 768 bytes a frame into 4096 leaves a 256 byte tail that has to be skipped every few frames
+		UploadRing ring(4096u, 256u);
+		Backend backend(ring, 3u);
+		for (int frame = 0; frame < 200; frame++)
+		{
+			backend.upload(300u);
+			backend.upload(200u);
+			backend.endFrame();
+		}
+		const auto statistics = ring.getStatistics();
+		CHECK(statistics.wraps > 0u);
+		CHECK(statistics.discards == 0u);
+		CHECK(statistics.peakBytesInFlight <= ring.getCapacity());
+		CHECK(backend.getOverwrites() == 0u);
+	}
+
+	void testDiscardWhenFull()
+	{
+		// Three frames of 1 KiB in flight can't fit in 2 KiB, so the ring must orphan rather than overwrite
+		UploadRing ring(2048u, 256u);
+		Backend backend(ring, 3u);
+		for (int frame = 0; frame < 20; frame++)
+		{
+			for (int draw = 0; draw < 4; draw++)
+			{
+				backend.upload(256u);
+			}
+			backend.endFrame();
+		}
+		CHECK(ring.getStatistics().discards > 0u);
+		CHECK(backend.getOverwrites() == 0u);
+	}
+
+	void testCapacityForDrawCount()
+	{
+		// 10k draws of one 256 byte slice, with the GPU trailing by as many frames as ConstantRing allows for
+		constexpr size_t draws = 10000u;
+		constexpr unsigned int framesInFlight = 5u;
+		const unsigned int capacity = UploadRing::getCapacityFor(draws, 256u, 256u, framesInFlight);
+		CHECK(capacity == draws * 256u * framesInFlight);
+
+		UploadRing sized(capacity, 256u);
+		Backend sizedBackend(sized, framesInFlight - 1u);
+		UploadRing fixed(256u * 1024u, 256u);
+		Backend fixedBackend(fixed, framesInFlight - 1u);
+		for (int frame = 0; frame < 30; frame++)
+		{
+			for (size_t draw = 0; draw < draws; draw++)
+			{
+				sizedBackend.upload(64u);
+				fixedBackend.upload(64u);
+			}
+			sizedBackend.endFrame();
+			fixedBackend.endFrame();
+		}
+		CHECK(sized.getStatistics().discards == 0u);
+		CHECK(sizedBackend.getOverwrites() == 0u);
+		// The old fixed 256 KiB ring orphans several times every frame at this load
+		CHECK(fixed.getStatistics().discards >= 30u);
+		CHECK(fixedBackend.getOverwrites() == 0u);
+	}
+
+	void testCapacitySaturates()
+	{
+		const unsigned int capacity = UploadRing::getCapacityFor(size_t{ 1 } << 40, 256u, 256u, 5u);
+		CHECK(capacity % 256u == 0u);
+		CHECK(capacity > 0xFFFFFF00u - 256u);
+		CHECK(UploadRing::getCapacityFor(0u, 0u, 256u, 0u) == 256u);
+	}
+}
+
+int main()
+{
+	testAlignment();
+	testWrapAround();
+	testDiscardWhenFull();
+	testCapacityForDrawCount();
+	testCapacitySaturates();
+	return checkResult("UploadRingTest");
+}
@@ -0,0 +1,263 @@
+#pragma once
+#include <cmath>
+
+// The part of DirectXMath the portable sources use, in plain C++ so they build without the Windows SDK. Same
+// row-vector convention and storage types as the real library; XMVECTOR and XMMATRIX are plain arrays rather than
+// SSE registers, which is all the code under test needs.
+namespace DirectX
+{
+	constexpr float XM_PI = 3.141592654f;
+	constexpr float XM_2PI = 6.283185307f;
+	constexpr float XM_PIDIV2 = 1.570796327f;
+	constexpr float XM_PIDIV4 = 0.785398163f;
+
+	struct XMFLOAT2
+	{
+		float x;
+		float y;
+	};
+
+	struct XMFLOAT3
+	{
+		float x;
+		float y;
+		float z;
+	};
+
+	struct XMFLOAT4
+	{
+		float x;
+		float y;
+		float z;
+		float w;
+	};
+
+	struct XMFLOAT4X4
+	{
+		union
+		{
+			struct
+			{
+				float _11, _12, _13, _14;
+				float _21, _22, _23, _24;
+				float _31, _32, _33, _34;
+				float _41, _42, _43, _44;
+			};
+			float m[4][4];
+		};
+	};
+
+	struct XMVECTOR
+	{
+		float v[4];
+	};
+
+	struct XMMATRIX
+	{
+		XMVECTOR r[4];
+	};
+
+	using FXMVECTOR = const XMVECTOR&;
+	using GXMVECTOR = const XMVECTOR&;
+	using CXMVECTOR = const XMVECTOR&;
+	using FXMMATRIX = const XMMATRIX&;
+	using CXMMATRIX = const XMMATRIX&;
+
+	inline XMVECTOR XMVectorSet(const float x, const float y, const float z, const float w) noexcept
+	{
+		return { { x, y, z, w } };
+	}
+
+	inline XMVECTOR XMVectorZero() noexcept
+	{
+		return { { 0.0f, 0.0f, 0.0f, 0.0f } };
+	}
+
+	inline XMVECTOR XMVectorSplatOne() noexcept
+	{
+		return { { 1.0f, 1.0f, 1.0f, 1.0f } };
+	}
+
+	inline float XMVectorGetX(FXMVECTOR v) noexcept
+	{
+		return v.v[0];
+	}
+
+	inline float XMVectorGetY(FXMVECTOR v) noexcept
+	{
+		return v.v[1];
+	}
+
+	inline float XMVectorGetZ(FXMVECTOR v) noexcept
+	{
+		return v.v[2];
+	}
+
+	inline float XMVectorGetW(FXMVECTOR v) noexcept
+	{
+		return v.v[3];
+	}
+
+	inline XMVECTOR XMVectorAdd(FXMVECTOR a, FXMVECTOR b) noexcept
+	{
+		return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+	}
+
+	inline XMVECTOR XMVectorNegate(FXMVECTOR v) noexcept
+	{
+		return { { -v.v[0], -v.v[1], -v.v[2], -v.v[3] } };
+	}
+
+	inline XMVECTOR XMVectorLerp(FXMVECTOR a, FXMVECTOR b, const float t) noexcept
+	{
+		XMVECTOR result;
+		for (int i = 0; i < 4; i++)
+		{
+			result.v[i] = a.v[i] + (b.v[i] - a.v[i]) * t;
+		}
+		return result;
+	}
+
+	inline XMVECTOR XMLoadFloat3(const XMFLOAT3* source) noexcept
+	{
+		return { { source->x, source->y, source->z, 0.0f } };
+	}
+
+	inline void XMStoreFloat3(XMFLOAT3* destination, FXMVECTOR v) noexcept
+	{
+		*destination = { v.v[0], v.v[1], v.v[2] };
+	}
+
+	inline XMVECTOR XMLoadFloat4(const XMFLOAT4* source) noexcept
+	{
+		return { { source->x, source->y, source->z, source->w } };
+	}
+
+	inline void XMStoreFloat4(XMFLOAT4* destination, FXMVECTOR v) noexcept
+	{
+		*destination = { v.v[0], v.v[1], v.v[2], v.v[3] };
+	}
+
+	inline XMVECTOR XMVector4Transform(FXMVECTOR v, FXMMATRIX m) noexcept
+	{
+		XMVECTOR result;
+		for (int column = 0; column < 4; column++)
+		{
+			result.v[column] = v.v[0] * m.r[0].v[column] + v.v[1] * m.r[1].v[column] + v.v[2] * m.r[2].v[column] + v.v[3] * m.r[3].v[column];
+		}
+		return result;
+	}
+
+	// w is taken as 1, as DirectXMath does
+	inline XMVECTOR XMVector3Transform(FXMVECTOR v, FXMMATRIX m) noexcept
+	{
+		return XMVector4Transform({ { v.v[0], v.v[1], v.v[2], 1.0f } }, m);
+	}
+
+	inline XMMATRIX XMMatrixIdentity() noexcept
+	{
+		return { { { { 1.0f, 0.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 0.0f, 1.0f } } } };
+	}
+
+	inline XMMATRIX XMMatrixMultiply(FXMMATRIX a, CXMMATRIX b) noexcept
+	{
+		XMMATRIX result;
+		for (int row = 0; row < 4; row++)
+		{
+			result.r[row] = XMVector4Transform(a.r[row], b);
+		}
+		return result;
+	}
+
+	inline XMMATRIX operator*(FXMMATRIX a, CXMMATRIX b) noexcept
+	{
+		return XMMatrixMultiply(a, b);
+	}
+
+	inline XMMATRIX XMMatrixTranspose(FXMMATRIX m) noexcept
+	{
+		XMMATRIX result;
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				result.r[row].v[column] = m.r[column].v[row];
+			}
+		}
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixTranslation(const float x, const float y, const float z) noexcept
+	{
+		XMMATRIX result = XMMatrixIdentity();
+		result.r[3] = { { x, y, z, 1.0f } };
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixScaling(const float x, const float y, const float z) noexcept
+	{
+		XMMATRIX result = XMMatrixIdentity();
+		result.r[0].v[0] = x;
+		result.r[1].v[1] = y;
+		result.r[2].v[2] = z;
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixRotationX(const float angle) noexcept
+	{
+		const float s = std::sin(angle);
+		const float c = std::cos(angle);
+		return { { { { 1.0f, 0.0f, 0.0f, 0.0f } }, { { 0.0f, c, s, 0.0f } }, { { 0.0f, -s, c, 0.0f } }, { { 0.0f, 0.0f, 0.0f, 1.0f } } } };
+	}
+
+	inline XMMATRIX XMMatrixRotationY(const float angle) noexcept
+	{
+		const float s = std::sin(angle);
+		const float c = std::cos(angle);
+		return { { { { c, 0.0f, -s, 0.0f } }, { { 0.0f, 1.0f, 0.0f, 0.0f } }, { { s, 0.0f, c, 0.0f } }, { { 0.0f, 0.0f, 0.0f, 1.0f } } } };
+	}
+
+	inline XMMATRIX XMMatrixRotationZ(const float angle) noexcept
+	{
+		const float s = std::sin(angle);
+		const float c = std::cos(angle);
+		return { { { { c, s, 0.0f, 0.0f } }, { { -s, c, 0.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 0.0f, 1.0f } } } };
+	}
+
+	// Roll about z, then pitch about x, then yaw about y
+	inline XMMATRIX XMMatrixRotationRollPitchYaw(const float pitch, const float yaw, const float roll) noexcept
+	{
+		return XMMatrixRotationZ(roll) * XMMatrixRotationX(pitch) * XMMatrixRotationY(yaw);
+	}
+
+	inline XMMATRIX XMMatrixPerspectiveLH(const float width, const float height, const float nearZ, const float farZ) noexcept
+	{
+		const float range = farZ / (farZ - nearZ);
+		return { { { { 2.0f * nearZ / width, 0.0f, 0.0f, 0.0f } }, { { 0.0f, 2.0f * nearZ / height, 0.0f, 0.0f } },
+			{ { 0.0f, 0.0f, range, 1.0f } }, { { 0.0f, 0.0f, -range * nearZ, 0.0f } } } };
+	}
+
+	inline void XMStoreFloat4x4(XMFLOAT4X4* destination, FXMMATRIX m) noexcept
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				destination->m[row][column] = m.r[row].v[column];
+			}
+		}
+	}
+
+	inline XMMATRIX XMLoadFloat4x4(const XMFLOAT4X4* source) noexcept
+	{
+		XMMATRIX result;
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				result.r[row].v[column] = source->m[row][column];
+			}
+		}
+		return result;
+	}
+}